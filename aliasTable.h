@@ -0,0 +1,92 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include "simRandom.h"
+#include <initializer_list>
+
+// ============ 离散决策的别名表抽样 ============
+// 传球目标、扣球策略、拦网人数、接一球员这类"按百分比选一个"的决策，
+// 原先写成一串 if/else 去比较 rand()%100。现在每种决策情境预先建一张别名表（Walker/Vose 方法），
+// 抽样只需一次随机数、一次比较，与选项个数和排列顺序无关。
+// 权重为整数（通常就是百分比），建表和抽样都是整数运算，分布与原来的百分比严格相同。
+// 表中保留了原始权重，分析工具可以直接用 probability() 读取各选项的概率。
+
+const int kAliasMaxOutcomes = 8;
+
+// 一个选项：结果（一般是枚举值）与整数权重
+struct AliasEntry {
+    int outcome;
+    int weight;
+};
+
+struct AliasTable {
+    int count = 0;                              // 选项个数
+    int total = 0;                              // 权重之和
+    int outcome[kAliasMaxOutcomes] = {};        // 各列对应的结果
+    int weight[kAliasMaxOutcomes] = {};         // 原始权重
+    int threshold[kAliasMaxOutcomes] = {};      // 落在本列时，余数小于该值取本列，否则取别名列
+    int alias[kAliasMaxOutcomes] = {};          // 别名列下标
+
+    // 抽样：一次 simRandBelow()，先定列再定取本列还是别名
+    int sample() const {
+        int r = simRandBelow(count * total);
+        int column = r / total;
+        return (r % total) < threshold[column] ? outcome[column] : outcome[alias[column]];
+    }
+
+    // 某个结果的概率（不在表中为 0）
+    double probability(int value) const {
+        int sum = 0;
+        for (int i = 0; i < count; i++) {
+            if (outcome[i] == value) sum += weight[i];
+        }
+        return total > 0 ? static_cast<double>(sum) / total : 0.0;
+    }
+};
+
+// 由（结果，权重）列表建表；权重为 0 的选项直接略去，最多 kAliasMaxOutcomes 个
+constexpr AliasTable makeAliasTable(const AliasEntry* entries, int n) {
+    AliasTable table;
+    for (int i = 0; i < n && table.count < kAliasMaxOutcomes; i++) {
+        if (entries[i].weight <= 0) continue;
+        table.outcome[table.count] = entries[i].outcome;
+        table.weight[table.count] = entries[i].weight;
+        table.total += entries[i].weight;
+        table.count++;
+    }
+    if (table.count == 0) return table;
+
+    // 每列容量为 total，权重放大 count 倍后按 Vose 方法把"多出的"部分填进"不足"的列
+    int scaled[kAliasMaxOutcomes] = {};
+    int small[kAliasMaxOutcomes] = {}, large[kAliasMaxOutcomes] = {};
+    int smallCount = 0, largeCount = 0;
+    for (int i = 0; i < table.count; i++) {
+        scaled[i] = table.weight[i] * table.count;
+        table.alias[i] = i;
+        if (scaled[i] < table.total) small[smallCount++] = i;
+        else large[largeCount++] = i;
+    }
+    while (smallCount > 0 && largeCount > 0) {
+        int s = small[--smallCount];
+        int l = large[--largeCount];
+        table.threshold[s] = scaled[s];
+        table.alias[s] = l;
+        scaled[l] -= table.total - scaled[s];
+        if (scaled[l] < table.total) small[smallCount++] = l;
+        else large[largeCount++] = l;
+    }
+    // 剩下的列恰好装满（整数运算无舍入误差）
+    while (largeCount > 0) table.threshold[large[--largeCount]] = table.total;
+    while (smallCount > 0) table.threshold[small[--smallCount]] = table.total;
+    return table;
+}
+
+constexpr AliasTable makeAliasTable(std::initializer_list<AliasEntry> entries) {
+    return makeAliasTable(entries.begin(), static_cast<int>(entries.size()));
+}
+
+#endif //ALIASTABLE_H
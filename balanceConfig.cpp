@@ -0,0 +1,293 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "balanceConfig.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+    // 默认参数（即 config.h 中的宏），常量初始化，保证任何线程在 pin 之前也能读到有效参数
+    constexpr BalanceParams kDefaultBalance{};
+
+    // 配置名 -> 成员指针
+    struct BalanceField {
+        const char* key;
+        double BalanceParams::* realValue;
+        int BalanceParams::* intValue;
+    };
+
+#define BALANCE_REAL(KEY, member) { #KEY, &BalanceParams::member, nullptr }
+#define BALANCE_INT(KEY, member) { #KEY, nullptr, &BalanceParams::member }
+
+    const BalanceField kBalanceFields[] = {
+        BALANCE_REAL(DUMP_ERROR_RATE, dumpErrorRate),
+        BALANCE_INT(MAX_RALLY_COUNT, maxRallyCount),
+
+        BALANCE_REAL(AGGRESSIVE_SERVE_THRESHOLD, aggressiveServeThreshold),
+        BALANCE_REAL(STABLE_SERVE_BASIC_FAULT_RATE, stableServeBasicFaultRate),
+        BALANCE_REAL(AGGRESSIVE_SERVE_BASIC_FAULT_RATE, aggressiveServeBasicFaultRate),
+        BALANCE_REAL(STABLE_SERVE_POWER_RATE, stableServePowerRate),
+        BALANCE_REAL(AGGRESSIVE_SERVE_POWER_RATE, aggressiveServePowerRate),
+
+        BALANCE_REAL(SET_QUICK_ATTACK_DIFF_RATE, setQuickAttackDiffRate),
+        BALANCE_REAL(SET_BACK_ATTACK_DIFF_RATE, setBackAttackDiffRate),
+        BALANCE_REAL(SET_OPPOSITE_DIFF_RATE, setOppositeDiffRate),
+        BALANCE_REAL(SET_FRONT_SPIKER_DIFF_RATE, setFrontSpikerDiffRate),
+        BALANCE_REAL(SET_ADJUST_ATTACK_DIFF_RATE, setAdjustAttackDiffRate),
+
+        BALANCE_REAL(STRONG_ATTACK_POWER, strongAttackPower),
+        BALANCE_REAL(STRONG_ATTACK_BLOCK, strongAttackBlock),
+        BALANCE_REAL(STRONG_ATTACK_FAULT, strongAttackFault),
+        BALANCE_REAL(STRONG_ATTACK_PASS, strongAttackPass),
+        BALANCE_REAL(STRONG_ATTACK_ADJUST, strongAttackAdjust),
+        BALANCE_REAL(AVOID_BLOCK_POWER, avoidBlockPower),
+        BALANCE_REAL(AVOID_BLOCK_BLOCK, avoidBlockBlock),
+        BALANCE_REAL(AVOID_BLOCK_FAULT, avoidBlockFault),
+        BALANCE_REAL(AVOID_BLOCK_PASS, avoidBlockPass),
+        BALANCE_REAL(AVOID_BLOCK_ADJUST, avoidBlockAdjust),
+        BALANCE_REAL(DROP_SHOT_POWER, dropShotPower),
+        BALANCE_REAL(DROP_SHOT_BLOCK, dropShotBlock),
+        BALANCE_REAL(DROP_SHOT_FAULT, dropShotFault),
+        BALANCE_REAL(DROP_SHOT_PASS, dropShotPass),
+        BALANCE_REAL(DROP_SHOT_ADJUST, dropShotAdjust),
+        BALANCE_REAL(QUICK_ATTACK_POWER, quickAttackPower),
+        BALANCE_REAL(QUICK_ATTACK_BLOCK, quickAttackBlock),
+        BALANCE_REAL(QUICK_ATTACK_FAULT, quickAttackFault),
+        BALANCE_REAL(QUICK_ATTACK_PASS, quickAttackPass),
+        BALANCE_REAL(QUICK_ATTACK_ADJUST, quickAttackAdjust),
+        BALANCE_REAL(ADJUST_SPIKE_POWER, adjustSpikePower),
+        BALANCE_REAL(ADJUST_SPIKE_BLOCK, adjustSpikeBlock),
+        BALANCE_REAL(ADJUST_SPIKE_FAULT, adjustSpikeFault),
+        BALANCE_REAL(ADJUST_SPIKE_PASS, adjustSpikePass),
+        BALANCE_REAL(ADJUST_SPIKE_ADJUST, adjustSpikeAdjust),
+        BALANCE_REAL(TRANSITION_ATTACK_POWER, transitionAttackPower),
+        BALANCE_REAL(TRANSITION_ATTACK_BLOCK, transitionAttackBlock),
+        BALANCE_REAL(TRANSITION_ATTACK_FAULT, transitionAttackFault),
+        BALANCE_REAL(TRANSITION_ATTACK_PASS, transitionAttackPass),
+        BALANCE_REAL(TRANSITION_ATTACK_ADJUST, transitionAttackAdjust),
+        BALANCE_REAL(SETTER_SPIKE_POWER, setterSpikePower),
+        BALANCE_REAL(SETTER_SPIKE_BLOCK, setterSpikeBlock),
+        BALANCE_REAL(SETTER_SPIKE_FAULT, setterSpikeFault),
+        BALANCE_REAL(SETTER_SPIKE_PASS, setterSpikePass),
+        BALANCE_REAL(SETTER_SPIKE_ADJUST, setterSpikeAdjust),
+        BALANCE_REAL(BACK_ATTACK_POWER_ADJUST, backAttackPowerAdjust),
+        BALANCE_REAL(BACK_ATTACK_BLOCK_ADJUST, backAttackBlockAdjust),
+
+        BALANCE_REAL(SINGLE_BLOCK_RATE, singleBlockRate),
+        BALANCE_REAL(DOUBLE_BLOCK_RATE, doubleBlockRate),
+        BALANCE_REAL(TRIPLE_BLOCK_RATE, tripleBlockRate),
+        BALANCE_REAL(BLOCK_BREAK_THRESHOLD, blockBreakThreshold),
+        BALANCE_REAL(BLOCK_NO_TOUCH_THRESHOLD, blockNoTouchThreshold),
+        BALANCE_REAL(BLOCK_LIMIT_PATH_THRESHOLD, blockLimitPathThreshold),
+        BALANCE_REAL(BLOCK_TOUCH_THRESHOLD, blockTouchThreshold),
+        BALANCE_REAL(SPIKE_INCREASE_RATIO, spikeIncreaseRatio),
+        BALANCE_REAL(SPIKE_REDUCTION_RATIO, spikeReductionRatio),
+    };
+
+#undef BALANCE_REAL
+#undef BALANCE_INT
+
+    const BalanceField* findField(const std::string& key) {
+        for (const auto& f : kBalanceFields) {
+            if (key == f.key) return &f;
+        }
+        return nullptr;
+    }
+
+    std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    // 最新发布的参数
+    std::mutex g_balanceMutex;
+    std::shared_ptr<const BalanceParams> g_publishedBalance;
+
+    // 当前线程持有的参数引用，保证 pin 期间参数不会被释放
+    thread_local std::shared_ptr<const BalanceParams> t_pinnedBalance;
+
+    // 文件监视线程
+    std::thread g_watcherThread;
+    std::atomic<bool> g_watcherRunning{false};
+}
+
+constinit thread_local const BalanceParams* g_threadBalance = &kDefaultBalance;
+
+std::shared_ptr<const BalanceParams> currentBalance() {
+    std::lock_guard<std::mutex> lk(g_balanceMutex);
+    if (!g_publishedBalance) g_publishedBalance = std::make_shared<const BalanceParams>();
+    return g_publishedBalance;
+}
+
+void publishBalance(std::shared_ptr<const BalanceParams> params) {
+    if (!params) return;
+    std::lock_guard<std::mutex> lk(g_balanceMutex);
+    g_publishedBalance = std::move(params);
+}
+
+void pinBalance() {
+    pinBalance(currentBalance());
+}
+
+void pinBalance(std::shared_ptr<const BalanceParams> params) {
+    t_pinnedBalance = std::move(params);
+    g_threadBalance = t_pinnedBalance ? t_pinnedBalance.get() : &kDefaultBalance;
+}
+
+bool setBalanceValue(BalanceParams& params, const std::string& key, double value) {
+    const BalanceField* f = findField(key);
+    if (!f) return false;
+    if (f->realValue) params.*(f->realValue) = value;
+    else params.*(f->intValue) = static_cast<int>(value);
+    return true;
+}
+
+bool getBalanceValue(const BalanceParams& params, const std::string& key, double& value) {
+    const BalanceField* f = findField(key);
+    if (!f) return false;
+    value = f->realValue ? params.*(f->realValue) : params.*(f->intValue);
+    return true;
+}
+
+std::vector<std::string> balanceKeys() {
+    std::vector<std::string> keys;
+    for (const auto& f : kBalanceFields) keys.emplace_back(f.key);
+    return keys;
+}
+
+std::vector<double> balanceValues(const BalanceParams& params) {
+    std::vector<double> values;
+    values.reserve(std::size(kBalanceFields));
+    for (const auto& f : kBalanceFields) values.push_back(f.realValue ? params.*(f.realValue) : params.*(f.intValue));
+    return values;
+}
+
+bool parseConfigLine(const std::string& rawLine, std::string& key, std::string& value) {
+    std::string line = trim(rawLine);
+    key.clear();
+    value.clear();
+
+    // 允许直接粘贴 config.h 中的 #define 行
+    if (line.rfind("#define", 0) == 0) {
+        line = line.substr(7);
+        size_t sp = line.find_first_not_of(" \t");
+        size_t nameEnd = (sp == std::string::npos) ? std::string::npos : line.find_first_of(" \t", sp);
+        if (nameEnd != std::string::npos) line[nameEnd] = '=';
+    }
+    size_t comment = line.find("//");
+    if (comment != std::string::npos) line = line.substr(0, comment);
+    comment = line.find('#');
+    if (comment != std::string::npos) line = line.substr(0, comment);
+    line = trim(line);
+    if (line.empty()) return false;
+
+    size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+        key = line;     // 非空但格式错误
+        return false;
+    }
+    key = trim(line.substr(0, eq));
+    value = trim(line.substr(eq + 1));
+    return !key.empty();
+}
+
+bool loadBalanceFile(const std::string& path, const BalanceParams& base, BalanceParams& out, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        error = "无法打开 " + path;
+        return false;
+    }
+
+    BalanceParams params = base;
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(ifs, line)) {
+        lineNum++;
+        std::string key, valueStr;
+        if (!parseConfigLine(line, key, valueStr)) {
+            if (key.empty()) continue;
+            error = path + " 第" + std::to_string(lineNum) + "行格式错误: " + key;
+            return false;
+        }
+
+        double value = 0;
+        std::istringstream iss(valueStr);
+        if (!readWhole(iss, value)) {
+            error = path + " 第" + std::to_string(lineNum) + "行数值错误: " + valueStr;
+            return false;
+        }
+        if (!setBalanceValue(params, key, value)) {
+            error = path + " 第" + std::to_string(lineNum) + "行未知参数: " + key;
+            return false;
+        }
+    }
+
+    out = params;
+    return true;
+}
+
+bool saveBalanceFile(const std::string& path, const BalanceParams& params) {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) return false;
+
+    ofs << "// 游戏平衡参数（参数名 = 数值），可直接替换 balance.cfg\n";
+    ofs.precision(6);
+    for (const auto& f : kBalanceFields) {
+        ofs << f.key << " = ";
+        if (f.realValue) ofs << params.*(f.realValue);
+        else ofs << params.*(f.intValue);
+        ofs << "\n";
+    }
+    return true;
+}
+
+bool reloadBalance(const std::string& path, std::ostream& log) {
+    // 以默认值为基础读取，这样从文件中删掉的键会恢复为默认值
+    BalanceParams params;
+    std::string error;
+    if (!loadBalanceFile(path, kDefaultBalance, params, error)) {
+        std::cerr << "平衡参数读取失败: " << error << std::endl;
+        return false;
+    }
+    publishBalance(std::make_shared<const BalanceParams>(params));
+    log << "已载入平衡参数: " << path << std::endl;
+    return true;
+}
+
+void startBalanceWatcher(const std::string& path, int intervalMs) {
+    if (g_watcherRunning.exchange(true)) return;
+
+    g_watcherThread = std::thread([path, intervalMs]() {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        auto lastWrite = fs::last_write_time(path, ec);
+        bool existed = !ec;
+
+        while (g_watcherRunning.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+            auto t = fs::last_write_time(path, ec);
+            if (ec) { existed = false; continue; }
+            if (!existed || t != lastWrite) {
+                existed = true;
+                lastWrite = t;
+                // 新参数只会在下一场比赛 pin 时生效
+                reloadBalance(path, std::cerr);
+            }
+        }
+    });
+}
+
+void stopBalanceWatcher() {
+    if (!g_watcherRunning.exchange(false)) return;
+    if (g_watcherThread.joinable()) g_watcherThread.join();
+}
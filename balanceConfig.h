@@ -0,0 +1,140 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef BALANCECONFIG_H
+#define BALANCECONFIG_H
+
+#include "config.h"
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============ 运行时平衡参数 ============
+// config.h 中的平衡宏只作为默认值，实际数值在启动时（及文件变化时）从 balance.cfg 读取。
+// 一份参数发布后不可修改；引擎在每场比赛开始时把最新参数固定（pin）到当前线程，
+// 热路径上 balance() 只是一次线程局部指针解引用，不加锁。
+
+struct BalanceParams {
+    // 通用
+    double dumpErrorRate = DUMP_ERROR_RATE;
+    int maxRallyCount = MAX_RALLY_COUNT;
+
+    // 发球部分
+    double aggressiveServeThreshold = AGGRESSIVE_SERVE_THRESHOLD;
+    double stableServeBasicFaultRate = STABLE_SERVE_BASIC_FAULT_RATE;
+    double aggressiveServeBasicFaultRate = AGGRESSIVE_SERVE_BASIC_FAULT_RATE;
+    double stableServePowerRate = STABLE_SERVE_POWER_RATE;
+    double aggressiveServePowerRate = AGGRESSIVE_SERVE_POWER_RATE;
+
+    // 二传部分
+    double setQuickAttackDiffRate = SET_QUICK_ATTACK_DIFF_RATE;
+    double setBackAttackDiffRate = SET_BACK_ATTACK_DIFF_RATE;
+    double setOppositeDiffRate = SET_OPPOSITE_DIFF_RATE;
+    double setFrontSpikerDiffRate = SET_FRONT_SPIKER_DIFF_RATE;
+    double setAdjustAttackDiffRate = SET_ADJUST_ATTACK_DIFF_RATE;
+
+    // 扣球部分（各策略系数）
+    double strongAttackPower = STRONG_ATTACK_POWER;
+    double strongAttackBlock = STRONG_ATTACK_BLOCK;
+    double strongAttackFault = STRONG_ATTACK_FAULT;
+    double strongAttackPass = STRONG_ATTACK_PASS;
+    double strongAttackAdjust = STRONG_ATTACK_ADJUST;
+
+    double avoidBlockPower = AVOID_BLOCK_POWER;
+    double avoidBlockBlock = AVOID_BLOCK_BLOCK;
+    double avoidBlockFault = AVOID_BLOCK_FAULT;
+    double avoidBlockPass = AVOID_BLOCK_PASS;
+    double avoidBlockAdjust = AVOID_BLOCK_ADJUST;
+
+    double dropShotPower = DROP_SHOT_POWER;
+    double dropShotBlock = DROP_SHOT_BLOCK;
+    double dropShotFault = DROP_SHOT_FAULT;
+    double dropShotPass = DROP_SHOT_PASS;
+    double dropShotAdjust = DROP_SHOT_ADJUST;
+
+    double quickAttackPower = QUICK_ATTACK_POWER;
+    double quickAttackBlock = QUICK_ATTACK_BLOCK;
+    double quickAttackFault = QUICK_ATTACK_FAULT;
+    double quickAttackPass = QUICK_ATTACK_PASS;
+    double quickAttackAdjust = QUICK_ATTACK_ADJUST;
+
+    double adjustSpikePower = ADJUST_SPIKE_POWER;
+    double adjustSpikeBlock = ADJUST_SPIKE_BLOCK;
+    double adjustSpikeFault = ADJUST_SPIKE_FAULT;
+    double adjustSpikePass = ADJUST_SPIKE_PASS;
+    double adjustSpikeAdjust = ADJUST_SPIKE_ADJUST;
+
+    double transitionAttackPower = TRANSITION_ATTACK_POWER;
+    double transitionAttackBlock = TRANSITION_ATTACK_BLOCK;
+    double transitionAttackFault = TRANSITION_ATTACK_FAULT;
+    double transitionAttackPass = TRANSITION_ATTACK_PASS;
+    double transitionAttackAdjust = TRANSITION_ATTACK_ADJUST;
+
+    double setterSpikePower = SETTER_SPIKE_POWER;
+    double setterSpikeBlock = SETTER_SPIKE_BLOCK;
+    double setterSpikeFault = SETTER_SPIKE_FAULT;
+    double setterSpikePass = SETTER_SPIKE_PASS;
+    double setterSpikeAdjust = SETTER_SPIKE_ADJUST;
+
+    double backAttackPowerAdjust = BACK_ATTACK_POWER_ADJUST;
+    double backAttackBlockAdjust = BACK_ATTACK_BLOCK_ADJUST;
+
+    // 拦网部分
+    double singleBlockRate = SINGLE_BLOCK_RATE;
+    double doubleBlockRate = DOUBLE_BLOCK_RATE;
+    double tripleBlockRate = TRIPLE_BLOCK_RATE;
+    double blockBreakThreshold = BLOCK_BREAK_THRESHOLD;
+    double blockNoTouchThreshold = BLOCK_NO_TOUCH_THRESHOLD;
+    double blockLimitPathThreshold = BLOCK_LIMIT_PATH_THRESHOLD;
+    double blockTouchThreshold = BLOCK_TOUCH_THRESHOLD;
+    double spikeIncreaseRatio = SPIKE_INCREASE_RATIO;
+    double spikeReductionRatio = SPIKE_REDUCTION_RATIO;
+};
+
+// 当前线程固定的参数（只读、无锁）
+extern constinit thread_local const BalanceParams* g_threadBalance;
+
+inline const BalanceParams& balance() {
+    return *g_threadBalance;
+}
+
+// 固定最新发布的参数到当前线程（在比赛开始时调用，比赛中途不会变化）
+void pinBalance();
+// 固定指定参数到当前线程（参数扫描等场景使用）
+void pinBalance(std::shared_ptr<const BalanceParams> params);
+
+// 最新发布的参数 / 发布新参数
+std::shared_ptr<const BalanceParams> currentBalance();
+void publishBalance(std::shared_ptr<const BalanceParams> params);
+
+// 按配置名读写参数（配置名与 config.h 中的宏同名，如 AGGRESSIVE_SERVE_THRESHOLD）
+bool setBalanceValue(BalanceParams& params, const std::string& key, double value);
+bool getBalanceValue(const BalanceParams& params, const std::string& key, double& value);
+std::vector<std::string> balanceKeys();
+std::vector<double> balanceValues(const BalanceParams& params);    // 全部参数的值，顺序同 balanceKeys()
+
+// 配置文件的一行：去掉 // 与 # 注释后按 KEY = value 拆分；空行返回 false 且 key 为空，格式错误返回 false 且 key 为该行内容
+bool parseConfigLine(const std::string& line, std::string& key, std::string& value);
+
+// 把配置值剩下的部分整个按类型读完（不允许多余内容，如 "0.0x5"）
+template <typename T>
+bool readWhole(std::istream& in, T& out) {
+    return (in >> out) && (in >> std::ws).eof();
+}
+
+// 解析配置文件：每行 KEY = value，支持 // 与 # 注释；未出现的键保持 base 中的值
+bool loadBalanceFile(const std::string& path, const BalanceParams& base, BalanceParams& out, std::string& error);
+// 以 balance.cfg 的格式写出全部参数
+bool saveBalanceFile(const std::string& path, const BalanceParams& params);
+// 读取配置文件并发布（失败时保留原参数），载入提示写到 log；失败信息总是写到标准错误
+bool reloadBalance(const std::string& path, std::ostream& log);
+
+// 后台监视配置文件，修改时间变化后自动重新读取并发布。
+// 提示写到标准错误，不与前台线程写到标准输出的内容交错
+void startBalanceWatcher(const std::string& path, int intervalMs = 1000);
+void stopBalanceWatcher();
+
+#endif //BALANCECONFIG_H
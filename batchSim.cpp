@@ -0,0 +1,172 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "batchSim.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+Roster captureRoster() {
+    Roster roster;
+    for (int i = 0; i < 7; i++) {
+        roster.teamA[i] = teamA[i];
+        roster.teamB[i] = teamB[i];
+    }
+    return roster;
+}
+
+void applyRoster(const Roster& roster) {
+    for (int i = 0; i < 7; i++) {
+        teamA[i] = roster.teamA[i];
+        teamB[i] = roster.teamB[i];
+    }
+}
+
+uint64_t matchSeed(uint64_t seed, uint64_t index) {
+    return seed * 0x100000001b3ULL + index;
+}
+
+double aceRate(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.aces) / s.rallies : 0.0;
+}
+
+double serveFaultRate(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.serveFaults) / s.rallies : 0.0;
+}
+
+double sideOutRate(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.sideOuts) / s.rallies : 0.0;
+}
+
+double meanRallyLength(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.touches) / s.rallies : 0.0;
+}
+
+double attacksPerRally(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.attacks) / s.rallies : 0.0;
+}
+
+double blockPointShare(const MatchStats& s) {
+    return s.rallies ? static_cast<double>(s.blockPoints) / s.rallies : 0.0;
+}
+
+double killRate(const MatchStats& s) {
+    return s.attacks ? static_cast<double>(s.attackPoints) / s.attacks : 0.0;
+}
+
+double blockPointsPerSet(const MatchStats& s) {
+    return s.sets ? static_cast<double>(s.blockPoints) / s.sets : 0.0;
+}
+
+void wilsonInterval(long long successes, long long trials, double z, double& low, double& high) {
+    if (trials <= 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+    double n = static_cast<double>(trials);
+    double p = successes / n;
+    double z2 = z * z;
+    double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double half = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    low = std::max(0.0, center - half);
+    high = std::min(1.0, center + half);
+}
+
+MatchStats runMatches(ThreadPool& pool, const Roster& roster,
+                      std::shared_ptr<const BalanceParams> params,
+                      int matches, uint64_t seed, int first) {
+    // 每个槽位一份累加器，块之间不加锁，全部完成后再合并
+    std::vector<MatchStats> partial(pool.size());
+    // 每个槽位一份发球→接一联合分布表，阵容和参数在本批次内不变
+    std::vector<ServeReceiveTables> tables(pool.size());
+
+    int chunk = std::max(1, matches / (pool.size() * 8));
+    pool.parallelForSlots(matches, chunk, [&](int slot, int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        setServeReceiveTables(&tables[slot]);
+
+        MatchStats& local = partial[slot];
+        for (int i = begin; i < end; i++) {
+            simSeed(matchSeed(seed, first + i));
+            simulateMatch(local);
+        }
+        setServeReceiveTables(nullptr);
+    });
+
+    MatchStats total;
+    for (const auto& p : partial) total.add(p);
+    return total;
+}
+
+namespace {
+    // 打印一张 6x6 轮次表，行为发球方轮次，列为接发球方轮次
+    void printRotationTable(const char* title, const MatchStats& s, int side,
+                            double (*value)(const RotationStats&)) {
+        std::cout << title << "\n      ";
+        for (int j = 0; j < 6; j++) std::cout << std::setw(9) << ("接" + std::to_string(j + 1));  // 汉字占3字节、显示2格
+        std::cout << "\n";
+        for (int i = 0; i < 6; i++) {
+            std::cout << std::setw(7) << ("发" + std::to_string(i + 1));
+            for (int j = 0; j < 6; j++) {
+                const RotationStats& r = s.rotations[side][i][j];
+                if (r.points) std::cout << std::setw(8) << value(r);
+                else std::cout << std::setw(8) << "-";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    double cellSideOutRate(const RotationStats& r) {
+        return r.points ? static_cast<double>(r.sideOuts) / r.points : 0.0;
+    }
+
+    double cellFirstBallKillRate(const RotationStats& r) {
+        return r.receptions ? static_cast<double>(r.firstBallKills) / r.receptions : 0.0;
+    }
+}
+
+void printRotationReport(const MatchStats& s) {
+    std::cout << std::fixed << std::setprecision(3);
+    for (int side = 0; side < 2; side++) {
+        const char* serving = side == 0 ? "A" : "B";
+        const char* receiving = side == 0 ? "B" : "A";
+        std::cout << "\n" << serving << "队发球、" << receiving << "队接发球（轮次为二传所在号位）\n";
+        printRotationTable("破攻率：", s, side, cellSideOutRate);
+        printRotationTable("接发球首攻得分率：", s, side, cellFirstBallKillRate);
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::flush;
+}
+
+bool writeRotationCsv(const std::string& path, const MatchStats& s) {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) return false;
+
+    ofs << "serving_team,serving_rotation,receiving_rotation,points,sideouts,break_points,"
+           "sideout_rate,receptions,first_ball_kills,first_ball_kill_rate,mean_rally_length,attacks_per_rally\n";
+    ofs << std::setprecision(6);
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                const RotationStats& r = s.rotations[side][i][j];
+                if (!r.points) continue;
+                ofs << (side == 0 ? "A" : "B") << "," << (i + 1) << "," << (j + 1)
+                    << "," << r.points << "," << r.sideOuts << "," << r.points - r.sideOuts
+                    << "," << cellSideOutRate(r)
+                    << "," << r.receptions << "," << r.firstBallKills << "," << cellFirstBallKillRate(r)
+                    << "," << static_cast<double>(r.touches) / r.points
+                    << "," << static_cast<double>(r.attacks) / r.points << "\n";
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include "game.h"
+#include "balanceConfig.h"
+#include "threadPool.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 两队上场阵容（teamA/teamB 的一份拷贝，可交给其他线程使用）
+struct Roster {
+    Player teamA[7];
+    Player teamB[7];
+};
+
+Roster captureRoster();                 // 取当前线程的阵容
+void applyRoster(const Roster& roster); // 设置当前线程的阵容
+
+// 在线程池上批量模拟 matches 场比赛。
+// 第 i 场使用种子 (seed, i)，因此结果与线程数、调度顺序无关，
+// 不同参数用同一个 seed 即为公共随机数，比较更稳定。
+// first 非零时模拟第 first 到 first+matches-1 场（接着已有的结果继续模拟）。
+MatchStats runMatches(ThreadPool& pool, const Roster& roster,
+                      std::shared_ptr<const BalanceParams> params,
+                      int matches, uint64_t seed, int first = 0);
+
+// 由 MatchStats 计算的指标
+double aceRate(const MatchStats& s);            // 发球直接得分率（每次发球）
+double serveFaultRate(const MatchStats& s);     // 发球失误率
+double sideOutRate(const MatchStats& s);        // 接发球方得分率
+double meanRallyLength(const MatchStats& s);    // 平均回合长度（每球触球次数）
+double attacksPerRally(const MatchStats& s);    // 平均每球进攻次数
+double blockPointShare(const MatchStats& s);    // 拦网得分占总得分比例
+double killRate(const MatchStats& s);           // 进攻得分率（扣球得分/进攻次数）
+double blockPointsPerSet(const MatchStats& s);  // 每局拦网得分
+
+// 胜率的 Wilson 置信区间（z=1.96 为 95%）
+void wilsonInterval(long long successes, long long trials, double z, double& low, double& high);
+
+// 按轮次组合的破攻率、首攻得分率表格，以及完整的 CSV（含球数、破发、平均回合长度与进攻次数）
+void printRotationReport(const MatchStats& s);
+bool writeRotationCsv(const std::string& path, const MatchStats& s);
+
+// 第 index 场比赛的种子
+uint64_t matchSeed(uint64_t seed, uint64_t index);
+
+#endif //BATCHSIM_H
@@ -4,9 +4,34 @@
 
 #include "block.h"
 #include "config.h"
+#include "balanceConfig.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+
+// 调试追踪中显示的枚举名称
+namespace {
+    const char* blockTypeName(BlockType value) {
+        switch (value) {
+            case SINGLE_BLOCK: return "单人拦网";
+            case DOUBLE_BLOCK: return "双人拦网";
+            case TRIPLE_BLOCK: return "三人拦网";
+        }
+        return "";
+    }
+}
+
+const char* blockResultName(BlockResult value) {
+    switch (value) {
+        case BLOCK_BREAK: return "破坏";
+        case NO_TOUCH: return "无接触";
+        case LIMIT_PATH: return "限制球路";
+        case BLOCK_TOUCH: return "撑起";
+        case BLOCK_BACK: return "拦回";
+    }
+    return "";
+}
 
 // 构造函数
 Blocker::Blocker(const GameState& gameState, int blockingTeam, int attackingTeam)
@@ -50,23 +75,32 @@ bool Blocker::isBackRowPlayer(const Player& player, int teamID) {
     return false;
 }
 
-// 获取指定位置索引的球员
-Player Blocker::getPlayerAtPosition(int teamID, int positionIndex) {
+// 判断本队下标为 index 的球员是否在前排
+bool Blocker::isFrontRowIndex(int index, int teamID) {
     const int* rotation = getRotation(teamID);
-    const Player* team = getTeamPlayers(teamID);
-    return team[rotation[positionIndex]];
+    for (int i : {3, 2, 1}) {
+        if (rotation[i] == index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 获取指定位置索引的球员下标
+int Blocker::getPlayerAtPosition(int teamID, int positionIndex) {
+    return getRotation(teamID)[positionIndex];
 }
 
 // 获取前排主攻
-Player Blocker::getFrontSpiker(int teamID) {
+int Blocker::getFrontSpiker(int teamID) {
     const int* rotation = getRotation(teamID);
     const Player* team = getTeamPlayers(teamID);
 
     // 前排位置：2号位、3号位、4号位中寻找主攻
     for (int i : {1, 2, 3}) {
-        Player player = team[rotation[i]];
+        const Player& player = team[rotation[i]];
         if (player.position == "OH" || player.position == "主攻") {
-            return player;
+            return rotation[i];
         }
     }
     // 如果没有找到主攻，返回第一个前排球员
@@ -74,15 +108,15 @@ Player Blocker::getFrontSpiker(int teamID) {
 }
 
 // 获取前排副攻
-Player Blocker::getFrontBlocker(int teamID) {
+int Blocker::getFrontBlocker(int teamID) {
     const int* rotation = getRotation(teamID);
     const Player* team = getTeamPlayers(teamID);
 
     // 前排位置：2号位、3号位、4号位中寻找副攻
     for (int i : {1, 2, 3}) {
-        Player player = team[rotation[i]];
+        const Player& player = team[rotation[i]];
         if (player.position == "MB" || player.position == "副攻") {
-            return player;
+            return rotation[i];
         }
     }
     // 如果没有找到副攻，返回第二个前排球员
@@ -90,15 +124,15 @@ Player Blocker::getFrontBlocker(int teamID) {
 }
 
 // 获取接应
-Player Blocker::getOpposite(int teamID) {
+int Blocker::getOpposite(int teamID) {
     const int* rotation = getRotation(teamID);
     const Player* team = getTeamPlayers(teamID);
 
     // 全场寻找接应
     for (int i = 0; i < 6; i++) {
-        Player player = team[rotation[i]];
+        const Player& player = team[rotation[i]];
         if (player.position == "OP" || player.position == "接应") {
-            return player;
+            return rotation[i];
         }
     }
     // 如果没有找到接应，返回第一个球员
@@ -106,24 +140,34 @@ Player Blocker::getOpposite(int teamID) {
 }
 
 // 获取二传
-Player Blocker::getSetter(int teamID) {
+int Blocker::getSetter(int teamID) {
     const int* rotation = getRotation(teamID);
     const Player* team = getTeamPlayers(teamID);
 
     // 全场寻找二传
     for (int i = 0; i < 6; i++) {
-        Player player = team[rotation[i]];
+        const Player& player = team[rotation[i]];
         if (player.position == "S" || player.position == "二传") {
-            return player;
+            return rotation[i];
         }
     }
     // 如果没有找到二传，返回第一个球员
     return getPlayerAtPosition(teamID, 0);
 }
 
+// 边攻（主攻、接应）时的拦网人数分布（百分比）
+namespace {
+    constexpr AliasTable kEdgeHardBlocks = makeAliasTable({{SINGLE_BLOCK, 60}, {DOUBLE_BLOCK, 40}});
+    constexpr AliasTable kEdgeNormalBlocks = makeAliasTable({{DOUBLE_BLOCK, 80}, {SINGLE_BLOCK, 20}});
+}
+
+const AliasTable& Blocker::edgeBlockTable(bool highQualityOrQuick) {
+    return highQualityOrQuick ? kEdgeHardBlocks : kEdgeNormalBlocks;
+}
+
 // 根据进攻类型确定拦网人数
 BlockType Blocker::determineBlockType(const SpikeResult& spikeResult) {
-    Player attacker = spikeResult.attacker;
+    const Player& attacker = spikeResult.attacker;
     bool isFrontRow = isFrontRowPlayer(attacker, attackingTeam);
     bool isBackRow = isBackRowPlayer(attacker, attackingTeam);
 
@@ -140,78 +184,41 @@ BlockType Blocker::determineBlockType(const SpikeResult& spikeResult) {
 
     BlockType blockType;
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦网类型决策调试信息 ===" << std::endl;
-    std::cout << "进攻球员: " << attacker.name << " 位置: " << attacker.position << std::endl;
-    std::cout << "进攻位置: " << (isFrontRow ? "前排" : (isBackRow ? "后排" : "未知")) << std::endl;
-    std::cout << "是否为二次进攻: " << (isSetterDump ? "是" : "否") << std::endl;
-    std::cout << "是否为快球/战术球: " << (isQuickAttack ? "是" : "否") << std::endl;
-    std::cout << "拦网系数: " << blockCoefficient << " (越低越难拦)" << std::endl;
-    std::cout << "是否为高质量/快传球: " << (isHighQualityOrQuick ? "是" : "否") << std::endl;
-    std::cout << "扣球策略: ";
-    switch(spikeResult.strategy) {
-        case STRONG_ATTACK: std::cout << "强攻"; break;
-        case AVOID_BLOCK: std::cout << "避手"; break;
-        case DROP_SHOT: std::cout << "吊球"; break;
-        case QUICK_ATTACK: std::cout << "快球"; break;
-        case ADJUST_SPIKE: std::cout << "调整攻"; break;
-        case TRANSITION_ATTACK: std::cout << "过渡"; break;
-        case SETTER_SPIKE: std::cout << "二次进攻"; break;
-    }
-    std::cout << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦网类型决策调试信息 ===");
+        traceWrite(TRACE_BLOCK, "进攻球员: {} 位置: {}", attacker.name, attacker.position);
+        traceWrite(TRACE_BLOCK, "进攻位置: {}", (isFrontRow ? "前排" : (isBackRow ? "后排" : "未知")));
+        traceWrite(TRACE_BLOCK, "是否为二次进攻: {}", (isSetterDump ? "是" : "否"));
+        traceWrite(TRACE_BLOCK, "是否为快球/战术球: {}", (isQuickAttack ? "是" : "否"));
+        traceWrite(TRACE_BLOCK, "拦网系数: {} (越低越难拦)", blockCoefficient);
+        traceWrite(TRACE_BLOCK, "是否为高质量/快传球: {}", (isHighQualityOrQuick ? "是" : "否"));
+        traceWrite(TRACE_BLOCK, "扣球策略: {}", spikeStrategyName(spikeResult.strategy));
+    }
 
     // 根据进攻球员位置和角色确定拦网类型
     if (isSetterDump) {
         // 二次进攻：单人拦网
         blockType = SINGLE_BLOCK;
-        #if DEBUG_BLOCK
-        std::cout << "判定: 二次进攻 => 单人拦网" << std::endl;
-        #endif
+        TRACE(TRACE_BLOCK, "判定: 二次进攻 => 单人拦网");
     } else if (attacker.position == "MB" || attacker.position == "副攻") {
         // 副攻进攻：通常单人拦网（敌方副攻）
         // 但在高质量/快传球或战术球时，可能拦网不到位（仍为单人但效率降低，通过blockCoefficient体现）
         blockType = SINGLE_BLOCK;
-        #if DEBUG_BLOCK
-        std::cout << "判定: 副攻进攻 => 单人拦网" << std::endl;
-        if (isHighQualityOrQuick) {
-            std::cout << "副攻快攻/高质量球，拦网难度增加" << std::endl;
+        if (traceOn(TRACE_BLOCK)) {
+            traceWrite(TRACE_BLOCK, "判定: 副攻进攻 => 单人拦网");
+            if (isHighQualityOrQuick) {
+                traceWrite(TRACE_BLOCK, "副攻快攻/高质量球，拦网难度增加");
+            }
         }
-        #endif
     } else if (attacker.position == "OH" || attacker.position == "主攻" ||
                attacker.position == "OP" || attacker.position == "接应") {
         // 边攻（主攻和接应）：至少一人拦网
         // 正常球（不是快球且拦网系数较高）大概率两人拦网
         // 但受二传传球水平和敌方拦网水平影响，也可能只有一人拦网
-        if (isHighQualityOrQuick) {
-            // 高质量传球、快球或难拦的球，有更高概率单人拦网
-            // 60%概率单人拦网，40%概率双人拦网
-            if ((rand() % 100) < 60) {
-                blockType = SINGLE_BLOCK;
-                #if DEBUG_BLOCK
-                std::cout << "判定: 边攻高质量/快传球 => 单人拦网" << std::endl;
-                #endif
-            } else {
-                blockType = DOUBLE_BLOCK;
-                #if DEBUG_BLOCK
-                std::cout << "判定: 边攻高质量/快传球 => 双人拦网" << std::endl;
-                #endif
-            }
-        } else {
-            // 正常球，大概率两人拦网
-            // 80%概率双人拦网，20%概率单人拦网
-            if ((rand() % 100) < 80) {
-                blockType = DOUBLE_BLOCK;
-                #if DEBUG_BLOCK
-                std::cout << "判定: 边攻正常球 => 双人拦网" << std::endl;
-                #endif
-            } else {
-                blockType = SINGLE_BLOCK;
-                #if DEBUG_BLOCK
-                std::cout << "判定: 边攻正常球 => 单人拦网" << std::endl;
-                #endif
-            }
-        }
+        // 高质量传球、快球或难拦的球：60%单人拦网，40%双人拦网
+        // 正常球：80%双人拦网，20%单人拦网
+        blockType = static_cast<BlockType>(edgeBlockTable(isHighQualityOrQuick).sample());
+        TRACE(TRACE_BLOCK, "判定: 边攻{} => {}", (isHighQualityOrQuick ? "高质量/快传球" : "正常球"), blockTypeName(blockType));
     } else {
         // 默认：单人拦网或双人拦网，根据球的难度决定
         if (isHighQualityOrQuick) {
@@ -219,29 +226,23 @@ BlockType Blocker::determineBlockType(const SpikeResult& spikeResult) {
         } else {
             blockType = DOUBLE_BLOCK;
         }
-        #if DEBUG_BLOCK
-        std::cout << "判定: 默认 => " << (isHighQualityOrQuick ? "单人拦网" : "双人拦网") << std::endl;
-        #endif
+        TRACE(TRACE_BLOCK, "判定: 默认 => {}", (isHighQualityOrQuick ? "单人拦网" : "双人拦网"));
     }
 
-    #if DEBUG_BLOCK
-    std::cout << "最终拦网类型: ";
-    switch(blockType) {
-        case SINGLE_BLOCK: std::cout << "单人拦网"; break;
-        case DOUBLE_BLOCK: std::cout << "双人拦网"; break;
-        case TRIPLE_BLOCK: std::cout << "三人拦网"; break;
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "最终拦网类型: {}", blockTypeName(blockType));
+        traceWrite(TRACE_BLOCK, "==============================");
     }
-    std::cout << std::endl << "==============================" << std::endl;
-    #endif
 
     return blockType;
 }
 
 // 获取拦网球员
-std::vector<Player> Blocker::getBlockers(BlockType blockType, const SpikeResult& spikeResult) {
-    std::vector<Player> blockers;
+int Blocker::getBlockers(BlockType blockType, const SpikeResult& spikeResult, int blockers[kMaxBlockers]) {
+    const Player* team = getTeamPlayers(blockingTeam);
+    int count = 0;
 
-    Player attacker = spikeResult.attacker;
+    const Player& attacker = spikeResult.attacker;
     bool isFrontRow = isFrontRowPlayer(attacker, attackingTeam);
 
     // 检查是否是二次进攻
@@ -249,17 +250,11 @@ std::vector<Player> Blocker::getBlockers(BlockType blockType, const SpikeResult&
                         spikeResult.attacker.position == "S") ||
                        (spikeResult.attacker.position == "二传");
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦网球员选择调试信息 ===" << std::endl;
-    std::cout << "拦网类型: ";
-    switch(blockType) {
-        case SINGLE_BLOCK: std::cout << "单人拦网"; break;
-        case DOUBLE_BLOCK: std::cout << "双人拦网"; break;
-        case TRIPLE_BLOCK: std::cout << "三人拦网"; break;
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦网球员选择调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网类型: {}", blockTypeName(blockType));
+        traceWrite(TRACE_BLOCK, "是否为二次进攻: {}", (isSetterDump ? "是" : "否"));
     }
-    std::cout << std::endl;
-    std::cout << "是否为二次进攻: " << (isSetterDump ? "是" : "否") << std::endl;
-    #endif
 
     // 根据拦网类型和进攻类型选择拦网球员
     switch (blockType) {
@@ -267,53 +262,41 @@ std::vector<Player> Blocker::getBlockers(BlockType blockType, const SpikeResult&
             // 单人拦网情况下
             if (isSetterDump || (attacker.position == "OP" || attacker.position == "接应")) {
                 // 二传扣球或接应扣球：选择对方前排主攻
-                Player spiker = getFrontSpiker(blockingTeam);
-                blockers.push_back(spiker);
-                #if DEBUG_BLOCK
-                std::cout << "选择拦网球员: " << spiker.name << " (前排主攻)" << std::endl;
-                #endif
+                int spiker = getFrontSpiker(blockingTeam);
+                blockers[count++] = spiker;
+                TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排主攻)", team[spiker].name);
             } else if ((attacker.position == "OH" || attacker.position == "主攻")) {
                 if (isFrontRow) {
                     // 前排主攻扣球：选择敌方二传和接应中在前排的球员（优先接应）
-                    Player opposite = getOpposite(blockingTeam);
-                    if (isFrontRowPlayer(opposite, blockingTeam)) {
+                    int opposite = getOpposite(blockingTeam);
+                    if (isFrontRowIndex(opposite, blockingTeam)) {
                         // 接应由前排，则选择接应
-                        blockers.push_back(opposite);
-                        #if DEBUG_BLOCK
-                        std::cout << "选择拦网球员: " << opposite.name << " (前排接应)" << std::endl;
-                        #endif
+                        blockers[count++] = opposite;
+                        TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排接应)", team[opposite].name);
                     } else {
                         // 接应不在前排，选择二传
-                        Player setter = getSetter(blockingTeam);
-                        if (isFrontRowPlayer(setter, blockingTeam)) {
-                            blockers.push_back(setter);
-                            #if DEBUG_BLOCK
-                            std::cout << "选择拦网球员: " << setter.name << " (前排二传)" << std::endl;
-                            #endif
+                        int setter = getSetter(blockingTeam);
+                        if (isFrontRowIndex(setter, blockingTeam)) {
+                            blockers[count++] = setter;
+                            TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排二传)", team[setter].name);
                         } else {
                             // 如果二传也不在前排，选择前排副攻作为备选
-                            Player blocker = getFrontBlocker(blockingTeam);
-                            blockers.push_back(blocker);
-                            #if DEBUG_BLOCK
-                            std::cout << "选择拦网球员: " << blocker.name << " (前排副攻 - 二传和接应都不在前排)" << std::endl;
-                            #endif
+                            int blocker = getFrontBlocker(blockingTeam);
+                            blockers[count++] = blocker;
+                            TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排副攻 - 二传和接应都不在前排)", team[blocker].name);
                         }
                     }
                 } else {
                     // 后排主攻扣球：选择敌方副攻
-                    Player blocker = getFrontBlocker(blockingTeam);
-                    blockers.push_back(blocker);
-                    #if DEBUG_BLOCK
-                    std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                    #endif
+                    int blocker = getFrontBlocker(blockingTeam);
+                    blockers[count++] = blocker;
+                    TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
                 }
             } else {
                 // 其他情况：选择前排副攻
-                Player blocker = getFrontBlocker(blockingTeam);
-                blockers.push_back(blocker);
-                #if DEBUG_BLOCK
-                std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                #endif
+                int blocker = getFrontBlocker(blockingTeam);
+                blockers[count++] = blocker;
+                TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
             }
             break;
 
@@ -321,71 +304,70 @@ std::vector<Player> Blocker::getBlockers(BlockType blockType, const SpikeResult&
             // 单人拦网的基础上添加副攻
             if (isSetterDump || (attacker.position == "OP" || attacker.position == "接应")) {
                 // 二传扣球或接应扣球：前排主攻和副攻双人拦网
-                Player spiker = getFrontSpiker(blockingTeam);
-                Player blocker = getFrontBlocker(blockingTeam);
-                blockers.push_back(spiker);
-                blockers.push_back(blocker);
-                #if DEBUG_BLOCK
-                std::cout << "选择拦网球员: " << spiker.name << " (前排主攻)" << std::endl;
-                std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                #endif
+                int spiker = getFrontSpiker(blockingTeam);
+                int blocker = getFrontBlocker(blockingTeam);
+                blockers[count++] = spiker;
+                blockers[count++] = blocker;
+                if (traceOn(TRACE_BLOCK)) {
+                    traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排主攻)", team[spiker].name);
+                    traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
+                }
             } else if ((attacker.position == "OH" || attacker.position == "主攻")) {
                 if (isFrontRow) {
                     // 前排主攻扣球：单人拦网选择的球员 + 敌方副攻
                     // 先获取单人拦网的球员
-                    std::vector<Player> singleBlockers = getBlockers(SINGLE_BLOCK, spikeResult);
-                    if (!singleBlockers.empty()) {
-                        blockers.push_back(singleBlockers[0]);
+                    int singleBlockers[kMaxBlockers];
+                    int singleCount = getBlockers(SINGLE_BLOCK, spikeResult, singleBlockers);
+                    if (singleCount > 0) {
+                        blockers[count++] = singleBlockers[0];
                     }
                     // 添加敌方副攻
-                    Player blocker = getFrontBlocker(blockingTeam);
-                    blockers.push_back(blocker);
-                    #if DEBUG_BLOCK
-                    std::cout << "选择拦网球员: " << (singleBlockers.empty() ? "无人" : singleBlockers[0].name) << " (单人拦网选择)" << std::endl;
-                    std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                    #endif
+                    int blocker = getFrontBlocker(blockingTeam);
+                    blockers[count++] = blocker;
+                    if (traceOn(TRACE_BLOCK)) {
+                        traceWrite(TRACE_BLOCK, "选择拦网球员: {} (单人拦网选择)", (singleCount == 0 ? "无人" : team[singleBlockers[0]].name));
+                        traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
+                    }
                 } else {
                     // 后排主攻扣球：敌方副攻和主攻双人拦网
-                    Player blocker = getFrontBlocker(blockingTeam);
-                    Player spiker = getFrontSpiker(blockingTeam);
-                    blockers.push_back(blocker);
-                    blockers.push_back(spiker);
-                    #if DEBUG_BLOCK
-                    std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                    std::cout << "选择拦网球员: " << spiker.name << " (前排主攻)" << std::endl;
-                    #endif
+                    int blocker = getFrontBlocker(blockingTeam);
+                    int spiker = getFrontSpiker(blockingTeam);
+                    blockers[count++] = blocker;
+                    blockers[count++] = spiker;
+                    if (traceOn(TRACE_BLOCK)) {
+                        traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
+                        traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排主攻)", team[spiker].name);
+                    }
                 }
             } else {
                 // 对于其他位置的双人拦网情况，选择前排主攻和副攻
-                Player spiker = getFrontSpiker(blockingTeam);
-                Player blocker = getFrontBlocker(blockingTeam);
-                blockers.push_back(spiker);
-                blockers.push_back(blocker);
-                #if DEBUG_BLOCK
-                std::cout << "选择拦网球员: " << spiker.name << " (前排主攻)" << std::endl;
-                std::cout << "选择拦网球员: " << blocker.name << " (前排副攻)" << std::endl;
-                #endif
+                int spiker = getFrontSpiker(blockingTeam);
+                int blocker = getFrontBlocker(blockingTeam);
+                blockers[count++] = spiker;
+                blockers[count++] = blocker;
+                if (traceOn(TRACE_BLOCK)) {
+                    traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排主攻)", team[spiker].name);
+                    traceWrite(TRACE_BLOCK, "选择拦网球员: {} (前排副攻)", team[blocker].name);
+                }
             }
             break;
 
         case TRIPLE_BLOCK:  // 三人拦网
             // 三人拦网：前排所有球员
             for (int i = 1; i <= 3; i++) {
-                Player player = getPlayerAtPosition(blockingTeam, i);
-                blockers.push_back(player);
-                #if DEBUG_BLOCK
-                std::cout << "选择拦网球员: " << player.name << " (前排位置" << i << ")" << std::endl;
-                #endif
+                int player = getPlayerAtPosition(blockingTeam, i);
+                blockers[count++] = player;
+                TRACE(TRACE_BLOCK, "选择拦网球员: {} (前排位置{})", team[player].name, i);
             }
             break;
     }
 
-    #if DEBUG_BLOCK
-    std::cout << "总共拦网球员数: " << blockers.size() << std::endl;
-    std::cout << "===============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "总共拦网球员数: {}", count);
+        traceWrite(TRACE_BLOCK, "===============================");
+    }
 
-    return blockers;
+    return count;
 }
 
 // 计算单个拦网球员的拦网强度
@@ -448,88 +430,86 @@ double Blocker::calculateSingleBlockPower(const Player& blocker, const SpikeResu
 
     double finalPower = std::max(0.0, std::min(100.0, blockPower));
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 单个拦网球员强度调试信息 ===" << std::endl;
-    std::cout << "拦网球员: " << blocker.name << " 拦网属性: " << blocker.block << std::endl;
-    std::cout << "1. 基础拦网能力: " << baseBlockAbility << std::endl;
-    std::cout << "2. 团队协作: " << teamworkEffect << " (权重40%)" << std::endl;
-    std::cout << "3. 心理素质: " << pressureEffect << " (权重10%)" << std::endl;
-    std::cout << "4. 专注度: " << concentrationEffect << " (权重5%)" << std::endl;
-    std::cout << "5. 自信心: " << confidenceEffect << " (权重5%)" << std::endl;
-    std::cout << "6. 耐力影响: " << staminaEffect << " * 疲劳系数 " << setFatigue << " = " << staminaEffect * setFatigue << std::endl;
-    std::cout << "综合调整系数: (" << baseBlockAbility/100.0 << "*0.4 + " << teamworkEffect << "*0.4 + " << pressureEffect << "*0.1 + " << concentrationEffect << "*0.05 + " << confidenceEffect << "*0.05) * " << staminaEffect * setFatigue << " = " << adjustment << std::endl;
-    std::cout << "策略适应性(" << strategyEffectStr << "): " << strategyAdaptation << std::endl;
-    std::cout << "计算后拦网强度: " << baseBlockAbility << " * " << adjustment << " * " << strategyAdaptation << " = " << blockPower << std::endl;
-    std::cout << "最终拦网强度(限定范围): " << finalPower << std::endl;
-    std::cout << "=================================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 单个拦网球员强度调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网球员: {} 拦网属性: {}", blocker.name, blocker.block);
+        traceWrite(TRACE_BLOCK, "1. 基础拦网能力: {}", baseBlockAbility);
+        traceWrite(TRACE_BLOCK, "2. 团队协作: {} (权重40%)", teamworkEffect);
+        traceWrite(TRACE_BLOCK, "3. 心理素质: {} (权重10%)", pressureEffect);
+        traceWrite(TRACE_BLOCK, "4. 专注度: {} (权重5%)", concentrationEffect);
+        traceWrite(TRACE_BLOCK, "5. 自信心: {} (权重5%)", confidenceEffect);
+        traceWrite(TRACE_BLOCK, "6. 耐力影响: {} * 疲劳系数 {} = {}", staminaEffect, setFatigue, staminaEffect * setFatigue);
+        traceWrite(TRACE_BLOCK, "综合调整系数: ({}*0.4 + {}*0.4 + {}*0.1 + {}*0.05 + {}*0.05) * {} = {}", baseBlockAbility/100.0, teamworkEffect, pressureEffect, concentrationEffect, confidenceEffect, staminaEffect * setFatigue, adjustment);
+        traceWrite(TRACE_BLOCK, "策略适应性({}): {}", strategyEffectStr, strategyAdaptation);
+        traceWrite(TRACE_BLOCK, "计算后拦网强度: {} * {} * {} = {}", baseBlockAbility, adjustment, strategyAdaptation, blockPower);
+        traceWrite(TRACE_BLOCK, "最终拦网强度(限定范围): {}", finalPower);
+        traceWrite(TRACE_BLOCK, "=================================");
+    }
 
     return finalPower;
 }
 
 // 计算组合拦网强度
-int Blocker::calculateCombinedBlockPower(const std::vector<Player>& blockers, const SpikeResult& spikeResult) {
-    if (blockers.empty()) {
-        #if DEBUG_BLOCK
-        std::cout << "无拦网球员，组合拦网强度为0" << std::endl;
-        #endif
+int Blocker::calculateCombinedBlockPower(const int* blockers, int count, const SpikeResult& spikeResult) {
+    const Player* team = getTeamPlayers(blockingTeam);
+    if (count == 0) {
+        TRACE(TRACE_BLOCK, "无拦网球员，组合拦网强度为0");
         return 0;
     }
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 组合拦网强度计算调试信息 ===" << std::endl;
-    std::cout << "拦网球员数量: " << blockers.size() << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 组合拦网强度计算调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网球员数量: {}", count);
+    }
 
     // 计算平均拦网强度
     double totalPower = 0.0;
-    for (const auto& blocker : blockers) {
+    for (int i = 0; i < count; i++) {
+        const Player& blocker = team[blockers[i]];
         double singlePower = calculateSingleBlockPower(blocker, spikeResult);
         totalPower += singlePower;
-        #if DEBUG_BLOCK
-        std::cout << "球员 " << blocker.name << " 单拦强度: " << singlePower << std::endl;
-        #endif
+        TRACE(TRACE_BLOCK, "球员 {} 单拦强度: {}", blocker.name, singlePower);
     }
-    double averagePower = totalPower / blockers.size();
+    double averagePower = totalPower / count;
 
     // 团队协作加成：拦网人数越多，团队协作影响越大
     double teamworkBonus = 0.0;
-    for (const auto& blocker : blockers) {
-        teamworkBonus += blocker.mental.commu_and_teamwork / 100.0;
+    for (int i = 0; i < count; i++) {
+        teamworkBonus += team[blockers[i]].mental.commu_and_teamwork / 100.0;
     }
-    double teamworkFactor = 1.0 + (teamworkBonus / blockers.size()) * 0.3;
+    double teamworkFactor = 1.0 + (teamworkBonus / count) * 0.3;
 
     // 人数加成：多人拦网有协同效应
     double numberBonus = 0.7;
-    switch (blockers.size()) {
+    switch (count) {
         case 2:  // 双人拦网
-            numberBonus = DOUBLE_BLOCK_RATE;
+            numberBonus = balance().doubleBlockRate;
             break;
         case 3:  // 三人拦网
-            numberBonus = TRIPLE_BLOCK_RATE;
+            numberBonus = balance().tripleBlockRate;
             break;
         default: // 单人拦网
-            numberBonus = SINGLE_BLOCK_RATE;
+            numberBonus = balance().singleBlockRate;
     }
 
     // 计算组合拦网强度
     double combinedPower = averagePower * teamworkFactor * numberBonus;
 
     // 添加随机因素
-    double randomFactor = (rand() % 20 - 10);
+    double randomFactor = (simRandBelow(20) - 10);
     combinedPower += randomFactor;
 
     int finalPower = static_cast<int>(std::max(0.0, std::min(100.0, combinedPower)));
 
-    #if DEBUG_BLOCK
-    std::cout << "平均拦网强度: " << totalPower << " / " << blockers.size() << " = " << averagePower << std::endl;
-    std::cout << "团队协作加成: 平均团队协作 " << teamworkBonus/blockers.size() << " => 系数 1 + " << teamworkBonus/blockers.size() << "*0.3 = " << teamworkFactor << std::endl;
-    std::cout << "人数加成: " << blockers.size() << "人拦网 => 系数 " << numberBonus << std::endl;
-    std::cout << "组合拦网强度: " << averagePower << " * " << teamworkFactor << " * " << numberBonus << " = " << combinedPower - randomFactor << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终组合拦网强度: " << combinedPower << " (取整： " << finalPower << ")" << std::endl;
-    std::cout << "====================================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "平均拦网强度: {} / {} = {}", totalPower, count, averagePower);
+        traceWrite(TRACE_BLOCK, "团队协作加成: 平均团队协作 {} => 系数 1 + {}*0.3 = {}", teamworkBonus/count, teamworkBonus/count, teamworkFactor);
+        traceWrite(TRACE_BLOCK, "人数加成: {}人拦网 => 系数 {}", count, numberBonus);
+        traceWrite(TRACE_BLOCK, "组合拦网强度: {} * {} * {} = {}", averagePower, teamworkFactor, numberBonus, combinedPower - randomFactor);
+        traceWrite(TRACE_BLOCK, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_BLOCK, "最终组合拦网强度: {} (取整： {})", combinedPower, finalPower);
+        traceWrite(TRACE_BLOCK, "====================================");
+    }
 
     return finalPower;
 }
@@ -537,9 +517,7 @@ int Blocker::calculateCombinedBlockPower(const std::vector<Player>& blockers, co
 // 计算拦网效果
 double Blocker::calculateBlockEffect(int blockPower, int spikePower, double blockCoefficient) {
     if (spikePower == 0) {
-        #if DEBUG_BLOCK
-        std::cout << "扣球强度为0，拦网效果为0" << std::endl;
-        #endif
+        TRACE(TRACE_BLOCK, "扣球强度为0，拦网效果为0");
         return 0.0; // 扣球失误，拦网效果为0
     }
 
@@ -551,24 +529,24 @@ double Blocker::calculateBlockEffect(int blockPower, int spikePower, double bloc
     baseEffect *= coefficientEffect;
 
     // 添加随机因素
-    double randomFactor = ((rand() % 20) - 10) / 100.0;
+    double randomFactor = (simRandBelow(20) - 10) / 100.0;
     baseEffect += randomFactor;
 
     // 限制效果值范围：0.0-1.0
     double finalEffect = std::max(0.0, std::min(1.0, baseEffect));
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦网效果计算调试信息 ===" << std::endl;
-    std::cout << "拦网强度: " << blockPower << std::endl;
-    std::cout << "扣球强度: " << spikePower << std::endl;
-    std::cout << "拦网系数: " << blockCoefficient << std::endl;
-    std::cout << "基础拦网效果: " << blockPower << " / " << spikePower << " = " << static_cast<double>(blockPower)/spikePower << std::endl;
-    std::cout << "拦网系数影响: 2.0 - " << blockCoefficient << " = " << coefficientEffect << std::endl;
-    std::cout << "计算后效果: " << static_cast<double>(blockPower)/spikePower << " * " << coefficientEffect << " = " << baseEffect - randomFactor << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终拦网效果: " << finalEffect << " (范围: 0.0-1.0)" << std::endl;
-    std::cout << "=============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦网效果计算调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网强度: {}", blockPower);
+        traceWrite(TRACE_BLOCK, "扣球强度: {}", spikePower);
+        traceWrite(TRACE_BLOCK, "拦网系数: {}", blockCoefficient);
+        traceWrite(TRACE_BLOCK, "基础拦网效果: {} / {} = {}", blockPower, spikePower, static_cast<double>(blockPower)/spikePower);
+        traceWrite(TRACE_BLOCK, "拦网系数影响: 2.0 - {} = {}", blockCoefficient, coefficientEffect);
+        traceWrite(TRACE_BLOCK, "计算后效果: {} * {} = {}", static_cast<double>(blockPower)/spikePower, coefficientEffect, baseEffect - randomFactor);
+        traceWrite(TRACE_BLOCK, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_BLOCK, "最终拦网效果: {} (范围: 0.0-1.0)", finalEffect);
+        traceWrite(TRACE_BLOCK, "=============================");
+    }
 
     return finalEffect;
 }
@@ -576,59 +554,42 @@ double Blocker::calculateBlockEffect(int blockPower, int spikePower, double bloc
 // 确定拦网结果
 BlockResult Blocker::determineBlockResult(double blockEffect) {
     // 根据拦网效果决定结果
-    double randomValue = (rand() % 100) / 100.0;
+    double randomValue = simRandBelow(100) / 100.0;
     BlockResult result;
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦网结果判定调试信息 ===" << std::endl;
-    std::cout << "拦网效果: " << blockEffect << std::endl;
-    std::cout << "随机值: " << randomValue << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦网结果判定调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网效果: {}", blockEffect);
+        traceWrite(TRACE_BLOCK, "随机值: {}", randomValue);
+    }
 
     // 调整判定阈值，使结果分布更合理
-    if (blockEffect < BLOCK_BREAK_THRESHOLD) {
+    if (blockEffect < balance().blockBreakThreshold) {
         // 效果很差，破坏
         result = BLOCK_BREAK;
-        #if DEBUG_BLOCK
-                std::cout << "拦网效果 < " << BLOCK_BREAK_THRESHOLD << " => 破坏" << std::endl;
-        #endif
-    } else if (blockEffect < BLOCK_NO_TOUCH_THRESHOLD) {
+                TRACE(TRACE_BLOCK, "拦网效果 < {} => 破坏", balance().blockBreakThreshold);
+    } else if (blockEffect < balance().blockNoTouchThreshold) {
         // 效果差，无接触
         result = NO_TOUCH;
-        #if DEBUG_BLOCK
-                std::cout << BLOCK_BREAK_THRESHOLD << " ≤ 拦网效果 < " << BLOCK_NO_TOUCH_THRESHOLD << " => 无接触" << std::endl;
-        #endif
-    } else if (blockEffect < BLOCK_LIMIT_PATH_THRESHOLD) {
+                TRACE(TRACE_BLOCK, "{} ≤ 拦网效果 < {} => 无接触", balance().blockBreakThreshold, balance().blockNoTouchThreshold);
+    } else if (blockEffect < balance().blockLimitPathThreshold) {
         // 效果一般，限制球路
         result = LIMIT_PATH;
-        #if DEBUG_BLOCK
-                std::cout << BLOCK_NO_TOUCH_THRESHOLD << " ≤ 拦网效果 < " << BLOCK_LIMIT_PATH_THRESHOLD << " => 限制球路" << std::endl;
-        #endif
-    } else if (blockEffect < BLOCK_TOUCH_THRESHOLD) {
+                TRACE(TRACE_BLOCK, "{} ≤ 拦网效果 < {} => 限制球路", balance().blockNoTouchThreshold, balance().blockLimitPathThreshold);
+    } else if (blockEffect < balance().blockTouchThreshold) {
         // 效果中等，撑起
         result = BLOCK_TOUCH;
-        #if DEBUG_BLOCK
-                std::cout << BLOCK_LIMIT_PATH_THRESHOLD << " ≤ 拦网效果 < " << BLOCK_TOUCH_THRESHOLD << " => 撑起" << std::endl;
-        #endif
+                TRACE(TRACE_BLOCK, "{} ≤ 拦网效果 < {} => 撑起", balance().blockLimitPathThreshold, balance().blockTouchThreshold);
     } else {
         // 效果好，拦回
         result = BLOCK_BACK;
-        #if DEBUG_BLOCK
-                std::cout << "拦网效果 ≥ " << BLOCK_TOUCH_THRESHOLD << " => 拦回" << std::endl;
-        #endif
-    }
-
-    #if DEBUG_BLOCK
-        std::cout << "拦网结果: ";
-        switch(result) {
-        case BLOCK_BREAK: std::cout << "破坏"; break;
-        case NO_TOUCH: std::cout << "无接触"; break;
-        case LIMIT_PATH: std::cout << "限制球路"; break;
-        case BLOCK_TOUCH: std::cout << "撑起"; break;
-        case BLOCK_BACK: std::cout << "拦回"; break;
+                TRACE(TRACE_BLOCK, "拦网效果 ≥ {} => 拦回", balance().blockTouchThreshold);
+    }
+
+        if (traceOn(TRACE_BLOCK)) {
+            traceWrite(TRACE_BLOCK, "拦网结果: {}", blockResultName(result));
+            traceWrite(TRACE_BLOCK, "==============================");
         }
-        std::cout << std::endl << "==============================" << std::endl;
-    #endif
 
     return result;
 }
@@ -636,27 +597,27 @@ BlockResult Blocker::determineBlockResult(double blockEffect) {
 // 计算拦网破坏时增加的扣球强度
 int Blocker::calculateIncreasedSpikePower(int spikePower, double blockEffect) {
     // 增加比例 = (1 - 拦网效果) * 0.3（最多增加30%）
-    double increaseRatio = (1.0 - blockEffect) * SPIKE_INCREASE_RATIO;
+    double increaseRatio = (1.0 - blockEffect) * balance().spikeIncreaseRatio;
 
     // 计算增加后的扣球强度
     double increasedPower = spikePower * (1.0 + increaseRatio);
 
     // 添加随机因素
-    double randomFactor = (rand() % 10 - 5);
+    double randomFactor = (simRandBelow(10) - 5);
     increasedPower += randomFactor;
 
     int finalPower = static_cast<int>(std::max(0.0, increasedPower));
 
-#if DEBUG_BLOCK
-    std::cout << "\n=== 增加扣球强度计算调试信息 ===" << std::endl;
-    std::cout << "原始扣球强度: " << spikePower << std::endl;
-    std::cout << "拦网效果: " << blockEffect << std::endl;
-    std::cout << "增加比例: (1 - " << blockEffect << ") * 0.3 = " << increaseRatio << std::endl;
-    std::cout << "增加后强度: " << spikePower << " * (1 + " << increaseRatio << ") = " << spikePower * (1.0 + increaseRatio) << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终增加后强度: " << increasedPower << " (四舍五入: " << finalPower << ")" << std::endl;
-    std::cout << "==================================" << std::endl;
-#endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 增加扣球强度计算调试信息 ===");
+        traceWrite(TRACE_BLOCK, "原始扣球强度: {}", spikePower);
+        traceWrite(TRACE_BLOCK, "拦网效果: {}", blockEffect);
+        traceWrite(TRACE_BLOCK, "增加比例: (1 - {}) * 0.3 = {}", blockEffect, increaseRatio);
+        traceWrite(TRACE_BLOCK, "增加后强度: {} * (1 + {}) = {}", spikePower, increaseRatio, spikePower * (1.0 + increaseRatio));
+        traceWrite(TRACE_BLOCK, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_BLOCK, "最终增加后强度: {} (四舍五入: {})", increasedPower, finalPower);
+        traceWrite(TRACE_BLOCK, "==================================");
+    }
 
     return finalPower;
 }
@@ -664,27 +625,27 @@ int Blocker::calculateIncreasedSpikePower(int spikePower, double blockEffect) {
 // 计算撑起时削减的扣球强度
 int Blocker::calculateReducedSpikePower(int spikePower, double blockEffect) {
     // 削减比例 = 拦网效果 * 0.7（最多削减70%）
-    double reductionRatio = blockEffect * SPIKE_REDUCTION_RATIO;
+    double reductionRatio = blockEffect * balance().spikeReductionRatio;
 
     // 计算削减后的扣球强度
     double reducedPower = spikePower * (1.0 - reductionRatio);
 
     // 添加随机因素
-    double randomFactor = (rand() % 10 - 5);
+    double randomFactor = (simRandBelow(10) - 5);
     reducedPower += randomFactor;
 
     int finalPower = static_cast<int>(std::max(0.0,  reducedPower));
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 削减扣球强度计算调试信息 ===" << std::endl;
-    std::cout << "原始扣球强度: " << spikePower << std::endl;
-    std::cout << "拦网效果: " << blockEffect << std::endl;
-    std::cout << "削减比例: " << blockEffect << " * 0.7 = " << reductionRatio << std::endl;
-    std::cout << "削减后强度: " << spikePower << " * (1 - " << reductionRatio << ") = " << spikePower * (1.0 - reductionRatio) << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终削减后强度: " << reducedPower << " (四舍五入: " << finalPower << ")" << std::endl;
-    std::cout << "==================================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 削减扣球强度计算调试信息 ===");
+        traceWrite(TRACE_BLOCK, "原始扣球强度: {}", spikePower);
+        traceWrite(TRACE_BLOCK, "拦网效果: {}", blockEffect);
+        traceWrite(TRACE_BLOCK, "削减比例: {} * 0.7 = {}", blockEffect, reductionRatio);
+        traceWrite(TRACE_BLOCK, "削减后强度: {} * (1 - {}) = {}", spikePower, reductionRatio, spikePower * (1.0 - reductionRatio));
+        traceWrite(TRACE_BLOCK, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_BLOCK, "最终削减后强度: {} (四舍五入: {})", reducedPower, finalPower);
+        traceWrite(TRACE_BLOCK, "==================================");
+    }
 
     return finalPower;
 }
@@ -696,20 +657,20 @@ int Blocker::calculateBlockBackPower(int blockPower, int spikePower) {
     double blockBackPower = (blockPower * 0.6 + spikePower * 0.4) * 0.8;
 
     // 添加随机因素
-    double randomFactor = (rand() % 20 - 10);
+    double randomFactor = (simRandBelow(20) - 10);
     blockBackPower += randomFactor;
 
     int finalPower = static_cast<int>(std::max(0.0, std::min(100.0, blockBackPower)));
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦回强度计算调试信息 ===" << std::endl;
-    std::cout << "拦网强度: " << blockPower << std::endl;
-    std::cout << "扣球强度: " << spikePower << std::endl;
-    std::cout << "计算: (" << blockPower << "*0.6 + " << spikePower << "*0.4) * 0.8 = " << (blockPower * 0.6 + spikePower * 0.4) * 0.8 << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终拦回强度: " << blockBackPower << " (四舍五入: " << finalPower << ")" << std::endl;
-    std::cout << "==============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦回强度计算调试信息 ===");
+        traceWrite(TRACE_BLOCK, "拦网强度: {}", blockPower);
+        traceWrite(TRACE_BLOCK, "扣球强度: {}", spikePower);
+        traceWrite(TRACE_BLOCK, "计算: ({}*0.6 + {}*0.4) * 0.8 = {}", blockPower, spikePower, (blockPower * 0.6 + spikePower * 0.4) * 0.8);
+        traceWrite(TRACE_BLOCK, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_BLOCK, "最终拦回强度: {} (四舍五入: {})", blockBackPower, finalPower);
+        traceWrite(TRACE_BLOCK, "==============================");
+    }
 
     return finalPower;
 }
@@ -729,23 +690,21 @@ BlockResultInfo Blocker::simulateBlock(const SpikeResult& spikeResult) {
     BlockType blockType = determineBlockType(spikeResult);
 
     // 获取拦网球员
-    result.blockers = getBlockers(blockType, spikeResult);
+    result.blockerCount = getBlockers(blockType, spikeResult, result.blockers);
 
     // 确保边攻扣球时至少有一名拦网球员
     bool isWingAttacker = (spikeResult.attacker.position == "OH" || spikeResult.attacker.position == "主攻" ||
                           spikeResult.attacker.position == "OP" || spikeResult.attacker.position == "接应");
 
-    if (isWingAttacker && result.blockers.empty()) {
+    if (isWingAttacker && result.blockerCount == 0) {
         // 边攻扣球但没有拦网球员时，至少选择一名前排球员
-        Player frontSpiker = getFrontSpiker(blockingTeam);
-        result.blockers.push_back(frontSpiker);
-        #if DEBUG_BLOCK
-        std::cout << "边攻扣球，强制添加拦网球员: " << frontSpiker.name << std::endl;
-        #endif
+        int frontSpiker = getFrontSpiker(blockingTeam);
+        result.blockers[result.blockerCount++] = frontSpiker;
+        TRACE(TRACE_BLOCK, "边攻扣球，强制添加拦网球员: {}", getTeamPlayers(blockingTeam)[frontSpiker].name);
     }
 
     // 计算组合拦网强度
-    result.blockPower = calculateCombinedBlockPower(result.blockers, spikeResult);
+    result.blockPower = calculateCombinedBlockPower(result.blockers, result.blockerCount, spikeResult);
 
     // 计算拦网效果
     double blockEffect = calculateBlockEffect(result.blockPower, spikeResult.spikePower, spikeResult.blockCoefficient);
@@ -787,13 +746,13 @@ BlockResultInfo Blocker::simulateBlock(const SpikeResult& spikeResult) {
 
     // 添加拦网人数信息
     std::string blockerNames = "";
-    for (size_t i = 0; i < result.blockers.size(); i++) {
+    for (int i = 0; i < result.blockerCount; i++) {
         if (i > 0) blockerNames += "、";
-        blockerNames += result.blockers[i].name;
+        blockerNames += getTeamPlayers(blockingTeam)[result.blockers[i]].name;
     }
     // 无论是否有拦网接触，都显示拦网球员信息
     if (!blockerNames.empty()) {
-        std::string blockTypeStr = std::to_string(result.blockers.size()) + "人拦网";
+        std::string blockTypeStr = std::to_string(result.blockerCount) + "人拦网";
         result.description += "（" + blockTypeStr + "：" + blockerNames + "）";
     } else if (isWingAttacker) {
         // 对于边攻，即使没有拦网球员也提示
@@ -801,28 +760,20 @@ BlockResultInfo Blocker::simulateBlock(const SpikeResult& spikeResult) {
     }
 
 
-    #if DEBUG_BLOCK
-    std::cout << "\n=== 拦网模拟最终结果 ===" << std::endl;
-    std::cout << "拦网描述: " << result.description << std::endl;
-    std::cout << "拦网结果: ";
-    switch(result.result) {
-    case BLOCK_BREAK: std::cout << "破坏"; break;
-    case NO_TOUCH: std::cout << "无接触"; break;
-    case LIMIT_PATH: std::cout << "限制球路"; break;
-    case BLOCK_TOUCH: std::cout << "撑起"; break;
-    case BLOCK_BACK: std::cout << "拦回"; break;
-    }
-    std::cout << std::endl;
-    std::cout << "拦网强度: " << result.blockPower << std::endl;
-    if (result.result == BLOCK_BREAK) {
-        std::cout << "拦网破坏后扣球强度: " << result.increasedSpikePower << std::endl;
-    } else if (result.result == LIMIT_PATH || result.result == BLOCK_TOUCH) {
-        std::cout << "削减后扣球强度: " << result.reducedSpikePower << std::endl;
-    } else if (result.result == BLOCK_BACK) {
-        std::cout << "拦回强度: " << result.blockBackPower << std::endl;
-    }
-    std::cout << "============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_BLOCK)) {
+        traceWrite(TRACE_BLOCK, "=== 拦网模拟最终结果 ===");
+        traceWrite(TRACE_BLOCK, "拦网描述: {}", result.description);
+        traceWrite(TRACE_BLOCK, "拦网结果: {}", blockResultName(result.result));
+        traceWrite(TRACE_BLOCK, "拦网强度: {}", result.blockPower);
+        if (result.result == BLOCK_BREAK) {
+            traceWrite(TRACE_BLOCK, "拦网破坏后扣球强度: {}", result.increasedSpikePower);
+        } else if (result.result == LIMIT_PATH || result.result == BLOCK_TOUCH) {
+            traceWrite(TRACE_BLOCK, "削减后扣球强度: {}", result.reducedSpikePower);
+        } else if (result.result == BLOCK_BACK) {
+            traceWrite(TRACE_BLOCK, "拦回强度: {}", result.blockBackPower);
+        }
+        traceWrite(TRACE_BLOCK, "============================");
+    }
 
     return result;
 }
@@ -8,6 +8,7 @@
 #include "player.h"
 #include "game.h"
 #include "spike.h"
+#include "aliasTable.h"
 
 // 拦网结果枚举
 enum BlockResult {
@@ -18,6 +19,11 @@ enum BlockResult {
     BLOCK_BACK       // 拦回
 };
 
+const char* blockResultName(BlockResult value);  // 调试追踪中显示的名称
+
+// 最多三人拦网
+const int kMaxBlockers = 3;
+
 // 拦网结果结构体
 struct BlockResultInfo {
     BlockResult result;            // 拦网结果
@@ -26,7 +32,8 @@ struct BlockResultInfo {
     int increasedSpikePower;       // 增加后的扣球强度（如果是破坏）
     int reducedSpikePower;         // 削减后的扣球强度（如果是撑起）
     int blockBackPower;            // 拦回强度（如果是拦回）
-    std::vector<Player> blockers;  // 拦网球员列表
+    int blockers[kMaxBlockers] = {-1, -1, -1};  // 拦网球员在本队的下标
+    int blockerCount = 0;          // 拦网人数
     std::string description;       // 描述
 };
 
@@ -46,14 +53,17 @@ public:
     // 根据进攻类型确定拦网人数
     BlockType determineBlockType(const SpikeResult& spikeResult);
 
-    // 获取拦网球员
-    std::vector<Player> getBlockers(BlockType blockType, const SpikeResult& spikeResult);
+    // 边攻时的拦网人数分布表（按是否为高质量/快传球）
+    static const AliasTable& edgeBlockTable(bool highQualityOrQuick);
+
+    // 获取拦网球员，下标写入 blockers，返回人数
+    int getBlockers(BlockType blockType, const SpikeResult& spikeResult, int blockers[kMaxBlockers]);
 
     // 计算单个拦网球员的拦网强度
     double calculateSingleBlockPower(const Player& blocker, const SpikeResult& spikeResult);
 
     // 计算组合拦网强度
-    int calculateCombinedBlockPower(const std::vector<Player>& blockers, const SpikeResult& spikeResult);
+    int calculateCombinedBlockPower(const int* blockers, int count, const SpikeResult& spikeResult);
 
     // 计算拦网效果
     double calculateBlockEffect(int blockPower, int spikePower, double blockCoefficient);
@@ -83,13 +93,14 @@ private:
     const int* getRotation(int teamID);
     bool isFrontRowPlayer(const Player& player, int teamID);
     bool isBackRowPlayer(const Player& player, int teamID);
-    Player getPlayerAtPosition(int teamID, int positionIndex);
-
-    // 获取特定位置的球员
-    Player getFrontSpiker(int teamID);   // 前排主攻
-    Player getFrontBlocker(int teamID);  // 前排副攻
-    Player getOpposite(int teamID);      // 接应
-    Player getSetter(int teamID);        // 二传
+    bool isFrontRowIndex(int index, int teamID);
+    int getPlayerAtPosition(int teamID, int positionIndex);
+
+    // 获取特定位置的球员（返回在本队的下标）
+    int getFrontSpiker(int teamID);   // 前排主攻
+    int getFrontBlocker(int teamID);  // 前排副攻
+    int getOpposite(int teamID);      // 接应
+    int getSetter(int teamID);        // 二传
 };
 
 #endif // BLOCK_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "boxScore.h"
+#include "serve.h"
+#include "receiveServe.h"
+#include "setBall.h"
+#include "spike.h"
+#include "block.h"
+#include "defense.h"
+#include <iomanip>
+#include <iostream>
+
+// 数组长度须与各环节的枚举一致
+static_assert(AGGRESSIVE_SERVE + 1 == kServeTypes, "ServeType");
+static_assert(RECEIVE_FAULT + 1 == kReceiveQualities, "ReceiveQuality");
+static_assert(ADJUST_ATTACK + 1 == kPassTargets, "PassTarget");
+static_assert(SETTER_SPIKE + 1 == kSpikeStrategies, "SpikeStrategy");
+static_assert(BLOCK_BACK + 1 == kBlockResults, "BlockResult");
+static_assert(DEFENSE_FAULT + 1 == kDefenseQualities, "DefenseQuality");
+
+namespace {
+    template <int N>
+    void addArray(long long (&to)[N], const long long (&from)[N]) {
+        for (int i = 0; i < N; i++) to[i] += from[i];
+    }
+
+    template <int N>
+    long long sum(const long long (&a)[N]) {
+        long long total = 0;
+        for (int i = 0; i < N; i++) total += a[i];
+        return total;
+    }
+
+    const char* kServeNames[kServeTypes] = {"", "稳定", "冲发"};
+    const char* kPassNames[kPassTargets] = {"前排主攻", "前排副攻", "后排主攻", "接应", "二次进攻", "调整攻"};
+    const char* kSpikeNames[kSpikeStrategies] = {"强攻", "避手", "吊球", "快球", "调整攻", "过渡", "二次进攻"};
+    const char* kBlockNames[kBlockResults] = {"破坏", "无接触", "限制球路", "撑起", "拦回"};
+}
+
+void PlayerBox::add(const PlayerBox& other) {
+    addArray(serveAttempts, other.serveAttempts);
+    addArray(serveAces, other.serveAces);
+    addArray(serveErrors, other.serveErrors);
+    addArray(receptions, other.receptions);
+    addArray(sets, other.sets);
+    addArray(spikeAttempts, other.spikeAttempts);
+    addArray(spikeKills, other.spikeKills);
+    addArray(spikeErrors, other.spikeErrors);
+    addArray(spikeBlocked, other.spikeBlocked);
+    addArray(blocks, other.blocks);
+    blockPoints += other.blockPoints;
+    addArray(digs, other.digs);
+}
+
+void BoxScore::add(const BoxScore& other) {
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < 7; i++) players[side][i].add(other.players[side][i]);
+    }
+}
+
+void printBoxScore(const BoxScore& box, const Player teamA[7], const Player teamB[7], long long matches) {
+    if (matches <= 0) return;
+    double n = static_cast<double>(matches);
+    auto avg = [n](long long v) { return v / n; };
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (int side = 0; side < 2; side++) {
+        const Player* team = (side == 0) ? teamA : teamB;
+        std::cout << "\n" << (side == 0 ? "A" : "B") << "队技术统计（每场平均）\n"
+                  << "  球员/位置    发球/ACE/失误    接发/到位/接飞   传球   扣球/得分/失误/被拦   拦网得分/触球   防起/失误\n";
+
+        PlayerBox total;
+        for (int i = 0; i < 7; i++) {
+            const PlayerBox& p = box.players[side][i];
+            total.add(p);
+            long long touches = sum(p.blocks) - p.blocks[NO_TOUCH];
+            long long digs = sum(p.digs) - p.digs[DEFENSE_FAULT];
+
+            std::cout << "  " << std::left << std::setw(6) << team[i].name << std::setw(4) << team[i].position << std::right
+                      << std::setw(7) << avg(sum(p.serveAttempts)) << std::setw(5) << avg(sum(p.serveAces))
+                      << std::setw(5) << avg(sum(p.serveErrors))
+                      << std::setw(9) << avg(sum(p.receptions)) << std::setw(5) << avg(p.receptions[RECEIVE_PERFECT])
+                      << std::setw(5) << avg(p.receptions[RECEIVE_FAULT])
+                      << std::setw(8) << avg(sum(p.sets))
+                      << std::setw(8) << avg(sum(p.spikeAttempts)) << std::setw(5) << avg(sum(p.spikeKills))
+                      << std::setw(5) << avg(sum(p.spikeErrors)) << std::setw(5) << avg(sum(p.spikeBlocked))
+                      << std::setw(11) << avg(p.blockPoints) << std::setw(6) << avg(touches)
+                      << std::setw(10) << avg(digs) << std::setw(5) << avg(p.digs[DEFENSE_FAULT]) << "\n";
+        }
+
+        // 全队按枚举分类
+        std::cout << "  发球：";
+        for (int t = STABLE_SERVE; t < kServeTypes; t++) {
+            std::cout << kServeNames[t] << " " << avg(total.serveAttempts[t]) << "次/ACE " << avg(total.serveAces[t])
+                      << "/失误 " << avg(total.serveErrors[t]) << "  ";
+        }
+        std::cout << "\n  二传分配：";
+        for (int t = 0; t < kPassTargets; t++) std::cout << kPassNames[t] << " " << avg(total.sets[t]) << "  ";
+        std::cout << "\n  扣球（次/得分/失误/被拦）：";
+        for (int t = 0; t < kSpikeStrategies; t++) {
+            if (!total.spikeAttempts[t]) continue;
+            std::cout << kSpikeNames[t] << " " << avg(total.spikeAttempts[t]) << "/" << avg(total.spikeKills[t])
+                      << "/" << avg(total.spikeErrors[t]) << "/" << avg(total.spikeBlocked[t]) << "  ";
+        }
+        std::cout << "\n  拦网（人次）：";
+        for (int t = 0; t < kBlockResults; t++) std::cout << kBlockNames[t] << " " << avg(total.blocks[t]) << "  ";
+        std::cout << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::flush;
+}
@@ -0,0 +1,54 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef BOXSCORE_H
+#define BOXSCORE_H
+
+#include "player.h"
+
+// ============ 技术统计 ============
+// 每名球员一组按枚举下标的定长计数数组，数据直接取自各环节类已算出的结果。
+// 数组长度与 serve.h / receiveServe.h / setBall.h / spike.h / block.h / defense.h 中的枚举对应，
+// boxScore.cpp 中有 static_assert 保证一致。
+
+const int kServeTypes = 3;          // ServeType（取值为1、2，下标0不用）
+const int kReceiveQualities = 4;    // ReceiveQuality
+const int kPassTargets = 6;         // PassTarget
+const int kSpikeStrategies = 7;     // SpikeStrategy
+const int kBlockResults = 5;        // BlockResult
+const int kDefenseQualities = 4;    // DefenseQuality
+
+struct PlayerBox {
+    long long serveAttempts[kServeTypes] = {0};
+    long long serveAces[kServeTypes] = {0};
+    long long serveErrors[kServeTypes] = {0};
+
+    long long receptions[kReceiveQualities] = {0};     // 接发球，RECEIVE_FAULT 即被发球得分
+
+    long long sets[kPassTargets] = {0};                // 二传分配（含二次进攻）
+
+    long long spikeAttempts[kSpikeStrategies] = {0};
+    long long spikeKills[kSpikeStrategies] = {0};      // 扣球后对方防守失误
+    long long spikeErrors[kSpikeStrategies] = {0};
+    long long spikeBlocked[kSpikeStrategies] = {0};    // 被拦回
+
+    long long blocks[kBlockResults] = {0};             // 参与拦网的结果
+    long long blockPoints = 0;                         // 拦回后对方防守失误（参与拦网者各记一次）
+
+    long long digs[kDefenseQualities] = {0};           // 防守扣球或拦回球，DEFENSE_FAULT 即未防起
+
+    void add(const PlayerBox& other);
+};
+
+// 两队各7人，下标与 teamA/teamB 一致
+struct BoxScore {
+    PlayerBox players[2][7];
+
+    void add(const BoxScore& other);
+};
+
+// 打印每场平均的技术统计，球员姓名与位置取自 teamA/teamB
+void printBoxScore(const BoxScore& box, const Player teamA[7], const Player teamB[7], long long matches);
+
+#endif //BOXSCORE_H
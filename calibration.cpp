@@ -0,0 +1,256 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "calibration.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+bool loadCalibrationSpec(const std::string& path, CalibrationSpec& spec, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        error = "无法打开 " + path;
+        return false;
+    }
+
+    BalanceParams probe;
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(ifs, line)) {
+        lineNum++;
+        std::string key, value;
+        if (!parseConfigLine(line, key, value)) {
+            if (key.empty()) continue;
+            error = path + " 第" + std::to_string(lineNum) + "行格式错误: " + key;
+            return false;
+        }
+
+        std::istringstream iss(value);
+        bool known = true, ok = false;
+        if (key == "target_sideout") ok = readWhole(iss, spec.targets.sideOutRate);
+        else if (key == "target_ace") ok = readWhole(iss, spec.targets.aceRate);
+        else if (key == "target_kill") ok = readWhole(iss, spec.targets.killRate);
+        else if (key == "target_block_per_set") ok = readWhole(iss, spec.targets.blockPointsPerSet);
+        else if (key == "matches") ok = readWhole(iss, spec.matches);
+        else if (key == "seed") ok = readWhole(iss, spec.seed);
+        else if (key == "threads") ok = readWhole(iss, spec.threads);
+        else if (key == "max_evaluations") ok = readWhole(iss, spec.maxEvaluations);
+        else if (key == "tolerance") ok = readWhole(iss, spec.tolerance);
+        else known = false;
+        if (known) {
+            if (ok) continue;
+            error = path + " 第" + std::to_string(lineNum) + "行数值错误: " + value;
+            return false;
+        }
+
+        double dummy = 0;
+        if (!getBalanceValue(probe, key, dummy)) {
+            error = path + " 第" + std::to_string(lineNum) + "行未知参数: " + key;
+            return false;
+        }
+        CalibrationParam p;
+        p.key = key;
+        if (!(iss >> p.low) || !readWhole(iss, p.high) || p.high <= p.low) {
+            error = path + " 第" + std::to_string(lineNum) + "行需要 下限 上限: " + value;
+            return false;
+        }
+        spec.params.push_back(p);
+    }
+
+    if (spec.params.empty()) {
+        error = path + " 中没有需要标定的参数";
+        return false;
+    }
+    const CalibrationTargets& t = spec.targets;
+    if (t.sideOutRate < 0 && t.aceRate < 0 && t.killRate < 0 && t.blockPointsPerSet < 0) {
+        error = path + " 中没有目标统计值";
+        return false;
+    }
+    if (spec.matches < 1) spec.matches = 1;
+    return true;
+}
+
+double calibrationLoss(const CalibrationTargets& targets, const MatchStats& stats) {
+    auto term = [](double target, double value) {
+        if (target < 0) return 0.0;
+        double scale = std::max(target, 1e-3);
+        double rel = (value - target) / scale;
+        return rel * rel;
+    };
+    return term(targets.sideOutRate, sideOutRate(stats))
+         + term(targets.aceRate, aceRate(stats))
+         + term(targets.killRate, killRate(stats))
+         + term(targets.blockPointsPerSet, blockPointsPerSet(stats));
+}
+
+namespace {
+    // 搜索在归一化坐标 [0,1]^d 中进行，便于不同量级的参数使用同一步长
+    struct Evaluator {
+        const CalibrationSpec& spec;
+        const BalanceParams& base;
+        const Roster& roster;
+        ThreadPool& pool;
+        int evaluations = 0;
+
+        Evaluator(const CalibrationSpec& spec, const BalanceParams& base, const Roster& roster, ThreadPool& pool)
+            : spec(spec), base(base), roster(roster), pool(pool) {}
+
+        double bestLoss = 1e300;
+        BalanceParams bestParams;
+        MatchStats bestStats;
+
+        BalanceParams toParams(const std::vector<double>& u) const {
+            BalanceParams params = base;
+            for (size_t d = 0; d < spec.params.size(); d++) {
+                const CalibrationParam& p = spec.params[d];
+                setBalanceValue(params, p.key, p.low + (p.high - p.low) * u[d]);
+            }
+            return params;
+        }
+
+        double operator()(const std::vector<double>& u) {
+            BalanceParams params = toParams(u);
+            // 所有候选共用同一个种子（公共随机数）
+            MatchStats stats = runMatches(pool, roster, std::make_shared<const BalanceParams>(params),
+                                          spec.matches, spec.seed);
+            double loss = calibrationLoss(spec.targets, stats);
+            evaluations++;
+
+            if (loss < bestLoss) {
+                bestLoss = loss;
+                bestParams = params;
+                bestStats = stats;
+            }
+            std::cout << "第" << evaluations << "次评估  误差=" << std::setprecision(5) << loss
+                      << "  当前最优=" << bestLoss << std::endl;
+            return loss;
+        }
+    };
+
+    void clampUnit(std::vector<double>& u) {
+        for (double& x : u) x = std::max(0.0, std::min(1.0, x));
+    }
+
+    // x = a + t * (b - a)
+    std::vector<double> lerp(const std::vector<double>& a, const std::vector<double>& b, double t) {
+        std::vector<double> x(a.size());
+        for (size_t i = 0; i < a.size(); i++) x[i] = a[i] + t * (b[i] - a[i]);
+        clampUnit(x);
+        return x;
+    }
+}
+
+CalibrationResult runCalibration(const CalibrationSpec& spec) {
+    std::shared_ptr<const BalanceParams> base = currentBalance();
+    Roster roster = captureRoster();
+    ThreadPool pool(spec.threads);
+    Evaluator eval(spec, *base, roster, pool);
+
+    size_t dims = spec.params.size();
+    std::cout << "参数标定：" << dims << " 个参数，每次评估 " << spec.matches
+              << " 场，" << pool.size() << " 个线程" << std::endl;
+
+    // 初始单纯形：当前参数为起点，每个方向偏移区间的 1/4
+    std::vector<double> start(dims);
+    for (size_t d = 0; d < dims; d++) {
+        const CalibrationParam& p = spec.params[d];
+        double value = 0;
+        getBalanceValue(*base, p.key, value);
+        start[d] = (value - p.low) / (p.high - p.low);
+    }
+    clampUnit(start);
+
+    std::vector<std::vector<double>> simplex(dims + 1, start);
+    for (size_t d = 0; d < dims; d++) {
+        double& x = simplex[d + 1][d];
+        x = (x + 0.25 <= 1.0) ? x + 0.25 : x - 0.25;
+    }
+    std::vector<double> loss(dims + 1);
+    for (size_t i = 0; i <= dims; i++) loss[i] = eval(simplex[i]);
+
+    std::vector<size_t> order(dims + 1);
+    while (eval.evaluations < spec.maxEvaluations) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return loss[a] < loss[b]; });
+        size_t best = order.front(), worst = order.back(), second = order[dims - 1];
+
+        if (loss[worst] - loss[best] < spec.tolerance) break;
+
+        // 除最差点外的重心
+        std::vector<double> centroid(dims, 0.0);
+        for (size_t i = 0; i <= dims; i++) {
+            if (i == worst) continue;
+            for (size_t d = 0; d < dims; d++) centroid[d] += simplex[i][d] / dims;
+        }
+
+        // 反射
+        std::vector<double> reflected = lerp(centroid, simplex[worst], -1.0);
+        double fr = eval(reflected);
+
+        if (fr < loss[best]) {
+            // 扩展
+            std::vector<double> expanded = lerp(centroid, simplex[worst], -2.0);
+            double fe = eval(expanded);
+            if (fe < fr) { simplex[worst] = expanded; loss[worst] = fe; }
+            else { simplex[worst] = reflected; loss[worst] = fr; }
+            continue;
+        }
+        if (fr < loss[second]) {
+            simplex[worst] = reflected;
+            loss[worst] = fr;
+            continue;
+        }
+
+        // 收缩：反射点比最差点好则向外收缩，否则向内收缩
+        bool outside = fr < loss[worst];
+        std::vector<double> contracted = outside ? lerp(centroid, reflected, 0.5)
+                                                 : lerp(centroid, simplex[worst], 0.5);
+        double fc = eval(contracted);
+        if (fc < (outside ? fr : loss[worst])) {
+            simplex[worst] = contracted;
+            loss[worst] = fc;
+            continue;
+        }
+
+        // 整体向最优点缩小
+        for (size_t i = 0; i <= dims; i++) {
+            if (i == best) continue;
+            simplex[i] = lerp(simplex[best], simplex[i], 0.5);
+            loss[i] = eval(simplex[i]);
+        }
+    }
+
+    CalibrationResult result;
+    result.best = eval.bestParams;
+    result.loss = eval.bestLoss;
+    result.stats = eval.bestStats;
+    result.evaluations = eval.evaluations;
+    return result;
+}
+
+void printCalibrationReport(const CalibrationSpec& spec, const CalibrationResult& result) {
+    std::cout << "\n标定完成：共评估 " << result.evaluations << " 组参数，最小误差 "
+              << std::setprecision(5) << result.loss << "\n";
+
+    std::cout << "\n参数：\n";
+    for (const auto& p : spec.params) {
+        double value = 0;
+        getBalanceValue(result.best, p.key, value);
+        std::cout << "  " << std::left << std::setw(36) << p.key << std::setprecision(4) << value << "\n";
+    }
+
+    std::cout << "\n统计（目标 / 模拟）：\n" << std::setprecision(3);
+    auto row = [](const char* name, double target, double value) {
+        if (target < 0) return;
+        std::cout << "  " << name << "：" << target << " / " << value << "\n";
+    };
+    row("破攻率", spec.targets.sideOutRate, sideOutRate(result.stats));
+    row("ACE率", spec.targets.aceRate, aceRate(result.stats));
+    row("进攻得分率", spec.targets.killRate, killRate(result.stats));
+    row("每局拦网", spec.targets.blockPointsPerSet, blockPointsPerSet(result.stats));
+    std::cout << std::flush;
+}
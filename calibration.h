@@ -0,0 +1,64 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include "balanceConfig.h"
+#include "batchSim.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============ 平衡参数自动标定 ============
+// 用 Nelder-Mead 单纯形法在给定参数范围内搜索，使模拟统计接近真实比赛的目标值。
+// 每个候选参数都用同一批种子（公共随机数）在线程池上批量模拟，候选之间的差异只来自参数本身。
+
+// 目标统计值（小于0表示不参与标定）
+struct CalibrationTargets {
+    double sideOutRate = -1;        // 破攻率（接发球方得分率）
+    double aceRate = -1;            // 发球直接得分率
+    double killRate = -1;           // 进攻得分率
+    double blockPointsPerSet = -1;  // 每局拦网得分
+};
+
+// 一个参与标定的参数
+struct CalibrationParam {
+    std::string key;    // 与 config.h 中的宏同名
+    double low;
+    double high;
+};
+
+struct CalibrationSpec {
+    std::vector<CalibrationParam> params;
+    CalibrationTargets targets;
+    int matches = 300;          // 每个候选模拟的场数
+    uint64_t seed = 1;
+    int threads = 0;            // 0 为自动
+    int maxEvaluations = 150;   // 最多评估的候选数
+    double tolerance = 1e-4;    // 单纯形各顶点误差之差小于此值时停止
+};
+
+struct CalibrationResult {
+    BalanceParams best;
+    double loss = 0;
+    MatchStats stats;           // 最优参数的模拟统计
+    int evaluations = 0;
+};
+
+// 读取标定配置，格式与 balance.cfg 相同：
+//   target_sideout / target_ace / target_kill / target_block_per_set = 目标值
+//   matches / seed / threads / max_evaluations / tolerance = 数值
+//   参数名 = 下限 上限
+bool loadCalibrationSpec(const std::string& path, CalibrationSpec& spec, std::string& error);
+
+// 误差：各目标相对误差的平方和
+double calibrationLoss(const CalibrationTargets& targets, const MatchStats& stats);
+
+// 以当前发布的平衡参数为起点标定，使用当前线程的阵容
+CalibrationResult runCalibration(const CalibrationSpec& spec);
+
+void printCalibrationReport(const CalibrationSpec& spec, const CalibrationResult& result);
+
+#endif //CALIBRATION_H
@@ -0,0 +1,336 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "columnWriter.h"
+#include <algorithm>
+#include <charconv>
+
+namespace {
+    // ============ 最小的 flatbuffers 构造器 ============
+    // 与官方实现相同，从缓冲区末尾向前写，对象位置以“距末尾的字节数”表示。
+    // 只实现 Arrow 元数据用到的部分：标量、表、字符串、偏移向量、结构体向量。
+    class FlatBuilder {
+    public:
+        FlatBuilder() : buf(1024), head(1024) {}
+
+        uint32_t size() const { return static_cast<uint32_t>(buf.size() - head); }
+
+        template <typename T>
+        void push(T value) {
+            align(sizeof(T));
+            reserve(sizeof(T));
+            head -= sizeof(T);
+            std::memcpy(&buf[head], &value, sizeof(T));
+        }
+
+        // 写一个指向 target 的 uoffset（target 必须已写入）
+        void pushOffset(uint32_t target) {
+            align(4);
+            push<uint32_t>(size() + 4 - target);
+        }
+
+        void startTable() {
+            fields.clear();
+            tableStart = size();
+        }
+
+        template <typename T>
+        void addScalar(int slot, T value) {
+            push(value);
+            fields.push_back({slot, size()});
+        }
+
+        void addOffset(int slot, uint32_t target) {
+            pushOffset(target);
+            fields.push_back({slot, size()});
+        }
+
+        uint32_t endTable() {
+            push<int32_t>(0);  // 指向 vtable 的 soffset，稍后回填
+            uint32_t table = size();
+
+            int slots = 0;
+            for (const auto& f : fields) slots = std::max(slots, f.slot + 1);
+            std::vector<uint16_t> vtable(slots, 0);
+            for (const auto& f : fields) vtable[f.slot] = static_cast<uint16_t>(table - f.offset);
+
+            for (int i = slots - 1; i >= 0; i--) push<uint16_t>(vtable[i]);
+            push<uint16_t>(static_cast<uint16_t>(table - tableStart));
+            push<uint16_t>(static_cast<uint16_t>((slots + 2) * 2));
+
+            int32_t soffset = static_cast<int32_t>(size() - table);
+            std::memcpy(&buf[buf.size() - table], &soffset, sizeof(soffset));
+            return table;
+        }
+
+        uint32_t createString(const std::string& s) {
+            align(4, s.size() + 1);
+            reserve(s.size() + 1);
+            head -= s.size() + 1;
+            std::memcpy(&buf[head], s.c_str(), s.size() + 1);
+            push<uint32_t>(static_cast<uint32_t>(s.size()));
+            return size();
+        }
+
+        uint32_t createOffsetVector(const std::vector<uint32_t>& targets) {
+            align(4, targets.size() * 4);
+            for (size_t i = targets.size(); i-- > 0;) pushOffset(targets[i]);
+            push<uint32_t>(static_cast<uint32_t>(targets.size()));
+            return size();
+        }
+
+        // 由两个 int64 组成的结构体（FieldNode、Buffer）的向量
+        uint32_t createPairVector(const std::vector<std::pair<int64_t, int64_t>>& items) {
+            align(4, items.size() * 16);
+            align(8, items.size() * 16);
+            for (size_t i = items.size(); i-- > 0;) {
+                push<int64_t>(items[i].second);
+                push<int64_t>(items[i].first);
+            }
+            push<uint32_t>(static_cast<uint32_t>(items.size()));
+            return size();
+        }
+
+        // 写入根偏移，返回完整的 flatbuffer
+        std::vector<uint8_t> finish(uint32_t root) {
+            align(minAlign, 4);
+            pushOffset(root);
+            return std::vector<uint8_t>(buf.begin() + head, buf.end());
+        }
+
+    private:
+        struct FieldLoc {
+            int slot;
+            uint32_t offset;
+        };
+
+        std::vector<uint8_t> buf;   // 有效数据位于 [head, buf.size())
+        size_t head;
+        size_t minAlign = 1;
+        uint32_t tableStart = 0;
+        std::vector<FieldLoc> fields;
+
+        void reserve(size_t n) {
+            if (head >= n) return;
+            size_t used = buf.size() - head;
+            size_t newSize = std::max(buf.size() * 2, used + n + 64);
+            std::vector<uint8_t> grown(newSize);
+            std::memcpy(&grown[newSize - used], &buf[head], used);
+            buf.swap(grown);
+            head = newSize - used;
+        }
+
+        // 补零，使再写入 additional 字节后总长度是 alignment 的倍数
+        void align(size_t alignment, size_t additional = 0) {
+            minAlign = std::max(minAlign, alignment);
+            size_t padding = (~(size() + additional) + 1) & (alignment - 1);
+            reserve(padding);
+            while (padding--) buf[--head] = 0;
+        }
+    };
+
+    // Arrow 元数据枚举（Schema.fbs / Message.fbs）
+    const int16_t kMetadataV5 = 4;
+    const uint8_t kHeaderSchema = 1;
+    const uint8_t kHeaderRecordBatch = 3;
+    const uint8_t kTypeInt = 2;
+    const uint8_t kTypeFloatingPoint = 3;
+    const int16_t kPrecisionDouble = 2;
+
+    uint32_t buildMessage(FlatBuilder& fb, uint8_t headerType, uint32_t header, int64_t bodyLength) {
+        fb.startTable();
+        fb.addScalar<int64_t>(3, bodyLength);
+        fb.addOffset(2, header);
+        fb.addScalar<int16_t>(0, kMetadataV5);
+        fb.addScalar<uint8_t>(1, headerType);
+        return fb.endTable();
+    }
+
+    int64_t padded8(int64_t n) {
+        return (n + 7) & ~int64_t(7);
+    }
+
+    // 封装消息：0xFFFFFFFF、元数据长度、元数据（补齐到8字节）
+    void writeMessage(std::FILE* file, const std::vector<uint8_t>& metadata) {
+        int32_t length = static_cast<int32_t>(padded8(8 + metadata.size()) - 8);
+        uint32_t continuation = 0xFFFFFFFFu;
+        std::fwrite(&continuation, 4, 1, file);
+        std::fwrite(&length, 4, 1, file);
+        std::fwrite(metadata.data(), 1, metadata.size(), file);
+        static const uint8_t zeros[8] = {0};
+        std::fwrite(zeros, 1, length - metadata.size(), file);
+    }
+}
+
+int columnWidth(ColumnType type) {
+    return type == COLUMN_INT32 ? 4 : 8;
+}
+
+void ColumnBatch::reset(const std::vector<ColumnDef>& schema, int reserveRows) {
+    rows = 0;
+    columns.resize(schema.size());
+    for (size_t i = 0; i < schema.size(); i++) {
+        columns[i].clear();
+        columns[i].reserve(static_cast<size_t>(reserveRows) * columnWidth(schema[i].type));
+    }
+}
+
+TableWriter::TableWriter(const std::string& path, ExportFormat format, const std::vector<ColumnDef>& schema, int maxQueued)
+    : format(format), schema(schema), maxQueued(std::max(1, maxQueued)) {
+    file = std::fopen(path.c_str(), format == EXPORT_CSV ? "w" : "wb");
+    if (!file) return;
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    if (format == EXPORT_ARROW) writeArrowSchema();
+    else writeCsvHeader();
+    worker = std::thread([this]() { writerLoop(); });
+}
+
+TableWriter::~TableWriter() {
+    close();
+}
+
+void TableWriter::submit(ColumnBatch&& batch) {
+    if (!file || batch.rows == 0) return;
+    std::unique_lock<std::mutex> lk(mtx);
+    spaceCv.wait(lk, [this]() { return static_cast<int>(queue.size()) < maxQueued; });
+    queue.push_back(std::move(batch));
+    lk.unlock();
+    queueCv.notify_one();
+}
+
+void TableWriter::close() {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        closing = true;
+    }
+    queueCv.notify_one();
+    if (worker.joinable()) worker.join();
+
+    if (format == EXPORT_ARROW) {
+        // 流结束标记
+        uint32_t eos[2] = {0xFFFFFFFFu, 0};
+        std::fwrite(eos, 4, 2, file);
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+void TableWriter::writerLoop() {
+    while (true) {
+        ColumnBatch batch;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            queueCv.wait(lk, [this]() { return closing || !queue.empty(); });
+            if (queue.empty()) return;  // closing 且已写完
+            batch = std::move(queue.front());
+            queue.pop_front();
+        }
+        spaceCv.notify_one();
+
+        if (format == EXPORT_ARROW) writeArrowBatch(batch);
+        else writeCsvBatch(batch);
+        rows += batch.rows;
+    }
+}
+
+void TableWriter::writeArrowSchema() {
+    FlatBuilder fb;
+    std::vector<uint32_t> fields;
+    for (const auto& col : schema) {
+        uint32_t name = fb.createString(col.name);
+        uint32_t type;
+        fb.startTable();
+        if (col.type == COLUMN_FLOAT64) {
+            fb.addScalar<int16_t>(0, kPrecisionDouble);
+        } else {
+            fb.addScalar<int32_t>(0, columnWidth(col.type) * 8);
+            fb.addScalar<uint8_t>(1, 1);  // is_signed
+        }
+        type = fb.endTable();
+        uint32_t children = fb.createOffsetVector({});
+
+        fb.startTable();
+        fb.addOffset(0, name);
+        fb.addOffset(3, type);
+        fb.addOffset(5, children);
+        fb.addScalar<uint8_t>(1, 0);  // nullable
+        fb.addScalar<uint8_t>(2, col.type == COLUMN_FLOAT64 ? kTypeFloatingPoint : kTypeInt);
+        fields.push_back(fb.endTable());
+    }
+    uint32_t fieldVector = fb.createOffsetVector(fields);
+
+    fb.startTable();
+    fb.addOffset(1, fieldVector);
+    fb.addScalar<int16_t>(0, 0);  // Little endian
+    uint32_t schemaTable = fb.endTable();
+
+    writeMessage(file, fb.finish(buildMessage(fb, kHeaderSchema, schemaTable, 0)));
+}
+
+void TableWriter::writeArrowBatch(const ColumnBatch& batch) {
+    // 每列一个 FieldNode，两个 Buffer（无空值，有效位图长度为0；数据缓冲区按8字节对齐）
+    std::vector<std::pair<int64_t, int64_t>> nodes, buffers;
+    int64_t body = 0;
+    for (const auto& col : batch.columns) {
+        nodes.push_back({batch.rows, 0});
+        buffers.push_back({body, 0});
+        buffers.push_back({body, static_cast<int64_t>(col.size())});
+        body += padded8(col.size());
+    }
+
+    FlatBuilder fb;
+    uint32_t nodeVector = fb.createPairVector(nodes);
+    uint32_t bufferVector = fb.createPairVector(buffers);
+    fb.startTable();
+    fb.addScalar<int64_t>(0, batch.rows);
+    fb.addOffset(1, nodeVector);
+    fb.addOffset(2, bufferVector);
+    uint32_t recordBatch = fb.endTable();
+
+    writeMessage(file, fb.finish(buildMessage(fb, kHeaderRecordBatch, recordBatch, body)));
+
+    static const uint8_t zeros[8] = {0};
+    for (const auto& col : batch.columns) {
+        std::fwrite(col.data(), 1, col.size(), file);
+        std::fwrite(zeros, 1, padded8(col.size()) - col.size(), file);
+    }
+}
+
+void TableWriter::writeCsvHeader() {
+    for (size_t i = 0; i < schema.size(); i++) {
+        std::fputs(schema[i].name.c_str(), file);
+        std::fputc(i + 1 < schema.size() ? ',' : '\n', file);
+    }
+}
+
+void TableWriter::writeCsvBatch(const ColumnBatch& batch) {
+    // 先在内存中格式化整批再一次写出
+    std::string text;
+    text.reserve(static_cast<size_t>(batch.rows) * schema.size() * 8);
+    char field[32];
+    for (int r = 0; r < batch.rows; r++) {
+        for (size_t c = 0; c < schema.size(); c++) {
+            const uint8_t* p = batch.columns[c].data() + static_cast<size_t>(r) * columnWidth(schema[c].type);
+            std::to_chars_result res;
+            if (schema[c].type == COLUMN_INT32) {
+                int32_t v;
+                std::memcpy(&v, p, 4);
+                res = std::to_chars(field, field + sizeof(field), v);
+            } else if (schema[c].type == COLUMN_INT64) {
+                int64_t v;
+                std::memcpy(&v, p, 8);
+                res = std::to_chars(field, field + sizeof(field), v);
+            } else {
+                double v;
+                std::memcpy(&v, p, 8);
+                res = std::to_chars(field, field + sizeof(field), v);
+            }
+            text.append(field, res.ptr);
+            text.push_back(c + 1 < schema.size() ? ',' : '\n');
+        }
+    }
+    std::fwrite(text.data(), 1, text.size(), file);
+}
@@ -0,0 +1,93 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef COLUMNWRITER_H
+#define COLUMNWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============ 列式结果输出 ============
+// 模拟线程按列攒满一批行后交给 TableWriter，由后台线程编码并整块写盘，队列有上限，内存占用固定。
+// 支持两种格式：
+//   Arrow IPC 流（.arrow，pyarrow.ipc.open_stream / pandas 可直接读取，自行编码 flatbuffers 元数据）
+//   CSV（带表头，作为通用的备选格式）
+
+enum ExportFormat {
+    EXPORT_ARROW,
+    EXPORT_CSV
+};
+
+enum ColumnType {
+    COLUMN_INT32,
+    COLUMN_INT64,
+    COLUMN_FLOAT64
+};
+
+struct ColumnDef {
+    std::string name;
+    ColumnType type;
+};
+
+// 一批行，每列一段连续的小端字节
+struct ColumnBatch {
+    int rows = 0;
+    std::vector<std::vector<uint8_t>> columns;
+
+    void reset(const std::vector<ColumnDef>& schema, int reserveRows);
+
+    template <typename T>
+    void put(int column, T value) {
+        std::vector<uint8_t>& c = columns[column];
+        size_t n = c.size();
+        c.resize(n + sizeof(T));
+        std::memcpy(c.data() + n, &value, sizeof(T));
+    }
+};
+
+class TableWriter {
+public:
+    // maxQueued：排队等待写盘的批数上限，超过时 submit 阻塞
+    TableWriter(const std::string& path, ExportFormat format, const std::vector<ColumnDef>& schema, int maxQueued = 4);
+    ~TableWriter();
+
+    TableWriter(const TableWriter&) = delete;
+    TableWriter& operator=(const TableWriter&) = delete;
+
+    bool ok() const { return file != nullptr; }
+    void submit(ColumnBatch&& batch);
+    void close();                       // 写完队列中的数据并结束文件
+    long long rowsWritten() const { return rows; }
+
+private:
+    std::FILE* file = nullptr;
+    ExportFormat format;
+    std::vector<ColumnDef> schema;
+    int maxQueued;
+    long long rows = 0;
+
+    std::deque<ColumnBatch> queue;
+    std::mutex mtx;
+    std::condition_variable queueCv;    // 有新批次或结束
+    std::condition_variable spaceCv;    // 队列有空位
+    bool closing = false;
+    std::thread worker;
+
+    void writerLoop();
+    void writeArrowSchema();
+    void writeArrowBatch(const ColumnBatch& batch);
+    void writeCsvHeader();
+    void writeCsvBatch(const ColumnBatch& batch);
+};
+
+int columnWidth(ColumnType type);
+
+#endif //COLUMNWRITER_H
@@ -0,0 +1,672 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "commandLine.h"
+#include "balanceConfig.h"
+#include "paramSweep.h"
+#include "processShards.h"
+#include "lockstepBatch.h"
+#include "calibration.h"
+#include "lineupOptimizer.h"
+#include "league.h"
+#include "markovModel.h"
+#include "pointPipeline.h"
+#include "jsonLines.h"
+#include "simService.h"
+#include "resultCache.h"
+#include "resultExport.h"
+#include "rareEvents.h"
+#include "schemeCompare.h"
+#include "sequentialRun.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include "trace.h"
+#include "player.h"
+#include "playerJournal.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // 命令行参数中 name 后面的值，没有则返回 fallback
+    std::string argValue(int argc, char** argv, const std::string& name, const std::string& fallback) {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (name == argv[i]) return argv[i + 1];
+        }
+        return fallback;
+    }
+
+    // 命令行数值参数写错（如 --matches abc、--matches 10x、--alpha 0），由 runCommandLine 统一报告
+    struct ArgumentError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    // 数值参数：整个值须为 T 类型的数，没有给出时返回 fallback
+    template <typename T>
+    T numberArg(int argc, char** argv, const std::string& name, T fallback) {
+        std::string text = argValue(argc, argv, name, "");
+        if (text.empty()) return fallback;
+        std::istringstream iss(text);
+        T value{};
+        if (!readWhole(iss, value)) throw ArgumentError(name + " 的值不是有效的数: " + text);
+        return value;
+    }
+
+    // 读取 players.txt 的预设阵容（前14人）与 balance.cfg
+    bool prepareHeadless() {
+        std::error_code ec;
+        if (std::filesystem::exists("balance.cfg", ec)) reloadBalance("balance.cfg", std::cout);
+
+        readData();
+        if (allPlayers.size() < 14) {
+            std::cerr << "players.txt 中球员不足14人，无法组成两队" << std::endl;
+            return false;
+        }
+        inputPlayerByPreset();
+        return true;
+    }
+
+    // --cache 目录：打开结果缓存；未给出时返回 true 且缓存保持关闭
+    bool openResultCache(int argc, char** argv, ResultCache& cache) {
+        std::string directory = argValue(argc, argv, "--cache", "");
+        if (directory.empty()) return true;
+        int capacity = std::max(1, numberArg<int>(argc, argv, "--cache-size", 4096));
+        std::string error;
+        if (!cache.open(directory, capacity, error)) {
+            std::cerr << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void printCacheUsage(const ResultCache& cache, long long cached, int matches) {
+        if (!cache.isOpen()) return;
+        std::cout << "结果缓存：命中 " << cached << " 场，模拟 " << matches - cached << " 场" << std::endl;
+    }
+
+    // --precision 半宽 或 --sprt delta：按停止条件自适应决定场数；两者都没给时返回 false
+    bool readStopRule(int argc, char** argv, StopRule& rule) {
+        bool precision = !argValue(argc, argv, "--precision", "").empty();
+        bool sprt = !argValue(argc, argv, "--sprt", "").empty();
+        if (!precision && !sprt) return false;
+        if (sprt) {
+            rule.kind = STOP_RULE_SPRT;
+            rule.delta = std::clamp(numberArg<double>(argc, argv, "--sprt", 0.0), 1e-4, 0.49);
+            rule.alpha = numberArg<double>(argc, argv, "--alpha", 0.05);
+            rule.beta = numberArg<double>(argc, argv, "--beta", 0.05);
+            // 0 或 0.5 以上时检验边界为无穷或反向，只会跑到场数上限
+            if (!(rule.alpha > 0 && rule.alpha < 0.5) || !(rule.beta > 0 && rule.beta < 0.5)) {
+                throw ArgumentError("--alpha 与 --beta 应在 0 与 0.5 之间（不含端点）");
+            }
+        } else {
+            rule.kind = STOP_RULE_PRECISION;
+            rule.halfWidth = std::max(1e-5, numberArg<double>(argc, argv, "--precision", 0.0));
+        }
+        rule.roundMatches = std::max(1, numberArg<int>(argc, argv, "--round", 200));
+        rule.maxMatches = std::max(1, numberArg<int>(argc, argv, "--max-matches", 1000000));
+        return true;
+    }
+
+    std::string batchSizeText(int argc, char** argv, int matches) {
+        StopRule rule;
+        return readStopRule(argc, argv, rule) ? "自适应场数" : std::to_string(matches) + " 场";
+    }
+
+    // 固定场数，或给出停止条件时自适应决定场数；--processes 时固定场数分片到多个进程。
+    // 线程池只在本进程内模拟时创建：分片时协调进程保持单线程再 fork，--threads 为每个工作进程的线程数。
+    // --lanes K 时每个线程交错推进 K 场比赛（结果与逐场模拟相同）
+    bool runBatch(int argc, char** argv, const char* title, ResultCache& cache, const Roster& roster,
+                  int matches, uint64_t seed, MatchStats& stats) {
+        int threads = numberArg<int>(argc, argv, "--threads", 0);
+        int lanes = numberArg<int>(argc, argv, "--lanes", 0);
+        StopRule rule;
+        bool adaptive = readStopRule(argc, argv, rule);
+        if (lanes > 0 && (adaptive || cache.isOpen() || !argValue(argc, argv, "--processes", "").empty())) {
+            std::cerr << "--lanes 只支持本进程内固定场数，不能与 --precision、--sprt、--processes、--cache 同用" << std::endl;
+            return false;
+        }
+        if (!argValue(argc, argv, "--processes", "").empty()) {
+            if (adaptive) {
+                std::cerr << "--processes 只支持固定场数，不能与 --precision、--sprt 同用" << std::endl;
+                return false;
+            }
+            ShardSpec spec;
+            spec.processes = std::max(1, numberArg<int>(argc, argv, "--processes", 1));
+            spec.shards = std::max(0, numberArg<int>(argc, argv, "--shards", 0));
+            spec.threadsPerProcess = std::max(1, threads);
+            std::cout << title << "：" << matches << " 场，" << spec.processes << " 个进程，每个 "
+                      << spec.threadsPerProcess << " 个线程" << std::endl;
+            ShardReport report;
+            stats = runMatchesSharded(roster, currentBalance(), matches, seed, spec, report);
+            printShardReport(report);
+            return report.ok;
+        }
+        ThreadPool pool(threads);
+        std::cout << title << "：" << batchSizeText(argc, argv, matches) << "，" << pool.size() << " 个线程";
+        if (lanes > 0) std::cout << "，每个线程交错推进 " << lanes << " 场";
+        std::cout << std::endl;
+        if (lanes > 0) {
+            stats = runMatchesLockstep(pool, roster, currentBalance(), matches, seed, lanes);
+            return true;
+        }
+        if (adaptive) {
+            SequentialResult result = runMatchesSequential(pool, &cache, roster, currentBalance(), rule, seed);
+            printSequentialSummary(rule, result);
+            stats = result.stats;
+            return true;
+        }
+        long long cached = 0;
+        stats = runMatchesCached(pool, &cache, roster, currentBalance(), matches, seed, &cached);
+        printCacheUsage(cache, cached, matches);
+        return true;
+    }
+
+    int runSweepCommand(int argc, char** argv) {
+        std::string specPath = argValue(argc, argv, "--sweep", "sweep.cfg");
+        std::string outPath = argValue(argc, argv, "--out", "sweep_result.csv");
+
+        SweepSpec spec;
+        std::string error;
+        if (!loadSweepSpec(specPath, spec, error)) {
+            std::cerr << "扫描配置读取失败: " << error << std::endl;
+            return 1;
+        }
+        if (!prepareHeadless()) return 1;
+
+        std::vector<SweepRow> rows = runSweep(spec);
+        printSweepTable(spec, rows);
+        if (!writeSweepCsv(outPath, spec, rows)) {
+            std::cerr << "无法写入 " << outPath << std::endl;
+            return 1;
+        }
+        std::cout << "结果已保存至 " << outPath << std::endl;
+        return 0;
+    }
+
+    int runCalibrateCommand(int argc, char** argv) {
+        std::string specPath = argValue(argc, argv, "--calibrate", "calibrate.cfg");
+        std::string outPath = argValue(argc, argv, "--out", "calibrated.cfg");
+
+        CalibrationSpec spec;
+        std::string error;
+        if (!loadCalibrationSpec(specPath, spec, error)) {
+            std::cerr << "标定配置读取失败: " << error << std::endl;
+            return 1;
+        }
+        if (!prepareHeadless()) return 1;
+
+        CalibrationResult result = runCalibration(spec);
+        printCalibrationReport(spec, result);
+        if (!saveBalanceFile(outPath, result.best)) {
+            std::cerr << "无法写入 " << outPath << std::endl;
+            return 1;
+        }
+        std::cout << "标定后的参数已保存至 " << outPath << "（确认后可替换 balance.cfg）" << std::endl;
+        return 0;
+    }
+
+    int runLineupCommand(int argc, char** argv) {
+        LineupSpec spec;
+        std::string side = argValue(argc, argv, "--lineup", "A");
+        spec.team = (side == "B" || side == "b") ? 1 : 0;
+        spec.roundMatches = std::max(1, numberArg<int>(argc, argv, "--round", 100));
+        spec.maxMatches = std::max(1, numberArg<int>(argc, argv, "--matches", 2000));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        if (!prepareHeadless()) return 1;
+
+        std::string error;
+        std::vector<LineupCandidate> candidates = optimizeLineup(spec, error);
+        if (candidates.empty()) {
+            std::cerr << "首发优化失败: " << error << std::endl;
+            return 1;
+        }
+        printLineupReport(spec, captureRoster(), candidates);
+        return 0;
+    }
+
+    // "2,1,3,4,5,6"：第 i 个数为站在 (i+1) 号位的球员在原阵容中的序号（从1开始）
+    bool parseLineupOrder(const std::string& text, LineupOrder& order) {
+        std::array<bool, 6> used{};
+        size_t pos = 0;
+        for (int i = 0; i < 6; i++) {
+            size_t comma = text.find(',', pos);
+            if ((i < 5) == (comma == std::string::npos)) return false;
+            std::istringstream iss(text.substr(pos, comma - pos));
+            int value = 0;
+            if (!readWhole(iss, value)) return false;
+            if (value < 1 || value > 6 || used[value - 1]) return false;
+            used[value - 1] = true;
+            order[i] = value - 1;
+            pos = comma + 1;
+        }
+        return true;
+    }
+
+    int runCompareCommand(int argc, char** argv) {
+        std::string cfgPath = argValue(argc, argv, "--compare", "");
+        if (cfgPath.rfind("--", 0) == 0) cfgPath.clear();
+        std::string orderText = argValue(argc, argv, "--order-a", "");
+        CompareSpec spec;
+        spec.matches = std::max(2, numberArg<int>(argc, argv, "--matches", 2000));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        if (!prepareHeadless()) return 1;
+
+        CompareArm first{captureRoster(), currentBalance()};
+        CompareArm second = first;
+        if (!cfgPath.empty()) {
+            auto params = std::make_shared<BalanceParams>();
+            std::string error;
+            if (!loadBalanceFile(cfgPath, *currentBalance(), *params, error)) {
+                std::cerr << "方案参数读取失败: " << error << std::endl;
+                return 1;
+            }
+            second.params = params;
+        }
+        if (!orderText.empty()) {
+            LineupOrder order;
+            if (!parseLineupOrder(orderText, order)) {
+                std::cerr << "--order-a 应为 1-6 的一个排列，如 2,1,3,4,5,6" << std::endl;
+                return 1;
+            }
+            applyLineup(second.roster.teamA, order);
+        }
+        std::cout << "方案1：当前参数与预设阵容；方案2：" << (cfgPath.empty() ? "当前参数" : cfgPath)
+                  << (orderText.empty() ? "" : "，A队站位 " + orderText) << std::endl;
+
+        printCompareReport(spec, compareArms(first, second, spec));
+        return 0;
+    }
+
+    int runRareCommand(int argc, char** argv) {
+        RareEventSpec spec;
+        spec.matches = std::max(1, numberArg<int>(argc, argv, "--matches", 100000));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        spec.longSetPoints = std::max(2, numberArg<int>(argc, argv, "--long-set", 35));
+        std::string favorite = argValue(argc, argv, "--favorite", "A");
+        spec.favorite = (favorite == "B" || favorite == "b") ? 1 : 0;
+        spec.shadows = std::max(0, numberArg<int>(argc, argv, "--shadows", 8));
+        spec.branchAttack = std::max(1, numberArg<int>(argc, argv, "--branch-attack", 3));
+
+        double upset = numberArg<double>(argc, argv, "--upset-tilt", 1);
+        double deuce = numberArg<double>(argc, argv, "--deuce-tilt", 1.5);
+        double rally = numberArg<double>(argc, argv, "--rally-tilt", 3);
+        if (upset <= 0 || deuce <= 0 || rally <= 0) {
+            std::cerr << "倾斜倍数应为正数（1 为不倾斜）" << std::endl;
+            return 1;
+        }
+        spec.upsetTilt = makeUpsetTilt(spec.favorite, upset);
+        spec.deuceTilt = makeDeuceTilt(deuce);
+        spec.rallyTilt = makeRallyTilt(rally);
+        if (!prepareHeadless()) return 1;
+
+        printRareEventReport(spec, estimateRareEvents(spec));
+        return 0;
+    }
+
+    int runLeagueCommand(int argc, char** argv) {
+        LeagueSpec spec;
+        spec.teams = numberArg<int>(argc, argv, "--league", 20);
+        spec.replicas = std::max(1, numberArg<int>(argc, argv, "--replicas", 100));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        std::string outPath = argValue(argc, argv, "--out", "league_result.csv");
+        if (spec.teams < 2) {
+            std::cerr << "联赛至少需要2支队伍" << std::endl;
+            return 1;
+        }
+        if (!prepareHeadless()) return 1;
+
+        std::vector<LeagueTeam> teams;
+        std::string error;
+        if (!buildLeagueTeams(spec.teams, spec.seed, teams, error)) {
+            std::cerr << "组队失败: " << error << std::endl;
+            return 1;
+        }
+
+        LeagueResult result = runLeague(spec, teams);
+        printLeagueReport(spec, teams, result);
+        if (!writeLeagueCsv(outPath, spec, teams, result)) {
+            std::cerr << "无法写入 " << outPath << std::endl;
+            return 1;
+        }
+        std::cout << "结果已保存至 " << outPath << std::endl;
+        return 0;
+    }
+
+    int runRotationsCommand(int argc, char** argv) {
+        int matches = std::max(1, numberArg<int>(argc, argv, "--matches", 2000));
+        uint64_t seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        std::string outPath = argValue(argc, argv, "--out", "rotation_stats.csv");
+        ResultCache cache;
+        if (!openResultCache(argc, argv, cache) || !prepareHeadless()) return 1;
+
+        MatchStats stats;
+        if (!runBatch(argc, argv, "轮次统计", cache, captureRoster(), matches, seed, stats)) return 1;
+        printRotationReport(stats);
+        if (!writeRotationCsv(outPath, stats)) {
+            std::cerr << "无法写入 " << outPath << std::endl;
+            return 1;
+        }
+        std::cout << "结果已保存至 " << outPath << std::endl;
+        return 0;
+    }
+
+    int runBoxScoreCommand(int argc, char** argv) {
+        int matches = std::max(1, numberArg<int>(argc, argv, "--matches", 1000));
+        uint64_t seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        ResultCache cache;
+        if (!openResultCache(argc, argv, cache) || !prepareHeadless()) return 1;
+
+        Roster roster = captureRoster();
+        MatchStats stats;
+        if (!runBatch(argc, argv, "技术统计", cache, roster, matches, seed, stats)) return 1;
+        printBoxScore(stats.box, roster.teamA, roster.teamB, stats.matches);
+        return 0;
+    }
+
+    int runExportCommand(int argc, char** argv) {
+        ExportSpec spec;
+        std::string format = argValue(argc, argv, "--format", "arrow");
+        if (format != "arrow" && format != "csv") {
+            std::cerr << "未知格式: " << format << "（可选 arrow、csv）" << std::endl;
+            return 1;
+        }
+        spec.format = (format == "csv") ? EXPORT_CSV : EXPORT_ARROW;
+        spec.matches = std::max(1, numberArg<int>(argc, argv, "--matches", 1000));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        std::string prefix = argValue(argc, argv, "--out", "sim");
+        spec.matchPath = prefix + "_matches." + format;
+        spec.pointPath = prefix + "_points." + format;
+        if (!prepareHeadless()) return 1;
+
+        auto t0 = std::chrono::steady_clock::now();
+        ExportResult result = exportMatches(captureRoster(), currentBalance(), spec);
+        auto t1 = std::chrono::steady_clock::now();
+        if (!result.ok) {
+            std::cerr << "无法写入 " << spec.matchPath << " 或 " << spec.pointPath << std::endl;
+            return 1;
+        }
+        std::cout << "导出 " << result.matchRows << " 场、" << result.pointRows << " 球，用时 "
+                  << std::chrono::duration<double>(t1 - t0).count() << " s" << std::endl;
+        std::cout << "结果已保存至 " << spec.matchPath << "、" << spec.pointPath << std::endl;
+        return 0;
+    }
+
+    int runJsonLinesCommand(int argc, char** argv) {
+        JsonLinesSpec spec;
+        spec.matches = std::max(1, numberArg<int>(argc, argv, "--matches", 1000));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        spec.path = argValue(argc, argv, "--out", "-");
+
+        // 结果写在标准输出上时，其余提示（如载入平衡参数）改到标准错误，不混进 JSON 行
+        std::streambuf* savedCout = std::cout.rdbuf();
+        if (spec.path == "-") std::cout.rdbuf(std::cerr.rdbuf());
+        struct CoutRestore {
+            std::streambuf* saved;
+            ~CoutRestore() { std::cout.rdbuf(saved); }
+        } restore{savedCout};
+        if (!prepareHeadless()) return 1;
+
+        auto t0 = std::chrono::steady_clock::now();
+        JsonLinesResult result = exportJsonLines(captureRoster(), currentBalance(), spec);
+        auto t1 = std::chrono::steady_clock::now();
+        if (!result.ok) {
+            std::cerr << "无法写入 " << spec.path << std::endl;
+            return 1;
+        }
+        std::cerr << "输出 " << result.matchLines << " 场、" << result.pointLines << " 球（" << result.bytes
+                  << " 字节），用时 " << std::chrono::duration<double>(t1 - t0).count() << " s" << std::endl;
+        return 0;
+    }
+
+    int runServeCommand(int argc, char** argv) {
+        ServiceSpec spec;
+        spec.socketPath = argValue(argc, argv, "--socket", "volleyball.sock");
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        spec.maxClients = std::max(1, numberArg<int>(argc, argv, "--max-clients", 64));
+        spec.maxQueuedMatches = std::max(1LL, numberArg<long long>(argc, argv, "--max-queued", 2000000));
+        spec.cacheDir = argValue(argc, argv, "--cache", "");
+        spec.cacheCapacity = std::max(1, numberArg<int>(argc, argv, "--cache-size", 4096));
+        if (!prepareHeadless()) return 1;
+        return runService(spec);
+    }
+
+    // 球员库编辑：写入编辑日志，不改动 players.txt（日志多了以后自动合并，也可用 compact 立即合并）
+    int runPlayerCommand(int argc, char** argv) {
+        std::string action = (argc > 2) ? argv[2] : "";
+        if (!loadPlayerDatabase("players.txt")) return 1;
+
+        std::string error;
+        bool ok;
+        if (action == "add" && argc > 3) {
+            ok = addPlayerRecord(argv[3], error);
+        } else if (action == "update" && argc > 4) {
+            ok = updatePlayerRecord(argv[3], argv[4], error);
+        } else if (action == "remove" && argc > 3) {
+            ok = removePlayerRecord(argv[3], error);
+        } else if (action == "compact") {
+            ok = compactPlayerJournal();
+            if (!ok) error = "无法写入 players.txt";
+        } else {
+            std::cerr << "用法: VolleyballSimulation --player add|update 姓名|remove 姓名|compact [球员数据]" << std::endl;
+            return 1;
+        }
+        if (!ok) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << "球员库共 " << allPlayers.size() << " 人，编辑日志中待合并 " << pendingJournalRecords() << " 条" << std::endl;
+        return 0;
+    }
+
+    int runTraceCommand(int argc, char** argv) {
+        std::string modules = (argc > 2) ? argv[2] : "";
+        uint32_t mask = parseTraceModules(modules);
+        if (mask == 0) {
+            std::cerr << "未知模块: " << modules << "（可选 all";
+            for (int m = 0; m < TRACE_MODULE_COUNT; m++) std::cerr << "、" << traceModuleName(static_cast<TraceModule>(m));
+            std::cerr << "，逗号分隔）" << std::endl;
+            return 1;
+        }
+        uint64_t seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        int match = std::max(0, numberArg<int>(argc, argv, "--match", 0));
+        std::string outPath = argValue(argc, argv, "--out", "");
+        if (!prepareHeadless()) return 1;
+
+        std::ofstream file;
+        if (!outPath.empty()) {
+            file.open(outPath);
+            if (!file) {
+                std::cerr << "无法写入 " << outPath << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& out = outPath.empty() ? std::cout : file;
+
+        // 与批量模拟中同一种子、同一场次的比赛完全相同
+        pinBalance();
+        setUIEventsEnabled(false);
+        simSeed(matchSeed(seed, match));
+        traceSetSink(&out);
+        traceSetMask(mask);
+        ServeReceiveTables tables;
+        setServeReceiveTables(&tables);
+        MatchStats stats;
+        int winner = simulateMatch(stats);
+        setServeReceiveTables(nullptr);
+        traceSetMask(0);
+        traceFlush();
+        traceSetSink(nullptr);
+
+        std::cout << "第 " << match << " 场（种子 " << seed << "）：" << (winner == 0 ? "A" : "B") << "队胜，局分 "
+                  << stats.setsA << ":" << stats.sets - stats.setsA << "，共 " << stats.rallies << " 球" << std::endl;
+        if (!outPath.empty()) std::cout << "追踪已保存至 " << outPath << std::endl;
+        return 0;
+    }
+
+    bool samePoints(const std::vector<PointRecord>& a, const std::vector<PointRecord>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].setNum != b[i].setNum || a[i].rally != b[i].rally || a[i].scorer != b[i].scorer ||
+                a[i].serveSide != b[i].serveSide || a[i].end != b[i].end || a[i].attacks != b[i].attacks ||
+                a[i].touches != b[i].touches) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int runLiveCommand(int argc, char** argv) {
+        uint64_t seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        int match = std::max(0, numberArg<int>(argc, argv, "--match", 0));
+        int threads = numberArg<int>(argc, argv, "--threads", 0);
+        int repeat = std::max(1, numberArg<int>(argc, argv, "--repeat", 200));
+        if (!prepareHeadless()) return 1;
+
+        Roster roster = captureRoster();
+        auto params = currentBalance();
+        uint64_t liveSeed = matchSeed(seed, match);
+
+        PointPipeline sequential(1);
+        PointPipeline pipeline(threads);
+
+        // 逐球顺序与推测流水线必须逐球一致
+        MatchStats stats, check;
+        std::vector<PointRecord> points, checkPoints;
+        int winner = pipeline.simulateMatch(roster, params, liveSeed, stats, &points);
+        sequential.simulateMatch(roster, params, liveSeed, check, &checkPoints);
+        if (!samePoints(points, checkPoints)) {
+            std::cerr << "流水线结果与顺序模拟不一致" << std::endl;
+            return 1;
+        }
+
+        std::cout << "第 " << match << " 场（种子 " << seed << "，逐球种子）：" << (winner == 0 ? "A" : "B") << "队胜，局分 "
+                  << stats.setsA << ":" << stats.sets - stats.setsA << "（";
+        for (size_t i = 0; i < points.size(); i++) {
+            const PointRecord& p = points[i];
+            if (i + 1 < points.size() && points[i + 1].setNum == p.setNum) continue;
+            if (p.setNum > 1) std::cout << " ";
+            std::cout << p.scoreA + (p.scorer == 0) << ":" << p.scoreB + (p.scorer == 1);
+        }
+        std::cout << "），共 " << stats.rallies << " 球" << std::endl;
+
+        // 计时：同一场比赛反复模拟
+        auto timeMatches = [&](PointPipeline& runner) {
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeat; r++) {
+                MatchStats s;
+                runner.simulateMatch(roster, params, liveSeed, s);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::micro>(t1 - t0).count() / repeat;
+        };
+        double sequentialUs = timeMatches(sequential);
+        double pipelineUs = timeMatches(pipeline);
+        const PipelineStats& ps = pipeline.pipelineStats();
+        std::cout << "顺序 " << sequentialUs << " us/场；流水线 " << pipeline.threads() << " 个线程、推测深度 "
+                  << pipeline.depth() << "：" << pipelineUs << " us/场，每轮确认 "
+                  << static_cast<double>(ps.committed) / ps.rounds << " 球，推测作废 "
+                  << 100.0 * (ps.simulated - ps.committed) / ps.simulated << "%" << std::endl;
+        return 0;
+    }
+
+    int runPredictCommand(int argc, char** argv) {
+        MarkovSpec spec;
+        spec.rallySamples = std::max(1, numberArg<int>(argc, argv, "--samples", 400));
+        spec.bootstrap = std::max(0, numberArg<int>(argc, argv, "--bootstrap", 100));
+        spec.seed = numberArg<uint64_t>(argc, argv, "--seed", 1);
+        spec.threads = numberArg<int>(argc, argv, "--threads", 0);
+        int check = numberArg<int>(argc, argv, "--check", 0);
+        ResultCache cache;
+        if (!openResultCache(argc, argv, cache) || !prepareHeadless()) return 1;
+        pinBalance();
+        setUIEventsEnabled(false);
+
+        auto t0 = std::chrono::steady_clock::now();
+        MatchupModel model = buildMatchupModel(spec);
+        auto t1 = std::chrono::steady_clock::now();
+        MatchPrediction prediction = predictMatch(model);
+        auto t2 = std::chrono::steady_clock::now();
+
+        printMatchPrediction(model, prediction);
+        std::cout << "建表 " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms，求解 "
+                  << std::chrono::duration<double, std::micro>(t2 - t1).count() << " us" << std::endl;
+
+        // 可选：与蒙特卡洛模拟对照
+        if (check > 0) {
+            ThreadPool pool(spec.threads);
+            long long cached = 0;
+            MatchStats stats = runMatchesCached(pool, &cache, captureRoster(), currentBalance(), check, spec.seed, &cached);
+            printCacheUsage(cache, cached, check);
+            double low, high;
+            wilsonInterval(stats.winsA, stats.matches, 1.96, low, high);
+            std::cout << "蒙特卡洛 " << stats.matches << " 场：A队胜率 "
+                      << static_cast<double>(stats.winsA) / stats.matches
+                      << "，95%置信区间 [" << low << ", " << high << "]" << std::endl;
+        }
+        return 0;
+    }
+
+    int runCommand(const std::string& command, int argc, char** argv) {
+        if (command == "--sweep") return runSweepCommand(argc, argv);
+        if (command == "--calibrate") return runCalibrateCommand(argc, argv);
+        if (command == "--lineup") return runLineupCommand(argc, argv);
+        if (command == "--compare") return runCompareCommand(argc, argv);
+        if (command == "--league") return runLeagueCommand(argc, argv);
+        if (command == "--rare") return runRareCommand(argc, argv);
+        if (command == "--predict") return runPredictCommand(argc, argv);
+        if (command == "--rotations") return runRotationsCommand(argc, argv);
+        if (command == "--boxscore") return runBoxScoreCommand(argc, argv);
+        if (command == "--export") return runExportCommand(argc, argv);
+        if (command == "--jsonl") return runJsonLinesCommand(argc, argv);
+        if (command == "--serve") return runServeCommand(argc, argv);
+        if (command == "--player") return runPlayerCommand(argc, argv);
+        if (command == "--trace") return runTraceCommand(argc, argv);
+        if (command == "--live") return runLiveCommand(argc, argv);
+
+        std::cerr << "未知参数: " << command << std::endl;
+        std::cerr << "用法: VolleyballSimulation --sweep sweep.cfg [--out 结果.csv]" << std::endl;
+        std::cerr << "      VolleyballSimulation --calibrate calibrate.cfg [--out calibrated.cfg]" << std::endl;
+        std::cerr << "      VolleyballSimulation --lineup A|B [--round 100] [--matches 2000] [--seed 1] [--threads 0]" << std::endl;
+        std::cerr << "      VolleyballSimulation --compare [方案.cfg] [--order-a 2,1,3,4,5,6] [--matches 2000] [--seed 1] [--threads 0]" << std::endl;
+        std::cerr << "      VolleyballSimulation --league 队伍数 [--replicas 100] [--seed 1] [--threads 0] [--out league_result.csv]" << std::endl;
+        std::cerr << "      VolleyballSimulation --rare [--matches 100000] [--long-set 35] [--favorite A|B] "
+                     "[--shadows 8] [--deuce-tilt 1.5] [--rally-tilt 3] [--branch-attack 3] [--upset-tilt 1] [--seed 1] [--threads 0]" << std::endl;
+        std::cerr << "      VolleyballSimulation --predict [--samples 400] [--bootstrap 100] [--seed 1] [--threads 0] [--check 场数] [--cache 目录]" << std::endl;
+        std::cerr << "      VolleyballSimulation --rotations [--matches 2000] [--seed 1] [--threads 0] [--out rotation_stats.csv] [--cache 目录]" << std::endl;
+        std::cerr << "      VolleyballSimulation --boxscore [--matches 1000] [--seed 1] [--threads 0] [--cache 目录]" << std::endl;
+        std::cerr << "      （--rotations、--boxscore 可用 --precision 0.005 或 --sprt 0.02 [--alpha 0.05] [--beta 0.05] 代替 --matches，"
+                     "另有 [--round 200] [--max-matches 1000000]；也可加 --processes 4 [--shards 16] 分到多个进程，"
+                     "或 --lanes 8 每个线程交错推进多场）" << std::endl;
+        std::cerr << "      VolleyballSimulation --export [--format arrow|csv] [--matches 1000] [--seed 1] [--threads 0] [--out sim]" << std::endl;
+        std::cerr << "      VolleyballSimulation --jsonl [--matches 1000] [--seed 1] [--threads 0] [--out -]" << std::endl;
+        std::cerr << "      VolleyballSimulation --serve [--socket volleyball.sock] [--threads 0] [--max-clients 64] [--max-queued 2000000] [--cache 目录]" << std::endl;
+        std::cerr << "      VolleyballSimulation --player add 球员数据 | update 姓名 球员数据 | remove 姓名 | compact" << std::endl;
+        std::cerr << "      VolleyballSimulation --trace 模块列表 [--seed 1] [--match 0] [--out trace.txt]" << std::endl;
+        std::cerr << "      VolleyballSimulation --live [--seed 1] [--match 0] [--threads 0] [--repeat 200]" << std::endl;
+        return 1;
+    }
+}
+
+int runCommandLine(int argc, char** argv) {
+    if (argc < 2) return -1;
+
+    std::string command = argv[1];
+    try {
+        return runCommand(command, argc, argv);
+    } catch (const ArgumentError& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
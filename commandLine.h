@@ -0,0 +1,15 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+// 命令行（无界面）模式
+// 用法：VolleyballSimulation --sweep sweep.cfg [--out 结果.csv]
+//       VolleyballSimulation --calibrate calibrate.cfg [--out calibrated.cfg]
+//       VolleyballSimulation --lineup A|B [--round 100] [--matches 2000] [--seed 1] [--threads 0]
+// 返回 -1 表示没有命令行参数，应进入图形界面
+int runCommandLine(int argc, char** argv);
+
+#endif //COMMANDLINE_H
@@ -13,25 +13,12 @@
 
 #define PRE_SEED 0                        // 设置种子（0为不设置）
 
-// ============ 全局调试开关 ============
-// 设为1启用调试信息，设为0禁用
+// ============ 调试信息 ============
+// 各模块的调试信息改为运行时开关（见 trace.h）：
+//   界面模式：设置环境变量 VOLLEYBALL_TRACE=serve,block（或 all），每球结束后输出到控制台
+//   命令行：VolleyballSimulation --trace 模块列表 [--seed 1] [--match 0] 追踪单场比赛
 
-#define DEBUG_ALL 0 // 主开关，设为1启用所有调试信息
-
-// 各模块调试开关
-#define DEBUG_BLOCK (DEBUG_ALL || 0)       // 拦网模块
-#define DEBUG_SERVE (DEBUG_ALL || 0)       // 发球模块
-#define DEBUG_RECEIVE (DEBUG_ALL || 0)     // 接一模块
-#define DEBUG_SETBALL (DEBUG_ALL || 0)     // 二传模块
-#define DEBUG_SPIKE (DEBUG_ALL || 0)       // 扣球模块
-#define DEBUG_DEFENSE (DEBUG_ALL || 0)     // 防守模块
-#define DEBUG_GAME (DEBUG_ALL || 0)        // 比赛流程
-
-#define DEBUG_MENTAL_CALC (DEBUG_ALL || 0)   // 心理参数计算
-
-// 其他配置
-
-#define PAUSE_FOR_READ (DEBUG_ALL || 0)    // 是否在每个回合后暂停
+#define PAUSE_FOR_READ 0                  // 是否在每个回合后暂停
 
 // ============   特殊规则   ============
 
@@ -40,10 +27,11 @@
 
 // ============ 游戏平衡参数 ============
 // 这些参数可以在运行时调整来平衡游戏
+// 此处的宏仅作为默认值，运行时以 balance.cfg 为准（见 balanceConfig.h）
 // 由于内容过多，且部分参数计算较复杂，故仅开放了一部分调整系数
 
-// 二次进攻失误率 (0.0-1.0)
-#define DUMP_ERROR_RATE 0.25
+// 二次进攻基础失误率 (0.0-1.0)
+#define DUMP_ERROR_RATE 0.15
 
 // 最大攻防回合数（防止无限循环）
 #define MAX_RALLY_COUNT 500
@@ -4,10 +4,21 @@
 
 #include "defense.h"
 #include "config.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <algorithm>
 #include <vector>
 #include <cmath>
-#include <iostream>
+
+namespace {
+    // 本队下标为 index 的球员是否参与了拦网
+    bool isBlocker(const BlockResultInfo& blockResult, int index) {
+        for (int i = 0; i < blockResult.blockerCount; i++) {
+            if (blockResult.blockers[i] == index) return true;
+        }
+        return false;
+    }
+}
 
 
 // 构造函数
@@ -38,66 +49,50 @@ bool Defender::isBackRowPlayer(const Player& player, int teamID) {
     return false;
 }
 
-// 获取可用的防守球员（排除拦网球员）
-std::vector<int> Defender::getAvailableDefenders(const BlockResultInfo& blockResult) {
+// 获取可用的防守球员（排除拦网球员），场上位置写入 availableDefenders，返回人数
+int Defender::getAvailableDefenders(const BlockResultInfo& blockResult, int availableDefenders[6]) {
     const int* rotation = getRotation(defendingTeam);
     const Player* team = getTeamPlayers(defendingTeam);
-    std::vector<int> availableDefenders;
+    int count = 0;
 
-    // 所有后排球员都可以防守
+    // 所有后排球员都可以防守（参与拦网的除外）
     for (int i : {0, 4, 5}) {
-        // 检查该球员是否参与拦网
-        bool isBlocker = false;
-        for (const auto& blocker : blockResult.blockers) {
-            if (team[rotation[i]].name == blocker.name) {
-                isBlocker = true;
-                break;
-            }
-        }
-
-        if (!isBlocker) {
-            availableDefenders.push_back(i);
+        if (!isBlocker(blockResult, rotation[i])) {
+            availableDefenders[count++] = i;
         }
     }
 
     // 如果可用防守球员太少，添加一些前排球员（除了拦网球员）
-    if (availableDefenders.size() < 2) {
+    if (count < 2) {
         for (int i : {1, 2, 3}) {
-            bool isBlocker = false;
-            for (const auto& blocker : blockResult.blockers) {
-                if (team[rotation[i]].name == blocker.name) {
-                    isBlocker = true;
-                    break;
-                }
-            }
-
-            if (!isBlocker && team[rotation[i]].position != "S" &&
+            if (!isBlocker(blockResult, rotation[i]) && team[rotation[i]].position != "S" &&
                 team[rotation[i]].position != "二传") {
                 // 前排非二传球员也可以参与防守
-                availableDefenders.push_back(i);
+                availableDefenders[count++] = i;
             }
         }
     }
 
-    return availableDefenders;
+    return count;
 }
 
-// 选择防守球员
-Player Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeResult& spikeResult) {
+// 选择防守球员，返回在本队的下标
+int Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeResult& spikeResult) {
     const int* rotation = getRotation(defendingTeam);
     const Player* team = getTeamPlayers(defendingTeam);
 
     // 获取可用防守球员
-    std::vector<int> availableDefenders = getAvailableDefenders(blockResult);
+    int availableDefenders[6];
+    int availableCount = getAvailableDefenders(blockResult, availableDefenders);
 
-    if (availableDefenders.empty()) {
+    if (availableCount == 0) {
         // 如果没有可用防守球员，返回自由人或第一个后排球员
         for (int i : {0, 4, 5}) {
             if (team[rotation[i]].position == "L" || team[rotation[i]].position == "自由人") {
-                return team[rotation[i]];
+                return rotation[i];
             }
         }
-        return team[rotation[0]]; // 返回第一个球员
+        return rotation[0]; // 返回第一个球员
     }
 
     // 根据扣球类型决定防守球员选择
@@ -105,20 +100,12 @@ Player Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeR
     if (spikeResult.strategy == DROP_SHOT || spikeResult.strategy == SETTER_SPIKE) {
         // 优先选择前排非拦网球员
         for (int i : {1, 2, 3}) {
-            bool isBlocker = false;
-            for (const auto& blocker : blockResult.blockers) {
-                if (team[rotation[i]].name == blocker.name) {
-                    isBlocker = true;
-                    break;
-                }
-            }
-
-            if (!isBlocker &&
+            if (!isBlocker(blockResult, rotation[i]) &&
                 (team[rotation[i]].position == "OH" ||
                  team[rotation[i]].position == "主攻" ||
                  team[rotation[i]].position == "OP" ||
                  team[rotation[i]].position == "接应")) {
-                return team[rotation[i]];
+                return rotation[i];
             }
         }
     }
@@ -128,9 +115,9 @@ Player Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeR
     for (int i : {0, 4, 5}) {
         if (team[rotation[i]].position == "L" || team[rotation[i]].position == "自由人") {
             // 检查是否是可用防守球员
-            for (int idx : availableDefenders) {
-                if (idx == i) {
-                    return team[rotation[i]];
+            for (int k = 0; k < availableCount; k++) {
+                if (availableDefenders[k] == i) {
+                    return rotation[i];
                 }
             }
         }
@@ -140,7 +127,7 @@ Player Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeR
     int bestDefenderIdx = availableDefenders[0];
     int bestDefense = team[rotation[bestDefenderIdx]].defense;
 
-    for (size_t i = 1; i < availableDefenders.size(); i++) {
+    for (int i = 1; i < availableCount; i++) {
         int idx = availableDefenders[i];
         if (team[rotation[idx]].defense > bestDefense) {
             bestDefense = team[rotation[idx]].defense;
@@ -148,16 +135,16 @@ Player Defender::selectDefender(const BlockResultInfo& blockResult, const SpikeR
         }
     }
 
-    #if DEBUG_DEFENSE
-    std::cout << "\n=== 防守球员选择调试信息 ===" << std::endl;
-    std::cout << "扣球类型: " << (spikeResult.strategy == DROP_SHOT ? "吊球" : "扣球") << std::endl;
-    std::cout << "可用防守球员数量: " << availableDefenders.size() << std::endl;
-    std::cout << "选择球员: " << team[rotation[bestDefenderIdx]].name << std::endl;
-    std::cout << "防守属性: " << bestDefense << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 防守球员选择调试信息 ===");
+        traceWrite(TRACE_DEFENSE, "扣球类型: {}", (spikeResult.strategy == DROP_SHOT ? "吊球" : "扣球"));
+        traceWrite(TRACE_DEFENSE, "可用防守球员数量: {}", availableCount);
+        traceWrite(TRACE_DEFENSE, "选择球员: {}", team[rotation[bestDefenderIdx]].name);
+        traceWrite(TRACE_DEFENSE, "防守属性: {}", bestDefense);
+        traceWrite(TRACE_DEFENSE, "===========================");
+    }
 
-    return team[rotation[bestDefenderIdx]];
+    return rotation[bestDefenderIdx];
 }
 
 // 计算防守调整系数
@@ -191,20 +178,19 @@ double Defender::calculateDefenseAdjustment(const Player& defender, DefenseType
         adjustment *= (0.6 + 0.6 * concentrationEffect);
     }
 
-    #if DEBUG_DEFENSE
-    std::cout << "\n=== 防守调整系数调试信息 ===" << std::endl;
-    std::cout << "防守球员: " << defender.name << " 防守类型: " <<
-        (defenseType == DEFENSE_BLOCK_BACK ? "拦回球防守" : "扣球防守") << std::endl;
-    std::cout << "1. 耐力影响: " << staminaEffect << " * 疲劳系数 " << setFatigue << " = " << staminaAdjustment << std::endl;
-    std::cout << "2. 心理素质影响: " << pressureEffect << " => " << pressureAdjustment << std::endl;
-    std::cout << "3. 专注度影响: " << concentrationEffect << " => " << concentrationAdjustment << std::endl;
-    std::cout << "4. 团队协作影响: " << teamworkEffect << " => " << teamworkAdjustment << std::endl;
-    if (defenseType == DEFENSE_BLOCK_BACK) {
-        std::cout << "5. 拦回球专注度加成: " << (0.6 + 0.6 * concentrationEffect) << std::endl;
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 防守调整系数调试信息 ===");
+        traceWrite(TRACE_DEFENSE, "防守球员: {} 防守类型: {}", defender.name, (defenseType == DEFENSE_BLOCK_BACK ? "拦回球防守" : "扣球防守"));
+        traceWrite(TRACE_DEFENSE, "1. 耐力影响: {} * 疲劳系数 {} = {}", staminaEffect, setFatigue, staminaAdjustment);
+        traceWrite(TRACE_DEFENSE, "2. 心理素质影响: {} => {}", pressureEffect, pressureAdjustment);
+        traceWrite(TRACE_DEFENSE, "3. 专注度影响: {} => {}", concentrationEffect, concentrationAdjustment);
+        traceWrite(TRACE_DEFENSE, "4. 团队协作影响: {} => {}", teamworkEffect, teamworkAdjustment);
+        if (defenseType == DEFENSE_BLOCK_BACK) {
+            traceWrite(TRACE_DEFENSE, "5. 拦回球专注度加成: {}", (0.6 + 0.6 * concentrationEffect));
+        }
+        traceWrite(TRACE_DEFENSE, "最终调整系数: {}", adjustment);
+        traceWrite(TRACE_DEFENSE, "===========================");
     }
-    std::cout << "最终调整系数: " << adjustment << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
 
     return std::max(0.3, adjustment);
 }
@@ -228,105 +214,103 @@ DefenseQuality Defender::calculateDefenseQuality(const Player& defender, int bal
     double defenseSuccessRate = baseDefenseAbility / 100.0 * adjustment * (1.0 - difficultyPenalty);
 
     // 添加随机因素
-    double randomEffect = (rand() % 20 - 10) / 100.0;
+    double randomEffect = (simRandBelow(20) - 10) / 100.0;
     defenseSuccessRate += randomEffect;
     defenseSuccessRate = std::max(0.0, std::min(1.0, defenseSuccessRate));
 
     // 根据成功率决定防守质量
-    double randomValue = (rand() % 100) / 100.0;
-
-    #if DEBUG_DEFENSE
-    std::cout << "\n=== 防守质量计算调试信息 ===" << std::endl;
-    std::cout << "防守球员: " << defender.name << " 基础防守能力: " << baseDefenseAbility << std::endl;
-    std::cout << "球的力量: " << ballPower << " 球难度系数: " << ballDifficulty << std::endl;
-    std::cout << "调整系数: " << adjustment << std::endl;
-    std::cout << "计算成功率: " << baseDefenseAbility / 100.0 << " * " << adjustment << " * " << (1.0 - ballDifficulty * 0.4) << " = " << defenseSuccessRate - randomEffect << std::endl;
-    std::cout << "随机影响: " << randomEffect << std::endl;
-    std::cout << "最终成功率: " << defenseSuccessRate << std::endl;
-    std::cout << "随机判定值: " << randomValue << std::endl;
-    #endif
+    double randomValue = simRollPercent(SIM_TILT_DEFENSE, defendingTeam, defenseSuccessRate) / 100.0;
+
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 防守质量计算调试信息 ===");
+        traceWrite(TRACE_DEFENSE, "防守球员: {} 基础防守能力: {}", defender.name, baseDefenseAbility);
+        traceWrite(TRACE_DEFENSE, "球的力量: {} 球难度系数: {}", ballPower, ballDifficulty);
+        traceWrite(TRACE_DEFENSE, "调整系数: {}", adjustment);
+        traceWrite(TRACE_DEFENSE, "计算成功率: {} * {} * {} = {}", baseDefenseAbility / 100.0, adjustment, (1.0 - ballDifficulty * 0.4), defenseSuccessRate - randomEffect);
+        traceWrite(TRACE_DEFENSE, "随机影响: {}", randomEffect);
+        traceWrite(TRACE_DEFENSE, "最终成功率: {}", defenseSuccessRate);
+        traceWrite(TRACE_DEFENSE, "随机判定值: {}", randomValue);
+    }
 
     if (defenseType == DEFENSE_BLOCK_BACK) {
         // 拦回球更难防守，质量分布会向下偏移
         if (randomValue < defenseSuccessRate * 0.2) {
-            qualityValue = 80 + rand() % 16; // 80-95
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 拦回球" << std::endl;
-            std::cout << "完美防守阈值: " << defenseSuccessRate * 0.2 << std::endl;
-            std::cout << "防守质量: 完美防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 80 + simRandBelow(16); // 80-95
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 拦回球");
+                traceWrite(TRACE_DEFENSE, "完美防守阈值: {}", defenseSuccessRate * 0.2);
+                traceWrite(TRACE_DEFENSE, "防守质量: 完美防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_PERFECT;
         } else if (randomValue < defenseSuccessRate * 0.5) {
-            qualityValue = 60 + rand() % 20; // 60-79
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 拦回球" << std::endl;
-            std::cout << "良好防守阈值: " << defenseSuccessRate * 0.5 << std::endl;
-            std::cout << "防守质量: 良好防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 60 + simRandBelow(20); // 60-79
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 拦回球");
+                traceWrite(TRACE_DEFENSE, "良好防守阈值: {}", defenseSuccessRate * 0.5);
+                traceWrite(TRACE_DEFENSE, "防守质量: 良好防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_GOOD;
         } else if (randomValue < defenseSuccessRate) {
-            qualityValue = 30 + rand() % 30; // 30-59
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 拦回球" << std::endl;
-            std::cout << "较差防守阈值: " << defenseSuccessRate << std::endl;
-            std::cout << "防守质量: 较差防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 30 + simRandBelow(30); // 30-59
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 拦回球");
+                traceWrite(TRACE_DEFENSE, "较差防守阈值: {}", defenseSuccessRate);
+                traceWrite(TRACE_DEFENSE, "防守质量: 较差防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_BAD;
         } else {
             qualityValue = 0;
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 拦回球" << std::endl;
-            std::cout << "防守质量: 失误" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 拦回球");
+                traceWrite(TRACE_DEFENSE, "防守质量: 失误");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_FAULT;
         }
     } else {
         // 正常扣球防守
         if (randomValue < defenseSuccessRate * 0.3) {
-            qualityValue = 90 + rand() % 11; // 90-100
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 扣球" << std::endl;
-            std::cout << "完美防守阈值: " << defenseSuccessRate * 0.3 << std::endl;
-            std::cout << "防守质量: 完美防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 90 + simRandBelow(11); // 90-100
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 扣球");
+                traceWrite(TRACE_DEFENSE, "完美防守阈值: {}", defenseSuccessRate * 0.3);
+                traceWrite(TRACE_DEFENSE, "防守质量: 完美防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_PERFECT;
         } else if (randomValue < defenseSuccessRate * 0.7) {
-            qualityValue = 70 + rand() % 20; // 70-89
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 扣球" << std::endl;
-            std::cout << "良好防守阈值: " << defenseSuccessRate * 0.7 << std::endl;
-            std::cout << "防守质量: 良好防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 70 + simRandBelow(20); // 70-89
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 扣球");
+                traceWrite(TRACE_DEFENSE, "良好防守阈值: {}", defenseSuccessRate * 0.7);
+                traceWrite(TRACE_DEFENSE, "防守质量: 良好防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_GOOD;
         } else if (randomValue < defenseSuccessRate) {
-            qualityValue = 40 + rand() % 30; // 40-69
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 扣球" << std::endl;
-            std::cout << "较差防守阈值: " << defenseSuccessRate << std::endl;
-            std::cout << "防守质量: 较差防守" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            qualityValue = 40 + simRandBelow(30); // 40-69
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 扣球");
+                traceWrite(TRACE_DEFENSE, "较差防守阈值: {}", defenseSuccessRate);
+                traceWrite(TRACE_DEFENSE, "防守质量: 较差防守");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_BAD;
         } else {
             qualityValue = 0;
-            #if DEBUG_DEFENSE
-            std::cout << "防守类型: 扣球" << std::endl;
-            std::cout << "防守质量: 失误" << std::endl;
-            std::cout << "质量值: " << qualityValue << std::endl;
-            #endif
+            if (traceOn(TRACE_DEFENSE)) {
+                traceWrite(TRACE_DEFENSE, "防守类型: 扣球");
+                traceWrite(TRACE_DEFENSE, "防守质量: 失误");
+                traceWrite(TRACE_DEFENSE, "质量值: {}", qualityValue);
+            }
             return DEFENSE_FAULT;
         }
     }
 
-    #if DEBUG_DEFENSE
-    std::cout << "===========================" << std::endl;
-    #endif
+    TRACE(TRACE_DEFENSE, "===========================");
 }
 
 // 模拟防守扣球
@@ -358,23 +342,16 @@ DefenseResult Defender::simulateDefenseAgainstSpike(const SpikeResult& spikeResu
         break;
     }
 
-#if DEBUG_DEFENSE
-    std::cout << "\n\n=== 扣球防守模拟开始 ===" << std::endl;
-    std::cout << "扣球力量: " << spikeResult.spikePower << std::endl;
-    std::cout << "拦网结果: ";
-    switch(blockResult.result) {
-    case BLOCK_BREAK: std::cout << "破坏"; break;
-    case NO_TOUCH: std::cout << "无接触"; break;
-    case LIMIT_PATH: std::cout << "限制球路"; break;
-    case BLOCK_TOUCH: std::cout << "撑起"; break;
-    case BLOCK_BACK: std::cout << "拦回"; break;
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 扣球防守模拟开始 ===");
+        traceWrite(TRACE_DEFENSE, "扣球力量: {}", spikeResult.spikePower);
+        traceWrite(TRACE_DEFENSE, "拦网结果: {}", blockResultName(blockResult.result));
+        traceWrite(TRACE_DEFENSE, "实际防守球力量: {}", result.ballPower);
     }
-    std::cout << std::endl;
-    std::cout << "实际防守球力量: " << result.ballPower << std::endl;
-#endif
 
     // 选择防守球员
-    result.defender = selectDefender(blockResult, spikeResult);
+    result.defenderIndex = selectDefender(blockResult, spikeResult);
+    result.defender = getTeamPlayers(defendingTeam)[result.defenderIndex];
 
     // 计算防守质量
     result.quality = calculateDefenseQuality(result.defender, result.ballPower, DEFENSE_SPIKE, result.qualityValue);
@@ -395,17 +372,14 @@ DefenseResult Defender::simulateDefenseAgainstSpike(const SpikeResult& spikeResu
             break;
     }
 
-    #if DEBUG_DEFENSE
-    std::cout << "\n=== 扣球防守结果 ===" << std::endl;
-    std::cout << "防守球员: " << result.defender.name << std::endl;
-    std::cout << "防守质量: " <<
-        (result.quality == DEFENSE_PERFECT ? "完美防守" :
-         result.quality == DEFENSE_GOOD ? "良好防守" :
-         result.quality == DEFENSE_BAD ? "较差防守" : "失误") << std::endl;
-    std::cout << "质量值: " << result.qualityValue << std::endl;
-    std::cout << "结果描述: " << result.description << std::endl;
-    std::cout << "=== 扣球防守模拟结束 ===\n" << std::endl;
-    #endif
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 扣球防守结果 ===");
+        traceWrite(TRACE_DEFENSE, "防守球员: {}", result.defender.name);
+        traceWrite(TRACE_DEFENSE, "防守质量: {}", (result.quality == DEFENSE_PERFECT ? "完美防守" : result.quality == DEFENSE_GOOD ? "良好防守" : result.quality == DEFENSE_BAD ? "较差防守" : "失误"));
+        traceWrite(TRACE_DEFENSE, "质量值: {}", result.qualityValue);
+        traceWrite(TRACE_DEFENSE, "结果描述: {}", result.description);
+        traceWrite(TRACE_DEFENSE, "=== 扣球防守模拟结束 ===");
+    }
 
     return result;
 }
@@ -418,10 +392,10 @@ DefenseResult Defender::simulateDefenseAgainstBlockBack(const BlockResultInfo& b
     // 使用拦回强度
     result.ballPower = blockResult.blockBackPower;
 
-    #if DEBUG_DEFENSE
-    std::cout << "\n\n=== 拦回球防守模拟开始 ===" << std::endl;
-    std::cout << "拦回球力量: " << result.ballPower << std::endl;
-    #endif
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 拦回球防守模拟开始 ===");
+        traceWrite(TRACE_DEFENSE, "拦回球力量: {}", result.ballPower);
+    }
 
     // 创建虚拟的扣球结果用于选择防守球员
     SpikeResult dummySpikeResult;
@@ -429,7 +403,8 @@ DefenseResult Defender::simulateDefenseAgainstBlockBack(const BlockResultInfo& b
     dummySpikeResult.spikePower = result.ballPower;
 
     // 选择防守球员
-    result.defender = selectDefender(blockResult, dummySpikeResult);
+    result.defenderIndex = selectDefender(blockResult, dummySpikeResult);
+    result.defender = getTeamPlayers(defendingTeam)[result.defenderIndex];
 
     // 计算防守质量（拦回球更难防守）
     result.quality = calculateDefenseQuality(result.defender, result.ballPower, DEFENSE_BLOCK_BACK, result.qualityValue);
@@ -450,32 +425,26 @@ DefenseResult Defender::simulateDefenseAgainstBlockBack(const BlockResultInfo& b
             break;
     }
 
-    #if DEBUG_DEFENSE
-    std::cout << "\n=== 拦回球防守结果 ===" << std::endl;
-    std::cout << "防守球员: " << result.defender.name << std::endl;
-    std::cout << "防守质量: " <<
-        (result.quality == DEFENSE_PERFECT ? "完美防守" :
-         result.quality == DEFENSE_GOOD ? "良好防守" :
-         result.quality == DEFENSE_BAD ? "较差防守" : "失误") << std::endl;
-    std::cout << "质量值: " << result.qualityValue << std::endl;
-    std::cout << "结果描述: " << result.description << std::endl;
-    std::cout << "=== 拦回球防守模拟结束 ===\n" << std::endl;
-    #endif
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 拦回球防守结果 ===");
+        traceWrite(TRACE_DEFENSE, "防守球员: {}", result.defender.name);
+        traceWrite(TRACE_DEFENSE, "防守质量: {}", (result.quality == DEFENSE_PERFECT ? "完美防守" : result.quality == DEFENSE_GOOD ? "良好防守" : result.quality == DEFENSE_BAD ? "较差防守" : "失误"));
+        traceWrite(TRACE_DEFENSE, "质量值: {}", result.qualityValue);
+        traceWrite(TRACE_DEFENSE, "结果描述: {}", result.description);
+        traceWrite(TRACE_DEFENSE, "=== 拦回球防守模拟结束 ===");
+    }
 
     return result;
 }
 
 // 统一的防守模拟函数
 DefenseResult Defender::simulateDefense(const SpikeResult& spikeResult, const BlockResultInfo& blockResult) {
-    #if DEBUG_DEFENSE
-    std::cout << "\n\n=== 统一防守模拟开始 ===" << std::endl;
-    std::cout << "防守方: " << defendingTeam << " 进攻方: " << attackingTeam << std::endl;
-    std::cout << "当前局数: " << gameState.setNum << std::endl;
-    std::cout << "拦网结果: " <<
-        (blockResult.result == BLOCK_TOUCH ? "撑起" :
-         blockResult.result == BLOCK_BACK ? "拦回" :
-         "无接触") << std::endl;
-    #endif
+    if (traceOn(TRACE_DEFENSE)) {
+        traceWrite(TRACE_DEFENSE, "=== 统一防守模拟开始 ===");
+        traceWrite(TRACE_DEFENSE, "防守方: {} 进攻方: {}", defendingTeam, attackingTeam);
+        traceWrite(TRACE_DEFENSE, "当前局数: {}", gameState.setNum);
+        traceWrite(TRACE_DEFENSE, "拦网结果: {}", (blockResult.result == BLOCK_TOUCH ? "撑起" : blockResult.result == BLOCK_BACK ? "拦回" : "无接触"));
+    }
 
     if (blockResult.result == BLOCK_BACK) {
         // 防守拦回球
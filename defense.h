@@ -22,6 +22,7 @@ struct DefenseResult {
     DefenseQuality quality;     // 防守质量
     int qualityValue;           // 防守质量数值（0-100）
     Player defender;           // 防守球员
+    int defenderIndex;         // 防守球员在本队的下标
     std::string description;   // 防守结果描述
     bool isSetterDump;         // 是否为拦回球（需要额外处理）
     int ballPower;             // 球的力量（扣球强度或拦回强度）
@@ -39,8 +40,8 @@ public:
     // 构造函数
     Defender(const GameState& gameState, int defendingTeam, int attackingTeam);
 
-    // 选择防守球员
-    Player selectDefender(const BlockResultInfo& blockResult, const SpikeResult& spikeResult);
+    // 选择防守球员，返回在本队的下标
+    int selectDefender(const BlockResultInfo& blockResult, const SpikeResult& spikeResult);
 
     // 计算防守调整系数
     double calculateDefenseAdjustment(const Player& defender, DefenseType defenseType);
@@ -66,7 +67,7 @@ private:
     const Player* getTeamPlayers(int teamID);
     const int* getRotation(int teamID);
     bool isBackRowPlayer(const Player& player, int teamID);
-    std::vector<int> getAvailableDefenders(const BlockResultInfo& blockResult);
+    int getAvailableDefenders(const BlockResultInfo& blockResult, int availableDefenders[6]);
 };
 
 #endif // DEFENSE_H
\ No newline at end of file
@@ -2,6 +2,23 @@
 #define GAME_H
 
 #include "player.h"
+#include "boxScore.h"
+#include <functional>
+#include <vector>
+
+struct ReceiveResult;
+struct RallyState;
+
+// 一球的结束方式（统计用）
+enum RallyEnd {
+    RALLY_SERVE_FAULT,   // 发球失误
+    RALLY_ACE,           // 发球直接得分（接飞）
+    RALLY_SET_FAULT,     // 传球失误
+    RALLY_ATTACK_FAULT,  // 扣球（含二次进攻）失误
+    RALLY_ATTACK_POINT,  // 扣球得分（防守失误）
+    RALLY_BLOCK_POINT,   // 拦网得分（拦回球防守失误）
+    RALLY_LIMIT          // 超过最大回合数，随机决定
+};
 
 // 比赛状态结构体
 struct GameState {
@@ -16,11 +33,81 @@ struct GameState {
     int scoredA[7] = {0}, scoredB[7] = {0};//得分统计
     int faultA[7] = {0}, faultB[7] = {0};  //失误统计
 
+    BoxScore* box = nullptr;               // 技术统计，为空时不统计
+    RallyEnd lastRallyEnd = RALLY_LIMIT;   // 最近一球的结束方式
+    int lastRallyAttacks = 0;              // 最近一球的进攻次数
+    int lastRallyTouches = 0;              // 最近一球的触球次数（回合长度，拦网未触球不算）
+};
+
+// 某一轮次组合下的统计（轮次以二传所在位置计，0-5 对应 1-6 号位）
+struct RotationStats {
+    long long points = 0;                  // 打的球数
+    long long sideOuts = 0;                // 接发球方得分次数（其余为发球方破发得分）
+    long long receptions = 0;              // 接发球进入攻防的次数（不含发球失误和接飞）
+    long long firstBallKills = 0;          // 接发球后第一次进攻直接得分
+    long long attacks = 0;                 // 进攻次数
+    long long touches = 0;                 // 触球次数（各球回合长度之和）
+
+    void add(const RotationStats& other);
+};
+
+// 逐球记录（导出用）
+struct PointRecord {
+    int setNum, rally;                     // 局数，本局第几球（从1开始）
+    int scoreA, scoreB;                    // 发球前比分
+    int serveSide, scorer;
+    int serveRotation, receiveRotation;    // 发球方、接发球方轮次（同 RotationStats）
+    RallyEnd end;
+    int attacks;
+    int touches;                           // 回合长度（触球次数）
+};
+
+// 比赛结果汇总（可累加多场）。
+// 按缓存行对齐，批量模拟时每个线程一份累加器放在数组中也不会伪共享
+struct alignas(64) MatchStats {
+    long long matches = 0, winsA = 0;
+    long long sets = 0, rallies = 0;
+    long long setsA = 0;                   // A队赢的局数
+    long long pointsA = 0, pointsB = 0;    // 双方总得分
+    long long aces = 0, serveFaults = 0;
+    long long sideOuts = 0;                // 接发球方得分次数
+    long long attacks = 0;                 // 进攻次数
+    long long touches = 0;                 // 触球次数（各球回合长度之和）
+    long long attackPoints = 0;            // 扣球得分次数
+    long long blockPoints = 0;             // 拦网得分次数
+
+    RotationStats rotations[2][6][6];      // [发球方][发球方轮次][接发球方轮次]
+    BoxScore box;                          // 球员技术统计
+
+    void add(const MatchStats& other);
+};
+
+// 回合观察者（批量分析用）：每球发球前、一球中每次组织进攻（轮到二传）前调用。
+// 观察者只能读取或复制传入的状态另行推演，不能修改；另行推演时应先关闭观察者
+struct RallyObserver {
+    std::function<void(const GameState&)> beforeRally;
+    std::function<void(const GameState&, const RallyState&)> beforeAttack;
 };
 
 // 函数声明
 void newGame();
 void rotateTeam(GameState& game, int teamID);  //轮转
-int playSet(int target, GameState& game);      //一局比赛
+int playSet(GameState& game);                  //一局比赛
+void initRotation(GameState& game);            //每局开始时初始化轮转与自由人（需先设置serveSide）
+int setTarget(int setNum);                     //该局的目标分（决胜局15分，其余25分）
+bool setFinished(const GameState& game);       //当前局是否已分出胜负（达到目标分且领先2分）
+void startSet(GameState& game, int setNum, int serveSide);  //开始新的一局：比分清零、设定发球方并初始化轮转
+int advanceSet(GameState& game, int& setsA, int& setsB, int secondServe, int thirdServe);  //一局结束后记入局分，比赛未结束时开始下一局；返回本局胜方
+void applyRallyResult(GameState& game, int scorer);  //记分、换发与轮转
+int processRallyFromServe(GameState& game);  //从发球打完一球，返回得分方
+int playAttackPhase(GameState& game, int& attackingTeam, int& defendingTeam, ReceiveResult& receive);  //一次进攻（二传到防守），球未落地返回-1
+PlayerBox* boxOf(GameState& game, int teamID, int index);  //某名球员的技术统计，未开启时返回nullptr
+int simulateMatch(MatchStats& stats, std::vector<PointRecord>* points = nullptr);  //无界面模拟一场比赛（三局两胜），返回胜方；points 非空时追加逐球记录
+void addPointStats(MatchStats& stats, const PointRecord& point);  //把一球计入比赛统计（不含技术统计）
+int findSetter(const Player team[7]);          //二传在队中的下标，没有时返回-1
+int setterRotation(const int rotate[6], int setter);  //当前轮次（二传所在位置0-5）
+void setUIEventsEnabled(bool enabled);         //当前线程是否输出比赛事件（批量模拟时关闭）
+void setUIEventSink(std::vector<std::string>* sink);  //当前线程的比赛事件改为追加到 sink（nullptr 恢复输出到界面）
+void setRallyObserver(RallyObserver* observer);  //当前线程的回合观察者（nullptr 关闭）
 
 #endif
\ No newline at end of file
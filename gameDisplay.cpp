@@ -1,5 +1,9 @@
 // gameDisplay.cpp
 #include "gameDisplay.h"
+#include "balanceConfig.h"
+#include "batchSim.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -7,25 +11,59 @@
 #include <ctime>
 #include <filesystem>
 #include <mutex>
-
-// forward declaration of internal function defined in game.cpp
-extern int processRallyFromServe(GameState& game);
+#include <cstdarg>
+#include <cstdio>
 
 // === 全局 UI 日志桥接：供 game.cpp 调用 ===
 namespace {
     std::mutex g_uiLogMutex;
     std::vector<std::string> g_uiLogBuffer; // 每回合详细步骤
+    thread_local bool t_uiEventsEnabled = true; // 批量模拟线程关闭
+    thread_local std::vector<std::string>* t_uiEventSink = nullptr; // 看板后台线程各自收集
+}
+
+void setUIEventsEnabled(bool enabled) {
+    t_uiEventsEnabled = enabled;
+}
+
+void setUIEventSink(std::vector<std::string>* sink) {
+    t_uiEventSink = sink;
 }
 
 void emitUIEvent(const char* msg) {
-    if (!msg) return;
+    if (!msg || !t_uiEventsEnabled) return;
+    if (t_uiEventSink) {
+        t_uiEventSink->emplace_back(msg);
+        return;
+    }
     std::lock_guard<std::mutex> lk(g_uiLogMutex);
     g_uiLogBuffer.emplace_back(msg);
 }
 
+// 带格式化的版本：事件关闭时（批量模拟）直接返回，连 vsnprintf 都不做
+void emitUIEventf(const char* format, ...) {
+    if (!t_uiEventsEnabled) return;
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    emitUIEvent(buffer);
+}
+
 namespace {
     // 本文件本地回合数，避免修改 game.h
     static int g_roundNum = 1;
+
+    // 按 UTF-8 字符截断，避免看板上的长事件超出卡片
+    std::string truncateUtf8(const std::string& text, size_t maxChars) {
+        size_t chars = 0;
+        for (size_t i = 0; i < text.size(); i++) {
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) == 0x80) continue;
+            if (chars++ == maxChars) return text.substr(0, i) + "…";
+        }
+        return text;
+    }
 }
 
 GameDisplay::GameDisplay(int width, int height)
@@ -49,6 +87,8 @@ GameDisplay::GameDisplay(int width, int height)
 }
 
 GameDisplay::~GameDisplay() {
+    stopBalanceWatcher();
+    releaseDashboard();
     if (fontLarge) TTF_CloseFont(fontLarge);
     if (fontMedium) TTF_CloseFont(fontMedium);
     if (fontSmall) TTF_CloseFont(fontSmall);
@@ -147,6 +187,10 @@ bool GameDisplay::init() {
     // 预加载队伍数据，避免任何界面看到全0
     ensureTeamsLoaded();
 
+    // 载入平衡参数并监视修改，新参数在下一场比赛开始时生效
+    reloadBalance("balance.cfg", std::cout);
+    startBalanceWatcher("balance.cfg");
+
     // 初始化主菜单
     initMainMenu();
 
@@ -155,13 +199,15 @@ bool GameDisplay::init() {
 
 void GameDisplay::initMainMenu() {
     buttons.clear();
-    buttons.push_back(Button(550, 250, 300, 80, "开始新游戏"));
-    buttons.push_back(Button(550, 370, 300, 80, "加载游戏"));
-    buttons.push_back(Button(550, 490, 300, 80, "设置"));
-    buttons.push_back(Button(550, 610, 300, 80, "退出"));
+    buttons.push_back(Button(550, 220, 300, 80, "开始新游戏"));
+    buttons.push_back(Button(550, 330, 300, 80, "多场看板"));
+    buttons.push_back(Button(550, 440, 300, 80, "加载游戏"));
+    buttons.push_back(Button(550, 550, 300, 80, "设置"));
+    buttons.push_back(Button(550, 660, 300, 80, "退出"));
 
     buttons[0].onClick = [this]() { currentScreen = SCREEN_TEAM_SETUP; initTeamSetup(); };
-    buttons[3].onClick = [this]() { running = false; };
+    buttons[1].onClick = [this]() { initDashboard(9); };
+    buttons[4].onClick = [this]() { running = false; };
 }
 
 void GameDisplay::initTeamSetup() {
@@ -367,6 +413,12 @@ void GameDisplay::setupGameRunningButtons() {
         initMatchState();
         setupGameRunningButtons();
     };
+
+    // 快进按钮：剩余的球不播放，只显示结果
+    buttons.push_back(Button(400, 800, 180, 60, "跳到局末"));
+    buttons.back().onClick = [this]() { skipToEnd(false); };
+    buttons.push_back(Button(620, 800, 180, 60, "跳到赛末"));
+    buttons.back().onClick = [this]() { skipToEnd(true); };
 }
 
 void GameDisplay::initPauseContinue() {
@@ -394,6 +446,31 @@ void GameDisplay::initPauseContinue() {
     };
 }
 
+// 多场看板：后台线程同时模拟 matchCount 场比赛（阵容取当前两队）
+void GameDisplay::initDashboard(int matchCount) {
+    releaseDashboard();
+    ensureTeamsLoaded();
+    currentScreen = SCREEN_DASHBOARD;
+
+    dashboardCards.resize(matchCount);
+    if (!dashboard) dashboard = std::make_unique<MatchDashboard>();
+    dashboard->start(matchCount, captureRoster(), currentBalance(), static_cast<uint64_t>(std::time(nullptr)));
+
+    buttons.clear();
+    const int counts[3] = {4, 9, 16};
+    for (int i = 0; i < 3; i++) {
+        buttons.push_back(Button(50 + i * 140, 830, 120, 50, std::to_string(counts[i]) + "场"));
+        int count = counts[i];
+        buttons.back().onClick = [this, count]() { initDashboard(count); };
+    }
+    buttons.push_back(Button(1200, 830, 150, 50, "返回菜单"));
+    buttons.back().onClick = [this]() {
+        releaseDashboard();
+        currentScreen = SCREEN_MAIN_MENU;
+        initMainMenu();
+    };
+}
+
 void GameDisplay::handleEvent(const SDL_Event& event) {
     switch (event.type) {
         case SDL_QUIT:
@@ -422,6 +499,9 @@ void GameDisplay::handleEvent(const SDL_Event& event) {
                 case SCREEN_PAUSE_CONTINUE:
                     handlePauseContinueEvent(event);
                     break;
+                case SCREEN_DASHBOARD:
+                    handleDashboardEvent(event);
+                    break;
                 default:
                     break;
             }
@@ -568,14 +648,44 @@ void GameDisplay::handlePauseContinueEvent(const SDL_Event& event) {
     }
 }
 
+// 看板的按钮会重建按钮列表，点中一个后立即返回
+void GameDisplay::handleDashboardEvent(const SDL_Event& event) {
+    if (event.type == SDL_MOUSEBUTTONDOWN) {
+        int mx = event.button.x;
+        int my = event.button.y;
+
+        for (auto& btn : buttons) {
+            if (btn.isMouseOver(mx, my) && btn.onClick) {
+                auto onClick = btn.onClick;
+                onClick();
+                return;
+            }
+        }
+    } else if (event.type == SDL_MOUSEMOTION) {
+        int mx = event.motion.x;
+        int my = event.motion.y;
+
+        for (auto& btn : buttons) {
+            btn.hovered = btn.isMouseOver(mx, my);
+        }
+    }
+}
+
 void GameDisplay::update() {
+    if (currentScreen == SCREEN_DASHBOARD) {
+        updateDashboard();
+        return;
+    }
+
     // 自动模拟控制
-    if (currentScreen == SCREEN_GAME_RUNNING && autoSimulating && !matchOver) {
-        Uint32 now = SDL_GetTicks();
-        if (now - lastSimTick >= simIntervalMs) {
-            simulateRound();
-            lastSimTick = now;
-        }
+    if (currentScreen != SCREEN_GAME_RUNNING) return;
+
+    Uint32 now = SDL_GetTicks();
+    if (rallyInProgress) {
+        // 一球未完：按间隔推进下一个环节
+        if (now - lastStepTick >= stepIntervalMs) advanceRallyStep();
+    } else if (autoSimulating && !matchOver && now - lastSimTick >= simIntervalMs) {
+        simulateRound();
     }
 }
 
@@ -607,6 +717,9 @@ void GameDisplay::render() {
             renderGameRunning(); // 先渲染游戏画面
             renderPauseContinue(); // 再渲染暂停界面
             break;
+        case SCREEN_DASHBOARD:
+            renderDashboard();
+            break;
     }
 
     SDL_RenderPresent(renderer);
@@ -908,8 +1021,96 @@ SDL_Texture* GameDisplay::createTextTexture(const std::string& text, TTF_Font* f
     return texture;
 }
 
+void GameDisplay::renderCachedText(CachedText& cache, const std::string& text, int x, int y, TTF_Font* font, SDL_Color color) {
+    if (!font) return;
+    if (text != cache.text || (!cache.texture && !text.empty())) {
+        releaseCachedText(cache);
+        cache.text = text;
+        if (!text.empty()) cache.texture = createTextTexture(text, font, color);
+        if (cache.texture) SDL_QueryTexture(cache.texture, nullptr, nullptr, &cache.w, &cache.h);
+    }
+    if (!cache.texture) return;
+
+    SDL_Rect rect = {x, y, cache.w, cache.h};
+    SDL_RenderCopy(renderer, cache.texture, nullptr, &rect);
+}
+
+void GameDisplay::releaseCachedText(CachedText& cache) {
+    if (cache.texture) SDL_DestroyTexture(cache.texture);
+    cache.texture = nullptr;
+    cache.w = cache.h = 0;
+}
+
+void GameDisplay::updateDashboard() {
+    if (!dashboard) return;
+    for (int i = 0; i < static_cast<int>(dashboardCards.size()); i++) {
+        dashboardUpdates.clear();
+        dashboard->drain(i, dashboardUpdates);
+        if (dashboardUpdates.empty()) continue;
+
+        // 只需要最新的比分和最后一条非空事件
+        DashboardCard& card = dashboardCards[i];
+        card.score = dashboardUpdates.back().score;
+        for (auto it = dashboardUpdates.rbegin(); it != dashboardUpdates.rend(); ++it) {
+            if (it->event.empty()) continue;
+            card.lastEvent = std::move(it->event);
+            break;
+        }
+    }
+}
+
+void GameDisplay::releaseDashboard() {
+    if (dashboard) dashboard->stop();
+    for (auto& card : dashboardCards) {
+        releaseCachedText(card.scoreLine);
+        releaseCachedText(card.setLine);
+        releaseCachedText(card.eventLine);
+    }
+    dashboardCards.clear();
+}
+
+// 看板：每场比赛一张卡片，文字纹理只在内容变化时重建
+void GameDisplay::renderDashboard() {
+    int count = static_cast<int>(dashboardCards.size());
+    renderText("多场看板 - 同时模拟" + intToString(count) + "场", 50, 30, fontLarge, colors.primary);
+    if (count == 0) return;
+
+    int cols = 1;
+    while (cols * cols < count) cols++;
+    int rows = (count + cols - 1) / cols;
+    const int gap = 12;
+    int cardW = (1300 - gap * (cols - 1)) / cols;
+    int cardH = (720 - gap * (rows - 1)) / rows;
+
+    for (int i = 0; i < count; i++) {
+        DashboardCard& card = dashboardCards[i];
+        const DashboardScore& score = card.score;
+        int x = 50 + (i % cols) * (cardW + gap);
+        int y = 90 + (i / cols) * (cardH + gap);
+
+        renderFilledRect(x, y, cardW, cardH, SDL_Color{45, 45, 45, 255});
+        renderBorderedRect(x, y, cardW, cardH, score.over ? colors.success : colors.border, 2);
+
+        // 发球方标记
+        int markX = (score.serveSide == 0) ? x + 10 : x + cardW - 22;
+        renderFilledRect(markX, y + 14, 12, 12, score.serveSide == 0 ? colors.primary : colors.secondary);
+
+        renderCachedText(card.scoreLine, "A  " + intToString(score.scoreA) + " : " + intToString(score.scoreB) + "  B",
+                         x + 30, y + 6, fontLarge, colors.text);
+        std::string setText = "第" + intToString(score.setNum) + "局  局分 " + intToString(score.setsA) + ":" +
+                              intToString(score.setsB) + (score.over ? "  已结束" : "");
+        renderCachedText(card.setLine, setText, x + 12, y + 48, fontSmall, colors.info);
+        size_t maxChars = static_cast<size_t>(std::max(4, (cardW - 24) / 15));
+        renderCachedText(card.eventLine, truncateUtf8(card.lastEvent, maxChars), x + 12, y + 72, fontSmall, colors.text);
+    }
+
+    for (auto& btn : buttons) {
+        renderButton(btn);
+    }
+}
+
 void GameDisplay::simulateRound() {
-    if (matchOver) return;
+    if (matchOver || rallyInProgress) return;
 
     // 清空之前的比赛事件
     while (!gameEvents.empty()) gameEvents.pop();
@@ -924,54 +1125,50 @@ void GameDisplay::simulateRound() {
     appendLog(std::string("第") + intToString(gameState.setNum) + "局 第" + intToString(g_roundNum) + "球 - 发球: " +
               (gameState.serveSide == 0 ? std::string("A ") + server.name : std::string("B ") + server.name));
 
-    // 使用真实比赛回合逻辑
-    int scorer = processRallyFromServe(gameState); // 0=A, 1=B
+    // 使用真实比赛回合逻辑，逐环节播放：先打发球，其余环节由 update() 按间隔推进
+    rally = beginRally(gameState);
+    rallyInProgress = true;
+    advanceRallyStep();
+}
 
-    // 将底层详细事件导入到UI事件面板
+void GameDisplay::advanceRallyStep() {
+    RallyPhase phase = advanceRally(gameState, rally);
+    currentRallyStep++;
+    lastStepTick = SDL_GetTicks();
+
+    // 将本环节的详细事件导入到UI事件面板，当前动作区显示本环节
     {
         std::vector<std::string> copied;
         {
             std::lock_guard<std::mutex> lk(g_uiLogMutex);
             copied.swap(g_uiLogBuffer);
         }
-        std::cout << "Copied " << copied.size() << " events" << std::endl; // 添加调试信息
+        currentRallyDescription.clear();
         for (const auto& ev : copied) {
-            std::cout << "Event: " << ev << std::endl; // 添加调试信息
             appendEvent(ev);
+            if (!currentRallyDescription.empty()) currentRallyDescription += '\n';
+            currentRallyDescription += ev;
         }
     }
 
+    if (phase == PHASE_OVER) {
+        rallyInProgress = false;
+        finishRound(rally.scorer);
+    }
+}
+
+void GameDisplay::finishRound(int scorer) {
+    lastSimTick = SDL_GetTicks();  // 自动模拟从这一球结束时开始计间隔
+
+    // 记分、换发与轮转（与 playSet 共用）
+    applyRallyResult(gameState, scorer);
+    traceFlush(&std::cout);  // 输出本球的调试追踪（VOLLEYBALL_TRACE）
     if (scorer == 0) {
-        gameState.scoreA++;
         appendLog("A队得分");
         appendEvent("A队得分", 0);
-        if (gameState.serveSide == 0) {
-            // 发球方连得分，不轮转
-        } else {
-            // 换发与轮转到A
-            rotateTeam(gameState, 0);
-            gameState.serveSide = 0;
-            // 若失分方的发球人是MB，进入自由人
-            if (server.position == "MB") {
-                gameState.liberoReplaceB = gameState.rotateB[0];
-                gameState.rotateB[0] = 6;
-            }
-        }
     } else {
-        gameState.scoreB++;
         appendLog("B队得分");
         appendEvent("B队得分", 1);
-        if (gameState.serveSide == 1) {
-            // 发球方连得分，不轮转
-        } else {
-            // 换发与轮转到B
-            rotateTeam(gameState, 1);
-            gameState.serveSide = 1;
-            if (server.position == "MB") {
-                gameState.liberoReplaceA = gameState.rotateA[0];
-                gameState.rotateA[0] = 6;
-            }
-        }
     }
 
     // 回合数+1
@@ -981,8 +1178,7 @@ void GameDisplay::simulateRound() {
     appendLog(std::string("当前比分 A:") + intToString(gameState.scoreA) + " - B:" + intToString(gameState.scoreB));
 
     // 判定本局结束
-    int target = currentSetTarget();
-    if ((gameState.scoreA >= target || gameState.scoreB >= target) && std::abs(gameState.scoreA - gameState.scoreB) >= 2) {
+    if (setFinished()) {
         if (gameState.scoreA > gameState.scoreB) {
             setsWonA++;
             appendLog("本局A队胜");
@@ -1011,6 +1207,64 @@ void GameDisplay::simulateRound() {
     }
 }
 
+// 快进到本局（wholeMatch 为真时到全场）结束。剩余的球关闭比赛事件直接打完，
+// 不生成任何事件文字，结束后只把各局比分和快进期间的得分汇总显示出来
+void GameDisplay::skipToEnd(bool wholeMatch) {
+    if (matchOver) return;
+    autoSimulating = false;
+    waitingForContinue = false;
+    continueCallback = nullptr;
+
+    setUIEventsEnabled(false);
+    int points = 0, pointsA = 0;
+    std::vector<std::string> setScores;
+    while (true) {
+        int scorer;
+        if (rallyInProgress) {
+            // 正在播放的一球先打完
+            while (advanceRally(gameState, rally) != PHASE_OVER) {}
+            scorer = rally.scorer;
+            rallyInProgress = false;
+        } else {
+            scorer = processRallyFromServe(gameState);
+        }
+        applyRallyResult(gameState, scorer);
+        g_roundNum++;
+        points++;
+        if (scorer == 0) pointsA++;
+        if (!setFinished()) continue;
+
+        gameState.scoreA > gameState.scoreB ? setsWonA++ : setsWonB++;
+        setScores.push_back("第" + intToString(gameState.setNum) + "局 A " + intToString(gameState.scoreA) + " : " +
+                            intToString(gameState.scoreB) + " B");
+        if (setsWonA == 2 || setsWonB == 2 || gameState.setNum >= 3) {
+            matchOver = true;
+            break;
+        }
+        startNextSet();
+        if (!wholeMatch) break;
+    }
+    setUIEventsEnabled(true);
+    traceFlush(&std::cout);  // 快进期间的调试追踪（VOLLEYBALL_TRACE）一次输出
+
+    currentRallyDescription.clear();
+    std::string summary = "快进" + intToString(points) + "球：A队得" + intToString(pointsA) + "分，B队得" +
+                          intToString(points - pointsA) + "分";
+    appendLog(summary);
+    appendEvent(summary);
+    for (const auto& line : setScores) {
+        appendLog(line);
+        appendEvent(line);
+    }
+
+    lastSimTick = SDL_GetTicks();
+    if (matchOver) {
+        currentScreen = SCREEN_GAME_RESULT;
+    } else {
+        appendEvent(std::string("第") + intToString(gameState.setNum) + "局开始，发球方：" + (gameState.serveSide == 0 ? "A队" : "B队"));
+    }
+}
+
 void GameDisplay::waitForContinue(const std::string& message, std::function<void()> callback) {
     waitingForContinue = true;
     continueCallback = callback;
@@ -1086,61 +1340,53 @@ void GameDisplay::ensureTeamsLoaded() {
 void GameDisplay::initMatchState() {
     matchOver = false;
     autoSimulating = false;
+    rallyInProgress = false;
     setsWonA = setsWonB = 0;
     eventLog.clear();
     while (!gameEvents.empty()) gameEvents.pop();
     g_roundNum = 1;
 
+    // 固定本场比赛的平衡参数
+    pinBalance();
+
     static bool seeded = false;
-    if (!seeded) { std::srand(static_cast<unsigned int>(std::time(nullptr))); seeded = true; }
+    if (!seeded) { simSeed(static_cast<unsigned int>(std::time(nullptr))); seeded = true; }
 
-    gameState.serveSide = std::rand() % 2;
+    gameState.serveSide = simRandBelow(2);
     gameState.setNum = 1;
     gameState.scoreA = 0; gameState.scoreB = 0;
-    for (int i = 0; i < 6; ++i) { gameState.rotateA[i] = i; gameState.rotateB[i] = i; }
-
-    // 初始化自由人替换（参考 newGame()）
-    if (teamA[gameState.rotateA[5]].position == "MB") { gameState.liberoReplaceA = gameState.rotateA[5]; gameState.rotateA[5] = 6; }
-    if (teamA[gameState.rotateA[4]].position == "MB") { gameState.liberoReplaceA = gameState.rotateA[4]; gameState.rotateA[4] = 6; }
-    if (teamA[gameState.rotateA[0]].position == "MB" && gameState.serveSide != 0) { gameState.liberoReplaceA = gameState.rotateA[0]; gameState.rotateA[0] = 6; }
-
-    if (teamB[gameState.rotateB[5]].position == "MB") { gameState.liberoReplaceB = gameState.rotateB[5]; gameState.rotateB[5] = 6; }
-    if (teamB[gameState.rotateB[4]].position == "MB") { gameState.liberoReplaceB = gameState.rotateB[4]; gameState.rotateB[4] = 6; }
-    if (teamB[gameState.rotateB[0]].position == "MB" && gameState.serveSide != 1) { gameState.liberoReplaceB = gameState.rotateB[0]; gameState.rotateB[0] = 6; }
+    // 初始化轮转与自由人替换
+    initRotation(gameState);
 
     appendLog(std::string("比赛开始！首发发球方：") + (gameState.serveSide == 0 ? "A队" : "B队"));
     appendEvent(std::string("比赛开始！首发发球方：") + (gameState.serveSide == 0 ? "A队" : "B队"));
 }
 
 void GameDisplay::nextSet() {
+    startNextSet();
+
+    appendLog(std::string("开始第") + intToString(gameState.setNum) + "局，发球方：" + (gameState.serveSide == 0 ? "A队" : "B队"));
+    appendEvent(std::string("开始第") + intToString(gameState.setNum) + "局，发球方：" + (gameState.serveSide == 0 ? "A队" : "B队"));
+}
+
+void GameDisplay::startNextSet() {
     // 重置比分与回合
     gameState.scoreA = gameState.scoreB = 0;
     g_roundNum = 1;
 
     if (gameState.setNum == 1) {
-        gameState.setNum = 2;
-        gameState.serveSide = 1 - gameState.serveSide; // 第二局交换发球权
+        startSet(gameState, 2, 1 - gameState.serveSide); // 第二局交换发球权
     } else {
-        gameState.setNum = 3;
-        gameState.serveSide = std::rand() % 2; // 第三局随机
+        startSet(gameState, 3, simRandBelow(2)); // 第三局随机
     }
-
-    for (int i = 0; i < 6; ++i) { gameState.rotateA[i] = i; gameState.rotateB[i] = i; }
-
-    if (teamA[gameState.rotateA[5]].position == "MB") { gameState.liberoReplaceA = gameState.rotateA[5]; gameState.rotateA[5] = 6; }
-    if (teamA[gameState.rotateA[4]].position == "MB") { gameState.liberoReplaceA = gameState.rotateA[4]; gameState.rotateA[4] = 6; }
-    if (teamA[gameState.rotateA[0]].position == "MB" && gameState.serveSide != 0) { gameState.liberoReplaceA = gameState.rotateA[0]; gameState.rotateA[0] = 6; }
-
-    if (teamB[gameState.rotateB[5]].position == "MB") { gameState.liberoReplaceB = gameState.rotateB[5]; gameState.rotateB[5] = 6; }
-    if (teamB[gameState.rotateB[4]].position == "MB") { gameState.liberoReplaceB = gameState.rotateB[4]; gameState.rotateB[4] = 6; }
-    if (teamB[gameState.rotateB[0]].position == "MB" && gameState.serveSide != 1) { gameState.liberoReplaceB = gameState.rotateB[0]; gameState.rotateB[0] = 6; }
-
-    appendLog(std::string("开始第") + intToString(gameState.setNum) + "局，发球方：" + (gameState.serveSide == 0 ? "A队" : "B队"));
-    appendEvent(std::string("开始第") + intToString(gameState.setNum) + "局，发球方：" + (gameState.serveSide == 0 ? "A队" : "B队"));
 }
 
 int GameDisplay::currentSetTarget() const {
-    return (gameState.setNum == 3) ? 15 : 25;
+    return setTarget(gameState.setNum);
+}
+
+bool GameDisplay::setFinished() const {
+    return ::setFinished(gameState);
 }
 
 void GameDisplay::appendLog(const std::string& s) {
@@ -11,9 +11,12 @@ const int SCREEN_HEIGHT = 900;
 #include <vector>
 #include <string>
 #include <functional>
+#include <memory>
 #include <queue>
 
 #include "game.h"
+#include "rally.h"
+#include "matchDashboard.h"
 
 // UI颜色定义
 struct UIColor {
@@ -72,7 +75,8 @@ enum UIScreen {
     SCREEN_FORMATION,
     SCREEN_GAME_RUNNING,
     SCREEN_GAME_RESULT,
-    SCREEN_PAUSE_CONTINUE
+    SCREEN_PAUSE_CONTINUE,
+    SCREEN_DASHBOARD
 };
 
 // 比赛事件结构体
@@ -85,6 +89,22 @@ struct GameEvent {
         : description(desc), team(t), timestamp(SDL_GetTicks()) {}
 };
 
+// 缓存的文字纹理：文字不变时直接复用，不必每帧重新排版
+struct CachedText {
+    std::string text;
+    SDL_Texture* texture = nullptr;
+    int w = 0, h = 0;
+};
+
+// 看板上的一场比赛
+struct DashboardCard {
+    DashboardScore score;
+    std::string lastEvent;
+    CachedText scoreLine;   // 比分
+    CachedText setLine;     // 局数与局分
+    CachedText eventLine;   // 最后一条事件
+};
+
 // 游戏显示管理器
 class GameDisplay {
 public:
@@ -106,6 +126,7 @@ private:
     void initGameRunning();
     void setupGameRunningButtons();
     void initPauseContinue();
+    void initDashboard(int matchCount);
 
     // 事件处理子函数
     void handleMainMenuEvent(const SDL_Event& event);
@@ -114,6 +135,7 @@ private:
     void handleFormationEvent(const SDL_Event& event);
     void handleGameRunningEvent(const SDL_Event& event);
     void handlePauseContinueEvent(const SDL_Event& event);
+    void handleDashboardEvent(const SDL_Event& event);
 
     // 渲染函数
     void renderMainMenu();
@@ -124,6 +146,7 @@ private:
     void renderGameResult();
     void renderGameEvents();
     void renderPauseContinue();
+    void renderDashboard();
 
     // 绘图工具
     void renderButton(const Button& btn);
@@ -133,20 +156,31 @@ private:
     void renderFilledRect(int x, int y, int w, int h, SDL_Color color);
     void renderBorderedRect(int x, int y, int w, int h, SDL_Color borderColor, int borderWidth);
     SDL_Texture* createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color);
+    void renderCachedText(CachedText& cache, const std::string& text, int x, int y, TTF_Font* font, SDL_Color color);
+    void releaseCachedText(CachedText& cache);
 
     // 游戏逻辑
     void simulateRound();
+    void advanceRallyStep();        // 推进正在播放的一球的一个环节
+    void finishRound(int scorer);
+    void skipToEnd(bool wholeMatch);  // 快进到局末或赛末，不生成事件文字
     std::string intToString(int value);
 
     // 比赛辅助逻辑
     void ensureTeamsLoaded();
     void initMatchState();
     void nextSet();
+    void startNextSet();            // 换局（不写日志）
     int currentSetTarget() const;
+    bool setFinished() const;       // 当前局是否已分出胜负
     void appendLog(const std::string& s);
     void appendEvent(const std::string& desc, int team = -1);
     void fixWorkingDirectoryForPlayers();
 
+    // 多场看板
+    void updateDashboard();         // 取出各场比赛积压的更新
+    void releaseDashboard();        // 停止后台模拟并释放纹理
+
     // 暂停继续控制
     void waitForContinue(const std::string& message, std::function<void()> callback);
 
@@ -185,11 +219,20 @@ private:
     // 比赛事件队列
     std::queue<GameEvent> gameEvents;
     int currentRallyStep = 0;  // 当前回合步骤
+    RallyState rally;          // 正在播放的一球
+    bool rallyInProgress = false;
+    Uint32 lastStepTick = 0;
+    Uint32 stepIntervalMs = 400;  // 逐环节播放间隔（每次触球）
     std::string currentRallyDescription = "";  // 当前回合描述
 
     // 暂停继续控制
     bool waitingForContinue = false;
     std::function<void()> continueCallback = nullptr;
+
+    // 多场看板
+    std::unique_ptr<MatchDashboard> dashboard;
+    std::vector<DashboardCard> dashboardCards;
+    std::vector<DashboardUpdate> dashboardUpdates;  // 每帧取更新用的暂存
 };
 
 #endif // GAME_DISPLAY_H
\ No newline at end of file
@@ -0,0 +1,252 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "jsonLines.h"
+#include "rally.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // 枚举名（含引号），下标为枚举值
+    const std::string_view kPhaseNames[] = {"\"SERVE\"", "\"RECEIVE\"", "\"SET\"", "\"ATTACK\"", "\"BLOCK\"", "\"DIG\"",
+                                            "\"COVER\""};
+    const std::string_view kServeNames[] = {"null", "\"STABLE_SERVE\"", "\"AGGRESSIVE_SERVE\""};
+    const std::string_view kReceiveNames[] = {"\"RECEIVE_PERFECT\"", "\"RECEIVE_GOOD\"", "\"RECEIVE_BAD\"",
+                                              "\"RECEIVE_FAULT\""};
+    const std::string_view kPassTargetNames[] = {"\"FRONT_SPIKER\"", "\"FRONT_BLOCKER\"", "\"BACK_SPIKER\"",
+                                                 "\"OPPOSITE\"", "\"SETTER_DUMP\"", "\"ADJUST_ATTACK\""};
+    const std::string_view kPassQualityNames[] = {"\"PERFECT_PASS\"", "\"GOOD_PASS\"", "\"DECENT_PASS\"", "\"POOR_PASS\""};
+    const std::string_view kSpikeNames[] = {"\"STRONG_ATTACK\"", "\"AVOID_BLOCK\"", "\"DROP_SHOT\"", "\"QUICK_ATTACK\"",
+                                            "\"ADJUST_SPIKE\"", "\"TRANSITION_ATTACK\"", "\"SETTER_SPIKE\""};
+    const std::string_view kBlockNames[] = {"\"BLOCK_BREAK\"", "\"NO_TOUCH\"", "\"LIMIT_PATH\"", "\"BLOCK_TOUCH\"",
+                                            "\"BLOCK_BACK\""};
+    const std::string_view kDefenseNames[] = {"\"DEFENSE_PERFECT\"", "\"DEFENSE_GOOD\"", "\"DEFENSE_BAD\"",
+                                              "\"DEFENSE_FAULT\""};
+    const std::string_view kEndNames[] = {"\"SERVE_FAULT\"", "\"ACE\"", "\"SET_FAULT\"", "\"ATTACK_FAULT\"",
+                                          "\"ATTACK_POINT\"", "\"BLOCK_POINT\"", "\"LIMIT\""};
+
+    // 一行的长度上限：固定部分加每次触球
+    const size_t kPointLineBytes = 512;
+    const size_t kTouchBytes = 160;
+    const size_t kMatchLineBytes = 512;
+
+    template <size_t N>
+    std::string_view nameOf(const std::string_view (&names)[N], int value) {
+        return (value >= 0 && value < static_cast<int>(N)) ? names[value] : std::string_view("null");
+    }
+
+    std::string_view actionName(const RallyTouch& touch) {
+        switch (touch.phase) {
+            case PHASE_SERVE: return nameOf(kServeNames, touch.action);
+            case PHASE_SET: return nameOf(kPassTargetNames, touch.action);
+            case PHASE_ATTACK: return nameOf(kSpikeNames, touch.action);
+            default: return "null";
+        }
+    }
+
+    std::string_view resultName(const RallyTouch& touch) {
+        switch (touch.phase) {
+            case PHASE_RECEIVE: return nameOf(kReceiveNames, touch.result);
+            case PHASE_SET: return nameOf(kPassQualityNames, touch.result);
+            case PHASE_BLOCK: return nameOf(kBlockNames, touch.result);
+            case PHASE_DIG:
+            case PHASE_COVER: return nameOf(kDefenseNames, touch.result);
+            default: return "null";
+        }
+    }
+
+    void appendTouch(JsonLineBuffer& out, const RallyTouch& touch) {
+        out.raw("{\"phase\":");
+        out.raw(nameOf(kPhaseNames, touch.phase));
+        out.raw(",\"team\":");
+        out.integer(touch.team);
+        out.raw(",\"player\":");
+        out.integer(touch.player);
+        if (touch.action >= 0) {
+            out.raw(",\"action\":");
+            out.raw(actionName(touch));
+        }
+        if (touch.result >= 0) {
+            out.raw(",\"result\":");
+            out.raw(resultName(touch));
+        }
+        out.raw(",\"value\":");
+        out.integer(touch.value);
+        out.put('}');
+    }
+
+    void appendPoint(JsonLineBuffer& out, int64_t id, const PointRecord& p, const RallyTouch* touch, const RallyTouch* end) {
+        out.raw("{\"type\":\"point\",\"match\":");
+        out.integer(id);
+        out.raw(",\"set\":");
+        out.integer(p.setNum);
+        out.raw(",\"rally\":");
+        out.integer(p.rally);
+        out.raw(",\"score_a\":");
+        out.integer(p.scoreA);
+        out.raw(",\"score_b\":");
+        out.integer(p.scoreB);
+        out.raw(",\"serve_side\":");
+        out.integer(p.serveSide);
+        out.raw(",\"serve_rotation\":");
+        out.integer(p.serveRotation);
+        out.raw(",\"receive_rotation\":");
+        out.integer(p.receiveRotation);
+        out.raw(",\"winner\":");
+        out.integer(p.scorer);
+        out.raw(",\"end\":");
+        out.raw(nameOf(kEndNames, p.end));
+        out.raw(",\"attacks\":");
+        out.integer(p.attacks);
+        out.raw(",\"touches\":[");
+        for (const RallyTouch* t = touch; t != end; t++) {
+            if (t != touch) out.put(',');
+            appendTouch(out, *t);
+        }
+        out.raw("]}\n");
+    }
+
+    void appendMatch(JsonLineBuffer& out, int64_t id, int winner, const MatchStats& m) {
+        out.raw("{\"type\":\"match\",\"match\":");
+        out.integer(id);
+        out.raw(",\"winner\":");
+        out.integer(winner);
+        out.raw(",\"sets_a\":");
+        out.integer(m.setsA);
+        out.raw(",\"sets_b\":");
+        out.integer(m.sets - m.setsA);
+        out.raw(",\"points_a\":");
+        out.integer(m.pointsA);
+        out.raw(",\"points_b\":");
+        out.integer(m.pointsB);
+        out.raw(",\"rallies\":");
+        out.integer(m.rallies);
+        out.raw(",\"aces\":");
+        out.integer(m.aces);
+        out.raw(",\"serve_faults\":");
+        out.integer(m.serveFaults);
+        out.raw(",\"attack_points\":");
+        out.integer(m.attackPoints);
+        out.raw(",\"block_points\":");
+        out.integer(m.blockPoints);
+        out.raw("}\n");
+    }
+
+    // 各线程共用的输出文件，每次写入一整块（若干完整的行）
+    struct JsonLinesOutput {
+        std::FILE* file = nullptr;
+        std::mutex mtx;
+        long long bytes = 0;
+
+        void write(JsonLineBuffer& buffer) {
+            if (buffer.size() == 0) return;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                std::fwrite(buffer.data(), 1, buffer.size(), file);
+                bytes += static_cast<long long>(buffer.size());
+            }
+            buffer.clear();
+        }
+    };
+
+    // 每个线程槽位的缓冲
+    struct JsonLinesSlot {
+        MatchStats total;
+        long long matchLines = 0, pointLines = 0;
+        std::vector<PointRecord> points;
+        std::vector<RallyTouch> touches;
+        std::unique_ptr<JsonLineBuffer> buffer;
+    };
+}
+
+void JsonLineBuffer::reserve(size_t n) {
+    if (capacity - used >= n) return;
+    size_t grown = std::max(capacity * 2, used + n);
+    std::unique_ptr<char[]> next(new char[grown]);
+    std::memcpy(next.get(), bytes.get(), used);
+    bytes = std::move(next);
+    capacity = grown;
+}
+
+// 从低位往高位写进栈上的小数组，再整段拷贝
+void JsonLineBuffer::integer(long long value) {
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    unsigned long long v = (value < 0) ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+    do {
+        *--p = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    if (value < 0) *--p = '-';
+    raw(std::string_view(p, digits + sizeof(digits) - p));
+}
+
+JsonLinesResult exportJsonLines(const Roster& roster, std::shared_ptr<const BalanceParams> params, const JsonLinesSpec& spec) {
+    JsonLinesResult result;
+    JsonLinesOutput output;
+    bool toStdout = (spec.path == "-");
+    output.file = toStdout ? stdout : std::fopen(spec.path.c_str(), "wb");
+    if (!output.file) return result;
+
+    ThreadPool pool(spec.threads);
+    std::vector<JsonLinesSlot> slots(pool.size());
+    std::vector<ServeReceiveTables> tables(pool.size());   // 与 runMatches 相同，每个槽位一份
+    size_t bufferBytes = std::max<size_t>(spec.bufferBytes, 4096);
+    for (auto& s : slots) s.buffer = std::make_unique<JsonLineBuffer>(bufferBytes);
+
+    int chunk = std::max(1, spec.matches / (pool.size() * 8));
+    pool.parallelForSlots(spec.matches, chunk, [&](int slotIndex, int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        setServeReceiveTables(&tables[slotIndex]);
+
+        JsonLinesSlot& slot = slots[slotIndex];
+        JsonLineBuffer& buffer = *slot.buffer;
+        setRallyTouchLog(&slot.touches);
+        for (int i = begin; i < end; i++) {
+            MatchStats match;
+            slot.points.clear();
+            slot.touches.clear();
+            simSeed(matchSeed(spec.seed, i));
+            int winner = simulateMatch(match, &slot.points);
+            slot.total.add(match);
+
+            // 整场放不下时先交出已写的块，保证同一场的各行在同一块中
+            size_t need = kPointLineBytes * slot.points.size() + kTouchBytes * slot.touches.size() + kMatchLineBytes;
+            if (buffer.remaining() < need) output.write(buffer);
+            buffer.reserve(need);
+
+            // 每球的触球从它的发球开始，到下一次发球为止
+            const RallyTouch* touch = slot.touches.data();
+            const RallyTouch* touchEnd = touch + slot.touches.size();
+            for (const auto& p : slot.points) {
+                const RallyTouch* next = touch + (touch != touchEnd);
+                while (next != touchEnd && next->phase != PHASE_SERVE) next++;
+                appendPoint(buffer, i, p, touch, next);
+                touch = next;
+            }
+            appendMatch(buffer, i, winner, match);
+            slot.pointLines += static_cast<long long>(slot.points.size());
+            slot.matchLines++;
+        }
+        setRallyTouchLog(nullptr);
+        setServeReceiveTables(nullptr);
+    });
+
+    for (auto& s : slots) {
+        output.write(*s.buffer);
+        result.stats.add(s.total);
+        result.matchLines += s.matchLines;
+        result.pointLines += s.pointLines;
+    }
+    result.bytes = output.bytes;
+    result.ok = (std::fflush(output.file) == 0) && !std::ferror(output.file);
+    if (!toStdout) result.ok = (std::fclose(output.file) == 0) && result.ok;
+    return result;
+}
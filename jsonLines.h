@@ -0,0 +1,65 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef JSONLINES_H
+#define JSONLINES_H
+
+#include "batchSim.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// ============ JSON Lines 逐球输出 ============
+// 批量模拟并把结果按 JSON Lines 输出（每行一个对象），供分析脚本直接按行读取：
+//   {"type":"point",...}  每球一行：局数、比分、发球方与双方轮次、得分方、结束方式、逐次触球（环节、球员、枚举、数值）
+//   {"type":"match",...}  每场一行，在该场各球之后
+// 以 match 字段关联。第 i 场使用种子 (seed, i)，结果与 --export 的同一场相同。
+// 各线程把行写进自己预先分配的大缓冲，写满后整块交给输出文件，格式化过程不分配内存、不调用 printf。
+// 块的先后顺序取决于调度，同一场比赛的各行总在同一块中、先后不变。
+
+struct JsonLinesSpec {
+    std::string path = "-";             // "-" 为标准输出
+    int matches = 1000;
+    uint64_t seed = 1;
+    int threads = 0;                    // 0 为自动
+    size_t bufferBytes = 1 << 20;       // 每个线程的输出缓冲
+};
+
+struct JsonLinesResult {
+    bool ok = false;
+    MatchStats stats;                   // 全部场次的汇总
+    long long matchLines = 0, pointLines = 0;
+    long long bytes = 0;
+};
+
+JsonLinesResult exportJsonLines(const Roster& roster, std::shared_ptr<const BalanceParams> params, const JsonLinesSpec& spec);
+
+// 手写的 JSON 行缓冲：容量一次分配好，调用方先 reserve 出一行的最大长度，之后的写入不做检查
+class JsonLineBuffer {
+public:
+    explicit JsonLineBuffer(size_t capacity = 1 << 20) : bytes(new char[capacity]), capacity(capacity) {}
+
+    const char* data() const { return bytes.get(); }
+    size_t size() const { return used; }
+    size_t remaining() const { return capacity - used; }
+    void clear() { used = 0; }
+    void reserve(size_t n);             // 容量不足 n 时扩容（只在一整场比整个缓冲还长时发生）
+
+    void raw(std::string_view s) {
+        std::memcpy(bytes.get() + used, s.data(), s.size());
+        used += s.size();
+    }
+    void put(char c) { bytes[used++] = c; }
+    void integer(long long value);
+
+private:
+    std::unique_ptr<char[]> bytes;
+    size_t capacity;
+    size_t used = 0;
+};
+
+#endif //JSONLINES_H
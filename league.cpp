@@ -0,0 +1,245 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "league.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+
+bool buildLeagueTeams(int count, uint64_t seed, std::vector<LeagueTeam>& teams, std::string& error) {
+    // 与 players.txt 预设阵容相同的站位：1-4 主攻对位，2-5 副攻对位，3-6 二传接应对位
+    static const char* kSlots[7] = {"OH", "MB", "S", "OH", "MB", "OP", "L"};
+
+    std::map<std::string, std::vector<int>> byPosition;
+    for (int i = 0; i < static_cast<int>(allPlayers.size()); i++) {
+        byPosition[allPlayers[i].position].push_back(i);
+    }
+    std::map<std::string, int> needed;
+    for (const char* pos : kSlots) needed[pos]++;
+    for (const auto& [pos, n] : needed) {
+        if (static_cast<int>(byPosition[pos].size()) < n) {
+            error = "球员池中 " + pos + " 不足 " + std::to_string(n) + " 人，无法组队";
+            return false;
+        }
+    }
+
+    std::mt19937_64 gen(seed);
+    teams.assign(count, LeagueTeam());
+    for (int t = 0; t < count; t++) {
+        LeagueTeam& team = teams[t];
+        char name[16];
+        snprintf(name, sizeof(name), "T%03d", t + 1);
+        team.name = name;
+
+        std::vector<int> chosen;
+        for (int slot = 0; slot < 7; slot++) {
+            const std::vector<int>& pool = byPosition[kSlots[slot]];
+            int pick;
+            do {
+                pick = pool[gen() % pool.size()];
+            } while (std::find(chosen.begin(), chosen.end(), pick) != chosen.end());
+            chosen.push_back(pick);
+            team.players[slot] = allPlayers[pick];
+        }
+    }
+    return true;
+}
+
+std::vector<Fixture> roundRobinFixtures(int teams) {
+    // 轮转法：固定第一支队，其余队每轮顺时针转一位；奇数队时补一个轮空位 -1
+    std::vector<int> slots(teams);
+    std::iota(slots.begin(), slots.end(), 0);
+    if (teams % 2 == 1) slots.push_back(-1);
+    int n = static_cast<int>(slots.size());
+
+    std::vector<Fixture> fixtures;
+    fixtures.reserve(static_cast<size_t>(teams) * (teams - 1) / 2);
+    for (int round = 0; round < n - 1; round++) {
+        for (int i = 0; i < n / 2; i++) {
+            int a = slots[i], b = slots[n - 1 - i];
+            if (a < 0 || b < 0) continue;
+            // 主客按轮次交替，避免某队总是先列出
+            if (round % 2 == 1) std::swap(a, b);
+            fixtures.push_back({round + 1, a, b});
+        }
+        std::rotate(slots.begin() + 1, slots.end() - 1, slots.end());
+    }
+    return fixtures;
+}
+
+std::vector<Standing> computeStandings(int teams, const std::vector<Fixture>& fixtures,
+                                       const FixtureResult* results, uint64_t tieBreakSeed) {
+    std::vector<Standing> table(teams);
+    for (int t = 0; t < teams; t++) table[t].team = t;
+
+    for (size_t i = 0; i < fixtures.size(); i++) {
+        const FixtureResult& r = results[i];
+        Standing& home = table[fixtures[i].home];
+        Standing& away = table[fixtures[i].away];
+        bool homeWin = r.setsHome > r.setsAway;
+        Standing& winner = homeWin ? home : away;
+        Standing& loser = homeWin ? away : home;
+        bool fullSets = std::min(r.setsHome, r.setsAway) > 0;   // 打满三局
+
+        home.played++;
+        away.played++;
+        winner.wins++;
+        loser.losses++;
+        winner.leaguePoints += fullSets ? 2 : 3;
+        loser.leaguePoints += fullSets ? 1 : 0;
+        home.setsWon += r.setsHome;
+        home.setsLost += r.setsAway;
+        away.setsWon += r.setsAway;
+        away.setsLost += r.setsHome;
+        home.pointsWon += r.pointsHome;
+        home.pointsLost += r.pointsAway;
+        away.pointsWon += r.pointsAway;
+        away.pointsLost += r.pointsHome;
+    }
+
+    std::mt19937_64 gen(tieBreakSeed);
+    std::vector<uint64_t> lot(teams);
+    for (auto& x : lot) x = gen();
+
+    // 比值用交叉相乘比较，避免除以0
+    std::sort(table.begin(), table.end(), [&](const Standing& a, const Standing& b) {
+        if (a.leaguePoints != b.leaguePoints) return a.leaguePoints > b.leaguePoints;
+        if (a.wins != b.wins) return a.wins > b.wins;
+        long long setA = 1LL * a.setsWon * b.setsLost, setB = 1LL * b.setsWon * a.setsLost;
+        if (setA != setB) return setA > setB;
+        long long ptA = 1LL * a.pointsWon * b.pointsLost, ptB = 1LL * b.pointsWon * a.pointsLost;
+        if (ptA != ptB) return ptA > ptB;
+        return lot[a.team] < lot[b.team];
+    });
+    return table;
+}
+
+LeagueResult runLeague(const LeagueSpec& spec, const std::vector<LeagueTeam>& teams) {
+    int teamCount = static_cast<int>(teams.size());
+    std::vector<Fixture> fixtures = roundRobinFixtures(teamCount);
+    int perSeason = static_cast<int>(fixtures.size());
+
+    std::shared_ptr<const BalanceParams> params = currentBalance();
+    ThreadPool pool(spec.threads);
+    std::cout << "联赛模拟：" << teamCount << " 支队伍，每赛季 " << perSeason << " 场，共 "
+              << spec.replicas << " 个赛季，" << pool.size() << " 个线程" << std::endl;
+
+    LeagueResult result;
+    result.summary.assign(teamCount, LeagueTeamSummary());
+
+    // 小联赛每批合并多个赛季，保证每批的场次足够分给所有线程
+    int batch = std::max(1, std::min(spec.replicas, 20000 / std::max(1, perSeason)));
+    std::vector<FixtureResult> results(static_cast<size_t>(batch) * perSeason);
+
+    for (int first = 0; first < spec.replicas; first += batch) {
+        int seasons = std::min(batch, spec.replicas - first);
+        int total = seasons * perSeason;
+        int chunk = std::max(1, total / (pool.size() * 8));
+
+        pool.parallelFor(total, chunk, [&](int begin, int end) {
+            pinBalance(params);
+            setUIEventsEnabled(false);
+            for (int k = begin; k < end; k++) {
+                int season = first + k / perSeason;
+                int index = k % perSeason;
+                const Fixture& f = fixtures[index];
+                for (int i = 0; i < 7; i++) {
+                    teamA[i] = teams[f.home].players[i];
+                    teamB[i] = teams[f.away].players[i];
+                }
+
+                // 种子只由赛季和场次决定，结果与线程数无关
+                simSeed(matchSeed(spec.seed, (static_cast<uint64_t>(season) << 32) | index));
+                MatchStats stats;
+                simulateMatch(stats);
+
+                FixtureResult& r = results[k];
+                r.setsHome = static_cast<int>(stats.setsA);
+                r.setsAway = static_cast<int>(stats.sets - stats.setsA);
+                r.pointsHome = static_cast<int>(stats.pointsA);
+                r.pointsAway = static_cast<int>(stats.pointsB);
+            }
+        });
+
+        for (int s = 0; s < seasons; s++) {
+            int season = first + s;
+            std::vector<Standing> table = computeStandings(teamCount, fixtures,
+                                                           &results[static_cast<size_t>(s) * perSeason],
+                                                           matchSeed(spec.seed, season));
+            for (int rank = 0; rank < teamCount; rank++) {
+                LeagueTeamSummary& sum = result.summary[table[rank].team];
+                if (rank == 0) sum.titles++;
+                sum.rankSum += rank + 1;
+                sum.leaguePointsSum += table[rank].leaguePoints;
+            }
+            if (season == 0) result.firstSeason = table;
+        }
+
+        std::cout << "\r进度 " << (first + seasons) << "/" << spec.replicas << std::flush;
+    }
+    std::cout << std::endl;
+
+    return result;
+}
+
+void printLeagueReport(const LeagueSpec& spec, const std::vector<LeagueTeam>& teams, const LeagueResult& result) {
+    const int shown = 20;
+
+    std::cout << "\n第一个赛季积分榜（名次 队伍 场 胜 负 积分 胜局/负局 得分/失分）：\n";
+    for (size_t i = 0; i < result.firstSeason.size() && i < shown; i++) {
+        const Standing& s = result.firstSeason[i];
+        std::cout << "  " << std::setw(4) << (i + 1) << "  " << teams[s.team].name
+                  << std::setw(5) << s.played << std::setw(5) << s.wins << std::setw(5) << s.losses
+                  << std::setw(6) << s.leaguePoints
+                  << "  " << s.setsWon << "/" << s.setsLost
+                  << "  " << s.pointsWon << "/" << s.pointsLost << "\n";
+    }
+
+    std::vector<int> order(teams.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (result.summary[a].titles != result.summary[b].titles)
+            return result.summary[a].titles > result.summary[b].titles;
+        return result.summary[a].rankSum < result.summary[b].rankSum;
+    });
+
+    std::cout << "\n夺冠概率（" << spec.replicas << " 个赛季；队伍 | 夺冠概率 | 平均名次 | 平均积分 | 阵容）：\n"
+              << std::fixed;
+    for (size_t i = 0; i < order.size() && i < shown; i++) {
+        const LeagueTeamSummary& sum = result.summary[order[i]];
+        const LeagueTeam& team = teams[order[i]];
+        std::cout << "  " << team.name
+                  << " | " << std::setprecision(3) << static_cast<double>(sum.titles) / spec.replicas
+                  << " | " << std::setprecision(2) << static_cast<double>(sum.rankSum) / spec.replicas
+                  << " | " << static_cast<double>(sum.leaguePointsSum) / spec.replicas << " |";
+        for (const Player& p : team.players) std::cout << " " << p.name;
+        std::cout << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::flush;
+}
+
+bool writeLeagueCsv(const std::string& path, const LeagueSpec& spec,
+                    const std::vector<LeagueTeam>& teams, const LeagueResult& result) {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) return false;
+
+    ofs << "team,players,seasons,titles,title_prob,mean_rank,mean_league_points\n";
+    ofs << std::setprecision(6);
+    for (size_t t = 0; t < teams.size(); t++) {
+        const LeagueTeamSummary& sum = result.summary[t];
+        ofs << teams[t].name << ",";
+        for (int i = 0; i < 7; i++) ofs << (i ? " " : "") << teams[t].players[i].name;
+        ofs << "," << spec.replicas << "," << sum.titles
+            << "," << static_cast<double>(sum.titles) / spec.replicas
+            << "," << static_cast<double>(sum.rankSum) / spec.replicas
+            << "," << static_cast<double>(sum.leaguePointsSum) / spec.replicas << "\n";
+    }
+    return true;
+}
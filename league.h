@@ -0,0 +1,79 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef LEAGUE_H
+#define LEAGUE_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============ 联赛模拟 ============
+// 从 players.txt 的球员池中按位置抽人组成若干支队伍，单循环赛制，每场比赛三局两胜。
+// 一个赛季的全部场次在线程池上动态分发；重复多个赛季即可估计各队夺冠概率。
+
+struct LeagueTeam {
+    std::string name;
+    Player players[7];      // 1-6号位 + 自由人，顺序同 players.txt 预设阵容
+};
+
+// 一场比赛
+struct Fixture {
+    int round;              // 第几轮（从1开始）
+    int home, away;         // 队伍下标，home 按 A 队、away 按 B 队上场
+};
+
+// 一场比赛的比分
+struct FixtureResult {
+    int setsHome = 0, setsAway = 0;
+    int pointsHome = 0, pointsAway = 0;
+};
+
+// 积分榜一行
+struct Standing {
+    int team = 0;
+    int played = 0, wins = 0, losses = 0;
+    int leaguePoints = 0;           // 2:0 胜得3分，2:1 胜得2分、负方得1分
+    int setsWon = 0, setsLost = 0;
+    int pointsWon = 0, pointsLost = 0;
+};
+
+struct LeagueSpec {
+    int teams = 20;
+    int replicas = 100;     // 模拟的赛季数
+    uint64_t seed = 1;
+    int threads = 0;        // 0 为自动
+};
+
+// 各队在全部赛季中的汇总
+struct LeagueTeamSummary {
+    long long titles = 0;           // 夺冠次数
+    long long rankSum = 0;          // 名次之和（第一名为1）
+    long long leaguePointsSum = 0;  // 积分之和
+};
+
+struct LeagueResult {
+    std::vector<LeagueTeamSummary> summary;
+    std::vector<Standing> firstSeason;  // 第一个赛季的最终积分榜
+};
+
+// 从球员池组队：每队按 主攻、副攻、二传、主攻、副攻、接应、自由人 的顺序抽取，
+// 同一队内不重复，不同队之间可以共用球员
+bool buildLeagueTeams(int count, uint64_t seed, std::vector<LeagueTeam>& teams, std::string& error);
+
+// 单循环赛程（轮转法），队伍数为奇数时每轮有一队轮空
+std::vector<Fixture> roundRobinFixtures(int teams);
+
+// 按 积分、胜场、胜局比、得分比 排序；仍相同时按 tieBreakSeed 随机排列
+std::vector<Standing> computeStandings(int teams, const std::vector<Fixture>& fixtures,
+                                       const FixtureResult* results, uint64_t tieBreakSeed);
+
+LeagueResult runLeague(const LeagueSpec& spec, const std::vector<LeagueTeam>& teams);
+
+void printLeagueReport(const LeagueSpec& spec, const std::vector<LeagueTeam>& teams, const LeagueResult& result);
+bool writeLeagueCsv(const std::string& path, const LeagueSpec& spec,
+                    const std::vector<LeagueTeam>& teams, const LeagueResult& result);
+
+#endif //LEAGUE_H
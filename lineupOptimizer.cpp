@@ -0,0 +1,160 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "lineupOptimizer.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+bool enumerateLineups(const Player team[7], std::vector<LineupOrder>& lineups, std::string& error) {
+    int setter = -1, opposite = -1;
+    std::vector<int> middles, outsides;
+    for (int i = 0; i < 6; i++) {
+        const std::string& pos = team[i].position;
+        if (pos == "S") {
+            if (setter >= 0) { error = "前6人中有多名二传"; return false; }
+            setter = i;
+        } else if (pos == "OP") {
+            if (opposite >= 0) { error = "前6人中有多名接应"; return false; }
+            opposite = i;
+        } else if (pos == "MB") {
+            middles.push_back(i);
+        } else if (pos == "OH") {
+            outsides.push_back(i);
+        } else {
+            error = "前6人中有无法排入轮次的位置：" + team[i].name + "(" + pos + ")";
+            return false;
+        }
+    }
+    if (setter < 0 || opposite < 0 || middles.size() != 2 || outsides.size() != 2) {
+        error = "前6人需恰好为 1二传 1接应 2副攻 2主攻";
+        return false;
+    }
+
+    // 三组对位球员，每组 {前一位置, 后一位置}
+    int pairs[3][2] = {
+        {setter, opposite},
+        {middles[0], middles[1]},
+        {outsides[0], outsides[1]}
+    };
+
+    lineups.clear();
+    int assign[3] = {0, 1, 2};  // 第 k 对位置 (k, k+3) 放第 assign[k] 组
+    do {
+        for (int flip = 0; flip < 8; flip++) {
+            LineupOrder order;
+            for (int k = 0; k < 3; k++) {
+                const int* pair = pairs[assign[k]];
+                bool swapped = (flip >> k) & 1;
+                order[k] = pair[swapped ? 1 : 0];
+                order[k + 3] = pair[swapped ? 0 : 1];
+            }
+            lineups.push_back(order);
+        }
+    } while (std::next_permutation(assign, assign + 3));
+
+    return true;
+}
+
+void applyLineup(Player team[7], const LineupOrder& order) {
+    Player original[6];
+    for (int i = 0; i < 6; i++) original[i] = team[i];
+    for (int i = 0; i < 6; i++) team[i] = original[order[i]];
+}
+
+std::vector<LineupCandidate> optimizeLineup(const LineupSpec& spec, std::string& error) {
+    Roster roster = captureRoster();
+    Player* side = (spec.team == 0) ? roster.teamA : roster.teamB;
+
+    std::vector<LineupOrder> lineups;
+    if (!enumerateLineups(side, lineups, error)) return {};
+
+    std::vector<LineupCandidate> candidates(lineups.size());
+    for (size_t i = 0; i < lineups.size(); i++) candidates[i].order = lineups[i];
+
+    std::shared_ptr<const BalanceParams> params = currentBalance();
+    ThreadPool pool(spec.threads);
+    std::cout << "首发轮次优化：" << candidates.size() << " 种排法，每轮 " << spec.roundMatches
+              << " 场，每种最多 " << spec.maxMatches << " 场，" << pool.size() << " 个线程" << std::endl;
+
+    int round = 0;
+    int alive = static_cast<int>(candidates.size());
+    while (alive > 1) {
+        round++;
+        // 同一轮所有候选使用同一个种子（公共随机数）
+        uint64_t roundSeed = matchSeed(spec.seed, static_cast<uint64_t>(round) << 32);
+
+        for (auto& c : candidates) {
+            if (!c.alive) continue;
+            Roster trial = roster;
+            applyLineup(spec.team == 0 ? trial.teamA : trial.teamB, c.order);
+            MatchStats stats = runMatches(pool, trial, params, spec.roundMatches, roundSeed);
+            c.wins += (spec.team == 0) ? stats.winsA : stats.matches - stats.winsA;
+            c.matches += stats.matches;
+            wilsonInterval(c.wins, c.matches, spec.z, c.low, c.high);
+        }
+
+        // 淘汰：置信上限低于当前最好候选的置信下限
+        double bestLow = 0;
+        for (const auto& c : candidates) {
+            if (c.alive) bestLow = std::max(bestLow, c.low);
+        }
+        for (auto& c : candidates) {
+            if (c.alive && c.high < bestLow) {
+                c.alive = false;
+                c.eliminatedRound = round;
+                alive--;
+            }
+        }
+
+        long long played = 0;
+        for (const auto& c : candidates) {
+            if (c.alive) played = c.matches;
+        }
+        std::cout << "第" << round << "轮：剩余 " << alive << " 种排法，每种已模拟 " << played << " 场" << std::endl;
+
+        // 所有存活候选场数相同，用第一个存活者判断是否达到上限
+        auto firstAlive = std::find_if(candidates.begin(), candidates.end(),
+                                       [](const LineupCandidate& c) { return c.alive; });
+        if (firstAlive->matches >= spec.maxMatches) break;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const LineupCandidate& a, const LineupCandidate& b) {
+        if (a.alive != b.alive) return a.alive;
+        double ra = a.matches ? static_cast<double>(a.wins) / a.matches : 0.0;
+        double rb = b.matches ? static_cast<double>(b.wins) / b.matches : 0.0;
+        return ra > rb;
+    });
+    return candidates;
+}
+
+void printLineupReport(const LineupSpec& spec, const Roster& roster, const std::vector<LineupCandidate>& candidates) {
+    if (candidates.empty()) return;
+    const Player* side = (spec.team == 0) ? roster.teamA : roster.teamB;
+    const char* teamName = (spec.team == 0) ? "A" : "B";
+
+    const LineupCandidate& best = candidates.front();
+    std::cout << "\n" << teamName << "队最佳首发（1-6号位）：\n";
+    for (int i = 0; i < 6; i++) {
+        const Player& p = side[best.order[i]];
+        std::cout << "  " << (i + 1) << "号位  " << p.name << " (" << p.position << ")\n";
+    }
+    std::cout << std::fixed << std::setprecision(3)
+              << "  胜率 " << static_cast<double>(best.wins) / best.matches
+              << "，95%置信区间 [" << best.low << ", " << best.high << "]，共 " << best.matches << " 场\n";
+
+    std::cout << "\n排名前列的排法（1-6号位 | 胜率 | 置信区间 | 场数）：\n";
+    int shown = 0;
+    for (const auto& c : candidates) {
+        if (shown++ >= 10) break;
+        std::cout << "  ";
+        for (int i = 0; i < 6; i++) std::cout << side[c.order[i]].name << (i < 5 ? " " : "");
+        std::cout << " | " << static_cast<double>(c.wins) / c.matches
+                  << " | [" << c.low << ", " << c.high << "] | " << c.matches;
+        if (!c.alive) std::cout << "（第" << c.eliminatedRound << "轮淘汰）";
+        std::cout << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << "\n按最佳顺序排列 players.txt 中该队前6人即可使用此首发。" << std::endl;
+}
@@ -0,0 +1,52 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef LINEUPOPTIMIZER_H
+#define LINEUPOPTIMIZER_H
+
+#include "batchSim.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============ 首发轮次优化 ============
+// 合法站位：二传与接应对位、两名副攻对位、两名主攻对位（1-4、2-5、3-6号位为对位）。
+// 三组对位分配到三对位置有 3! 种，每组内谁在前排又各有 2 种，共 48 种排法
+// （即 8 种循环顺序 × 6 种起始轮次）。
+// 所有候选用同一批种子分轮批量模拟，每轮结束后用 Wilson 置信区间淘汰明显落后的候选。
+
+// 一种排法：order[i] 为站在 (i+1) 号位的球员在 teamA/teamB 中的下标
+typedef std::array<int, 6> LineupOrder;
+
+struct LineupSpec {
+    int team = 0;               // 0=优化A队，1=优化B队（对手阵容保持不变）
+    int roundMatches = 100;     // 每轮每个候选模拟的场数
+    int maxMatches = 2000;      // 每个候选最多模拟的场数
+    double z = 1.96;            // 置信区间的 z 值
+    uint64_t seed = 1;
+    int threads = 0;            // 0 为自动
+};
+
+struct LineupCandidate {
+    LineupOrder order;
+    long long wins = 0;
+    long long matches = 0;
+    double low = 0, high = 1;   // 胜率置信区间
+    bool alive = true;          // 是否仍在比较中
+    int eliminatedRound = 0;    // 被淘汰的轮次（0 表示未淘汰）
+};
+
+// 枚举 team[0..5] 的全部合法排法（需恰好 1 S、1 OP、2 MB、2 OH）
+bool enumerateLineups(const Player team[7], std::vector<LineupOrder>& lineups, std::string& error);
+
+// 按排法重排一队的前 6 人（自由人不变）
+void applyLineup(Player team[7], const LineupOrder& order);
+
+// 以当前线程的阵容为基础搜索；返回按胜率排序的全部候选
+std::vector<LineupCandidate> optimizeLineup(const LineupSpec& spec, std::string& error);
+
+void printLineupReport(const LineupSpec& spec, const Roster& roster, const std::vector<LineupCandidate>& candidates);
+
+#endif //LINEUPOPTIMIZER_H
@@ -0,0 +1,135 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "lockstepBatch.h"
+#include "rally.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // 一个工作线程的全部通道，每个字段一个数组，下标为通道号
+    struct LaneArrays {
+        std::vector<GameState> game;
+        std::vector<RallyState> rally;
+        std::vector<uint64_t> rngState;
+        std::vector<int> match;                 // 正在打第几场，-1 为空闲
+        std::vector<char> inRally;
+        std::vector<int> setsA, setsB;
+        std::vector<int> firstServe;
+        // 本球发球前的局面（逐球统计用）
+        std::vector<int> serveSide, scoreA, scoreB, rotA, rotB;
+
+        explicit LaneArrays(int lanes)
+            : game(lanes), rally(lanes), rngState(lanes, 0), match(lanes, -1), inRally(lanes, 0),
+              setsA(lanes, 0), setsB(lanes, 0), firstServe(lanes, 0),
+              serveSide(lanes, 0), scoreA(lanes, 0), scoreB(lanes, 0), rotA(lanes, 0), rotB(lanes, 0) {}
+    };
+
+    // 同 simulateMatch 的开场：先取第一局发球方
+    void startLane(LaneArrays& l, int k, int index, uint64_t seed, MatchStats& stats) {
+        simSeed(matchSeed(seed, index));
+        l.match[k] = index;
+        l.inRally[k] = 0;
+        l.setsA[k] = l.setsB[k] = 0;
+        l.firstServe[k] = simRandBelow(2);
+        l.game[k] = GameState();
+        l.game[k].box = &stats.box;
+        startSet(l.game[k], 1, l.firstServe[k]);
+    }
+
+    // 推进一个环节；球落地时记分，局结束时按 simulateMatch 的顺序换局。比赛结束时返回 true
+    bool stepLane(LaneArrays& l, int k, int setterA, int setterB, MatchStats& stats) {
+        GameState& game = l.game[k];
+        RallyState& rally = l.rally[k];
+        if (!l.inRally[k]) {
+            l.serveSide[k] = game.serveSide;
+            l.scoreA[k] = game.scoreA;
+            l.scoreB[k] = game.scoreB;
+            l.rotA[k] = setterRotation(game.rotateA, setterA);
+            l.rotB[k] = setterRotation(game.rotateB, setterB);
+            rally = beginRally(game);
+            l.inRally[k] = 1;
+        }
+        if (advanceRally(game, rally) != PHASE_OVER) return false;
+
+        l.inRally[k] = 0;
+        int servingSide = l.serveSide[k];
+        int serveRot = (servingSide == 0) ? l.rotA[k] : l.rotB[k];
+        int receiveRot = (servingSide == 0) ? l.rotB[k] : l.rotA[k];
+        PointRecord point = {game.setNum, l.scoreA[k] + l.scoreB[k] + 1, l.scoreA[k], l.scoreB[k], servingSide,
+                             rally.scorer, serveRot, receiveRot, game.lastRallyEnd, game.lastRallyAttacks,
+                             game.lastRallyTouches};
+        addPointStats(stats, point);
+        applyRallyResult(game, rally.scorer);
+        if (!setFinished(game)) return false;
+
+        game.scoreA > game.scoreB ? l.setsA[k]++ : l.setsB[k]++;
+        stats.sets++;
+        stats.pointsA += game.scoreA;
+        stats.pointsB += game.scoreB;
+        if (l.setsA[k] < 2 && l.setsB[k] < 2) {
+            int setNum = game.setNum + 1;
+            int serveSide = (setNum == 2) ? 1 - l.firstServe[k] : simRandBelow(2);
+            startSet(game, setNum, serveSide);
+            return false;
+        }
+
+        stats.matches++;
+        stats.setsA += l.setsA[k];
+        if (l.setsA[k] > l.setsB[k]) stats.winsA++;
+        return true;
+    }
+}
+
+MatchStats runMatchesLockstep(ThreadPool& pool, const Roster& roster, std::shared_ptr<const BalanceParams> params,
+                              int matches, uint64_t seed, int lanes, int first) {
+    lanes = std::max(1, lanes);
+    std::vector<MatchStats> partial(pool.size());
+    std::vector<ServeReceiveTables> tables(pool.size());
+
+    // 每块至少够填满所有通道
+    int chunk = std::max(lanes, matches / (pool.size() * 8));
+    pool.parallelForSlots(matches, chunk, [&](int slot, int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        setServeReceiveTables(&tables[slot]);
+        int setterA = findSetter(teamA), setterB = findSetter(teamB);
+
+        MatchStats& local = partial[slot];
+        uint64_t savedState = g_simRandState;
+        int width = std::min(lanes, end - begin);
+        LaneArrays l(width);
+        int next = begin;
+        for (int k = 0; k < width; k++) {
+            startLane(l, k, first + next++, seed, local);
+            l.rngState[k] = g_simRandState;
+        }
+
+        int active = width;
+        while (active > 0) {
+            for (int k = 0; k < width; k++) {
+                if (l.match[k] < 0) continue;
+                g_simRandState = l.rngState[k];
+                if (stepLane(l, k, setterA, setterB, local)) {
+                    if (next < end) {
+                        startLane(l, k, first + next++, seed, local);
+                    } else {
+                        l.match[k] = -1;
+                        active--;
+                    }
+                }
+                l.rngState[k] = g_simRandState;
+            }
+        }
+        g_simRandState = savedState;
+        setServeReceiveTables(nullptr);
+    });
+
+    MatchStats total;
+    for (const auto& p : partial) total.add(p);
+    return total;
+}
@@ -0,0 +1,24 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef LOCKSTEPBATCH_H
+#define LOCKSTEPBATCH_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <memory>
+
+// ============ 多场比赛交错推进的批量模拟 ============
+// runMatches 一场接一场地打，每场一球一球打完。这里每个工作线程同时持有 lanes 场比赛（每场一条"通道"），
+// 按一球状态机（rally.h）轮流让每条通道推进一个环节，一条通道的比赛打完后接着取下一场，直到取完。
+// 各通道的状态按字段分别存放在数组中（比赛状态、回合状态、随机数状态、局分……各一个数组），
+// 每条通道有自己的随机数状态，推进前换入、推进后换出，所以第 i 场仍用种子 (seed, i)、抽数顺序与 simulateMatch 相同，
+// 结果与 runMatches 逐位相同，只是不同比赛的环节在时间上交错。
+// 各环节的公式分支很多（按球员、质量档位、策略分支），这里不做向量化，只是标量代码按通道轮转；
+// 回合观察者（RallyObserver）不会被调用。
+
+MatchStats runMatchesLockstep(ThreadPool& pool, const Roster& roster, std::shared_ptr<const BalanceParams> params,
+                              int matches, uint64_t seed, int lanes, int first = 0);
+
+#endif //LOCKSTEPBATCH_H
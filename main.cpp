@@ -1,8 +1,18 @@
 
 #include "gameDisplay.h"
+#include "commandLine.h"
+#include "trace.h"
+#include <cstdlib>
 #include <iostream>
 
 int main(int argc, char** argv) {
+    // 带参数时进入命令行模式（参数扫描等），不创建窗口
+    int cliResult = runCommandLine(argc, argv);
+    if (cliResult >= 0) return cliResult;
+
+    // 调试追踪：VOLLEYBALL_TRACE=serve,block 或 all
+    if (const char* modules = std::getenv("VOLLEYBALL_TRACE")) traceSetMask(parseTraceModules(modules));
+
     // 创建显示管理器
     GameDisplay display(1400, 900);
 
@@ -0,0 +1,443 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "markovModel.h"
+#include "serve.h"
+#include "receiveServe.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace {
+    typedef std::array<int, 15> ConfigKey;      // 发球方 + 双方轮转 + 双方自由人替换
+    typedef std::array<int, 12> ArrangementKey; // 双方轮转
+
+    ConfigKey configKey(const GameState& g) {
+        ConfigKey key;
+        key[0] = g.serveSide;
+        for (int i = 0; i < 6; i++) {
+            key[1 + i] = g.rotateA[i];
+            key[7 + i] = g.rotateB[i];
+        }
+        key[13] = g.liberoReplaceA;
+        key[14] = g.liberoReplaceB;
+        return key;
+    }
+
+    GameState stateOf(const CourtConfig& c, int setNum) {
+        GameState g;
+        g.setNum = setNum;
+        g.scoreA = 0;
+        g.scoreB = 0;
+        g.serveSide = c.serveSide;
+        for (int i = 0; i < 6; i++) {
+            g.rotateA[i] = c.rotateA[i];
+            g.rotateB[i] = c.rotateB[i];
+        }
+        g.liberoReplaceA = c.liberoReplaceA;
+        g.liberoReplaceB = c.liberoReplaceB;
+        return g;
+    }
+
+    // 从两种开局出发，按 applyRallyResult 遍历一局中所有可能出现的布局
+    void enumerateConfigs(MatchupModel& model) {
+        std::map<ConfigKey, int> index;
+        std::map<ArrangementKey, int> arrangements;
+
+        auto add = [&](const GameState& g) {
+            ConfigKey key = configKey(g);
+            auto it = index.find(key);
+            if (it != index.end()) return it->second;
+
+            CourtConfig c;
+            c.serveSide = g.serveSide;
+            ArrangementKey arr;
+            for (int i = 0; i < 6; i++) {
+                c.rotateA[i] = g.rotateA[i];
+                c.rotateB[i] = g.rotateB[i];
+                arr[i] = g.rotateA[i];
+                arr[6 + i] = g.rotateB[i];
+            }
+            c.liberoReplaceA = g.liberoReplaceA;
+            c.liberoReplaceB = g.liberoReplaceB;
+            auto inserted = arrangements.emplace(arr, static_cast<int>(arrangements.size()));
+            c.arrangement = inserted.first->second;
+
+            int id = static_cast<int>(model.configs.size());
+            model.configs.push_back(c);
+            index[key] = id;
+            return id;
+        };
+
+        for (int side = 0; side < 2; side++) {
+            GameState g;
+            g.setNum = 1;
+            g.scoreA = 0;
+            g.scoreB = 0;
+            g.serveSide = side;
+            g.liberoReplaceA = -1;
+            g.liberoReplaceB = -1;
+            initRotation(g);
+            model.startConfig[side] = add(g);
+        }
+
+        // configs 在遍历中增长，只能按下标访问
+        for (size_t i = 0; i < model.configs.size(); i++) {
+            for (int scorer = 0; scorer < 2; scorer++) {
+                GameState g = stateOf(model.configs[i], 1);
+                applyRallyResult(g, scorer);
+                int next = add(g);
+                model.configs[i].next[scorer] = next;
+            }
+        }
+        model.arrangements = static_cast<int>(arrangements.size());
+    }
+
+    const int kRallyStates = 2 * 3 * kQualityBuckets;
+    const uint64_t kBootstrapSalt = 0x5be0cd19137e2179ULL;     // 自助法的种子与建表错开
+
+    int bucketOf(int qualityValue) {
+        return std::max(0, std::min(kQualityBuckets - 1, qualityValue / 10));
+    }
+
+    int rallyState(int team, int quality, int bucket) {
+        return (team * 3 + quality) * kQualityBuckets + bucket;
+    }
+
+    // 解 (I - P) x = b，n 很小，用带主元的高斯消元
+    std::vector<double> solveLinear(std::vector<double> m, std::vector<double> b, int n) {
+        for (int col = 0; col < n; col++) {
+            int pivot = col;
+            for (int r = col + 1; r < n; r++) {
+                if (std::fabs(m[r * n + col]) > std::fabs(m[pivot * n + col])) pivot = r;
+            }
+            if (pivot != col) {
+                for (int k = 0; k < n; k++) std::swap(m[col * n + k], m[pivot * n + k]);
+                std::swap(b[col], b[pivot]);
+            }
+            double diag = m[col * n + col];
+            if (std::fabs(diag) < 1e-12) continue;
+            for (int r = 0; r < n; r++) {
+                if (r == col) continue;
+                double f = m[r * n + col] / diag;
+                if (f == 0) continue;
+                for (int k = col; k < n; k++) m[r * n + k] -= f * m[col * n + k];
+                b[r] -= f * b[col];
+            }
+        }
+        std::vector<double> x(n, 0.5);
+        for (int i = 0; i < n; i++) {
+            if (std::fabs(m[i * n + i]) >= 1e-12) x[i] = b[i] / m[i * n + i];
+        }
+        return x;
+    }
+
+    const int kPointA = -1, kPointB = -2;       // 进攻起点抽样结果：A/B队得分，否则为下一个起点的下标
+
+    // 一局中一种轮转组合的转移数据：发球与接一为精确分布，进攻起点之间为抽样结果
+    struct ArrangementSample {
+        int setNum = 1;
+        std::vector<int> members;                           // 属于该组合的布局
+        std::vector<int> order;                             // 已发现的起点，按发现顺序
+        std::vector<int> local = std::vector<int>(kRallyStates, -1);   // 起点 → order 中的下标
+        std::vector<std::vector<int>> outcomes;             // [起点] 每次抽样的结果
+        // [布局][局势]：发球方直接得分（发球方接飞）的概率，以及各起点的概率
+        std::vector<std::array<double, 3>> serverPoint;
+        std::vector<std::array<std::vector<double>, 3>> start;
+    };
+
+    // 发球与接一：由发球→接一联合分布表精确求出，质量值在质量段内均匀，按10分分段
+    void serveStarts(ArrangementSample& sample, const MatchupModel& model, ServeReceiveTables& tables,
+                     const std::function<void(int)>& discover) {
+        sample.serverPoint.assign(sample.members.size(), {0.0, 0.0, 0.0});
+        sample.start.resize(sample.members.size());
+        for (size_t m = 0; m < sample.members.size(); m++) {
+            const CourtConfig& c = model.configs[sample.members[m]];
+            int receiving = 1 - c.serveSide;
+            for (int k = 0; k < 3; k++) {
+                GameState g = stateOf(c, sample.setNum);
+                // 领先/落后取3分，发球策略只看分差是否超过2
+                int& serverScore = (c.serveSide == 0) ? g.scoreA : g.scoreB;
+                int& receiverScore = (c.serveSide == 0) ? g.scoreB : g.scoreA;
+                if (k == 1) serverScore = 3;
+                if (k == 2) receiverScore = 3;
+
+                std::vector<double>& start = sample.start[m][k];
+                start.assign(kRallyStates, 0.0);
+                const ServeReceiveTable& table = tables.lookup(g);
+                for (size_t o = 0; o < table.outcomeList().size(); o++) {
+                    const ServeReceiveOutcome& outcome = table.outcomeList()[o];
+                    double p = table.probabilityList()[o];
+                    if (outcome.serveFault) continue;
+                    if (outcome.quality == RECEIVE_FAULT) {
+                        sample.serverPoint[m][k] += p;
+                        continue;
+                    }
+                    int low = 0, count = 1;
+                    ReceiveServe::qualityValueRange(outcome.quality, low, count);
+                    for (int v = low; v < low + count; v++) {
+                        int s = rallyState(receiving, outcome.quality, bucketOf(v));
+                        start[s] += p / count;
+                        discover(s);
+                    }
+                }
+            }
+        }
+    }
+
+    // 进攻起点：从每个起点抽样 rallySamples 次，新出现的起点加入队列
+    ArrangementSample sampleArrangement(const MatchupModel& model, const MarkovSpec& spec, int setNum, int arrangement,
+                                        ServeReceiveTables& tables) {
+        ArrangementSample sample;
+        sample.setNum = setNum;
+        for (int c = 0; c < static_cast<int>(model.configs.size()); c++) {
+            if (model.configs[c].arrangement == arrangement) sample.members.push_back(c);
+        }
+        auto discover = [&sample](int s) {
+            if (sample.local[s] < 0) {
+                sample.local[s] = static_cast<int>(sample.order.size());
+                sample.order.push_back(s);
+            }
+        };
+        serveStarts(sample, model, tables, discover);
+
+        GameState base = stateOf(model.configs[sample.members.front()], setNum);
+        for (size_t i = 0; i < sample.order.size(); i++) {
+            int s = sample.order[i];
+            int team = s / (3 * kQualityBuckets);
+            int quality = (s / kQualityBuckets) % 3;
+            int bucket = s % kQualityBuckets;
+
+            ReceiveResult start;
+            start.quality = static_cast<ReceiveQuality>(quality);
+            start.qualityValue = std::min(100, bucket * 10 + 5);
+            start.position = -1;
+
+            std::vector<int> results(spec.rallySamples);
+            for (int n = 0; n < spec.rallySamples; n++) {
+                GameState g = base;
+                int attacking = team, defending = 1 - team;
+                ReceiveResult receive = start;
+                int scorer = playAttackPhase(g, attacking, defending, receive);
+                if (scorer >= 0) {
+                    results[n] = (scorer == 0) ? kPointA : kPointB;
+                    continue;
+                }
+                int to = rallyState(attacking, receive.quality, bucketOf(receive.qualityValue));
+                discover(to);
+                results[n] = sample.local[to];
+            }
+            sample.outcomes.push_back(std::move(results));
+        }
+        return sample;
+    }
+
+    // 解出该组合下各布局、各局势的发球得分概率。resample 时每个起点的抽样结果有放回地重抽（自助法），
+    // 用来估计转移概率的抽样误差传到胜率上的大小
+    void solveArrangement(const ArrangementSample& sample, bool resample, MatchupModel& model) {
+        // winA[i]：从 order[i] 出发A队赢得这一分的概率
+        int n = static_cast<int>(sample.order.size());
+        std::vector<double> m(static_cast<size_t>(n) * n, 0.0), b(n, 0.0);
+        for (int i = 0; i < n; i++) {
+            const std::vector<int>& results = sample.outcomes[i];
+            int count = static_cast<int>(results.size());
+            double share = 1.0 / count;
+            m[i * n + i] = 1.0;
+            for (int k = 0; k < count; k++) {
+                int result = results[resample ? simRandBelow(count) : k];
+                if (result == kPointA) b[i] += share;
+                else if (result >= 0) m[i * n + result] -= share;
+            }
+        }
+        std::vector<double> winA = n ? solveLinear(m, b, n) : std::vector<double>();
+
+        for (size_t mi = 0; mi < sample.members.size(); mi++) {
+            const CourtConfig& c = model.configs[sample.members[mi]];
+            for (int k = 0; k < 3; k++) {
+                double win = sample.serverPoint[mi][k];
+                const std::vector<double>& start = sample.start[mi][k];
+                for (int s = 0; s < kRallyStates; s++) {
+                    if (start[s] <= 0.0) continue;
+                    double pA = winA[sample.local[s]];
+                    win += start[s] * (c.serveSide == 0 ? pA : 1.0 - pA);
+                }
+                model.serveWin[sample.setNum - 1][k][sample.members[mi]] = win;
+            }
+        }
+    }
+
+    // 发球方视角的局势
+    int situationOf(int serveSide, int scoreA, int scoreB) {
+        int lead = (serveSide == 0) ? scoreA - scoreB : scoreB - scoreA;
+        if (std::abs(lead) <= 2) return 0;
+        return lead > 0 ? 1 : 2;
+    }
+
+    // 一局的动态规划；双方都到 target-1 分之后只与分差有关，单独迭代求解
+    class SetSolver {
+    public:
+        SetSolver(const MatchupModel& model, int setNum)
+            : model(model), set(setNum - 1), target(setTarget(setNum)),
+              configs(static_cast<int>(model.configs.size())),
+              memo(static_cast<size_t>(target) * target * configs, -1.0) {
+            solveDeuce();
+        }
+
+        double win(int a, int b, int c) {
+            if ((a >= target || b >= target) && std::abs(a - b) >= 2) return a > b ? 1.0 : 0.0;
+            if (a >= target - 1 && b >= target - 1) return deuce[a - b + 1][c];
+
+            double& slot = memo[(static_cast<size_t>(a) * target + b) * configs + c];
+            if (slot >= 0) return slot;
+            double pA = pointWinA(c, situationOf(model.configs[c].serveSide, a, b));
+            slot = pA * win(a + 1, b, model.configs[c].next[0])
+                 + (1.0 - pA) * win(a, b + 1, model.configs[c].next[1]);
+            return slot;
+        }
+
+    private:
+        const MatchupModel& model;
+        int set, target, configs;
+        std::vector<double> memo;
+        std::vector<double> deuce[3];   // 分差 -1/0/+1
+
+        double pointWinA(int c, int situation) const {
+            double p = model.serveWin[set][situation][c];
+            return model.configs[c].serveSide == 0 ? p : 1.0 - p;
+        }
+
+        void solveDeuce() {
+            for (auto& d : deuce) d.assign(configs, 0.5);
+            for (int iter = 0; iter < 10000; iter++) {
+                double change = 0;
+                for (int d = 0; d < 3; d++) {
+                    for (int c = 0; c < configs; c++) {
+                        double pA = pointWinA(c, 0);
+                        double up = (d == 2) ? 1.0 : deuce[d + 1][model.configs[c].next[0]];
+                        double down = (d == 0) ? 0.0 : deuce[d - 1][model.configs[c].next[1]];
+                        double value = pA * up + (1.0 - pA) * down;
+                        change = std::max(change, std::fabs(value - deuce[d][c]));
+                        deuce[d][c] = value;
+                    }
+                }
+                if (change < 1e-14) break;
+            }
+        }
+    };
+}
+
+MatchupModel buildMatchupModel(const MarkovSpec& spec) {
+    MatchupModel model;
+    enumerateConfigs(model);
+    for (auto& set : model.serveWin) {
+        for (auto& v : set) v.assign(model.configs.size(), 0.5);
+    }
+
+    Roster roster = captureRoster();
+    std::shared_ptr<const BalanceParams> params = currentBalance();
+
+    // 每个任务为一局中的一种轮转组合，种子只由任务编号决定
+    ThreadPool pool(spec.threads);
+    int tasks = 3 * model.arrangements;
+    std::vector<ArrangementSample> samples(tasks);
+    pool.parallelFor(tasks, 1, [&](int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        ServeReceiveTables tables;
+        for (int t = begin; t < end; t++) {
+            simSeed(matchSeed(spec.seed, t));
+            samples[t] = sampleArrangement(model, spec, t / model.arrangements + 1, t % model.arrangements, tables);
+            solveArrangement(samples[t], false, model);
+        }
+    });
+    for (const auto& sample : samples) model.rallyStates += static_cast<int>(sample.order.size());
+
+    // 自助法副本：每个副本重抽全部进攻起点的抽样结果后重新求解，种子只由副本编号决定
+    std::vector<MatchupModel> replicas(std::max(0, spec.bootstrap));
+    pool.parallelFor(static_cast<int>(replicas.size()), 1, [&](int begin, int end) {
+        for (int r = begin; r < end; r++) {
+            MatchupModel& replica = replicas[r];
+            replica.configs = model.configs;
+            replica.startConfig[0] = model.startConfig[0];
+            replica.startConfig[1] = model.startConfig[1];
+            for (int s = 0; s < 3; s++) {
+                for (int k = 0; k < 3; k++) replica.serveWin[s][k] = model.serveWin[s][k];
+            }
+            simSeed(matchSeed(spec.seed ^ kBootstrapSalt, r));
+            for (const auto& sample : samples) solveArrangement(sample, true, replica);
+        }
+    });
+    for (const auto& replica : replicas) model.replicaMatchWinA.push_back(predictMatch(replica).matchWinA);
+    return model;
+}
+
+double setWinProbability(const MatchupModel& model, int setNum, int scoreA, int scoreB, int config) {
+    SetSolver solver(model, setNum);
+    return solver.win(scoreA, scoreB, config);
+}
+
+MatchPrediction predictMatch(const MatchupModel& model) {
+    MatchPrediction prediction;
+    for (int s = 0; s < 3; s++) {
+        SetSolver solver(model, s + 1);
+        for (int side = 0; side < 2; side++) {
+            prediction.setWin[s][side] = solver.win(0, 0, model.startConfig[side]);
+        }
+    }
+
+    // 第一局发球方随机，第二局交换，第三局再随机
+    double p3 = 0.5 * (prediction.setWin[2][0] + prediction.setWin[2][1]);
+    for (int first = 0; first < 2; first++) {
+        double p1 = prediction.setWin[0][first];
+        double p2 = prediction.setWin[1][1 - first];
+        double split = p1 * (1 - p2) + (1 - p1) * p2;
+        prediction.setScore[0] += 0.5 * p1 * p2;
+        prediction.setScore[1] += 0.5 * split * p3;
+        prediction.setScore[2] += 0.5 * split * (1 - p3);
+        prediction.setScore[3] += 0.5 * (1 - p1) * (1 - p2);
+    }
+    prediction.matchWinA = prediction.setScore[0] + prediction.setScore[1];
+
+    // 自助法副本的 2.5%、97.5% 分位数与标准差
+    std::vector<double> replicas = model.replicaMatchWinA;
+    if (!replicas.empty()) {
+        std::sort(replicas.begin(), replicas.end());
+        int count = static_cast<int>(replicas.size());
+        prediction.matchWinLow = replicas[static_cast<int>(0.025 * (count - 1) + 0.5)];
+        prediction.matchWinHigh = replicas[static_cast<int>(0.975 * (count - 1) + 0.5)];
+        double mean = 0, squares = 0;
+        for (double r : replicas) mean += r / count;
+        for (double r : replicas) squares += (r - mean) * (r - mean);
+        prediction.matchWinStdError = count > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+    }
+    return prediction;
+}
+
+void printMatchPrediction(const MatchupModel& model, const MatchPrediction& prediction) {
+    std::cout << "布局 " << model.configs.size() << " 种，轮转组合 " << model.arrangements
+              << " 种，进攻起点 " << model.rallyStates << " 个\n";
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "\n各局A队胜率（A先发 / B先发）：\n";
+    for (int s = 0; s < 3; s++) {
+        std::cout << "  第" << (s + 1) << "局  " << prediction.setWin[s][0] << " / " << prediction.setWin[s][1] << "\n";
+    }
+    std::cout << "\n局分概率：2:0 " << prediction.setScore[0] << "  2:1 " << prediction.setScore[1]
+              << "  1:2 " << prediction.setScore[2] << "  0:2 " << prediction.setScore[3] << "\n";
+    std::cout << "A队胜率：" << prediction.matchWinA;
+    if (!model.replicaMatchWinA.empty()) {
+        std::cout << "，转移抽样误差 95%区间 [" << prediction.matchWinLow << ", " << prediction.matchWinHigh
+                  << "]（标准误 " << prediction.matchWinStdError << "，自助法 " << model.replicaMatchWinA.size() << " 次）";
+    }
+    std::cout << "\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::flush;
+}
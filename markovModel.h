@@ -0,0 +1,71 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef MARKOVMODEL_H
+#define MARKOVMODEL_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <vector>
+
+// ============ 马尔可夫链胜率预测 ============
+// 一个回合可以看成有限状态链：每次进攻的起点是（进攻方，一传/防守质量等级，质量值分段），
+// 经过 二传 → 扣球 → 拦网 → 防守 后要么有一方得分，要么进入下一个起点。
+// 发球与接一取自发球→接一联合分布表（serveReceiveTable.h，精确枚举），按质量值分段得到各起点的概率；
+// 进攻起点之间的转移涉及二传、扣球、拦网、防守的大量随机档位，无法逐一枚举，仍用各环节的函数从每个起点抽样，
+// 再解线性方程得到各起点的得分概率，从而得到发球方在每种场上布局下赢得一分的概率。
+// 有了每分的概率后，局（25/15分，领先2分）与比赛（三局两胜）的胜率用动态规划求解，
+// 转移表建好后任意比分下的预测都只需微秒级计算。
+// 结果带有转移抽样的误差（质量值分段也是一种近似）：用自助法把每个起点的抽样结果有放回地重抽 bootstrap 次、
+// 各自重新求解，给出整场胜率的 95% 区间。
+
+// 质量值按 10 分一段
+const int kQualityBuckets = 11;
+
+// 场上布局：发球方、双方轮转与自由人替换情况
+struct CourtConfig {
+    int serveSide = 0;
+    int rotateA[6] = {0}, rotateB[6] = {0};
+    int liberoReplaceA = -1, liberoReplaceB = -1;
+    int next[2] = {-1, -1};         // A队/B队得分后的布局
+    int arrangement = -1;           // 对应的轮转组合（不含发球方），回合转移表按此共用
+};
+
+struct MarkovSpec {
+    int rallySamples = 400;         // 每个进攻起点抽样次数
+    int bootstrap = 100;            // 自助法重抽次数，0 为不估计误差
+    uint64_t seed = 1;
+    int threads = 0;                // 0 为自动
+};
+
+struct MatchupModel {
+    std::vector<CourtConfig> configs;
+    int startConfig[2] = {-1, -1};      // 按发球方的开局布局
+    // serveWin[局-1][局势][布局]：发球方赢得这一分的概率
+    // 局势按发球方看：0=比分接近（分差不超过2），1=领先，2=落后（影响发球策略）
+    std::vector<double> serveWin[3][3];
+    int arrangements = 0;               // 不同轮转组合数
+    int rallyStates = 0;                // 所有转移表中的进攻起点总数
+    std::vector<double> replicaMatchWinA;   // 各自助法副本的整场A队胜率
+};
+
+struct MatchPrediction {
+    double setWin[3][2];                // [局-1][开局发球方]：A队赢下该局的概率
+    double matchWinA = 0;
+    double setScore[4] = {0};           // 2:0、2:1、1:2、0:2 的概率（A队在前）
+    // 整场胜率的抽样误差（自助法），没有副本时为 0
+    double matchWinLow = 0, matchWinHigh = 0, matchWinStdError = 0;
+};
+
+// 以当前线程的阵容和平衡参数建立转移表
+MatchupModel buildMatchupModel(const MarkovSpec& spec);
+
+// 在第 setNum 局、比分 scoreA:scoreB、布局 config 时A队赢下本局的概率
+double setWinProbability(const MatchupModel& model, int setNum, int scoreA, int scoreB, int config);
+
+MatchPrediction predictMatch(const MatchupModel& model);
+
+void printMatchPrediction(const MatchupModel& model, const MatchPrediction& prediction);
+
+#endif //MARKOVMODEL_H
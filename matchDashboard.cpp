@@ -0,0 +1,170 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "matchDashboard.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const size_t kMaxQueuedUpdates = 32;   // 界面跟不上时丢弃最旧的更新
+    const int kRestartDelayMs = 3000;      // 比赛结束后停留的时间
+}
+
+MatchDashboard::MatchDashboard(int count) {
+    if (count <= 0) count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    workerCount = std::max(1, count);
+}
+
+MatchDashboard::~MatchDashboard() {
+    stop();
+}
+
+void MatchDashboard::setPacing(int stepInterval, int pointInterval) {
+    stepMs.store(std::max(1, stepInterval));
+    pointMs.store(std::max(1, pointInterval));
+}
+
+void MatchDashboard::start(int matchCount, const Roster& matchRoster, std::shared_ptr<const BalanceParams> matchParams,
+                           uint64_t matchSeedValue) {
+    stop();
+    roster = matchRoster;
+    params = std::move(matchParams);
+    seed = matchSeedValue;
+
+    // 各格先处于"已结束"状态，后台线程第一次推进时开出第一场
+    Clock::time_point now = Clock::now();
+    for (int i = 0; i < matchCount; i++) {
+        auto slot = std::make_unique<Slot>();
+        slot->index = i;
+        slot->score.over = true;
+        slot->due = now;
+        slots.push_back(std::move(slot));
+    }
+
+    int threadCount = std::min(workerCount, matchCount);
+    for (int w = 0; w < threadCount; w++) threads.emplace_back(&MatchDashboard::workerLoop, this, w, threadCount);
+}
+
+void MatchDashboard::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& t : threads) t.join();
+    threads.clear();
+    slots.clear();
+    stopping = false;
+}
+
+void MatchDashboard::drain(int match, std::vector<DashboardUpdate>& out) {
+    if (match < 0 || match >= matchCount()) return;
+    Slot& slot = *slots[match];
+    std::lock_guard<std::mutex> lock(slot.queueMutex);
+    for (auto& update : slot.queue) out.push_back(std::move(update));
+    slot.queue.clear();
+}
+
+// 后台线程 worker 负责第 worker、worker+stride、... 场比赛
+void MatchDashboard::workerLoop(int worker, int stride) {
+    applyRoster(roster);
+    pinBalance(params);
+    setServeReceiveTables(nullptr);
+    traceSetMask(0);
+    std::vector<std::string> events;
+    setUIEventsEnabled(true);
+    setUIEventSink(&events);    // 比赛事件留在本线程，不进界面的全局事件缓冲
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopping) {
+        lock.unlock();
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = now + std::chrono::seconds(1);
+        for (int i = worker; i < matchCount(); i += stride) {
+            Slot& slot = *slots[i];
+            if (slot.due <= now) step(slot, events);
+            next = std::min(next, slot.due);
+        }
+        lock.lock();
+        wakeCv.wait_until(lock, next, [this] { return stopping; });
+    }
+    setUIEventSink(nullptr);
+}
+
+// 开下一场比赛：第 i 格第 g 场使用种子 (seed, g * 场数 + i)，比赛级的随机数只决定各局发球方
+void MatchDashboard::resetMatch(Slot& slot) {
+    simSeed(matchSeed(seed, slot.generation * slots.size() + slot.index));
+    slot.generation++;
+
+    int firstServe = simRandBelow(2);
+    slot.secondServe = 1 - firstServe;
+    slot.thirdServe = simRandBelow(2);
+
+    slot.game = GameState();
+    startSet(slot.game, 1, firstServe);
+    slot.inRally = false;
+    slot.score = DashboardScore();
+    slot.score.serveSide = firstServe;
+}
+
+// 推进一步（一次触球），球落地时记分并判定换局
+void MatchDashboard::step(Slot& slot, std::vector<std::string>& events) {
+    uint64_t savedState = g_simRandState;
+    g_simRandState = slot.rngState;
+    events.clear();
+    Clock::time_point now = Clock::now();
+
+    if (slot.score.over) {
+        resetMatch(slot);
+        slot.due = now + std::chrono::milliseconds(pointMs.load());
+        publish(slot, "比赛开始");
+    } else {
+        if (!slot.inRally) {
+            slot.rally = beginRally(slot.game);
+            slot.inRally = true;
+        }
+        GameState& game = slot.game;
+        std::string event;
+        if (advanceRally(game, slot.rally) != PHASE_OVER) {
+            if (!events.empty()) event = std::move(events.back());
+            slot.due = now + std::chrono::milliseconds(stepMs.load());
+        } else {
+            int scorer = slot.rally.scorer;
+            slot.inRally = false;
+            applyRallyResult(game, scorer);
+            event = (scorer == 0) ? "A队得分" : "B队得分";
+            slot.due = now + std::chrono::milliseconds(pointMs.load());
+
+            if (setFinished(game)) {
+                int setNum = game.setNum;
+                int winner = advanceSet(game, slot.score.setsA, slot.score.setsB, slot.secondServe, slot.thirdServe);
+                if (slot.score.setsA == 2 || slot.score.setsB == 2) {
+                    slot.score.over = true;
+                    event = (winner == 0) ? "A队赢得比赛" : "B队赢得比赛";
+                    slot.due = now + std::chrono::milliseconds(kRestartDelayMs);
+                } else {
+                    event = std::string(winner == 0 ? "A队" : "B队") + "赢下第" + std::to_string(setNum) + "局";
+                }
+            }
+        }
+        slot.score.setNum = game.setNum;
+        slot.score.scoreA = game.scoreA;
+        slot.score.scoreB = game.scoreB;
+        slot.score.serveSide = game.serveSide;
+        publish(slot, std::move(event));
+    }
+
+    slot.rngState = g_simRandState;
+    g_simRandState = savedState;
+}
+
+void MatchDashboard::publish(Slot& slot, std::string event) {
+    DashboardUpdate update{slot.score, std::move(event)};
+    std::lock_guard<std::mutex> lock(slot.queueMutex);
+    slot.queue.push_back(std::move(update));
+    if (slot.queue.size() > kMaxQueuedUpdates) slot.queue.pop_front();
+}
@@ -0,0 +1,103 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef MATCHDASHBOARD_H
+#define MATCHDASHBOARD_H
+
+#include "batchSim.h"
+#include "rally.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============ 多场比赛看板的后台模拟 ============
+// 看板同时播放 4-16 场比赛。每场比赛固定交给一个后台线程，按一球状态机（rally.h）逐环节推进，
+// 每推进一步就把比分快照和本步的最后一条事件放进这场比赛自己的队列，界面每帧取走。
+// 后台线程按时间表推进（每次触球、每球之间都有间隔），大部分时间在休眠，
+// 线程数最多为硬件线程数减一，给界面的渲染循环留出一个核心。
+// 每场比赛保存自己的随机数状态，同一线程交替推进多场比赛时互不影响。
+
+// 一场比赛的比分快照
+struct DashboardScore {
+    int setNum = 1;
+    int scoreA = 0, scoreB = 0;
+    int setsA = 0, setsB = 0;
+    int serveSide = 0;
+    bool over = false;
+};
+
+// 一场比赛推进一步后的更新
+struct DashboardUpdate {
+    DashboardScore score;
+    std::string event;          // 本步最后一条比赛事件，可能为空
+};
+
+class MatchDashboard {
+public:
+    explicit MatchDashboard(int workerCount = 0);   // 0 为硬件线程数减一
+    ~MatchDashboard();
+
+    MatchDashboard(const MatchDashboard&) = delete;
+    MatchDashboard& operator=(const MatchDashboard&) = delete;
+
+    // 开始 matchCount 场比赛（先停止正在播放的），第 i 场使用种子 (seed, i)；比赛结束后稍停片刻开下一场
+    void start(int matchCount, const Roster& roster, std::shared_ptr<const BalanceParams> params, uint64_t seed);
+    void stop();
+
+    int matchCount() const { return static_cast<int>(slots.size()); }
+    int workers() const { return workerCount; }
+
+    // 取出第 match 场积压的更新（追加到 out），界面每帧调用
+    void drain(int match, std::vector<DashboardUpdate>& out);
+
+    // 播放节奏：每次触球的间隔、每球之间的间隔（毫秒）
+    void setPacing(int stepMs, int pointMs);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // 一场比赛。除 queue 外只由负责它的后台线程访问
+    struct Slot {
+        int index = 0;
+        uint64_t generation = 0;    // 本格已开到第几场，决定下一场的种子
+        GameState game;
+        RallyState rally;
+        bool inRally = false;
+        DashboardScore score;
+        int secondServe = 0, thirdServe = 0;
+        uint64_t rngState = 0;
+        Clock::time_point due;
+
+        std::mutex queueMutex;
+        std::deque<DashboardUpdate> queue;
+    };
+
+    int workerCount = 1;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<std::thread> threads;
+
+    Roster roster;
+    std::shared_ptr<const BalanceParams> params;
+    uint64_t seed = 0;
+    std::atomic<int> stepMs{150};
+    std::atomic<int> pointMs{700};
+
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable wakeCv;
+
+    void workerLoop(int worker, int stride);
+    void resetMatch(Slot& slot);
+    void step(Slot& slot, std::vector<std::string>& events);
+    void publish(Slot& slot, std::string event);
+};
+
+#endif //MATCHDASHBOARD_H
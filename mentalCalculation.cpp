@@ -1,6 +1,7 @@
 // mentalCalculations.cpp
 #include "mentalCalculation.h"
-#include <iostream>
+#include "simRandom.h"
+#include "trace.h"
 #include <algorithm>
 
 // 计算耐力影响
@@ -42,6 +43,22 @@ PlayerStateAdjustments calculatePlayerStateAdjustments(
     double concentrationWeight,
     double communicationWeight,
     double fatiguePerSet) {
+    int randomRoll = simRandBelow(20);
+    return calculatePlayerStateAdjustmentsForRoll(randomRoll, player, game,
+                                                  staminaWeight, mentalWeight, concentrationWeight,
+                                                  communicationWeight, fatiguePerSet);
+}
+
+// 给定随机档位（0-19，对应 -10% 到 +9%）的球员状态调整系数
+PlayerStateAdjustments calculatePlayerStateAdjustmentsForRoll(
+    int randomRoll,
+    const Player& player,
+    const GameState& game,
+    double staminaWeight,
+    double mentalWeight,
+    double concentrationWeight,
+    double communicationWeight,
+    double fatiguePerSet) {
 
     PlayerStateAdjustments adjustments;
 
@@ -62,11 +79,23 @@ PlayerStateAdjustments calculatePlayerStateAdjustments(
     total *= std::pow(adjustments.concentrationEffect, concentrationWeight);
     total *= std::pow(adjustments.communicationEffect, communicationWeight);
 
-    total *= (1.0 + double(rand() % 20 - 10) / 100.0);
+    total *= (1.0 + double(randomRoll - 10) / 100.0);
 
 
     adjustments.totalAdjustment = total;
 
+    if (traceOn(TRACE_MENTAL)) {
+        traceWrite(TRACE_MENTAL, "=== 球员状态计算调试信息 ===");
+        traceWrite(TRACE_MENTAL, "球员: {}", player.name);
+        traceWrite(TRACE_MENTAL, "耐力: {} -> 耐力影响: {}", player.stamina, adjustments.staminaEffect);
+        traceWrite(TRACE_MENTAL, "心理素质: {} -> 心理影响: {}", player.mental.pressureResist, adjustments.mentalEffect);
+        traceWrite(TRACE_MENTAL, "专注度: {} -> 专注影响: {}", player.mental.concentration, adjustments.concentrationEffect);
+        traceWrite(TRACE_MENTAL, "沟通配合: {} -> 沟通影响: {}", player.mental.commu_and_teamwork, adjustments.communicationEffect);
+        traceWrite(TRACE_MENTAL, "局数疲劳系数: {}", adjustments.setFatigue);
+        traceWrite(TRACE_MENTAL, "总调整系数: {}", adjustments.totalAdjustment);
+        traceWrite(TRACE_MENTAL, "===========================");
+    }
+
     return adjustments;
 }
 
@@ -97,19 +126,3 @@ double calculateAdjustmentWithWeights(
 
     return std::max(0.1, adjustments.totalAdjustment);
 }
-
-// 调试信息函数
-#if DEBUG_MENTAL_CALC
-void printPlayerStateDebugInfo(const Player& player, const GameState& game,
-                               const PlayerStateAdjustments& adjustments) {
-    std::cout << "\n=== 球员状态计算调试信息 ===" << std::endl;
-    std::cout << "球员: " << player.name << std::endl;
-    std::cout << "耐力: " << player.stamina << " -> 耐力影响: " << adjustments.staminaEffect << std::endl;
-    std::cout << "心理素质: " << player.mental.pressureResist << " -> 心理影响: " << adjustments.mentalEffect << std::endl;
-    std::cout << "专注度: " << player.mental.concentration << " -> 专注影响: " << adjustments.concentrationEffect << std::endl;
-    std::cout << "沟通配合: " << player.mental.commu_and_teamwork << " -> 沟通影响: " << adjustments.communicationEffect << std::endl;
-    std::cout << "局数疲劳系数: " << adjustments.setFatigue << std::endl;
-    std::cout << "总调整系数: " << adjustments.totalAdjustment << std::endl;
-    std::cout << "===========================" << std::endl;
-}
-#endif
\ No newline at end of file
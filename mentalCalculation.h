@@ -28,6 +28,18 @@ PlayerStateAdjustments calculatePlayerStateAdjustments(
     double fatiguePerSet = 0.1
 );
 
+// 同上，但随机档位由调用方给出（0-19），用于精确枚举所有可能结果
+PlayerStateAdjustments calculatePlayerStateAdjustmentsForRoll(
+    int randomRoll,
+    const Player& player,
+    const GameState& game,
+    double staminaWeight = 1.0,
+    double mentalWeight = 1.0,
+    double concentrationWeight = 1.0,
+    double communicationWeight = 1.0,
+    double fatiguePerSet = 0.1
+);
+
 // 计算耐力影响
 double calculateStaminaEffect(const Player& player, const GameState& game, double fatiguePerSet = 0.1);
 
@@ -0,0 +1,204 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "paramSweep.h"
+#include "balanceConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& error) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        error = "无法打开 " + path;
+        return false;
+    }
+
+    BalanceParams probe;
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(ifs, line)) {
+        lineNum++;
+        std::string key, value;
+        if (!parseConfigLine(line, key, value)) {
+            if (key.empty()) continue;
+            error = path + " 第" + std::to_string(lineNum) + "行格式错误: " + key;
+            return false;
+        }
+
+        std::istringstream iss(value);
+        if (key == "mode") {
+            if (value == "grid") spec.mode = SWEEP_GRID;
+            else if (value == "lhs") spec.mode = SWEEP_LHS;
+            else {
+                error = path + " 第" + std::to_string(lineNum) + "行未知扫描方式: " + value;
+                return false;
+            }
+            continue;
+        }
+        bool known = true, ok = false;
+        if (key == "samples") ok = readWhole(iss, spec.samples);
+        else if (key == "matches") ok = readWhole(iss, spec.matches);
+        else if (key == "seed") ok = readWhole(iss, spec.seed);
+        else if (key == "threads") ok = readWhole(iss, spec.threads);
+        else known = false;
+        if (known) {
+            if (ok) continue;
+            error = path + " 第" + std::to_string(lineNum) + "行数值错误: " + value;
+            return false;
+        }
+
+        double dummy = 0;
+        if (!getBalanceValue(probe, key, dummy)) {
+            error = path + " 第" + std::to_string(lineNum) + "行未知参数: " + key;
+            return false;
+        }
+        SweepParam p;
+        p.key = key;
+        p.steps = 1;
+        bool parsed = (iss >> p.low >> p.high) && ((iss >> std::ws).eof() || readWhole(iss, p.steps));
+        if (!parsed) {
+            error = path + " 第" + std::to_string(lineNum) + "行需要 下限 上限 [网格点数]: " + value;
+            return false;
+        }
+        if (p.steps < 1) p.steps = 1;
+        spec.params.push_back(p);
+    }
+
+    if (spec.params.empty()) {
+        error = path + " 中没有需要扫描的参数";
+        return false;
+    }
+    if (spec.matches < 1) spec.matches = 1;
+    if (spec.samples < 1) spec.samples = 1;
+    return true;
+}
+
+std::vector<std::vector<double>> sweepPoints(const SweepSpec& spec) {
+    std::vector<std::vector<double>> points;
+    size_t dims = spec.params.size();
+
+    if (spec.mode == SWEEP_GRID) {
+        // 笛卡尔积，最后一个参数变化最快
+        std::vector<int> idx(dims, 0);
+        while (true) {
+            std::vector<double> point(dims);
+            for (size_t d = 0; d < dims; d++) {
+                const SweepParam& p = spec.params[d];
+                point[d] = (p.steps == 1) ? p.low
+                         : p.low + (p.high - p.low) * idx[d] / (p.steps - 1);
+            }
+            points.push_back(point);
+
+            int d = static_cast<int>(dims) - 1;
+            while (d >= 0 && ++idx[d] == spec.params[d].steps) {
+                idx[d] = 0;
+                d--;
+            }
+            if (d < 0) break;
+        }
+    } else {
+        // 拉丁超立方：每个参数的区间分成 n 层，各取一个随机位置，再把各维的层次序打乱
+        int n = spec.samples;
+        std::mt19937_64 gen(spec.seed);
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        points.assign(n, std::vector<double>(dims));
+        for (size_t d = 0; d < dims; d++) {
+            std::vector<int> perm(n);
+            std::iota(perm.begin(), perm.end(), 0);
+            std::shuffle(perm.begin(), perm.end(), gen);
+            const SweepParam& p = spec.params[d];
+            for (int k = 0; k < n; k++) {
+                points[k][d] = p.low + (p.high - p.low) * (perm[k] + uni(gen)) / n;
+            }
+        }
+    }
+
+    return points;
+}
+
+std::vector<SweepRow> runSweep(const SweepSpec& spec) {
+    std::vector<std::vector<double>> points = sweepPoints(spec);
+    std::shared_ptr<const BalanceParams> base = currentBalance();
+    Roster roster = captureRoster();
+    ThreadPool pool(spec.threads);
+
+    std::cout << "参数扫描：" << points.size() << " 组参数，每组 " << spec.matches
+              << " 场，" << pool.size() << " 个线程" << std::endl;
+
+    std::vector<SweepRow> rows;
+    rows.reserve(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        BalanceParams params = *base;
+        for (size_t d = 0; d < spec.params.size(); d++) {
+            setBalanceValue(params, spec.params[d].key, points[i][d]);
+        }
+
+        // 所有参数组使用同一个种子（公共随机数），差异只来自参数本身
+        SweepRow row;
+        row.values = points[i];
+        row.stats = runMatches(pool, roster, std::make_shared<const BalanceParams>(params),
+                               spec.matches, spec.seed);
+        rows.push_back(row);
+
+        std::cout << "\r进度 " << (i + 1) << "/" << points.size() << std::flush;
+    }
+    std::cout << std::endl;
+
+    return rows;
+}
+
+void printSweepTable(const SweepSpec& spec, const std::vector<SweepRow>& rows) {
+    std::cout << std::left << std::setw(5) << "#";
+    for (const auto& p : spec.params) std::cout << std::setw(std::max<size_t>(12, p.key.size() + 2)) << p.key;
+    std::cout << std::setw(10) << "A胜率" << std::setw(10) << "ACE率" << std::setw(10) << "发球失误"
+              << std::setw(10) << "破攻率" << std::setw(10) << "回合长度" << std::setw(10) << "进攻/球"
+              << std::setw(10) << "拦网得分" << "\n";
+
+    std::cout << std::fixed;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const SweepRow& r = rows[i];
+        std::cout << std::setw(5) << i;
+        for (size_t d = 0; d < r.values.size(); d++) {
+            std::cout << std::setw(std::max<size_t>(12, spec.params[d].key.size() + 2)) << std::setprecision(4) << r.values[d];
+        }
+        double winA = r.stats.matches ? static_cast<double>(r.stats.winsA) / r.stats.matches : 0.0;
+        std::cout << std::setprecision(3)
+                  << std::setw(10) << winA
+                  << std::setw(10) << aceRate(r.stats)
+                  << std::setw(10) << serveFaultRate(r.stats)
+                  << std::setw(10) << sideOutRate(r.stats)
+                  << std::setw(10) << meanRallyLength(r.stats)
+                  << std::setw(10) << attacksPerRally(r.stats)
+                  << std::setw(10) << blockPointShare(r.stats) << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::flush;
+}
+
+bool writeSweepCsv(const std::string& path, const SweepSpec& spec, const std::vector<SweepRow>& rows) {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) return false;
+
+    ofs << "config";
+    for (const auto& p : spec.params) ofs << "," << p.key;
+    ofs << ",matches,win_rate_a,ace_rate,serve_fault_rate,sideout_rate,mean_rally_length,attacks_per_rally,block_point_share\n";
+
+    ofs << std::setprecision(6);
+    for (size_t i = 0; i < rows.size(); i++) {
+        const SweepRow& r = rows[i];
+        ofs << i;
+        for (double v : r.values) ofs << "," << v;
+        double winA = r.stats.matches ? static_cast<double>(r.stats.winsA) / r.stats.matches : 0.0;
+        ofs << "," << r.stats.matches << "," << winA
+            << "," << aceRate(r.stats) << "," << serveFaultRate(r.stats)
+            << "," << sideOutRate(r.stats) << "," << meanRallyLength(r.stats) << "," << attacksPerRally(r.stats)
+            << "," << blockPointShare(r.stats) << "\n";
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef PARAMSWEEP_H
+#define PARAMSWEEP_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 参数扫描的采样方式
+enum SweepMode {
+    SWEEP_GRID,     // 网格：各参数取等距点，做笛卡尔积
+    SWEEP_LHS       // 拉丁超立方：每个参数的区间等分为 samples 层，每层恰好取一次
+};
+
+// 一个被扫描的参数
+struct SweepParam {
+    std::string key;    // 与 config.h 中的宏同名
+    double low;
+    double high;
+    int steps;          // 网格点数（仅网格方式使用）
+};
+
+struct SweepSpec {
+    SweepMode mode = SWEEP_GRID;
+    std::vector<SweepParam> params;
+    int samples = 20;           // 拉丁超立方采样数
+    int matches = 200;          // 每组参数模拟的场数
+    uint64_t seed = 1;
+    int threads = 0;            // 0 为自动
+};
+
+// 一组参数的结果
+struct SweepRow {
+    std::vector<double> values;     // 与 SweepSpec::params 一一对应
+    MatchStats stats;
+};
+
+// 读取扫描配置文件，格式与 balance.cfg 相同：
+//   mode = grid / lhs，samples / matches / seed / threads = 数值
+//   参数名 = 下限 上限 [网格点数]
+bool loadSweepSpec(const std::string& path, SweepSpec& spec, std::string& error);
+
+// 生成所有参数组合
+std::vector<std::vector<double>> sweepPoints(const SweepSpec& spec);
+
+// 执行扫描（以当前发布的平衡参数为基础），使用当前线程的阵容
+std::vector<SweepRow> runSweep(const SweepSpec& spec);
+
+// 输出结果表
+void printSweepTable(const SweepSpec& spec, const std::vector<SweepRow>& rows);
+bool writeSweepCsv(const std::string& path, const SweepSpec& spec, const std::vector<SweepRow>& rows);
+
+#endif //PARAMSWEEP_H
@@ -1,5 +1,6 @@
 #include "player.h"
 #include "config.h"
+#include "playerJournal.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,7 +9,7 @@
 #include <algorithm>
 
 std::vector<Player> allPlayers;
-Player teamA[7], teamB[7];
+thread_local Player teamA[7], teamB[7];
 bool used[1000];
 
 // 添加去除字符串前后空格的函数
@@ -75,33 +76,14 @@ void inputPlayerData() {
     std::cout << "团队压力（负面属性）：";
     std::cin >> newPlayer.mental.teampressure;
 
-    // 将球员数据写入txt文件（追加模式）
-    std::ofstream ofs("players.txt", std::ios::app);
-    if (!ofs.is_open()) {
-        std::cerr << "无法打开文件进行写入！" << std::endl;
+    // 追加到编辑日志，只更新内存中新增的一条，不重新读取 players.txt
+    std::string error;
+    if (!addPlayerRecord(formatPlayerLine(newPlayer), error)) {
+        std::cerr << error << std::endl;
         return;
     }
 
-    // 按固定格式写入（逗号分隔，便于后续读取）
-    ofs << newPlayer.name << ","
-        << newPlayer.position << ","
-        << newPlayer.gender << ","
-        << newPlayer.spike << ","
-        << newPlayer.block << ","
-        << newPlayer.serve << ","
-        << newPlayer.pass << ","
-        << newPlayer.defense << ","
-        << newPlayer.adjust << ","
-        << newPlayer.stamina << ","
-        << newPlayer.mental.pressureResist << ","
-        << newPlayer.mental.concentration << ","
-        << newPlayer.mental.confidence << ","
-        << newPlayer.mental.commu_and_teamwork << ","
-        << newPlayer.mental.teampressure << "\n";
-    ofs.close();
-
     std::cout << "\n球员数据录入成功！已保存至players.txt" << std::endl;
-    readData();
     system("pause");
 }
 
@@ -115,49 +97,43 @@ std::vector<std::string> split(const std::string& s, char delimiter) {
     return tokens;
 }
 
-void readData() {
-    std::ifstream ifs("players.txt");
-    if (!ifs.is_open()) {
-        std::cerr << "无法打开文件进行读取！" << std::endl;
-        return;
+bool parsePlayerLine(const std::string& line, Player& player) {
+    // 跳过注释行（以"//"开头的行）和空行
+    if (line.empty() || line.find("//") == 0) {
+        return false;
     }
 
-    Player aNewPlayer;
-    std::string line;
-    allPlayers.clear();
-    while(std::getline(ifs, line)) {
-        // 跳过注释行（以"//"开头的行）和空行
-        if (line.empty() || line.find("//") == 0) {
-            continue;
-        }
-
-        std::vector<std::string> fields = split(line, ',');
+    std::vector<std::string> fields = split(line, ',');
 
-        if(fields.size() < 15) continue;
+    if(fields.size() < 15) return false;
 
-        aNewPlayer.name = trim(fields[0]);
-        aNewPlayer.position = trim(fields[1]);
-        aNewPlayer.gender = std::stoi(fields[2]);
+    try {
+        player.name = trim(fields[0]);
+        player.position = trim(fields[1]);
+        player.gender = std::stoi(fields[2]);
         // 对五项能力值应用映射函数
-        aNewPlayer.spike = mapAbilityValue(std::stoi(fields[3]));
-        aNewPlayer.block = mapAbilityValue(std::stoi(fields[4]));
-        aNewPlayer.serve = mapAbilityValue(std::stoi(fields[5]));
-        aNewPlayer.pass = mapAbilityValue(std::stoi(fields[6]));
-        aNewPlayer.defense = mapAbilityValue(std::stoi(fields[7]));
-
-
-        aNewPlayer.adjust = std::stoi(fields[8]);
-        aNewPlayer.stamina = std::stoi(fields[9]);
-        aNewPlayer.mental.pressureResist = std::stoi(fields[10]);
-        aNewPlayer.mental.concentration = std::stoi(fields[11]);
-        aNewPlayer.mental.confidence = std::stoi(fields[12]);
-        aNewPlayer.mental.commu_and_teamwork = std::stoi(fields[13]);
-        aNewPlayer.mental.teampressure = std::stoi(fields[14]);
-
-        allPlayers.push_back(aNewPlayer);
+        player.spike = mapAbilityValue(std::stoi(fields[3]));
+        player.block = mapAbilityValue(std::stoi(fields[4]));
+        player.serve = mapAbilityValue(std::stoi(fields[5]));
+        player.pass = mapAbilityValue(std::stoi(fields[6]));
+        player.defense = mapAbilityValue(std::stoi(fields[7]));
+
+
+        player.adjust = std::stoi(fields[8]);
+        player.stamina = std::stoi(fields[9]);
+        player.mental.pressureResist = std::stoi(fields[10]);
+        player.mental.concentration = std::stoi(fields[11]);
+        player.mental.confidence = std::stoi(fields[12]);
+        player.mental.commu_and_teamwork = std::stoi(fields[13]);
+        player.mental.teampressure = std::stoi(fields[14]);
+    } catch (const std::exception&) {
+        return false;
     }
+    return true;
+}
 
-    ifs.close();
+void readData() {
+    loadPlayerDatabase("players.txt");
 }
 
 void inputPlayerByPreset() {
@@ -92,12 +92,14 @@ struct Player {
 
 // 全局球员数据
 extern std::vector<Player> allPlayers;
-extern Player teamA[7], teamB[7];
+// 每个线程各自一份上场阵容，批量模拟时各线程独立比赛
+extern thread_local Player teamA[7], teamB[7];
 extern bool used[1000];
 
 // 函数声明
 void inputPlayerData();                                                 //输入一个新球员数据
-void readData();                                                        //从txt中读取球员数据
+void readData();                                                        //从txt中读取球员数据（含编辑日志）
+bool parsePlayerLine(const std::string& line, Player& player);          //解析 players.txt 的一行，注释、空行或格式错误返回 false
 void inputPlayer();                                                     //输入球员轮次
 void inputPlayerByPreset();
 void showAllPlayer();                                                   //显示所有球员
@@ -0,0 +1,412 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "playerJournal.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    const long long kCompactThreshold = 1000;          // 日志超过这么多条时在后台合并
+    const std::string kSeqPrefix = "// journal-seq: ";
+
+    // 球员库：allPlayers 之外另存每名球员的原始行（合并时原样写回，能力值不经过二次映射）
+    struct PlayerDatabase {
+        std::string basePath = "players.txt";
+        std::string journalPath = "players.txt.journal";
+        std::vector<std::string> header;                // 主文件第一名球员之前的注释与空行
+        std::vector<std::string> lines;                 // 与 allPlayers 一一对应
+        std::vector<std::vector<std::string>> notes;    // 每名球员之后、下一名之前的注释与空行，合并时原样写回
+        std::unordered_map<std::string, size_t> index;  // 姓名 -> 下标（重名时取第一个，与按姓名选人一致）
+        uint64_t baseSeq = 0;                           // 主文件已合并到的日志序号
+        uint64_t seq = 0;                               // 最后一条日志的序号
+        long long pendingRecords = 0;
+        std::uintmax_t journalBytes = 0;                // 日志中完整记录的字节数
+        bool journalTorn = false;                       // 写到一半失败且没能截掉
+        std::ofstream journal;
+        std::mutex mtx;                                 // 编辑与后台合并之间互斥
+        std::mutex compactMtx;                          // 同一时间只有一次合并
+        std::thread compactor;
+        std::atomic<bool> compacting{false};
+
+        ~PlayerDatabase() {
+            if (compactor.joinable()) compactor.join();
+        }
+    };
+
+    PlayerDatabase g_db;
+
+    std::string trimLine(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    void indexFrom(size_t first) {
+        for (size_t i = first; i < allPlayers.size(); i++) g_db.index.emplace(allPlayers[i].name, i);
+    }
+
+    // 以下三个函数只修改内存，调用前已检查过参数
+    void applyInsert(const Player& player, const std::string& line) {
+        allPlayers.push_back(player);
+        g_db.lines.push_back(line);
+        g_db.notes.emplace_back();
+        g_db.index.emplace(player.name, allPlayers.size() - 1);
+    }
+
+    void applyUpdate(size_t at, const Player& player, const std::string& line) {
+        if (player.name != allPlayers[at].name) {
+            g_db.index.erase(allPlayers[at].name);
+            g_db.index[player.name] = at;
+        }
+        allPlayers[at] = player;
+        g_db.lines[at] = line;
+    }
+
+    void applyRemove(size_t at) {
+        // 后面的球员前移一位，索引中的下标原地减一；重名的只有第一个在索引中，删掉它时由下一个同名的补上
+        const std::string name = allPlayers[at].name;
+        auto removed = g_db.index.find(name);
+        bool wasIndexed = removed != g_db.index.end() && removed->second == at;
+        if (wasIndexed) g_db.index.erase(removed);
+        for (size_t i = at + 1; i < allPlayers.size(); i++) {
+            auto it = g_db.index.find(allPlayers[i].name);
+            if (it != g_db.index.end() && it->second == i) it->second = i - 1;
+            else if (wasIndexed && it == g_db.index.end() && allPlayers[i].name == name) g_db.index.emplace(name, i - 1);
+        }
+        // 被删球员后面的注释并到前一名球员（或文件头）后面
+        std::vector<std::string>& keep = at == 0 ? g_db.header : g_db.notes[at - 1];
+        keep.insert(keep.end(), g_db.notes[at].begin(), g_db.notes[at].end());
+        allPlayers.erase(allPlayers.begin() + static_cast<std::ptrdiff_t>(at));
+        g_db.lines.erase(g_db.lines.begin() + static_cast<std::ptrdiff_t>(at));
+        g_db.notes.erase(g_db.notes.begin() + static_cast<std::ptrdiff_t>(at));
+    }
+
+    int indexOf(const std::string& name) {
+        auto it = g_db.index.find(name);
+        return it == g_db.index.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    // 检查一次编辑；通过时给出解析后的球员与要写入日志的行
+    bool checkInsert(const std::string& rawLine, Player& player, std::string& line, std::string& error) {
+        line = trimLine(rawLine);
+        player = Player{};
+        if (!parsePlayerLine(line, player)) {
+            error = "球员数据格式错误（需要15个逗号分隔的字段）: " + rawLine;
+            return false;
+        }
+        if (indexOf(player.name) >= 0) {
+            error = "球员已存在: " + player.name;
+            return false;
+        }
+        return true;
+    }
+
+    bool checkUpdate(const std::string& name, const std::string& rawLine, int& at, Player& player, std::string& line,
+                     std::string& error) {
+        at = indexOf(name);
+        if (at < 0) {
+            error = "找不到球员: " + name;
+            return false;
+        }
+        line = trimLine(rawLine);
+        player = Player{};
+        if (!parsePlayerLine(line, player)) {
+            error = "球员数据格式错误（需要15个逗号分隔的字段）: " + rawLine;
+            return false;
+        }
+        if (player.name != name && indexOf(player.name) >= 0) {
+            error = "球员已存在: " + player.name;
+            return false;
+        }
+        return true;
+    }
+
+    // 重放日志中的一行；格式不完整（如写到一半时退出）返回 false
+    bool replayRecord(const std::string& record, uint64_t& recordSeq) {
+        if (record.size() < 3 || record[1] != ' ') return false;
+        char op = record[0];
+        size_t tab = record.find('\t');
+        if (tab == std::string::npos) return false;
+        try {
+            recordSeq = std::stoull(record.substr(2, tab - 2));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (recordSeq <= g_db.baseSeq) return true;     // 已合并进主文件
+
+        std::string payload = record.substr(tab + 1);
+        std::string error;
+        Player player;
+        std::string line;
+        int at = -1;
+        bool ok = true;
+        if (op == '+') {
+            ok = checkInsert(payload, player, line, error);
+            if (ok) applyInsert(player, line);
+        } else if (op == '=') {
+            size_t split = payload.find('\t');
+            if (split == std::string::npos) return false;
+            ok = checkUpdate(payload.substr(0, split), payload.substr(split + 1), at, player, line, error);
+            if (ok) applyUpdate(static_cast<size_t>(at), player, line);
+        } else if (op == '-') {
+            at = indexOf(payload);
+            ok = at >= 0;
+            if (ok) applyRemove(static_cast<size_t>(at));
+            else error = "找不到球员: " + payload;
+        } else {
+            return false;
+        }
+        if (!ok) std::cerr << "编辑日志第 " << recordSeq << " 条无法应用，已跳过: " << error << std::endl;
+        g_db.pendingRecords++;
+        return true;
+    }
+
+    // 把日志截回最后一条完整记录的末尾
+    bool truncateTornTail() {
+        std::error_code ec;
+        std::filesystem::resize_file(g_db.journalPath, g_db.journalBytes, ec);
+        g_db.journalTorn = static_cast<bool>(ec);
+        return !ec;
+    }
+
+    // 追加一条日志并立即刷到文件；写到一半失败时截掉残缺的部分，免得下一条接在它后面
+    bool appendRecord(char op, const std::string& payload, std::string& error) {
+        if (g_db.journalTorn && !truncateTornTail()) {
+            error = "编辑日志 " + g_db.journalPath + " 末尾有写到一半的记录且无法截掉";
+            return false;
+        }
+        std::string record = op + (" " + std::to_string(g_db.seq + 1)) + "\t" + payload + "\n";
+        if (!g_db.journal.is_open()) g_db.journal.open(g_db.journalPath, std::ios::app | std::ios::binary);
+        g_db.journal << record;
+        g_db.journal.flush();
+        if (!g_db.journal) {
+            g_db.journal.close();
+            truncateTornTail();
+            error = "无法写入编辑日志 " + g_db.journalPath;
+            return false;
+        }
+        g_db.journalBytes += record.size();
+        g_db.seq++;
+        g_db.pendingRecords++;
+        return true;
+    }
+
+    // 合并：主文件换成 seq 时刻的球员库，日志只留下合并期间新追加的编辑
+    bool compactNow() {
+        std::lock_guard<std::mutex> compactLock(g_db.compactMtx);
+        std::vector<std::string> header, lines;
+        std::vector<std::vector<std::string>> notes;
+        uint64_t seq;
+        std::uintmax_t journalBytes = 0;
+        std::error_code ec;
+        {
+            std::lock_guard<std::mutex> lock(g_db.mtx);
+            if (g_db.pendingRecords == 0) return true;
+            header = g_db.header;
+            lines = g_db.lines;
+            notes = g_db.notes;
+            seq = g_db.seq;
+            journalBytes = g_db.journalBytes;
+        }
+
+        std::string tmpPath = g_db.basePath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::trunc | std::ios::binary);
+            out << kSeqPrefix << seq << "\n";
+            for (const auto& h : header) out << h << "\n";
+            for (size_t i = 0; i < lines.size(); i++) {
+                out << lines[i] << "\n";
+                for (const auto& n : notes[i]) out << n << "\n";
+            }
+            out.flush();
+            if (!out) return false;
+        }
+        std::filesystem::rename(tmpPath, g_db.basePath, ec);
+        if (ec) return false;
+
+        std::lock_guard<std::mutex> lock(g_db.mtx);
+        g_db.baseSeq = seq;
+        // 合并期间追加的编辑搬到新日志里
+        std::string tail;
+        g_db.journal.close();
+        std::ifstream in(g_db.journalPath, std::ios::binary);
+        if (in.is_open()) {
+            in.seekg(static_cast<std::streamoff>(journalBytes));
+            std::ostringstream rest;
+            rest << in.rdbuf();
+            tail = rest.str();
+        }
+        in.close();
+        std::string journalTmp = g_db.journalPath + ".tmp";
+        {
+            std::ofstream out(journalTmp, std::ios::trunc | std::ios::binary);
+            out << tail;
+        }
+        std::filesystem::rename(journalTmp, g_db.journalPath, ec);
+        g_db.journalBytes = tail.size();
+        g_db.journalTorn = false;
+        g_db.pendingRecords = static_cast<long long>(std::count(tail.begin(), tail.end(), '\n'));
+        g_db.journal.open(g_db.journalPath, std::ios::app | std::ios::binary);
+        return !ec;
+    }
+
+    void maybeCompactInBackground() {
+        {
+            std::lock_guard<std::mutex> lock(g_db.mtx);
+            if (g_db.pendingRecords < kCompactThreshold) return;
+        }
+        if (g_db.compacting.exchange(true)) return;
+        if (g_db.compactor.joinable()) g_db.compactor.join();
+        g_db.compactor = std::thread([] {
+            compactNow();
+            g_db.compacting = false;
+        });
+    }
+}
+
+bool loadPlayerDatabase(const std::string& basePath) {
+    if (g_db.compactor.joinable()) g_db.compactor.join();
+    std::lock_guard<std::mutex> lock(g_db.mtx);
+    std::ifstream ifs(basePath);
+    if (!ifs.is_open()) {
+        std::cerr << "无法打开文件进行读取！" << std::endl;
+        return false;
+    }
+
+    g_db.basePath = basePath;
+    g_db.journalPath = basePath + ".journal";
+    g_db.header.clear();
+    g_db.lines.clear();
+    g_db.notes.clear();
+    g_db.index.clear();
+    g_db.baseSeq = 0;
+    g_db.pendingRecords = 0;
+    g_db.journalTorn = false;
+    g_db.journal.close();
+    allPlayers.clear();
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.rfind(kSeqPrefix, 0) == 0) {
+            try {
+                g_db.baseSeq = std::stoull(line.substr(kSeqPrefix.size()));
+            } catch (const std::exception&) {
+            }
+            continue;
+        }
+        Player player{};
+        if (parsePlayerLine(line, player)) {
+            allPlayers.push_back(player);
+            g_db.lines.push_back(line);
+            g_db.notes.emplace_back();
+        } else if (g_db.lines.empty()) {
+            g_db.header.push_back(line);
+        } else {
+            g_db.notes.back().push_back(line);
+        }
+    }
+    indexFrom(0);
+    g_db.seq = g_db.baseSeq;
+
+    std::ifstream journal(g_db.journalPath, std::ios::binary);
+    std::string record;
+    std::streamoff goodBytes = 0;
+    bool damaged = false;
+    while (std::getline(journal, record)) {
+        uint64_t recordSeq = 0;
+        if (journal.eof() || !replayRecord(record, recordSeq)) {     // 最后一行没有换行也算写到一半
+            damaged = true;
+            break;
+        }
+        g_db.seq = std::max(g_db.seq, recordSeq);
+        goodBytes = journal.tellg();
+    }
+    journal.close();
+    if (damaged) {
+        // 截掉不完整的部分，之后的编辑接在完整的最后一条后面
+        std::cerr << "编辑日志在第 " << g_db.seq + 1 << " 条处不完整，其后内容已忽略" << std::endl;
+        std::error_code ec;
+        std::filesystem::resize_file(g_db.journalPath, static_cast<std::uintmax_t>(goodBytes), ec);
+        g_db.journalTorn = static_cast<bool>(ec);
+    }
+    g_db.journalBytes = static_cast<std::uintmax_t>(goodBytes);
+    return true;
+}
+
+bool addPlayerRecord(const std::string& rawLine, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(g_db.mtx);
+        Player player;
+        std::string line;
+        if (!checkInsert(rawLine, player, line, error) || !appendRecord('+', line, error)) return false;
+        applyInsert(player, line);
+    }
+    maybeCompactInBackground();
+    return true;
+}
+
+bool updatePlayerRecord(const std::string& name, const std::string& rawLine, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(g_db.mtx);
+        int at;
+        Player player;
+        std::string line;
+        if (!checkUpdate(name, rawLine, at, player, line, error) || !appendRecord('=', name + "\t" + line, error)) {
+            return false;
+        }
+        applyUpdate(static_cast<size_t>(at), player, line);
+    }
+    maybeCompactInBackground();
+    return true;
+}
+
+bool removePlayerRecord(const std::string& name, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(g_db.mtx);
+        int at = indexOf(name);
+        if (at < 0) {
+            error = "找不到球员: " + name;
+            return false;
+        }
+        if (!appendRecord('-', name, error)) return false;
+        applyRemove(static_cast<size_t>(at));
+    }
+    maybeCompactInBackground();
+    return true;
+}
+
+int findPlayerIndex(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_db.mtx);
+    return indexOf(name);
+}
+
+std::string formatPlayerLine(const Player& p) {
+    std::ostringstream out;
+    out << p.name << "," << p.position << "," << p.gender << "," << p.spike << "," << p.block << "," << p.serve << ","
+        << p.pass << "," << p.defense << "," << p.adjust << "," << p.stamina << "," << p.mental.pressureResist << ","
+        << p.mental.concentration << "," << p.mental.confidence << "," << p.mental.commu_and_teamwork << ","
+        << p.mental.teampressure;
+    return out.str();
+}
+
+bool compactPlayerJournal() {
+    if (g_db.compactor.joinable()) g_db.compactor.join();
+    return compactNow();
+}
+
+long long pendingJournalRecords() {
+    std::lock_guard<std::mutex> lock(g_db.mtx);
+    return g_db.pendingRecords;
+}
@@ -0,0 +1,38 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef PLAYERJOURNAL_H
+#define PLAYERJOURNAL_H
+
+#include "player.h"
+#include <string>
+
+// ============ 球员库编辑日志 ============
+// players.txt 为主文件，旁边的 players.txt.journal 为只追加的编辑日志，每行一条编辑：
+//   + 序号<TAB>姓名,位置,性别,...,团队压力          新增（字段与 players.txt 的一行相同）
+//   = 序号<TAB>原姓名<TAB>姓名,位置,...              修改（可以改名）
+//   - 序号<TAB>姓名                                 删除
+// 读取时先读主文件，再按顺序重放日志中序号大于主文件已合并序号（开头的 "// journal-seq: N" 注释）的编辑。
+// 每次编辑只追加一行日志，再原地更新 allPlayers 中受影响的一条（按姓名哈希查找），不重新解析整个文件；
+// 删除保持其余球员的先后顺序（预设阵容取前14人），需要移动其后的元素，但同样不读写主文件。
+// 日志积累到一定条数后由后台线程合并：把当时的球员库写成新的主文件（临时文件写完再 rename），
+// 然后从日志中去掉已合并的编辑。合并中途退出时，主文件里的序号保证已合并的编辑不会被重放两次。
+// 主文件中的注释与空行跟着它前面的球员（或文件头）原样写回；追加日志失败时截掉写到一半的记录。
+
+// 读取主文件并重放日志，结果放入 allPlayers（readData 调用）
+bool loadPlayerDatabase(const std::string& basePath = "players.txt");
+
+// 编辑球员库；line 为 players.txt 格式的一行。失败时返回 false 并给出原因，球员库不变
+bool addPlayerRecord(const std::string& line, std::string& error);
+bool updatePlayerRecord(const std::string& name, const std::string& line, std::string& error);
+bool removePlayerRecord(const std::string& name, std::string& error);
+
+int findPlayerIndex(const std::string& name);      // allPlayers 中的下标，找不到返回 -1
+std::string formatPlayerLine(const Player& player); // 按 players.txt 的格式写出一名球员（属性原样写出）
+
+// 立即把日志合并进主文件（等待正在进行的后台合并完成）
+bool compactPlayerJournal();
+long long pendingJournalRecords();                 // 日志中尚未合并的编辑条数
+
+#endif //PLAYERJOURNAL_H
@@ -0,0 +1,193 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "pointPipeline.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const int kMaxSpeculationDepth = 3;
+}
+
+PointPipeline::PointPipeline(int threadCount) {
+    if (threadCount <= 0) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, threadCount);
+
+    // 深度 d 每轮要打 2^(d+1)-1 球，线程数不够时减小深度
+    while (speculationDepth < kMaxSpeculationDepth && (2 << (speculationDepth + 1)) - 1 <= threadCount) {
+        speculationDepth++;
+    }
+    nodes.resize((2 << speculationDepth) - 1);
+    for (size_t i = 1; i < nodes.size(); i++) helpers.emplace_back(&PointPipeline::helperLoop, this);
+}
+
+PointPipeline::~PointPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& t : helpers) t.join();
+}
+
+void PointPipeline::helperLoop() {
+    uint64_t seen = generation.load(std::memory_order_acquire);
+    uint64_t appliedMatch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wakeCv.wait(lock, [this] { return stopping || active.load(); });
+            if (stopping) return;
+        }
+        // 比赛进行中：自旋等待新的一轮
+        while (active.load(std::memory_order_acquire)) {
+            uint64_t g = generation.load(std::memory_order_acquire);
+            if (g == seen) {
+                std::this_thread::yield();
+                continue;
+            }
+            seen = g;
+            runTasks(appliedMatch);
+        }
+    }
+}
+
+// 工作线程打本场第一球前，换上本场的阵容与参数
+void PointPipeline::prepareThread(uint64_t& appliedMatch) {
+    uint64_t current = matchNumber.load(std::memory_order_acquire);
+    if (current == appliedMatch) return;
+    applyRoster(*roster);
+    pinBalance(params);
+    setUIEventsEnabled(false);
+    setServeReceiveTables(nullptr);
+    traceSetMask(0);
+    appliedMatch = current;
+}
+
+void PointPipeline::runTasks(uint64_t& appliedMatch) {
+    int count = static_cast<int>(nodes.size());
+    for (int i = nextTask.fetch_add(1, std::memory_order_acq_rel); i < count;
+         i = nextTask.fetch_add(1, std::memory_order_acq_rel)) {
+        if (!nodes[i].before.over) {
+            prepareThread(appliedMatch);
+            playNode(nodes[i]);
+        }
+        doneTasks.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void PointPipeline::playNode(Node& node) {
+    const GameState& before = node.before.game;
+    int servingSide = before.serveSide;
+    int rotA = setterRotation(before.rotateA, setterA), rotB = setterRotation(before.rotateB, setterB);
+
+    GameState game = before;
+    simSeed(matchSeed(seed, node.before.point));
+    int scorer = processRallyFromServe(game);
+
+    int serveRot = (servingSide == 0) ? rotA : rotB, receiveRot = (servingSide == 0) ? rotB : rotA;
+    node.record = {before.setNum, before.scoreA + before.scoreB + 1, before.scoreA, before.scoreB, servingSide, scorer,
+                   serveRot, receiveRot, game.lastRallyEnd, game.lastRallyAttacks, game.lastRallyTouches};
+}
+
+// 假定 scorer 拿下这一球之后的局面（含换局），不消耗随机数
+PointPipeline::Cursor PointPipeline::advance(const Cursor& cursor, int scorer) const {
+    Cursor next = cursor;
+    if (next.over) return next;
+
+    GameState& game = next.game;
+    applyRallyResult(game, scorer);
+    next.point++;
+
+    if (setFinished(game)) {
+        advanceSet(game, next.setsA, next.setsB, secondServe, thirdServe);
+        next.over = (next.setsA == 2 || next.setsB == 2);
+    }
+    return next;
+}
+
+int PointPipeline::simulateMatch(const Roster& matchRoster, std::shared_ptr<const BalanceParams> matchParams,
+                                 uint64_t matchSeedValue, MatchStats& stats, std::vector<PointRecord>* points) {
+    roster = &matchRoster;
+    params = std::move(matchParams);
+    seed = matchSeedValue;
+
+    applyRoster(matchRoster);
+    pinBalance(params);
+    setUIEventsEnabled(false);
+    setServeReceiveTables(nullptr);
+    uint32_t savedTraceMask = t_traceMask;
+    traceSetMask(0);    // 推测分支的追踪没有意义，流水线不输出追踪
+
+    // 比赛级的随机数只决定各局发球方
+    simSeed(seed);
+    int firstServe = simRandBelow(2);
+    secondServe = 1 - firstServe;
+    thirdServe = simRandBelow(2);
+    setterA = findSetter(teamA);
+    setterB = findSetter(teamB);
+
+    Cursor cursor;
+    startSet(cursor.game, 1, firstServe);
+
+    uint64_t appliedMatch = matchNumber.fetch_add(1, std::memory_order_acq_rel) + 1;   // 本线程已设置好
+    if (!helpers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            active.store(true, std::memory_order_release);
+        }
+        wakeCv.notify_all();
+    }
+
+    int count = static_cast<int>(nodes.size());
+    while (!cursor.over) {
+        // 展开推测树：子结点的局面只取决于父结点的得分方
+        nodes[0].before = cursor;
+        for (int i = 0; 2 * i + 2 < count; i++) {
+            nodes[2 * i + 1].before = advance(nodes[i].before, 0);
+            nodes[2 * i + 2].before = advance(nodes[i].before, 1);
+        }
+        doneTasks.store(0, std::memory_order_relaxed);
+        nextTask.store(0, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+
+        runTasks(appliedMatch);
+        while (doneTasks.load(std::memory_order_acquire) < count) std::this_thread::yield();
+
+        counters.rounds++;
+        for (const Node& node : nodes) {
+            if (!node.before.over) counters.simulated++;
+        }
+
+        // 沿实际得分方向确认，另一支作废
+        for (int i = 0; i < count && !nodes[i].before.over; i = 2 * i + 1 + nodes[i].record.scorer) {
+            const PointRecord& record = nodes[i].record;
+            if (points) points->push_back(record);
+            addPointStats(stats, record);
+            counters.committed++;
+
+            cursor = advance(nodes[i].before, record.scorer);
+            if (cursor.over || cursor.game.setNum != record.setNum) {
+                stats.sets++;
+                stats.pointsA += record.scoreA + (record.scorer == 0);
+                stats.pointsB += record.scoreB + (record.scorer == 1);
+            }
+        }
+    }
+
+    if (!helpers.empty()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        active.store(false, std::memory_order_release);
+    }
+    traceSetMask(savedTraceMask);
+
+    int winner = cursor.setsA > cursor.setsB ? 0 : 1;
+    stats.matches++;
+    stats.setsA += cursor.setsA;
+    if (winner == 0) stats.winsA++;
+    return winner;
+}
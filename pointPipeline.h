@@ -0,0 +1,97 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef POINTPIPELINE_H
+#define POINTPIPELINE_H
+
+#include "batchSim.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============ 单场比赛的逐球推测流水线 ============
+// 实时预览只要一场比赛的结果，越快越好，但各球之间严格先后相依。
+// 好在一球打完后的局面（比分、发球方、轮转、换局）只取决于谁得分，所以不等第 k 球打完，
+// 就可以在空闲核心上把第 k+1 球按"A队得分""B队得分"两种局面各打一遍，第 k 球结果出来后保留对的分支、丢弃另一支。
+// 推测深度为 d 时，每轮同时打一棵 2^(d+1)-1 个结点的二叉树，沿实际得分方向一次确认 d+1 球。
+//
+// 为使结果与线程数无关，每一球用独立的随机数子序列：本场第 k 球使用种子 (seed, k)，
+// 各局的发球方由种子 seed 的序列决定。同一局面、同一球序号无论在哪个线程打、打几遍，结果都相同。
+// 因此这里的比赛与 simulateMatch 在同一种子下的比赛不是同一场，但单线程与多线程之间逐球一致。
+// 推测分支的技术统计无法按球回滚，流水线不统计技术统计（MatchStats::box）和球员得分/失误。
+//
+// 一球只需一两微秒，线程池那样用锁和条件变量派发任务的开销比一球还大，
+// 所以流水线自带工作线程：一场比赛进行中自旋等待下一轮，比赛之间在条件变量上休眠。
+
+struct PipelineStats {
+    long long rounds = 0;       // 流水线轮数
+    long long simulated = 0;    // 实际打的球数（含作废的推测分支）
+    long long committed = 0;    // 确认的球数
+};
+
+class PointPipeline {
+public:
+    explicit PointPipeline(int threadCount = 0);    // 0 为硬件线程数；少于3个线程时不推测，逐球顺序模拟
+    ~PointPipeline();
+
+    PointPipeline(const PointPipeline&) = delete;
+    PointPipeline& operator=(const PointPipeline&) = delete;
+
+    int depth() const { return speculationDepth; }
+    int threads() const { return static_cast<int>(helpers.size()) + 1; }
+
+    // 模拟一场比赛（三局两胜），返回胜方；points 非空时追加逐球记录。在调用线程上设置阵容与平衡参数
+    int simulateMatch(const Roster& roster, std::shared_ptr<const BalanceParams> params, uint64_t seed,
+                      MatchStats& stats, std::vector<PointRecord>* points = nullptr);
+
+    const PipelineStats& pipelineStats() const { return counters; }
+
+private:
+    // 一球开球前的局面
+    struct Cursor {
+        GameState game;
+        int setsA = 0, setsB = 0;
+        int point = 0;              // 本场第几球（从0开始），决定这一球的种子
+        bool over = false;          // 比赛已结束
+    };
+
+    // 推测树的一个结点：结点 i 的两个子结点 2i+1、2i+2 分别假定 A队、B队拿下结点 i 这一球
+    struct Node {
+        Cursor before;
+        PointRecord record;
+    };
+
+    int speculationDepth = 0;
+    std::vector<std::thread> helpers;
+    std::vector<Node> nodes;
+    PipelineStats counters;
+
+    // 本场比赛的设置，工作线程在打本场第一球前读取
+    const Roster* roster = nullptr;
+    std::shared_ptr<const BalanceParams> params;
+    uint64_t seed = 0;
+    int secondServe = 0, thirdServe = 0;     // 第二、三局的发球方
+    int setterA = -1, setterB = -1;
+
+    std::atomic<uint64_t> matchNumber{0};
+    std::atomic<uint64_t> generation{0};     // 轮次号，变化即有新一轮任务
+    std::atomic<int> nextTask{0};
+    std::atomic<int> doneTasks{0};
+    std::atomic<bool> active{false};         // 比赛进行中（工作线程自旋）
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable wakeCv;
+
+    void helperLoop();
+    void prepareThread(uint64_t& appliedMatch);
+    void runTasks(uint64_t& appliedMatch);
+    void playNode(Node& node);
+    Cursor advance(const Cursor& cursor, int scorer) const;
+};
+
+#endif //POINTPIPELINE_H
@@ -0,0 +1,173 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "processShards.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <new>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // 第 k 个分片的场次 [first, first+count)
+    struct ShardRange {
+        int first, count;
+    };
+
+    ShardRange shardRange(int k, int shards, int matches) {
+        int first = static_cast<int>(static_cast<long long>(matches) * k / shards);
+        int end = static_cast<int>(static_cast<long long>(matches) * (k + 1) / shards);
+        return {first, end - first};
+    }
+
+#ifndef _WIN32
+    // 共享内存中每个分片一个槽位，工作进程写完统计后再置 done
+    struct ShardSlot {
+        std::atomic<uint32_t> done{0};
+        MatchStats stats;
+    };
+
+    std::string describeStatus(int status) {
+        if (WIFSIGNALED(status)) return std::string("被信号 ") + strsignal(WTERMSIG(status)) + " 终止";
+        if (WIFEXITED(status) && WEXITSTATUS(status) != 0) return "退出码 " + std::to_string(WEXITSTATUS(status));
+        return "未写完结果";
+    }
+#endif
+}
+
+#ifdef _WIN32
+
+MatchStats runMatchesSharded(const Roster& roster, std::shared_ptr<const BalanceParams> params,
+                             int matches, uint64_t seed, const ShardSpec& spec, ShardReport& report) {
+    auto t0 = std::chrono::steady_clock::now();
+    report = ShardReport();
+    ThreadPool pool(std::max(1, spec.processes) * std::max(1, spec.threadsPerProcess));
+    MatchStats stats = runMatches(pool, roster, params, matches, seed);
+    report.ok = true;
+    report.processes = 1;
+    report.shards = 1;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return stats;
+}
+
+#else
+
+MatchStats runMatchesSharded(const Roster& roster, std::shared_ptr<const BalanceParams> params,
+                             int matches, uint64_t seed, const ShardSpec& spec, ShardReport& report) {
+    auto t0 = std::chrono::steady_clock::now();
+    report = ShardReport();
+    int shards = std::clamp(spec.shards > 0 ? spec.shards : std::max(1, spec.processes) * 4, 1, std::max(1, matches));
+    int processes = std::clamp(spec.processes, 1, shards);
+    report.shards = shards;
+    report.processes = processes;
+
+    size_t bytes = sizeof(ShardSlot) * shards;
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        report.error = std::string("无法分配共享内存: ") + std::strerror(errno);
+        return MatchStats();
+    }
+    ShardSlot* slots = static_cast<ShardSlot*>(mem);
+    for (int k = 0; k < shards; k++) new (&slots[k]) ShardSlot();
+
+    // 子进程会复制尚未写出的缓冲，先刷新
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    std::deque<int> pending;
+    for (int k = 0; k < shards; k++) pending.push_back(k);
+    std::vector<int> attempts(shards, 0);
+    std::map<pid_t, int> running;
+
+    while (report.error.empty() && (!pending.empty() || !running.empty())) {
+        while (static_cast<int>(running.size()) < processes && !pending.empty()) {
+            int k = pending.front();
+            slots[k].done.store(0, std::memory_order_relaxed);
+            pid_t pid = fork();
+            if (pid == 0) {
+                ShardRange range = shardRange(k, shards, matches);
+                {
+                    ThreadPool pool(std::max(1, spec.threadsPerProcess));
+                    slots[k].stats = runMatches(pool, roster, params, range.count, seed, range.first);
+                }
+                slots[k].done.store(1, std::memory_order_release);
+                _exit(0);
+            }
+            if (pid < 0) {
+                // 进程数受限时等已有的进程结束再试；一个都没有时只能放弃
+                if (running.empty()) report.error = std::string("无法创建工作进程: ") + std::strerror(errno);
+                break;
+            }
+            pending.pop_front();
+            running[pid] = k;
+        }
+        if (running.empty()) continue;
+
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            report.error = std::string("等待工作进程失败: ") + std::strerror(errno);
+            break;
+        }
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+        int k = it->second;
+        running.erase(it);
+
+        ShardRange range = shardRange(k, shards, matches);
+        bool good = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                    slots[k].done.load(std::memory_order_acquire) == 1 && slots[k].stats.matches == range.count;
+        if (good) continue;
+        if (attempts[k] >= spec.retries) {
+            report.error = "分片 " + std::to_string(k) + "（第 " + std::to_string(range.first) + " 场起）重跑 " +
+                           std::to_string(attempts[k]) + " 次仍失败：" + describeStatus(status);
+            break;
+        }
+        attempts[k]++;
+        report.reruns++;
+        std::cerr << "分片 " << k << " 的工作进程" << describeStatus(status) << "，重跑" << std::endl;
+        pending.push_front(k);
+    }
+
+    // 失败时结束仍在运行的进程
+    for (const auto& entry : running) kill(entry.first, SIGKILL);
+    for (const auto& entry : running) waitpid(entry.first, nullptr, 0);
+
+    MatchStats total;
+    if (report.error.empty()) {
+        for (int k = 0; k < shards; k++) total.add(slots[k].stats);
+        report.ok = true;
+    }
+    for (int k = 0; k < shards; k++) slots[k].~ShardSlot();
+    munmap(mem, bytes);
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return total;
+}
+
+#endif
+
+void printShardReport(const ShardReport& report) {
+    if (!report.ok) {
+        std::cerr << "多进程模拟失败: " << report.error << std::endl;
+        return;
+    }
+    std::cout << "多进程：" << report.processes << " 个进程、" << report.shards << " 个分片，用时 " << report.seconds << " 秒";
+    if (report.reruns) std::cout << "，重跑 " << report.reruns << " 个分片";
+    std::cout << std::endl;
+}
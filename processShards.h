@@ -0,0 +1,41 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef PROCESSSHARDS_H
+#define PROCESSSHARDS_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ============ 多进程分片批量模拟 ============
+// 把第 0 到 matches-1 场按下标切成 shards 个连续分片，由协调进程 fork 出工作进程，同时最多 processes 个，
+// 每个工作进程模拟一个分片（第 i 场仍用种子 (seed, i)），把结果写进共享内存中该分片自己的槽位后退出。
+// 协调进程按分片顺序合并各槽位；所有统计都是整数计数，合并结果与单进程 runMatches 逐位相同。
+// 工作进程崩溃、被杀或没有写完槽位时，该分片重新 fork 一个进程重跑，最多 retries 次，仍失败才整体失败。
+// 不支持 fork 的平台（Windows）退化为在本进程内用线程池模拟。
+
+struct ShardSpec {
+    int processes = 4;                      // 同时运行的工作进程数
+    int shards = 0;                         // 分片数，0 为 processes 的 4 倍（分片越小，慢进程拖尾越短）
+    int threadsPerProcess = 1;              // 每个工作进程的线程数
+    int retries = 3;                        // 每个分片最多重跑几次
+};
+
+struct ShardReport {
+    bool ok = false;
+    int processes = 0, shards = 0;
+    int reruns = 0;                         // 重跑的分片次数
+    std::string error;
+    double seconds = 0;
+};
+
+// 调用前不要在本线程以外持有锁（fork 只复制调用线程）；输出缓冲会先刷新
+MatchStats runMatchesSharded(const Roster& roster, std::shared_ptr<const BalanceParams> params,
+                             int matches, uint64_t seed, const ShardSpec& spec, ShardReport& report);
+
+void printShardReport(const ShardReport& report);
+
+#endif //PROCESSSHARDS_H
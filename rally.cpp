@@ -0,0 +1,542 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "rally.h"
+#include "serveReceiveTable.h"
+#include "balanceConfig.h"
+#include "simRandom.h"
+#include "trace.h"
+
+extern void emitUIEvent(const char* msg);
+extern void emitUIEventf(const char* format, ...);  // 事件关闭时不做格式化
+
+namespace {
+    thread_local std::vector<RallyTouch>* t_touchLog = nullptr;
+
+    // 记录一次触球并计入回合长度；拦网未触球（NO_TOUCH）照常记录，但不算触球
+    void recordTouch(GameState& game, RallyPhase phase, int team, int player, int action, int result, int value) {
+        if (phase != PHASE_BLOCK || result != NO_TOUCH) game.lastRallyTouches++;
+        if (t_touchLog) t_touchLog->push_back({phase, team, player, action, result, value});
+    }
+
+    const Player* teamOf(int side) {
+        return (side == 0) ? teamA : teamB;
+    }
+
+    const int* rotationOf(const GameState& game, int side) {
+        return (side == 0) ? game.rotateA : game.rotateB;
+    }
+
+    const char* sideName(int side) {
+        return (side == 0) ? "A" : "B";
+    }
+
+    // 按下标取球员，-1 时返回空球员
+    const Player& playerAt(int side, int index) {
+        static const Player none{};
+        return (index >= 0) ? teamOf(side)[index] : none;
+    }
+
+    void countFault(GameState& game, int side, int index) {
+        if (side == 0) {
+            game.faultA[index]++;
+        } else {
+            game.faultB[index]++;
+        }
+    }
+
+    void countScore(GameState& game, int side, int index) {
+        if (side == 0) {
+            game.scoredA[index]++;
+        } else {
+            game.scoredB[index]++;
+        }
+    }
+
+    RallyPhase endRally(GameState& game, RallyState& rally, int scorer, RallyEnd end) {
+        game.lastRallyEnd = end;
+        rally.scorer = scorer;
+        return PHASE_OVER;
+    }
+
+    // 防守成功后，防守方转为进攻方，按接一结果组织下一次进攻
+    RallyPhase continueFromDig(RallyState& rally, const DefenseResult& defenseResult) {
+        switch (defenseResult.quality) {
+            case DEFENSE_PERFECT: rally.receiveQuality = RECEIVE_PERFECT; break;
+            case DEFENSE_GOOD: rally.receiveQuality = RECEIVE_GOOD; break;
+            case DEFENSE_BAD: rally.receiveQuality = RECEIVE_BAD; break;
+            case DEFENSE_FAULT: rally.receiveQuality = RECEIVE_FAULT; break;
+        }
+        rally.receiveValue = defenseResult.qualityValue;
+        rally.receiverIndex = defenseResult.defenderIndex;
+        rally.receivePosition = -1;
+        std::swap(rally.attackingTeam, rally.defendingTeam);
+        return PHASE_SET;
+    }
+
+    const char* defenseReceiveDescription(ReceiveQuality quality) {
+        switch (quality) {
+            case RECEIVE_PERFECT: return "完美防守，可以组织快攻";
+            case RECEIVE_GOOD: return "好防守，可以组织进攻";
+            case RECEIVE_BAD: return "防守不到位，只能调整攻";
+            case RECEIVE_FAULT: return "防守失误";
+        }
+        return "";
+    }
+
+    // 扣球结果（拦网、防守环节用）。扣球强度已按拦网结果修正
+    SpikeResult spikeOf(const RallyState& rally, int attackingTeam) {
+        SpikeResult spike;
+        spike.strategy = rally.spikeStrategy;
+        spike.spikePower = rally.spikePower;
+        spike.blockCoefficient = rally.blockCoefficient;
+        spike.isError = false;
+        spike.isOut = false;
+        spike.attacker = playerAt(attackingTeam, rally.attackerIndex);
+        spike.isSetterDump = rally.setterDump;
+        return spike;
+    }
+
+    // 拦回时拦网球员在对方，不影响本方防守选位，withBlockers 为 false
+    BlockResultInfo blockOf(const RallyState& rally, bool withBlockers) {
+        BlockResultInfo block;
+        block.result = rally.blockResult;
+        block.blockPower = rally.blockPower;
+        block.blockEffect = rally.blockEffect;
+        block.increasedSpikePower = rally.increasedSpikePower;
+        block.reducedSpikePower = rally.reducedSpikePower;
+        block.blockBackPower = rally.blockBackPower;
+        if (withBlockers) {
+            block.blockerCount = rally.blockerCount;
+            for (int i = 0; i < rally.blockerCount; i++) block.blockers[i] = rally.blockers[i];
+        }
+        return block;
+    }
+
+    // 1. 发球
+    RallyPhase playServe(GameState& game, RallyState& rally) {
+        game.lastRallyAttacks = 0;
+        game.lastRallyTouches = 0;
+
+        int serverID = rotationOf(game, game.serveSide)[0];
+        const Player& server = teamOf(game.serveSide)[serverID];
+
+        TRACE(TRACE_GAME, "第{}局 A:{} B:{} {}队{}发球", game.setNum, game.scoreA, game.scoreB,
+              sideName(game.serveSide), server.name);
+
+        // 批量模拟时查发球→接一联合分布表，一次抽样得到两个环节的结果；界面模式逐步计算
+        ServeReceiveTables* tables = serveReceiveTables();
+        ServeResult serveResult;
+        if (tables) {
+            ReceiveResult receiveResult;
+            tables->sample(game, serveResult, receiveResult);
+            if (serveResult.success) {
+                rally.receiveSampled = true;
+                rally.receiveQuality = receiveResult.quality;
+                rally.receiveValue = receiveResult.qualityValue;
+                rally.receivePosition = receiveResult.position;
+                rally.receiverIndex = receiveResult.receiverIndex;
+            }
+        } else {
+            Serve serve(server, game);
+            serveResult = serve.simulate();
+        }
+        rally.serveType = serveResult.type;
+        rally.serveEffectiveness = serveResult.effectiveness;
+        recordTouch(game, PHASE_SERVE, game.serveSide, serverID, serveResult.type, -1, serveResult.effectiveness);
+
+        PlayerBox* serverBox = boxOf(game, game.serveSide, serverID);
+        if (serverBox) serverBox->serveAttempts[serveResult.type]++;
+
+        const char* serveTypeStr = (serveResult.type == STABLE_SERVE) ? "稳定发球" : "冲发球";
+        emitUIEventf("%s队%s使用%s...", sideName(game.serveSide), server.name.c_str(), serveTypeStr);
+
+        if (!serveResult.success) {
+            // 发球失误，接发球方得分
+            emitUIEvent("发球失误！");
+
+            countFault(game, game.serveSide, serverID);
+            if (serverBox) serverBox->serveErrors[serveResult.type]++;
+
+            return endRally(game, rally, rally.attackingTeam, RALLY_SERVE_FAULT);
+        }
+
+        emitUIEventf("发球成功，效果值：%d", serveResult.effectiveness);
+        return PHASE_RECEIVE;
+    }
+
+    // 2. 接一
+    RallyPhase playReceive(GameState& game, RallyState& rally) {
+        ReceiveServe receiveServe(game, rally.attackingTeam, rally.serveEffectiveness);
+        if (!rally.receiveSampled) {
+            ReceiveResult receiveResult = receiveServe.simulate();
+            rally.receiveQuality = receiveResult.quality;
+            rally.receiveValue = receiveResult.qualityValue;
+            rally.receivePosition = receiveResult.position;
+            rally.receiverIndex = receiveResult.receiverIndex;
+        }
+
+        if (PlayerBox* receiverBox = boxOf(game, rally.attackingTeam, rally.receiverIndex)) {
+            receiverBox->receptions[rally.receiveQuality]++;
+        }
+        recordTouch(game, PHASE_RECEIVE, rally.attackingTeam, rally.receiverIndex, -1, rally.receiveQuality, rally.receiveValue);
+
+        // 显示接一阵型信息
+        ReceiveFormation formation = receiveServe.getReceiveFormation();
+        const char* formationStr = (formation == FORMATION_4_PLAYER) ? "4人接一" : "3人接一";
+        emitUIEventf("%s队采用%s阵型", sideName(rally.attackingTeam), formationStr);
+
+        // 显示接一结果
+        emitUIEventf("%s队%s接一：%s（质量值：%d）",
+                sideName(rally.attackingTeam),
+                playerAt(rally.attackingTeam, rally.receiverIndex).name.c_str(),
+                ReceiveServe::qualityDescription(rally.receiveQuality),
+                rally.receiveValue);
+
+        if (rally.receiveQuality == RECEIVE_FAULT) {
+            // 接飞，发球方得分（ace球）
+            emitUIEvent("接飞！直接失分");
+
+            int serverID = rotationOf(game, game.serveSide)[0];
+            countScore(game, game.serveSide, serverID);
+            if (PlayerBox* serverBox = boxOf(game, game.serveSide, serverID)) serverBox->serveAces[rally.serveType]++;
+
+            return endRally(game, rally, rally.defendingTeam, RALLY_ACE);
+        }
+        return PHASE_SET;
+    }
+
+    // 3. 二传
+    RallyPhase playSet(GameState& game, RallyState& rally) {
+        if (rally.attackCount >= balance().maxRallyCount) {
+            // 达到最大回合数，随机决定得分方（防止无限循环）
+            emitUIEventf("攻防回合过多（超过%d回合），随机决定得分方", balance().maxRallyCount);
+            int scorer = (simRandBelow(2) == 0) ? rally.attackingTeam : rally.defendingTeam;
+            return endRally(game, rally, scorer, RALLY_LIMIT);
+        }
+        rally.attackCount++;
+
+        const int* rotation = rotationOf(game, rally.attackingTeam);
+        const Player* team = teamOf(rally.attackingTeam);
+
+        rally.setterIndex = -1;
+        for (int i = 0; i < 6; i++) {
+            if (team[rotation[i]].position == "S" || team[rotation[i]].position == "二传") {
+                rally.setterIndex = rotation[i];
+                break;
+            }
+        }
+        const Player& setter = playerAt(rally.attackingTeam, rally.setterIndex);
+
+        // 二传只用到起球的质量，不必还原接一球员
+        ReceiveResult receive;
+        receive.quality = rally.receiveQuality;
+        receive.qualityValue = rally.receiveValue;
+        receive.position = rally.receivePosition;
+
+        Setter setterObj(setter, game, rally.attackingTeam);
+        PassResult passResult = setterObj.simulateSet(receive);
+
+        rally.passTarget = passResult.target;
+        rally.passQuality = passResult.quality;
+        rally.passValue = passResult.qualityValue;
+        rally.setterDump = passResult.isSetterDump;
+        rally.dumpEffectiveness = passResult.dumpEffectiveness;
+        rally.targetIndex = passResult.isSetterDump ? rally.setterIndex : passResult.targetIndex;
+
+        if (PlayerBox* setterBox = boxOf(game, rally.attackingTeam, rally.setterIndex)) setterBox->sets[passResult.target]++;
+        recordTouch(game, PHASE_SET, rally.attackingTeam, rally.setterIndex, passResult.target, passResult.quality,
+                    passResult.qualityValue);
+
+        if (passResult.isSetterDump) {
+            // 二次进攻的特殊显示格式
+            emitUIEventf("%s队%s二次进攻：%s（质量值：%d）",
+                    sideName(rally.attackingTeam),
+                    setter.name.c_str(),
+                    passResult.description.c_str(),
+                    passResult.qualityValue);
+            emitUIEventf("二次进攻效果值：%d", passResult.dumpEffectiveness);
+        } else {
+            // 正常传球的显示格式
+            emitUIEventf("%s队%s传球给%s：%s（质量值：%d）",
+                    sideName(rally.attackingTeam),
+                    setter.name.c_str(),
+                    passResult.targetPlayer.name.c_str(),
+                    passResult.description.c_str(),
+                    passResult.qualityValue);
+        }
+
+        // 如果二传失误，直接失分
+        if (passResult.quality == POOR_PASS && !passResult.isSetterDump) {
+            emitUIEvent("传球失误！直接失分");
+
+            countFault(game, rally.attackingTeam, rally.setterIndex);
+            return endRally(game, rally, rally.defendingTeam, RALLY_SET_FAULT);
+        }
+        return PHASE_ATTACK;
+    }
+
+    // 4. 扣球
+    RallyPhase playAttack(GameState& game, RallyState& rally) {
+        game.lastRallyAttacks++;
+
+        SpikeResult spikeResult;
+        if (rally.setterDump) {
+            // 二次进攻
+            const Player& setter = playerAt(rally.attackingTeam, rally.setterIndex);
+            emitUIEventf("%s进行二次进攻...", setter.name.c_str());
+
+            spikeResult = Spiker::createSetterDumpResult(setter, rally.dumpEffectiveness, rally.attackingTeam);
+            rally.attackerIndex = rally.setterIndex;
+            rally.attackerID = rally.setterIndex;
+
+            emitUIEventf("%s使用二次进攻：%s", spikeResult.attacker.name.c_str(), spikeResult.description.c_str());
+        } else {
+            // 正常扣球
+            PassResult passResult;
+            passResult.target = rally.passTarget;
+            passResult.quality = rally.passQuality;
+            passResult.qualityValue = rally.passValue;
+            passResult.targetPlayer = playerAt(rally.attackingTeam, rally.targetIndex);
+            passResult.isSetterDump = false;
+            passResult.dumpEffectiveness = rally.dumpEffectiveness;
+
+            emitUIEventf("%s准备扣球...", passResult.targetPlayer.name.c_str());
+
+            Spiker spiker(passResult.targetPlayer, game, rally.attackingTeam);
+            spikeResult = spiker.simulateSpike(passResult);
+            rally.attackerIndex = rally.targetIndex;
+
+            // 得分、失误记在场上的攻手名下（不在场上时记在0号）
+            const int* rotation = rotationOf(game, rally.attackingTeam);
+            rally.attackerID = 0;
+            for (int i = 0; i < 6; i++) {
+                if (rotation[i] == rally.targetIndex) {
+                    rally.attackerID = rotation[i];
+                    break;
+                }
+            }
+
+            // 显示扣球策略
+            const char* strategyStr = "";
+            switch (spikeResult.strategy) {
+                case STRONG_ATTACK: strategyStr = "强攻"; break;
+                case AVOID_BLOCK: strategyStr = "避手"; break;
+                case DROP_SHOT: strategyStr = "吊球"; break;
+                case QUICK_ATTACK: strategyStr = "快球"; break;
+                case ADJUST_SPIKE: strategyStr = "调整攻"; break;
+                case TRANSITION_ATTACK: strategyStr = "过渡"; break;
+                case SETTER_SPIKE: strategyStr = "二次进攻"; break;
+            }
+            emitUIEventf("%s使用%s：%s", spikeResult.attacker.name.c_str(), strategyStr, spikeResult.description.c_str());
+        }
+
+        PlayerBox* attackerBox = boxOf(game, rally.attackingTeam, rally.attackerID);
+        if (attackerBox) attackerBox->spikeAttempts[spikeResult.strategy]++;
+        recordTouch(game, PHASE_ATTACK, rally.attackingTeam, rally.attackerIndex, spikeResult.strategy, -1, spikeResult.spikePower);
+
+        if (spikeResult.isError) {
+            emitUIEvent(rally.setterDump ? "二次进攻失误！失分" : "扣球失误！失分");
+
+            countFault(game, rally.attackingTeam, rally.attackerID);
+            if (attackerBox) attackerBox->spikeErrors[spikeResult.strategy]++;
+
+            return endRally(game, rally, rally.defendingTeam, RALLY_ATTACK_FAULT);
+        }
+
+        emitUIEventf(rally.setterDump ? "二次进攻强度：%d，拦网系数：%.2f" : "扣球强度：%d，拦网系数：%.2f",
+                spikeResult.spikePower,
+                spikeResult.blockCoefficient);
+
+        rally.spikeStrategy = spikeResult.strategy;
+        rally.spikePower = spikeResult.spikePower;
+        rally.blockCoefficient = spikeResult.blockCoefficient;
+        return PHASE_BLOCK;
+    }
+
+    // 5. 拦网
+    RallyPhase playBlock(GameState& game, RallyState& rally) {
+        Blocker blocker(game, rally.defendingTeam, rally.attackingTeam);
+        BlockResultInfo blockResult = blocker.simulateBlock(spikeOf(rally, rally.attackingTeam));
+
+        rally.blockResult = blockResult.result;
+        rally.blockPower = blockResult.blockPower;
+        rally.blockEffect = blockResult.blockEffect;
+        rally.increasedSpikePower = blockResult.increasedSpikePower;
+        rally.reducedSpikePower = blockResult.reducedSpikePower;
+        rally.blockBackPower = blockResult.blockBackPower;
+        rally.blockerCount = 0;
+        for (int i = 0; i < blockResult.blockerCount; i++) {
+            int id = blockResult.blockers[i];
+            rally.blockers[rally.blockerCount++] = id;
+            if (PlayerBox* blockerBox = boxOf(game, rally.defendingTeam, id)) blockerBox->blocks[blockResult.result]++;
+        }
+        recordTouch(game, PHASE_BLOCK, rally.defendingTeam, rally.blockerCount > 0 ? rally.blockers[0] : -1, -1,
+                    blockResult.result, blockResult.blockPower);
+
+        // 显示拦网结果
+        emitUIEventf("%s队拦网：%s（拦网强度：%d，效果值：%.2f）",
+                sideName(rally.defendingTeam),
+                blockResult.description.c_str(),
+                blockResult.blockPower,
+                blockResult.blockEffect);
+
+        // 根据拦网结果处理
+        switch (blockResult.result) {
+            case BLOCK_BACK:
+                // 拦回，原进攻方需要防守拦回球
+                emitUIEventf("球被拦回！%s队需要防守拦回球", sideName(rally.attackingTeam));
+                if (PlayerBox* attackerBox = boxOf(game, rally.attackingTeam, rally.attackerID)) {
+                    attackerBox->spikeBlocked[rally.spikeStrategy]++;
+                }
+                // 交换攻防角色：拦网方成为进攻方
+                std::swap(rally.attackingTeam, rally.defendingTeam);
+                return PHASE_COVER;
+
+            case BLOCK_BREAK:
+                // 拦网破坏，扣球强度增加
+                emitUIEventf("拦网破坏！扣球强度从%d增加到%d", rally.spikePower, blockResult.increasedSpikePower);
+                rally.spikePower = blockResult.increasedSpikePower;
+                break;
+
+            case LIMIT_PATH:
+                // 限制球路，扣球强度略微削减
+                emitUIEventf("限制球路！扣球强度从%d削减到%d", rally.spikePower, blockResult.reducedSpikePower);
+                rally.spikePower = blockResult.reducedSpikePower;
+                break;
+
+            case BLOCK_TOUCH:
+                // 撑起，扣球强度被削弱
+                emitUIEventf("扣球被撑起，强度从%d削弱到%d", rally.spikePower, blockResult.reducedSpikePower);
+                rally.spikePower = blockResult.reducedSpikePower;
+                break;
+
+            case NO_TOUCH:
+                // 无接触，扣球强度不变
+                emitUIEventf("无接触，扣球强度保持%d", rally.spikePower);
+                break;
+        }
+        return PHASE_DIG;
+    }
+
+    // 6. 防守扣球（拦网没有拦回的情况）
+    RallyPhase playDig(GameState& game, RallyState& rally) {
+        Defender defender(game, rally.defendingTeam, rally.attackingTeam);
+        DefenseResult defenseResult = defender.simulateDefenseAgainstSpike(spikeOf(rally, rally.attackingTeam),
+                                                                           blockOf(rally, true));
+
+        if (PlayerBox* digBox = boxOf(game, rally.defendingTeam, defenseResult.defenderIndex)) {
+            digBox->digs[defenseResult.quality]++;
+        }
+        recordTouch(game, PHASE_DIG, rally.defendingTeam, defenseResult.defenderIndex, -1, defenseResult.quality,
+                    defenseResult.qualityValue);
+
+        emitUIEventf("%s队%s防守：%s（质量值：%d）",
+                sideName(rally.defendingTeam),
+                defenseResult.defender.name.c_str(),
+                defenseResult.description.c_str(),
+                defenseResult.qualityValue);
+
+        if (defenseResult.quality == DEFENSE_FAULT) {
+            // 防守失误，进攻方得分
+            emitUIEventf("防守失误！%s队得分", sideName(rally.attackingTeam));
+
+            countScore(game, rally.attackingTeam, rally.attackerID);
+            if (PlayerBox* attackerBox = boxOf(game, rally.attackingTeam, rally.attackerID)) {
+                attackerBox->spikeKills[rally.spikeStrategy]++;
+            }
+            return endRally(game, rally, rally.attackingTeam, RALLY_ATTACK_POINT);
+        }
+        return continueFromDig(rally, defenseResult);
+    }
+
+    // 6. 防守拦回球（此时进攻方为拦网方）
+    RallyPhase playCover(GameState& game, RallyState& rally) {
+        Defender defender(game, rally.defendingTeam, rally.attackingTeam);
+        DefenseResult defenseResult = defender.simulateDefenseAgainstBlockBack(blockOf(rally, false));
+
+        if (PlayerBox* digBox = boxOf(game, rally.defendingTeam, defenseResult.defenderIndex)) {
+            digBox->digs[defenseResult.quality]++;
+        }
+        recordTouch(game, PHASE_COVER, rally.defendingTeam, defenseResult.defenderIndex, -1, defenseResult.quality,
+                    defenseResult.qualityValue);
+
+        emitUIEventf("%s队%s防守拦回球：%s（质量值：%d）",
+                sideName(rally.defendingTeam),
+                defenseResult.defender.name.c_str(),
+                defenseResult.description.c_str(),
+                defenseResult.qualityValue);
+
+        if (defenseResult.quality == DEFENSE_FAULT) {
+            // 防守失误，拦网方得分
+            emitUIEventf("防守拦回球失误！%s队得分", sideName(rally.attackingTeam));
+
+            for (int i = 0; i < rally.blockerCount; i++) {
+                if (PlayerBox* blockerBox = boxOf(game, rally.attackingTeam, rally.blockers[i])) blockerBox->blockPoints++;
+            }
+            return endRally(game, rally, rally.attackingTeam, RALLY_BLOCK_POINT);
+        }
+        return continueFromDig(rally, defenseResult);
+    }
+}
+
+void setRallyTouchLog(std::vector<RallyTouch>* log) {
+    t_touchLog = log;
+}
+
+RallyState beginRally(const GameState& game) {
+    simBeginRallyStreams(game.setNum, game.scoreA, game.scoreB);
+    simTiltServeSide(game.serveSide);
+    RallyState rally;
+    rally.phase = PHASE_SERVE;
+    rally.attackingTeam = 1 - game.serveSide;   // 接发球方开始进攻
+    rally.defendingTeam = game.serveSide;       // 发球方开始防守
+    return rally;
+}
+
+RallyState beginRallyFromReceive(int attackingTeam, int defendingTeam, const ReceiveResult& receive) {
+    RallyState rally;
+    rally.phase = PHASE_SET;
+    rally.attackingTeam = attackingTeam;
+    rally.defendingTeam = defendingTeam;
+    rally.receiveQuality = receive.quality;
+    rally.receiveValue = receive.qualityValue;
+    rally.receivePosition = receive.position;
+    rally.receiverIndex = receive.receiverIndex;
+    return rally;
+}
+
+namespace {
+    // 各环节取随机数的决策点（开启子序列时生效）
+    const SimRandSite kPhaseSites[] = {SIM_SITE_SERVE, SIM_SITE_RECEIVE, SIM_SITE_SET, SIM_SITE_SPIKE,
+                                       SIM_SITE_BLOCK, SIM_SITE_DEFENSE, SIM_SITE_DEFENSE};
+}
+
+RallyPhase advanceRally(GameState& game, RallyState& rally) {
+    if (rally.phase == PHASE_OVER) return rally.phase;
+    SimRandSiteScope site(kPhaseSites[rally.phase]);
+    switch (rally.phase) {
+        case PHASE_SERVE: rally.phase = playServe(game, rally); break;
+        case PHASE_RECEIVE: rally.phase = playReceive(game, rally); break;
+        case PHASE_SET: rally.phase = playSet(game, rally); break;
+        case PHASE_ATTACK: rally.phase = playAttack(game, rally); break;
+        case PHASE_BLOCK: rally.phase = playBlock(game, rally); break;
+        case PHASE_DIG: rally.phase = playDig(game, rally); break;
+        case PHASE_COVER: rally.phase = playCover(game, rally); break;
+        case PHASE_OVER: break;
+    }
+    return rally.phase;
+}
+
+ReceiveResult rallyReceive(const RallyState& rally) {
+    ReceiveResult receive;
+    receive.quality = rally.receiveQuality;
+    receive.qualityValue = rally.receiveValue;
+    receive.receiver = playerAt(rally.attackingTeam, rally.receiverIndex);
+    receive.receiverIndex = rally.receiverIndex;
+    receive.position = rally.receivePosition;
+    receive.description = (rally.receivePosition >= 0) ? ReceiveServe::qualityDescription(rally.receiveQuality)
+                                                       : defenseReceiveDescription(rally.receiveQuality);
+    return receive;
+}
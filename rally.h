@@ -0,0 +1,113 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef RALLY_H
+#define RALLY_H
+
+#include "game.h"
+#include "serve.h"
+#include "receiveServe.h"
+#include "setBall.h"
+#include "spike.h"
+#include "block.h"
+#include "defense.h"
+
+// ============ 一球的分步状态机 ============
+// 一球拆成发球、接一、二传、扣球、拦网、防守几个环节，每次 advanceRally() 只打一个环节（一次触球），
+// 环节之间的全部信息都存在 RallyState 里。RallyState 只含数值和球员下标（不含字符串和 Player 副本），
+// 可以随意复制、暂存：
+//   界面按帧率逐环节推进，一球打到一半也能停下来；
+//   批量代码可以在同一线程里交替推进多场比赛的回合，不必每场一个线程。
+// 球员下标是球员在本队 7 人中的位置（teamA/teamB 的下标），-1 表示没有对应球员。
+// 逐环节推进与一次打完一球（processRallyFromServe）消耗随机数的顺序完全相同，结果一致。
+
+// 下一次 advanceRally() 要打的环节
+enum RallyPhase {
+    PHASE_SERVE,        // 发球
+    PHASE_RECEIVE,      // 接发球
+    PHASE_SET,          // 二传（接一或防守起球之后）
+    PHASE_ATTACK,       // 扣球（含二次进攻）
+    PHASE_BLOCK,        // 拦网
+    PHASE_DIG,          // 防守扣球
+    PHASE_COVER,        // 防守拦回球
+    PHASE_OVER          // 球已落地，scorer 为得分方
+};
+
+const int kMaxRallyBlockers = kMaxBlockers;
+
+struct RallyState {
+    RallyPhase phase = PHASE_SERVE;
+    int attackingTeam = 0;          // 当前进攻方（持球组织进攻的一方）
+    int defendingTeam = 1;
+    int scorer = -1;                // 得分方，球未落地时为 -1
+    int attackCount = 0;            // 已打的进攻次数（超过最大回合数时随机决定得分方）
+
+    // 发球
+    ServeType serveType = STABLE_SERVE;
+    int serveEffectiveness = 0;
+
+    // 起球：接一或防守成功后的球，二传据此组织进攻
+    ReceiveQuality receiveQuality = RECEIVE_GOOD;
+    int receiveValue = 0;
+    int receiverIndex = -1;
+    int receivePosition = -1;       // 接一球员的场上位置，防守起球为 -1
+    bool receiveSampled = false;    // 查联合分布表时发球环节已抽出接一结果
+
+    // 二传
+    PassTarget passTarget = ADJUST_ATTACK;
+    PassQuality passQuality = GOOD_PASS;
+    int passValue = 0;
+    int setterIndex = -1;
+    int targetIndex = -1;           // 传球目标球员
+    bool setterDump = false;        // 二次进攻
+    int dumpEffectiveness = 0;
+
+    // 扣球
+    SpikeStrategy spikeStrategy = STRONG_ATTACK;
+    int spikePower = 0;             // 拦网后按拦网结果修正
+    double blockCoefficient = 1.0;
+    int attackerIndex = -1;         // 扣球球员
+    int attackerID = 0;             // 得分、失误计入的球员（按场上轮转查找，与原统计口径一致）
+
+    // 拦网
+    BlockResult blockResult = NO_TOUCH;
+    int blockPower = 0;
+    double blockEffect = 0.0;
+    int increasedSpikePower = 0;
+    int reducedSpikePower = 0;
+    int blockBackPower = 0;
+    int blockerCount = 0;
+    int blockers[kMaxRallyBlockers] = {-1, -1, -1};
+};
+
+// 一次触球的记录（逐球输出用）。action、result 为该环节的枚举值，没有时为 -1：
+//   发球 action=ServeType；接一 result=ReceiveQuality；二传 action=PassTarget、result=PassQuality；
+//   扣球 action=SpikeStrategy；拦网 result=BlockResult（player 为第一名拦网球员）；防守 result=DefenseQuality。
+// value 依次为发球效果值、接一质量值、传球质量值、扣球强度、拦网强度、防守质量值。
+struct RallyTouch {
+    RallyPhase phase;
+    int team;
+    int player;
+    int action;
+    int result;
+    int value;
+};
+
+// 当前线程每次触球追加一条记录到 log（nullptr 关闭，默认关闭）
+void setRallyTouchLog(std::vector<RallyTouch>* log);
+
+// 从发球开始的一球（发球方取 game.serveSide）
+RallyState beginRally(const GameState& game);
+
+// 从一次起球开始（攻防中途，下一步为二传）
+RallyState beginRallyFromReceive(int attackingTeam, int defendingTeam, const ReceiveResult& receive);
+
+// 打当前环节，更新 rally 与比赛统计，返回下一个环节（球落地时为 PHASE_OVER）。
+// 比赛事件照常经 emitUIEvent 输出，每个环节的事件在本次调用内输出完毕
+RallyPhase advanceRally(GameState& game, RallyState& rally);
+
+// 当前起球还原成接一结果（下一步为二传时有效）
+ReceiveResult rallyReceive(const RallyState& rally);
+
+#endif //RALLY_H
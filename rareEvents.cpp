@@ -0,0 +1,249 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "rareEvents.h"
+#include "rally.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+    const char* const kEventNames[] = {"长局", "爆冷0:2", "回合上限"};
+    const uint64_t kShadowSalt = 0x9e6c63d0676a9a99ULL;    // 分支的种子与正常比赛错开
+
+    // 每个槽位的累加器，x 为一场的加权值
+    struct alignas(64) RareTally {
+        double sumX[RARE_EVENT_COUNT] = {}, sumX2[RARE_EVENT_COUNT] = {};
+        long long hits[RARE_EVENT_COUNT] = {};
+        double sumW = 0;
+        long long matches = 0, branches = 0;
+
+        void add(const RareTally& o) {
+            for (int e = 0; e < RARE_EVENT_COUNT; e++) {
+                sumX[e] += o.sumX[e];
+                sumX2[e] += o.sumX2[e];
+                hits[e] += o.hits[e];
+            }
+            sumW += o.sumW;
+            matches += o.matches;
+            branches += o.branches;
+        }
+    };
+
+    // 长局只有经过平分才能达到时才从平分分支；胜方得分不超过 25 时不经平分也能达到（如 25:20），
+    // 平分分支会漏掉这些局，改为按正常比赛的逐球记录计数
+    bool longSetByBranch(const RareEventSpec& spec) {
+        return spec.shadows > 0 && spec.longSetPoints > std::max(setTarget(1), setTarget(3));
+    }
+
+    // 一场正常比赛及其分支
+    class MatchSampler {
+    public:
+        MatchSampler(const RareEventSpec& spec, RareTally& tally) : spec(spec), tally(tally) {
+            observer.beforeRally = [this](const GameState& game) { beforeRally(game); };
+            observer.beforeAttack = [this](const GameState& game, const RallyState& rally) { beforeAttack(game, rally); };
+        }
+
+        void run(int index) {
+            matchKey = matchSeed(spec.seed, index) ^ kShadowSalt;
+            branch = 0;
+            std::fill(std::begin(x), std::end(x), 0.0);
+            simSeed(matchSeed(spec.seed, index));
+            simSetTilt(spec.upsetTilt);
+            points.clear();
+
+            MatchStats match;
+            setRallyObserver(spec.shadows > 0 ? &observer : nullptr);
+            int winner = simulateMatch(match, &points);
+            setRallyObserver(nullptr);
+
+            double w = std::exp(g_simTilt.logWeight);
+            int loserSets = (winner == 0) ? static_cast<int>(match.sets - match.setsA) : static_cast<int>(match.setsA);
+            if (winner != spec.favorite && loserSets == 0) count(RARE_UPSET, w);
+            countFromPoints(w, !longSetByBranch(spec), spec.shadows <= 0);
+
+            for (int e = 0; e < RARE_EVENT_COUNT; e++) {
+                tally.sumX[e] += x[e];
+                tally.sumX2[e] += x[e] * x[e];
+            }
+            tally.sumW += w;
+            tally.matches++;
+        }
+
+    private:
+        const RareEventSpec& spec;
+        RareTally& tally;
+        RallyObserver observer;
+        std::vector<PointRecord> points;
+        uint64_t matchKey = 0;
+        uint64_t branch = 0;
+        double x[RARE_EVENT_COUNT] = {};
+
+        void count(RareEvent event, double weight) {
+            x[event] += weight;
+            tally.hits[event]++;
+        }
+
+        // 不分支的事件按正常比赛的逐球记录计数
+        void countFromPoints(double weight, bool countLongSet, bool countRallyLimit) {
+            if (!countLongSet && !countRallyLimit) return;
+            bool longSet = false, rallyLimit = false;
+            for (size_t i = 0; i < points.size(); i++) {
+                const PointRecord& p = points[i];
+                if (p.end == RALLY_LIMIT) rallyLimit = true;
+                // 一局的最后一球：记录的是发球前比分，加上这一分即为终局比分
+                if (i + 1 == points.size() || points[i + 1].setNum != p.setNum) {
+                    int finalA = p.scoreA + (p.scorer == 0 ? 1 : 0);
+                    int finalB = p.scoreB + (p.scorer == 1 ? 1 : 0);
+                    if (std::max(finalA, finalB) >= spec.longSetPoints) longSet = true;
+                }
+            }
+            if (countLongSet && longSet) count(RARE_LONG_SET, weight);
+            if (countRallyLimit && rallyLimit) count(RARE_RALLY_LIMIT, weight);
+        }
+
+        // 从当前状态复制出 shadows 份分别推演，play 返回事件是否发生；结束后恢复正常比赛的随机数与权重
+        template <typename Play>
+        void branchOut(RareEvent event, const SimTiltSpec& tilt, Play play) {
+            SimTilt mainTilt = g_simTilt;
+            uint64_t mainState = g_simRandState;
+            uint64_t mainMatchSeed = g_simStreams.matchSeed;
+            setRallyObserver(nullptr);
+
+            double sum = 0;
+            for (int k = 0; k < spec.shadows; k++) {
+                simSeed(matchSeed(matchKey, branch * 64 + k));
+                simSetTilt(tilt);
+                if (play()) {
+                    sum += std::exp(g_simTilt.logWeight);
+                    tally.hits[event]++;
+                }
+            }
+            branch++;
+            tally.branches++;
+
+            g_simTilt = mainTilt;
+            g_simRandState = mainState;
+            g_simStreams.matchSeed = mainMatchSeed;
+            setRallyObserver(&observer);
+            x[event] += std::exp(mainTilt.logWeight) * sum / spec.shadows;
+        }
+
+        void beforeRally(const GameState& game) {
+            if (!longSetByBranch(spec)) return;
+            int target = setTarget(game.setNum);
+            if (game.scoreA != target - 1 || game.scoreB != target - 1) return;
+            branchOut(RARE_LONG_SET, spec.deuceTilt, [&]() {
+                GameState shadow = game;
+                shadow.box = nullptr;
+                while (!setFinished(shadow)) applyRallyResult(shadow, processRallyFromServe(shadow));
+                return std::max(shadow.scoreA, shadow.scoreB) >= spec.longSetPoints;
+            });
+        }
+
+        void beforeAttack(const GameState& game, const RallyState& rally) {
+            if (rally.attackCount != spec.branchAttack) return;
+            branchOut(RARE_RALLY_LIMIT, spec.rallyTilt, [&]() {
+                GameState shadow = game;
+                shadow.box = nullptr;
+                RallyState shadowRally = rally;
+                simTiltServeSide(shadow.serveSide);
+                while (advanceRally(shadow, shadowRally) != PHASE_OVER) {}
+                return shadow.lastRallyEnd == RALLY_LIMIT;
+            });
+        }
+    };
+}
+
+SimTiltSpec makeUpsetTilt(int favorite, double strength) {
+    SimTiltSpec tilt;
+    tilt.odds[SIM_TILT_SERVE_FAULT][favorite] = strength;
+    tilt.odds[SIM_TILT_SPIKE_ERROR][favorite] = strength;
+    tilt.odds[SIM_TILT_DEFENSE][favorite] = 1.0 / strength;
+    return tilt;
+}
+
+SimTiltSpec makeDeuceTilt(double strength) {
+    SimTiltSpec tilt;
+    tilt.byServe = true;
+    tilt.odds[SIM_TILT_SERVE_FAULT][0] = strength;
+    tilt.odds[SIM_TILT_SPIKE_ERROR][0] = strength;
+    tilt.odds[SIM_TILT_DEFENSE][0] = 1.0 / strength;
+    tilt.odds[SIM_TILT_SPIKE_ERROR][1] = 1.0 / strength;
+    tilt.odds[SIM_TILT_DEFENSE][1] = strength;
+    return tilt;
+}
+
+SimTiltSpec makeRallyTilt(double strength) {
+    SimTiltSpec tilt;
+    for (int side = 0; side < 2; side++) {
+        tilt.odds[SIM_TILT_SPIKE_ERROR][side] = 1.0 / strength;
+        tilt.odds[SIM_TILT_DEFENSE][side] = strength;
+    }
+    return tilt;
+}
+
+RareEventResult estimateRareEvents(const RareEventSpec& spec) {
+    Roster roster = captureRoster();
+    std::shared_ptr<const BalanceParams> params = currentBalance();
+    ThreadPool pool(spec.threads);
+    std::vector<RareTally> partial(pool.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    int chunk = std::max(1, spec.matches / (pool.size() * 8));
+    // 不使用发球→接一联合分布表：表内直接抽出发球结果，绕过了发球失误的倾斜
+    pool.parallelForSlots(spec.matches, chunk, [&](int slot, int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        MatchSampler sampler(spec, partial[slot]);
+        for (int i = begin; i < end; i++) sampler.run(i);
+        simClearTilt();
+    });
+
+    RareEventResult result;
+    RareTally total;
+    for (const auto& p : partial) total.add(p);
+    double n = static_cast<double>(total.matches);
+    result.matches = total.matches;
+    result.branches = total.branches;
+    result.meanWeight = total.sumW / n;
+    for (int e = 0; e < RARE_EVENT_COUNT; e++) {
+        RareEventEstimate& est = result.events[e];
+        est.hits = total.hits[e];
+        est.probability = total.sumX[e] / n;
+        double variance = std::max(0.0, total.sumX2[e] / n - est.probability * est.probability);  // 每场加权值的方差
+        est.stdError = std::sqrt(variance / n);
+        est.effectiveSamples = total.sumX2[e] > 0 ? total.sumX[e] * total.sumX[e] / total.sumX2[e] : 0;
+        // 普通蒙特卡洛每场的方差为 p(1-p)
+        if (variance > 0) est.plainMatches = n * est.probability * (1 - est.probability) / variance;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+void printRareEventReport(const RareEventSpec& spec, const RareEventResult& result) {
+    std::cout << "稀有事件：" << result.matches << " 场，分支点 " << result.branches << " 个（每个 " << spec.shadows
+              << " 份），用时 " << result.seconds << " 秒\n";
+    std::cout << "长局为胜方得分 ≥ " << spec.longSetPoints << "，爆冷为" << (spec.favorite == 0 ? "A" : "B")
+              << "队 0:2 输球，回合上限在第 " << spec.branchAttack << " 次进攻时分支；正常比赛权重均值 "
+              << result.meanWeight << "\n";
+    if (spec.shadows > 0 && !longSetByBranch(spec)) {
+        std::cout << "长局阈值不超过 " << std::max(setTarget(1), setTarget(3)) << " 分，不经平分也能达到，按正常比赛计数（不分支）\n";
+    }
+    for (int e = 0; e < RARE_EVENT_COUNT; e++) {
+        const RareEventEstimate& est = result.events[e];
+        std::cout << "  " << kEventNames[e] << "：发生 " << est.hits << " 次，概率 " << std::setprecision(4)
+                  << est.probability << " ± " << 1.96 * est.stdError;
+        if (est.probability > 0) {
+            std::cout << "（相对误差 " << est.stdError / est.probability * 100 << "%），有效样本量 "
+                      << est.effectiveSamples << "，相当于普通蒙特卡洛 " << est.plainMatches << " 场";
+        }
+        std::cout << std::setprecision(6) << "\n";
+    }
+    std::cout << "± 为 95% 置信区间半宽；某事件一次也没有发生时无法估计，需要加大倾斜倍数或分支份数" << std::endl;
+}
@@ -0,0 +1,68 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef RAREEVENTS_H
+#define RAREEVENTS_H
+
+#include "batchSim.h"
+#include "simRandom.h"
+#include <cstdint>
+
+// ============ 稀有事件概率（重要性抽样） ============
+// 普通蒙特卡洛几乎打不出来的尾部事件：
+//   长局：某一局胜方得分达到 longSetPoints（如 35:33）
+//   爆冷：favorite 队 0:2 输掉比赛
+//   回合上限：某一球的进攻次数达到 MAX_RALLY_COUNT
+// 倾斜判定概率并按似然比加权（见 simRandom.h）。一场有几百次判定，整场倾斜会让权重极度分散，
+// 所以长局和回合上限用分支：正常比赛每进入一次平分（24:24，决胜局 14:14），就从这个状态复制出 shadows 份，
+// 各用自己的随机数、按 deuceTilt 倾斜打完这一局；每一球打到第 branchAttack 次进攻时，同样复制出 shadows 份、
+// 按 rallyTilt 打完这一球。分支从事件必经的状态出发，权重只含分支内的判定，也不影响正常比赛的进程。
+// 一场中各分支 w·I 的平均值之和，是每场该事件期望次数的无偏估计（事件稀有时即为概率）。
+// 爆冷与整场有关，按 upsetTilt 倾斜正常比赛本身（倍数宜小，1.1～1.3）；此时分支的估计再乘以正常比赛到分支点为止的权重。
+// 报告估计值、标准误、有效样本量 (Σx)²/Σx²（x 为每场的加权值），以及普通蒙特卡洛达到同样标准误所需的场数。
+
+enum RareEvent {
+    RARE_LONG_SET,
+    RARE_UPSET,
+    RARE_RALLY_LIMIT,
+    RARE_EVENT_COUNT
+};
+
+struct RareEventSpec {
+    int matches = 100000;
+    uint64_t seed = 1;
+    int threads = 0;
+    int longSetPoints = 35;                 // 一局胜方得分达到此值算长局；不超过 25 时按正常比赛计数，不分支
+    int favorite = 0;                       // 爆冷：该队（0=A队，1=B队）0:2 输球
+    int shadows = 8;                        // 每个分支点复制的份数，0 为不分支（长局、回合上限直接按正常比赛计数）
+    int branchAttack = 3;                   // 一球打到第几次进攻时分支
+    SimTiltSpec upsetTilt, deuceTilt, rallyTilt;    // 倍数全为 1 即不倾斜
+};
+
+// 常用的倾斜方向，strength 为优势比倍数（1 为不倾斜）
+SimTiltSpec makeUpsetTilt(int favorite, double strength);   // 强队更容易发球、扣球失误，更难防起
+SimTiltSpec makeDeuceTilt(double strength);                 // 发球方更容易失误、更难防起，接发球方相反：连续破攻，平分持续
+SimTiltSpec makeRallyTilt(double strength);                 // 两队都更少扣球失误、更容易防起
+
+struct RareEventEstimate {
+    long long hits = 0;                     // 发生事件的次数（正常比赛或分支，未加权）
+    double probability = 0;                 // 原模型下每场的概率（期望次数）
+    double stdError = 0;
+    double effectiveSamples = 0;
+    double plainMatches = 0;                // 普通蒙特卡洛达到同样标准误所需的场数
+};
+
+struct RareEventResult {
+    long long matches = 0;
+    long long branches = 0;                 // 分支点个数（每个复制 shadows 份）
+    double meanWeight = 0;                  // 正常比赛的权重均值，应接近 1
+    RareEventEstimate events[RARE_EVENT_COUNT];
+    double seconds = 0;
+};
+
+// 以当前线程的阵容与参数模拟
+RareEventResult estimateRareEvents(const RareEventSpec& spec);
+void printRareEventReport(const RareEventSpec& spec, const RareEventResult& result);
+
+#endif //RAREEVENTS_H
@@ -5,10 +5,21 @@
 
 #include "receiveServe.h"
 #include "config.h"
-#include <iostream>
 #include <cmath>
 
 #include "mentalCalculation.h"
+#include "simRandom.h"
+#include "trace.h"
+
+const char* receiveQualityName(ReceiveQuality value) {
+    switch (value) {
+        case RECEIVE_PERFECT: return "到位";
+        case RECEIVE_GOOD: return "半到位";
+        case RECEIVE_BAD: return "不到位";
+        case RECEIVE_FAULT: return "接飞";
+    }
+    return "";
+}
 
 
 ReceiveServe::ReceiveServe(const GameState &game, int receivingTeam, int serveEffectiveness)
@@ -34,17 +45,16 @@ ReceiveFormation ReceiveServe::getReceiveFormation() {
     // 如果接应在3号位，采用3人接一；否则4人接一
     ReceiveFormation formation = (oppositePosition == 2) ? FORMATION_3_PLAYER : FORMATION_4_PLAYER;
 
-    #if DEBUG_RECEIVE
-    std::cout << "\n=== 接一阵型调试信息 ===" << std::endl;
-    std::cout << "接应位置索引: " << oppositePosition << std::endl;
-    if (oppositePosition != -1) {
-        int actualPosition = oppositePosition + 1;
-        std::cout << "接应球员: " << team[rotate[oppositePosition]].name
-                  << " 在 " << actualPosition << "号位" << std::endl;
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一阵型调试信息 ===");
+        traceWrite(TRACE_RECEIVE, "接应位置索引: {}", oppositePosition);
+        if (oppositePosition != -1) {
+            int actualPosition = oppositePosition + 1;
+            traceWrite(TRACE_RECEIVE, "接应球员: {} 在 {}号位", team[rotate[oppositePosition]].name, actualPosition);
+        }
+        traceWrite(TRACE_RECEIVE, "采用阵型: {}", (formation == FORMATION_3_PLAYER ? "3人接一" : "4人接一"));
+        traceWrite(TRACE_RECEIVE, "========================");
     }
-    std::cout << "采用阵型: " << (formation == FORMATION_3_PLAYER ? "3人接一" : "4人接一") << std::endl;
-    std::cout << "========================" << std::endl;
-    #endif
 
     return formation;
 }
@@ -54,6 +64,7 @@ std::vector<int> ReceiveServe::getReceivePlayers(ReceiveFormation formation) {
     const int* rotate = (receivingTeam == 0) ? game.rotateA : game.rotateB;
     const Player* team = (receivingTeam == 0) ? teamA : teamB;
     std::vector<int> receivePlayers;
+    receivePlayers.reserve(6);  // 最多6人，避免逐个扩容
 
     // 定义场上位置对应的角色
     // 对于4人接一：两个主攻、自由人、接应（除了二传和前排副攻）
@@ -62,7 +73,7 @@ std::vector<int> ReceiveServe::getReceivePlayers(ReceiveFormation formation) {
     if (formation == FORMATION_4_PLAYER) {
         // 4人接一：除了二传和前排副攻的所有人
         for (int i = 0; i < 6; i++) {
-            Player player = team[rotate[i]];
+            const Player& player = team[rotate[i]];
             if (player.position != "S" && player.position != "二传") { // 排除二传
                 // 排除前排副攻（位置1、2、3中的副攻）
                 if (!(i >= 1 && i <= 3 && (player.position == "MB" || player.position == "副攻"))) {
@@ -73,7 +84,7 @@ std::vector<int> ReceiveServe::getReceivePlayers(ReceiveFormation formation) {
     } else { // FORMATION_3_PLAYER
         // 3人接一：两个主攻和自由人
         for (int i = 0; i < 6; i++) {
-            Player player = team[rotate[i]];
+            const Player& player = team[rotate[i]];
             if (player.position == "OH" || player.position == "主攻" ||
                 player.position == "L" || player.position == "自由人") {
                 receivePlayers.push_back(i);
@@ -81,151 +92,211 @@ std::vector<int> ReceiveServe::getReceivePlayers(ReceiveFormation formation) {
         }
     }
 
-    #if DEBUG_RECEIVE
-    std::cout << "\n=== 接一球员列表调试信息 ===" << std::endl;
-    std::cout << "阵型: " << (formation == FORMATION_3_PLAYER ? "3人接一" : "4人接一") << std::endl;
-    std::cout << "可接一球员数量: " << receivePlayers.size() << std::endl;
-    std::cout << "可接一球员: ";
-    for (int idx : receivePlayers) {
-        std::cout << team[rotate[idx]].name << "(" << idx+1 << "号位) ";
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一球员列表调试信息 ===");
+        traceWrite(TRACE_RECEIVE, "阵型: {}", (formation == FORMATION_3_PLAYER ? "3人接一" : "4人接一"));
+        traceWrite(TRACE_RECEIVE, "可接一球员数量: {}", receivePlayers.size());
+        for (int idx : receivePlayers) {
+            traceWrite(TRACE_RECEIVE, "可接一球员: {}({}号位)", team[rotate[idx]].name, idx+1);
+        }
+        traceWrite(TRACE_RECEIVE, "================================");
     }
-    std::cout << std::endl << "================================" << std::endl;
-    #endif
 
     return receivePlayers;
 }
 
-// 选择接一球员
-Player ReceiveServe::selectReceivePlayer(ReceiveFormation formation) {
+// 接一球员分布：按（可接一球员的位置集合，前排副攻位置）预先建表，结果为场上位置索引
+// 10%概率发向前排：有前排副攻则由其接一，否则三个前排位置等概率；
+// 90%概率发向后排：可接一球员等概率。
+// 权重总和取 300k（k 为可接一人数），两部分都能整除
+namespace {
+    constexpr int kReceiveMasks = 1 << 6;
+
+    constexpr AliasTable buildReceiverTable(int receiverMask, int frontBlockerPosition) {
+        int weights[6] = {0};
+        int receiverCount = 0;
+        for (int i = 0; i < 6; i++) {
+            if (receiverMask & (1 << i)) receiverCount++;
+        }
+        // 没有可接一球员时只能发向前排
+        int frontWeight = receiverCount > 0 ? 30 * receiverCount : 300;
+        if (frontBlockerPosition > 0) {
+            weights[frontBlockerPosition] += frontWeight;
+        } else {
+            for (int i = 1; i <= 3; i++) weights[i] += frontWeight / 3;
+        }
+        for (int i = 0; i < 6; i++) {
+            if (receiverMask & (1 << i)) weights[i] += 270;
+        }
+        AliasEntry entries[6] = {};
+        for (int i = 0; i < 6; i++) entries[i] = {i, weights[i]};
+        return makeAliasTable(entries, 6);
+    }
+
+    struct ReceiverTables {
+        AliasTable tables[kReceiveMasks][4];
+    };
+
+    constexpr ReceiverTables buildReceiverTables() {
+        ReceiverTables all;
+        for (int mask = 0; mask < kReceiveMasks; mask++) {
+            for (int front = 0; front < 4; front++) {
+                all.tables[mask][front] = buildReceiverTable(mask, front);
+            }
+        }
+        return all;
+    }
+
+    constexpr ReceiverTables kReceiverTables = buildReceiverTables();
+}
+
+const AliasTable& ReceiveServe::receiverTable(int receiverMask, int frontBlockerPosition) {
+    return kReceiverTables.tables[receiverMask & (kReceiveMasks - 1)][frontBlockerPosition];
+}
+
+// 当前轮转下接一球员（场上位置）的分布
+const AliasTable& ReceiveServe::receiverDistribution(ReceiveFormation formation) {
     const int* rotate = (receivingTeam == 0) ? game.rotateA : game.rotateB;
     const Player* team = (receivingTeam == 0) ? teamA : teamB;
 
-    std::vector<int> receivePlayers = getReceivePlayers(formation);
-
-    // 90%概率发向后排接一球员，10%概率发向前排
-    double frontRowProbability = 0.1;
-    double randomValue = (rand() % 100) / 100.0;
-
-    #if DEBUG_RECEIVE
-    std::cout << "\n=== 选择接一球员调试信息 ===" << std::endl;
-    std::cout << "随机值: " << randomValue << " 前排发球阈值: " << frontRowProbability << std::endl;
-    #endif
-
-    if (randomValue < frontRowProbability) {
-        // 发向前排，由前排副攻接一
-        for (int i = 1; i <= 3; i++) { // 前排位置：1,2,3
-            Player player = team[rotate[i]];
-            if (player.position == "MB" || player.position == "副攻") {
-                #if DEBUG_RECEIVE
-                std::cout << "发向前排，由前排副攻接一: " << player.name << std::endl;
-                std::cout << "=================================" << std::endl;
-                #endif
-                return player;
-            }
+    int receiverMask = 0;
+    for (int i : getReceivePlayers(formation)) {
+        receiverMask |= 1 << i;
+    }
+
+    // 前排位置：1,2,3，取第一个副攻
+    int frontBlockerPosition = 0;
+    for (int i = 1; i <= 3; i++) {
+        const Player& player = team[rotate[i]];
+        if (player.position == "MB" || player.position == "副攻") {
+            frontBlockerPosition = i;
+            break;
         }
-        // 如果没有找到前排副攻，随机选择一个前排球员
-        int randomFront = 1 + rand() % 3; // 1,2,3
-        Player selected = team[rotate[randomFront]];
-        #if DEBUG_RECEIVE
-        std::cout << "无前排副攻，随机选择前排球员: " << selected.name << std::endl;
-        std::cout << "=================================" << std::endl;
-        #endif
-        return selected;
-    } else {
-        // 发向后排，随机选择一个接一球员
-        int randomIndex = rand() % receivePlayers.size();
-        Player selected = team[rotate[receivePlayers[randomIndex]]];
-        #if DEBUG_RECEIVE
-        std::cout << "发向后排，随机选择后排接一球员: " << selected.name << std::endl;
-        std::cout << "=================================" << std::endl;
-        #endif
-        return selected;
     }
+
+    TRACE(TRACE_RECEIVE, "前排副攻位置: {}", (frontBlockerPosition > 0 ? frontBlockerPosition + 1 : 0));
+    return receiverTable(receiverMask, frontBlockerPosition);
+}
+
+// 选择接一球员，返回场上位置索引
+int ReceiveServe::selectReceivePosition(ReceiveFormation formation) {
+    const int* rotate = (receivingTeam == 0) ? game.rotateA : game.rotateB;
+    const Player* team = (receivingTeam == 0) ? teamA : teamB;
+
+    int position = receiverDistribution(formation).sample();
+    const Player& selected = team[rotate[position]];
+
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 选择接一球员调试信息 ===");
+        traceWrite(TRACE_RECEIVE, "选中: {}({}号位)", selected.name, position + 1);
+        traceWrite(TRACE_RECEIVE, "=================================");
+    }
+    return position;
 }
 
 // 计算接一调整系数
-double ReceiveServe::calculateReceiveAdjustment(const Player& receiver) {
+double ReceiveServe::calculateReceiveAdjustment(const Player& receiver, int randomRoll) {
     // 使用新的辅助函数
-    auto adjustments = calculatePlayerStateAdjustments(receiver, game, 1.0, 1.0, 1.0, 1.0, 0.1);
+    auto adjustments = calculatePlayerStateAdjustmentsForRoll(randomRoll, receiver, game, 1.0, 1.0, 1.0, 1.0, 0.1);
     double finalAdjustment = std::max(0.3, adjustments.totalAdjustment);
 
-#if DEBUG_RECEIVE
-    std::cout << "\n=== 接一调整系数调试信息 ===" << std::endl;
-    std::cout << "接一球员: " << receiver.name << " 防守属性: " << receiver.defense << std::endl;
-    std::cout << "1. 耐力影响: " << adjustments.staminaEffect << std::endl;
-    std::cout << "2. 心理素质影响: " << adjustments.mentalEffect << std::endl;
-    std::cout << "3. 专注度影响: " << adjustments.concentrationEffect << std::endl;
-    std::cout << "4. 沟通配合影响: " << adjustments.communicationEffect << std::endl;
-    std::cout << "最终调整系数(限定范围): " << finalAdjustment << std::endl;
-    std::cout << "============================" << std::endl;
-#endif
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一调整系数调试信息 ===");
+        traceWrite(TRACE_RECEIVE, "接一球员: {} 防守属性: {}", receiver.name, receiver.defense);
+        traceWrite(TRACE_RECEIVE, "1. 耐力影响: {}", adjustments.staminaEffect);
+        traceWrite(TRACE_RECEIVE, "2. 心理素质影响: {}", adjustments.mentalEffect);
+        traceWrite(TRACE_RECEIVE, "3. 专注度影响: {}", adjustments.concentrationEffect);
+        traceWrite(TRACE_RECEIVE, "4. 沟通配合影响: {}", adjustments.communicationEffect);
+        traceWrite(TRACE_RECEIVE, "最终调整系数(限定范围): {}", finalAdjustment);
+        traceWrite(TRACE_RECEIVE, "============================");
+    }
 
     return finalAdjustment;
 }
 
 // 计算接一质量
-ReceiveQuality ReceiveServe::calculateReceiveQuality(const Player& receiver, int& qualityValue) {
+double ReceiveServe::receiveSuccessRate(int defense, double adjustment, int serveEffectiveness, int factorRoll) {
     // 计算接一基础能力
-    double adjustment = calculateReceiveAdjustment(receiver);
-    double baseReceiveAbility = receiver.defense * (1 + 0.4 * adjustment);
+    double baseReceiveAbility = defense * (1 + 0.4 * adjustment);
 
     // 发球强度影响接一难度
     double serveDifficulty = serveEffectiveness / 100.0;
 
     // 计算接一成功率
-    double receiveSuccessRate = baseReceiveAbility / 100.0 * (1.0 - serveDifficulty * 0.3);
+    double successRate = baseReceiveAbility / 100.0 * (1.0 - serveDifficulty * 0.3);
 
     // 添加随机因素
-    double randomFactor = (rand() % 5 - 10) / 100.0;//-2.5%到+2.5%
-    receiveSuccessRate += randomFactor;
-    receiveSuccessRate = std::max(0.0, std::min(1.0, receiveSuccessRate));
+    double randomFactor = (factorRoll - 10) / 100.0;
+    successRate += randomFactor;
+    return std::max(0.0, std::min(1.0, successRate));
+}
 
-    // 根据成功率决定接一质量
-    double randomValue = (rand() % 100) / 100.0;
-
-    #if DEBUG_RECEIVE
-    std::cout << "\n=== 接一质量计算调试信息 ===" << std::endl;
-    std::cout << "发球效果值: " << serveEffectiveness << " => 发球难度系数: " << serveDifficulty << std::endl;
-    std::cout << "基础接一能力: " << receiver.defense << " * (" << 0.6 << " + 0.4*" << adjustment << ") = " << baseReceiveAbility << std::endl;
-    std::cout << "接一成功率计算: " << baseReceiveAbility/100.0 << " * (1.0 - " << serveDifficulty << "*0.3) = " << receiveSuccessRate-randomFactor << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终接一成功率: " << receiveSuccessRate << std::endl;
-    std::cout << "质量判定随机值: " << randomValue << std::endl;
-    #endif
-
-    ReceiveQuality quality;
-
-    if (randomValue < receiveSuccessRate * 0.2) {
-        qualityValue = 90 + rand() % 11;
-        quality = RECEIVE_PERFECT;    // 20%的成功率部分中，完美接一
-        #if DEBUG_RECEIVE
-        std::cout << "判定: 完美接一 (质量值: " << qualityValue << ")" << std::endl;
-        #endif
-    } else if (randomValue < receiveSuccessRate * 0.7) {
-        qualityValue = 70 + rand() % 20;
-        quality = RECEIVE_GOOD;       // 接下来的50%，半到位
-        #if DEBUG_RECEIVE
-        std::cout << "判定: 半到位 (质量值: " << qualityValue << ")" << std::endl;
-        #endif
-    } else if (randomValue < receiveSuccessRate) {
-        // 不到位：质量值40-69
-        qualityValue = 40 + rand() % 30;
-        quality = RECEIVE_BAD;        // 接下来的30%，不到位
-        #if DEBUG_RECEIVE
-        std::cout << "判定: 不到位 (质量值: " << qualityValue << ")" << std::endl;
-        #endif
-    } else {
-        // 接飞：质量值0
-        qualityValue = 0;
-        quality = RECEIVE_FAULT;      // 失败，接飞
-        #if DEBUG_RECEIVE
-        std::cout << "判定: 接飞 (质量值: " << qualityValue << ")" << std::endl;
-        #endif
+double ReceiveServe::qualityThreshold(ReceiveQuality quality, double successRate) {
+    switch (quality) {
+        case RECEIVE_PERFECT: return successRate * 0.2;   // 20%的成功率部分中，完美接一
+        case RECEIVE_GOOD: return successRate * 0.7;      // 接下来的50%，半到位
+        case RECEIVE_BAD: return successRate;             // 接下来的30%，不到位
+        default: return 1.0;                              // 失败，接飞
+    }
+}
+
+ReceiveQuality ReceiveServe::qualityForRoll(int qualityRoll, double successRate) {
+    double randomValue = qualityRoll / 100.0;
+    if (randomValue < qualityThreshold(RECEIVE_PERFECT, successRate)) {
+        return RECEIVE_PERFECT;
+    } else if (randomValue < qualityThreshold(RECEIVE_GOOD, successRate)) {
+        return RECEIVE_GOOD;
+    } else if (randomValue < qualityThreshold(RECEIVE_BAD, successRate)) {
+        return RECEIVE_BAD;
+    }
+    return RECEIVE_FAULT;
+}
+
+void ReceiveServe::qualityValueRange(ReceiveQuality quality, int& low, int& count) {
+    switch (quality) {
+        case RECEIVE_PERFECT: low = 90; count = 11; break;
+        case RECEIVE_GOOD: low = 70; count = 20; break;
+        case RECEIVE_BAD: low = 40; count = 30; break;  // 不到位：质量值40-69
+        default: low = 0; count = 1; break;             // 接飞：质量值0
     }
+}
 
-    #if DEBUG_RECEIVE
-    std::cout << "==============================" << std::endl;
-    #endif
+int ReceiveServe::drawQualityValue(ReceiveQuality quality) {
+    if (quality == RECEIVE_FAULT) return 0;
+    int low = 0, count = 1;
+    qualityValueRange(quality, low, count);
+    return low + simRandBelow(count);
+}
+
+const char* ReceiveServe::qualityDescription(ReceiveQuality quality) {
+    switch (quality) {
+        case RECEIVE_PERFECT: return "到位！完美的一传，可以组织快攻";
+        case RECEIVE_GOOD: return "半到位，可以组织强攻";
+        case RECEIVE_BAD: return "不到位，只能进行调整攻";
+        case RECEIVE_FAULT: return "接飞！直接失分";
+    }
+    return "";
+}
+
+ReceiveQuality ReceiveServe::calculateReceiveQuality(const Player& receiver, int& qualityValue) {
+    double adjustment = calculateReceiveAdjustment(receiver, simRandBelow(20));
+    int factorRoll = simRandBelow(5);
+    double successRate = receiveSuccessRate(receiver.defense, adjustment, serveEffectiveness, factorRoll);
+
+    // 根据成功率决定接一质量
+    int qualityRoll = simRandBelow(100);
+    ReceiveQuality quality = qualityForRoll(qualityRoll, successRate);
+    qualityValue = drawQualityValue(quality);
+
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一质量计算调试信息 ===");
+        traceWrite(TRACE_RECEIVE, "发球效果值: {} 防守属性: {} 调整系数: {}", serveEffectiveness, receiver.defense, adjustment);
+        traceWrite(TRACE_RECEIVE, "随机因素: {}", (factorRoll - 10) / 100.0);
+        traceWrite(TRACE_RECEIVE, "最终接一成功率: {}", successRate);
+        traceWrite(TRACE_RECEIVE, "质量判定随机值: {}", qualityRoll / 100.0);
+        traceWrite(TRACE_RECEIVE, "判定: {} (质量值: {})", receiveQualityName(quality), qualityValue);
+        traceWrite(TRACE_RECEIVE, "==============================");
+    }
 
     return quality;
 }
@@ -234,51 +305,35 @@ ReceiveQuality ReceiveServe::calculateReceiveQuality(const Player& receiver, int
 ReceiveResult ReceiveServe::simulate() {
     ReceiveResult result;
 
-    #if DEBUG_RECEIVE
-    std::cout << "\n\n=== 接一模拟开始 ===" << std::endl;
-    std::cout << "接一方: " << (receivingTeam == 0 ? "A队" : "B队") << std::endl;
-    std::cout << "发球效果值: " << serveEffectiveness << std::endl;
-    #endif
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一模拟开始 ===");
+        traceWrite(TRACE_RECEIVE, "接一方: {}", (receivingTeam == 0 ? "A队" : "B队"));
+        traceWrite(TRACE_RECEIVE, "发球效果值: {}", serveEffectiveness);
+    }
 
     // 确定接一阵型
     ReceiveFormation formation = getReceiveFormation();
 
     // 选择接一球员
-    result.receiver = selectReceivePlayer(formation);
+    const int* rotate = (receivingTeam == 0) ? game.rotateA : game.rotateB;
+    const Player* team = (receivingTeam == 0) ? teamA : teamB;
+    result.position = selectReceivePosition(formation);
+    result.receiverIndex = rotate[result.position];
+    result.receiver = team[result.receiverIndex];
 
     // 计算接一质量
     result.quality = calculateReceiveQuality(result.receiver, result.qualityValue);
 
     // 设置接一结果描述
-    switch (result.quality) {
-        case RECEIVE_PERFECT:
-            result.description = "到位！完美的一传，可以组织快攻";
-            break;
-        case RECEIVE_GOOD:
-            result.description = "半到位，可以组织强攻";
-            break;
-        case RECEIVE_BAD:
-            result.description = "不到位，只能进行调整攻";
-            break;
-        case RECEIVE_FAULT:
-            result.description = "接飞！直接失分";
-            break;
-    }
-
-    #if DEBUG_RECEIVE
-    std::cout << "\n=== 接一最终结果 ===" << std::endl;
-    std::cout << "接一球员: " << result.receiver.name << std::endl;
-    std::cout << "接一质量: ";
-    switch(result.quality) {
-        case RECEIVE_PERFECT: std::cout << "完美"; break;
-        case RECEIVE_GOOD: std::cout << "半到位"; break;
-        case RECEIVE_BAD: std::cout << "不到位"; break;
-        case RECEIVE_FAULT: std::cout << "接飞"; break;
+    result.description = qualityDescription(result.quality);
+
+    if (traceOn(TRACE_RECEIVE)) {
+        traceWrite(TRACE_RECEIVE, "=== 接一最终结果 ===");
+        traceWrite(TRACE_RECEIVE, "接一球员: {}", result.receiver.name);
+        traceWrite(TRACE_RECEIVE, "接一质量: {} (质量值: {})", receiveQualityName(result.quality), result.qualityValue);
+        traceWrite(TRACE_RECEIVE, "描述: {}", result.description);
+        traceWrite(TRACE_RECEIVE, "=== 接一模拟结束 ===");
     }
-    std::cout << " (质量值: " << result.qualityValue << ")" << std::endl;
-    std::cout << "描述: " << result.description << std::endl;
-    std::cout << "=== 接一模拟结束 ===\n" << std::endl;
-    #endif
 
     return result;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "player.h"
 #include "game.h"
+#include "aliasTable.h"
 
 #ifndef RECEIVESERVE_H
 #define RECEIVESERVE_H
@@ -17,12 +18,15 @@ enum ReceiveQuality {
     RECEIVE_FAULT       // 接飞
 };
 
+const char* receiveQualityName(ReceiveQuality value);  // 调试追踪中显示的名称
+
 // 接一结果结构体
 struct ReceiveResult {
     ReceiveQuality quality;     // 接一质量
     int qualityValue;           // 接一质量（数值）
     Player receiver;           // 接一球员
     int position;              // 接一球员在场上的位置索引
+    int receiverIndex = -1;    // 接一球员在本队的下标
     std::string description;   // 接一结果描述
 };
 
@@ -40,12 +44,10 @@ private:
 
 
     std::vector<int> getReceivePlayers(ReceiveFormation formation);
-    Player selectReceivePlayer(ReceiveFormation formation);
+    int selectReceivePosition(ReceiveFormation formation);
 
     ReceiveQuality calculateReceiveQuality(const Player& receiver, int& qualityValue);
 
-    double calculateReceiveAdjustment(const Player& receiver);
-
 public:
     ReceiveServe(const GameState& game, int receivingTeam, int serveEffectiveness);
 
@@ -53,6 +55,21 @@ public:
 
     ReceiveFormation getReceiveFormation();
 
+    // 接一球员的分布表（按可接一球员位置集合与前排副攻位置，结果为场上位置索引）
+    static const AliasTable& receiverTable(int receiverMask, int frontBlockerPosition);
+
+    // 当前轮转与阵型下接一球员（场上位置）的分布
+    const AliasTable& receiverDistribution(ReceiveFormation formation);
+
+    // 以下拆出了随机档位，便于精确枚举（发球→接一联合分布表使用）
+    double calculateReceiveAdjustment(const Player& receiver, int randomRoll);       // 档位 0-19
+    static double receiveSuccessRate(int defense, double adjustment, int serveEffectiveness, int factorRoll);  // 档位 0-4
+    static ReceiveQuality qualityForRoll(int qualityRoll, double successRate);      // 档位 0-99
+    static double qualityThreshold(ReceiveQuality quality, double successRate);     // 判定值低于此值即不差于该质量
+    static int drawQualityValue(ReceiveQuality quality);                            // 按质量抽取质量值
+    static void qualityValueRange(ReceiveQuality quality, int& low, int& count);    // 质量值在 [low, low+count) 中均匀分布
+    static const char* qualityDescription(ReceiveQuality quality);
+
 };
 
 // 函数声明
@@ -0,0 +1,314 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "resultCache.h"
+#include "player.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable_v<MatchStats>, "MatchStats 按字节存入缓存文件");
+
+struct ResultCache::Header {
+    char magic[8];
+    uint32_t format;
+    uint32_t statsBytes;        // sizeof(MatchStats)，结构变化时旧文件作废
+    uint32_t capacity;
+    uint32_t reserved;
+    uint64_t clock;             // LRU 计数，每次命中或存入加一
+};
+
+struct ResultCache::Entry {
+    uint64_t hi, lo;
+    int64_t matches;            // 0 为空槽；第 k 个条目的结果存在 results.bin 的第 k 个槽位
+    uint64_t lastUsed;
+};
+
+namespace {
+    const char kMagic[8] = {'V', 'B', 'C', 'A', 'C', 'H', 'E', '1'};
+    const uint32_t kFormatVersion = 1;
+
+    // 两路独立的 64 位哈希，合成 128 位键
+    class KeyHasher {
+    public:
+        void word(uint64_t v) {
+            for (int i = 0; i < 8; i++) {
+                hi ^= (v >> (8 * i)) & 0xff;
+                hi *= 0x100000001b3ULL;
+            }
+            lo += v + 0x9e3779b97f4a7c15ULL;
+            lo = (lo ^ (lo >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            lo = (lo ^ (lo >> 27)) * 0x94d049bb133111ebULL;
+            lo ^= lo >> 31;
+        }
+
+        void real(double v) {
+            uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            word(bits);
+        }
+
+        void text(const std::string& s) {
+            word(s.size());
+            for (size_t i = 0; i < s.size(); i += 8) {
+                uint64_t v = 0;
+                std::memcpy(&v, s.data() + i, std::min<size_t>(8, s.size() - i));
+                word(v);
+            }
+        }
+
+        void player(const Player& p) {
+            text(p.name);
+            text(p.position);
+            for (int v : {p.gender, p.spike, p.block, p.serve, p.pass, p.defense, p.adjust, p.stamina, p.wisdom}) {
+                word(static_cast<uint64_t>(static_cast<int64_t>(v)));
+            }
+            const MentalAttr& m = p.mental;
+            for (int v : {m.pressureResist, m.concentration, m.confidence, m.commu_and_teamwork, m.teampressure}) {
+                word(static_cast<uint64_t>(static_cast<int64_t>(v)));
+            }
+        }
+
+        ResultCacheKey key() const { return {hi, lo}; }
+
+    private:
+        uint64_t hi = 0xcbf29ce484222325ULL;
+        uint64_t lo = 0;
+    };
+}
+
+ResultCacheKey resultCacheKey(const Roster& roster, const BalanceParams& params, uint64_t seed) {
+    KeyHasher h;
+    h.word(kSimEngineVersion);
+    for (const auto& p : roster.teamA) h.player(p);
+    for (const auto& p : roster.teamB) h.player(p);
+    // 参数名只在第一次用到时哈希一遍，之后按同样的顺序只哈希数值
+    static const ResultCacheKey names = [] {
+        KeyHasher nameHasher;
+        for (const auto& name : balanceKeys()) nameHasher.text(name);
+        return nameHasher.key();
+    }();
+    h.word(names.hi);
+    h.word(names.lo);
+    for (double value : balanceValues(params)) h.real(value);
+    h.word(seed);
+    return h.key();
+}
+
+ResultCache::~ResultCache() {
+    close();
+}
+
+ResultCacheCounters ResultCache::counters() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stats;
+}
+
+MatchStats runMatchesCached(ThreadPool& pool, ResultCache* cache, const Roster& roster,
+                            std::shared_ptr<const BalanceParams> params, int matches, uint64_t seed,
+                            long long* cachedMatches) {
+    if (cachedMatches) *cachedMatches = 0;
+    if (!cache || !cache->isOpen()) return runMatches(pool, roster, params, matches, seed);
+
+    ResultCacheKey key = resultCacheKey(roster, *params, seed);
+    MatchStats total;
+    long long cached = cache->lookup(key, matches, total);
+    if (cachedMatches) *cachedMatches = cached;
+    if (cached == matches) return total;
+
+    // 第 cached 场起继续模拟，与一次模拟全部场次的结果逐项相同
+    total.add(runMatches(pool, roster, params, matches - static_cast<int>(cached), seed, static_cast<int>(cached)));
+    cache->store(key, matches, total);
+    return total;
+}
+
+#ifdef _WIN32
+
+bool ResultCache::open(const std::string&, int, std::string& error) {
+    error = "本平台不支持结果缓存";
+    return false;
+}
+
+void ResultCache::close() {}
+
+long long ResultCache::lookup(const ResultCacheKey&, long long, MatchStats&) {
+    return 0;
+}
+
+void ResultCache::store(const ResultCacheKey&, long long, const MatchStats&) {}
+
+#else
+
+namespace {
+    // 进程间互斥：整个查找或存入期间持有索引文件的排他锁
+    struct FileLock {
+        int fd;
+        explicit FileLock(int fd) : fd(fd) { while (::flock(fd, LOCK_EX) != 0 && errno == EINTR) {} }
+        ~FileLock() { ::flock(fd, LOCK_UN); }
+    };
+
+    bool readFully(int fd, void* buffer, size_t size, off_t offset) {
+        char* p = static_cast<char*>(buffer);
+        while (size > 0) {
+            ssize_t n = ::pread(fd, p, size, offset);
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+            offset += n;
+        }
+        return true;
+    }
+
+    bool writeFully(int fd, const void* buffer, size_t size, off_t offset) {
+        const char* p = static_cast<const char*>(buffer);
+        while (size > 0) {
+            ssize_t n = ::pwrite(fd, p, size, offset);
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+            offset += n;
+        }
+        return true;
+    }
+}
+
+bool ResultCache::open(const std::string& directory, int capacity, std::string& error) {
+    close();
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    std::string indexPath = (std::filesystem::path(directory) / "index.bin").string();
+    std::string dataPath = (std::filesystem::path(directory) / "results.bin").string();
+    indexFd = ::open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    dataFd = ::open(dataPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (indexFd < 0 || dataFd < 0) {
+        error = "无法打开缓存目录 " + directory;
+        close();
+        return false;
+    }
+
+    if (!mapIndex(capacity, indexPath, dataPath, error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::mapIndex(int capacity, const std::string& indexPath, const std::string& dataPath, std::string& error) {
+    FileLock lock(indexFd);
+
+    // 已有的索引：格式正确时沿用它的容量
+    Header existing{};
+    struct stat st{};
+    bool valid = ::fstat(indexFd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Header)) &&
+                 readFully(indexFd, &existing, sizeof(existing), 0) &&
+                 std::memcmp(existing.magic, kMagic, sizeof(kMagic)) == 0 && existing.format == kFormatVersion &&
+                 existing.statsBytes == sizeof(MatchStats) && existing.capacity > 0 &&
+                 st.st_size == static_cast<off_t>(sizeof(Header) + existing.capacity * sizeof(Entry));
+    uint32_t slots = valid ? existing.capacity : static_cast<uint32_t>(std::max(1, capacity));
+    size_t indexBytes = sizeof(Header) + slots * sizeof(Entry);
+
+    if (!valid) {
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.format = kFormatVersion;
+        header.statsBytes = sizeof(MatchStats);
+        header.capacity = slots;
+        // 先清空再写表头，条目全部为 0（空槽）
+        if (::ftruncate(indexFd, 0) != 0 || ::ftruncate(indexFd, static_cast<off_t>(indexBytes)) != 0 ||
+            ::ftruncate(dataFd, 0) != 0 || !writeFully(indexFd, &header, sizeof(header), 0)) {
+            error = "无法初始化缓存文件 " + indexPath;
+            return false;
+        }
+    }
+    // 结果文件按容量预留（稀疏文件，不占实际空间）
+    if (::ftruncate(dataFd, static_cast<off_t>(slots) * static_cast<off_t>(sizeof(MatchStats))) != 0) {
+        error = "无法扩展缓存文件 " + dataPath;
+        return false;
+    }
+
+    void* mapped = ::mmap(nullptr, indexBytes, PROT_READ | PROT_WRITE, MAP_SHARED, indexFd, 0);
+    if (mapped == MAP_FAILED) {
+        error = "无法映射缓存索引 " + indexPath;
+        return false;
+    }
+    index = static_cast<Header*>(mapped);
+    entries = reinterpret_cast<Entry*>(static_cast<char*>(mapped) + sizeof(Header));
+    mappedBytes = indexBytes;
+    return true;
+}
+
+void ResultCache::close() {
+    if (index) ::munmap(index, mappedBytes);
+    index = nullptr;
+    entries = nullptr;
+    mappedBytes = 0;
+    if (indexFd >= 0) ::close(indexFd);
+    if (dataFd >= 0) ::close(dataFd);
+    indexFd = dataFd = -1;
+}
+
+long long ResultCache::lookup(const ResultCacheKey& key, long long matches, MatchStats& out) {
+    if (!index) return 0;
+    std::lock_guard<std::mutex> guard(mtx);
+    FileLock lock(indexFd);
+    stats.lookups++;
+
+    Entry* best = nullptr;
+    for (uint32_t i = 0; i < index->capacity; i++) {
+        Entry& e = entries[i];
+        if (e.hi == key.hi && e.lo == key.lo && e.matches > 0 && e.matches <= matches &&
+            (!best || e.matches > best->matches)) {
+            best = &e;
+        }
+    }
+    MatchStats cached;
+    if (!best || !readFully(dataFd, &cached, sizeof(cached), static_cast<off_t>(best - entries) * sizeof(MatchStats))) {
+        stats.misses++;
+        return 0;
+    }
+
+    best->lastUsed = ++index->clock;
+    out = cached;
+    (best->matches == matches ? stats.hits : stats.partialHits)++;
+    stats.cachedMatches += best->matches;
+    return best->matches;
+}
+
+void ResultCache::store(const ResultCacheKey& key, long long matches, const MatchStats& value) {
+    if (!index || matches <= 0) return;
+    std::lock_guard<std::mutex> guard(mtx);
+    FileLock lock(indexFd);
+
+    // 已有同样的条目只更新使用时间；否则用空槽，没有空槽时淘汰最久未用的
+    Entry* slot = nullptr;
+    for (uint32_t i = 0; i < index->capacity; i++) {
+        Entry& e = entries[i];
+        if (e.hi == key.hi && e.lo == key.lo && e.matches == matches) {
+            e.lastUsed = ++index->clock;
+            return;
+        }
+        if (!slot || (slot->matches != 0 && (e.matches == 0 || e.lastUsed < slot->lastUsed))) slot = &e;
+    }
+    if (slot->matches != 0) stats.evictions++;
+
+    // 先作废条目再写结果，写到一半中断时不会留下错误的结果
+    slot->matches = 0;
+    if (!writeFully(dataFd, &value, sizeof(value), static_cast<off_t>(slot - entries) * sizeof(MatchStats))) return;
+    slot->hi = key.hi;
+    slot->lo = key.lo;
+    slot->lastUsed = ++index->clock;
+    slot->matches = matches;
+}
+
+#endif
@@ -0,0 +1,76 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// ============ 模拟结果缓存 ============
+// 同一对阵反复被查询时直接返回磁盘上的结果。第 i 场使用种子 (seed, i)，结果只取决于
+// （两队阵容的全部属性与顺序，生效的平衡参数，seed，引擎版本），前 n 场的汇总就由这些内容与 n 唯一确定。
+// 键为上述内容的 128 位哈希，值为前 n 场的 MatchStats；同一个键可以存多个 n。
+// 查询 n 场时取不超过 n 的最大已缓存前缀，只模拟剩下的场次，再把 n 场的结果存回去。
+//
+// 目录下两个文件：index.bin 为定长索引表（mmap 映射，查找只是内存扫描），results.bin 按槽位存放 MatchStats。
+// 表满时淘汰最久未用的条目（LRU）。多个进程可以共用一个目录，读写时对索引文件加 flock。
+// 修改比赛逻辑（改变同种子下的结果）时递增 kSimEngineVersion，旧结果自然不再命中。
+
+const uint32_t kSimEngineVersion = 1;
+
+struct ResultCacheKey {
+    uint64_t hi = 0, lo = 0;
+};
+
+ResultCacheKey resultCacheKey(const Roster& roster, const BalanceParams& params, uint64_t seed);
+
+struct ResultCacheCounters {
+    long long lookups = 0, hits = 0, partialHits = 0, misses = 0;
+    long long cachedMatches = 0;        // 从缓存取出的场数
+    long long evictions = 0;
+};
+
+class ResultCache {
+public:
+    ResultCache() = default;
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // 打开（或新建）缓存目录；已有的缓存沿用其容量，格式不符（如 MatchStats 结构变化）时清空重建
+    bool open(const std::string& directory, int capacity, std::string& error);
+    void close();
+    bool isOpen() const { return index != nullptr; }
+
+    // 取出不超过 matches 场的最长已缓存前缀，返回其场数（0 为未命中，此时 stats 不变）
+    long long lookup(const ResultCacheKey& key, long long matches, MatchStats& stats);
+    // 存入前 matches 场的汇总
+    void store(const ResultCacheKey& key, long long matches, const MatchStats& stats);
+
+    ResultCacheCounters counters();
+
+private:
+    struct Header;
+    struct Entry;
+
+    bool mapIndex(int capacity, const std::string& indexPath, const std::string& dataPath, std::string& error);
+
+    int indexFd = -1, dataFd = -1;
+    Header* index = nullptr;
+    Entry* entries = nullptr;
+    size_t mappedBytes = 0;
+    ResultCacheCounters stats;
+    std::mutex mtx;     // flock 只在进程之间互斥，同一进程的线程另用互斥量
+};
+
+// 与 runMatches 相同，cache 非空时先查缓存，只模拟缓存中没有的场次；cachedMatches 返回命中的场数
+MatchStats runMatchesCached(ThreadPool& pool, ResultCache* cache, const Roster& roster,
+                            std::shared_ptr<const BalanceParams> params, int matches, uint64_t seed,
+                            long long* cachedMatches = nullptr);
+
+#endif //RESULTCACHE_H
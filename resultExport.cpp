@@ -0,0 +1,126 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "resultExport.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    const std::vector<ColumnDef> kMatchColumns = {
+        {"match_id", COLUMN_INT64}, {"winner", COLUMN_INT32},
+        {"sets_a", COLUMN_INT32}, {"sets_b", COLUMN_INT32},
+        {"points_a", COLUMN_INT32}, {"points_b", COLUMN_INT32},
+        {"rallies", COLUMN_INT32}, {"aces", COLUMN_INT32}, {"serve_faults", COLUMN_INT32},
+        {"attack_points", COLUMN_INT32}, {"block_points", COLUMN_INT32}, {"attacks", COLUMN_INT32},
+    };
+
+    const std::vector<ColumnDef> kPointColumns = {
+        {"match_id", COLUMN_INT64}, {"set", COLUMN_INT32}, {"rally", COLUMN_INT32},
+        {"score_a", COLUMN_INT32}, {"score_b", COLUMN_INT32},
+        {"serve_side", COLUMN_INT32}, {"scorer", COLUMN_INT32},
+        {"serve_rotation", COLUMN_INT32}, {"receive_rotation", COLUMN_INT32},
+        {"end", COLUMN_INT32}, {"attacks", COLUMN_INT32},
+    };
+
+    // 每个线程槽位的缓冲
+    struct ExportSlot {
+        MatchStats total;
+        ColumnBatch matchBatch, pointBatch;
+        std::vector<PointRecord> points;
+    };
+
+    void appendMatch(ColumnBatch& batch, int64_t id, int winner, const MatchStats& m) {
+        int c = 0;
+        batch.put<int64_t>(c++, id);
+        batch.put<int32_t>(c++, winner);
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.setsA));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.sets - m.setsA));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.pointsA));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.pointsB));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.rallies));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.aces));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.serveFaults));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.attackPoints));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.blockPoints));
+        batch.put<int32_t>(c++, static_cast<int32_t>(m.attacks));
+        batch.rows++;
+    }
+
+    void appendPoint(ColumnBatch& batch, int64_t id, const PointRecord& p) {
+        int c = 0;
+        batch.put<int64_t>(c++, id);
+        batch.put<int32_t>(c++, p.setNum);
+        batch.put<int32_t>(c++, p.rally);
+        batch.put<int32_t>(c++, p.scoreA);
+        batch.put<int32_t>(c++, p.scoreB);
+        batch.put<int32_t>(c++, p.serveSide);
+        batch.put<int32_t>(c++, p.scorer);
+        batch.put<int32_t>(c++, p.serveRotation);
+        batch.put<int32_t>(c++, p.receiveRotation);
+        batch.put<int32_t>(c++, static_cast<int32_t>(p.end));
+        batch.put<int32_t>(c++, p.attacks);
+        batch.rows++;
+    }
+}
+
+ExportResult exportMatches(const Roster& roster, std::shared_ptr<const BalanceParams> params, const ExportSpec& spec) {
+    ExportResult result;
+    TableWriter matchWriter(spec.matchPath, spec.format, kMatchColumns);
+    TableWriter pointWriter(spec.pointPath, spec.format, kPointColumns);
+    if (!matchWriter.ok() || !pointWriter.ok()) return result;
+
+    ThreadPool pool(spec.threads);
+    int batchRows = std::max(1, spec.batchRows);
+    std::vector<ExportSlot> slots(pool.size());
+    std::vector<ServeReceiveTables> tables(pool.size());   // 与 runMatches 相同，每个槽位一份
+    for (auto& s : slots) {
+        s.matchBatch.reset(kMatchColumns, batchRows);
+        s.pointBatch.reset(kPointColumns, batchRows);
+    }
+
+    int chunk = std::max(1, spec.matches / (pool.size() * 8));
+    pool.parallelForSlots(spec.matches, chunk, [&](int slotIndex, int begin, int end) {
+        applyRoster(roster);
+        pinBalance(params);
+        setUIEventsEnabled(false);
+        setServeReceiveTables(&tables[slotIndex]);
+
+        ExportSlot& slot = slots[slotIndex];
+        for (int i = begin; i < end; i++) {
+            MatchStats match;
+            slot.points.clear();
+            simSeed(matchSeed(spec.seed, i));
+            int winner = simulateMatch(match, &slot.points);
+            slot.total.add(match);
+
+            appendMatch(slot.matchBatch, i, winner, match);
+            for (const auto& p : slot.points) {
+                appendPoint(slot.pointBatch, i, p);
+                if (slot.pointBatch.rows >= batchRows) {
+                    pointWriter.submit(std::move(slot.pointBatch));
+                    slot.pointBatch.reset(kPointColumns, batchRows);
+                }
+            }
+            if (slot.matchBatch.rows >= batchRows) {
+                matchWriter.submit(std::move(slot.matchBatch));
+                slot.matchBatch.reset(kMatchColumns, batchRows);
+            }
+        }
+        setServeReceiveTables(nullptr);
+    });
+
+    for (auto& s : slots) {
+        matchWriter.submit(std::move(s.matchBatch));
+        pointWriter.submit(std::move(s.pointBatch));
+        result.stats.add(s.total);
+    }
+    matchWriter.close();
+    pointWriter.close();
+    result.matchRows = matchWriter.rowsWritten();
+    result.pointRows = pointWriter.rowsWritten();
+    result.ok = true;
+    return result;
+}
@@ -0,0 +1,35 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef RESULTEXPORT_H
+#define RESULTEXPORT_H
+
+#include "batchSim.h"
+#include "columnWriter.h"
+#include <cstdint>
+#include <string>
+
+// ============ 模拟结果导出 ============
+// 批量模拟并输出两张表：每场一行（matches）、每球一行（points），以 match_id 关联。
+// 各线程攒满 batchRows 行后交给后台写线程，行的先后顺序取决于调度，但内容与线程数无关。
+
+struct ExportSpec {
+    ExportFormat format = EXPORT_ARROW;
+    std::string matchPath = "sim_matches.arrow";
+    std::string pointPath = "sim_points.arrow";
+    int matches = 1000;
+    uint64_t seed = 1;          // 第 i 场使用种子 (seed, i)，与 runMatches 相同
+    int threads = 0;            // 0 为自动
+    int batchRows = 65536;      // 每批行数
+};
+
+struct ExportResult {
+    bool ok = false;
+    MatchStats stats;           // 全部场次的汇总
+    long long matchRows = 0, pointRows = 0;
+};
+
+ExportResult exportMatches(const Roster& roster, std::shared_ptr<const BalanceParams> params, const ExportSpec& spec);
+
+#endif //RESULTEXPORT_H
@@ -0,0 +1,175 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "schemeCompare.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    const char* const kModeNames[] = {"独立", "同种子", "决策点子序列", "子序列+对偶"};
+    const uint64_t kIndependentSeedOffset = 0x5bd1e9955bd1e995ULL;  // 独立方式下方案2换一个种子
+
+    // 每个槽位的累加器：按单位（一场或一对）累计两边的指标与差值
+    struct alignas(64) DiffTally {
+        double win[2] = {0, 0};
+        double winDiff = 0, winDiffSq = 0;
+        double shareDiff = 0, shareDiffSq = 0;
+        long long units = 0;
+
+        void add(const DiffTally& o) {
+            win[0] += o.win[0];
+            win[1] += o.win[1];
+            winDiff += o.winDiff;
+            winDiffSq += o.winDiffSq;
+            shareDiff += o.shareDiff;
+            shareDiffSq += o.shareDiffSq;
+            units += o.units;
+        }
+    };
+
+    struct Outcome {
+        double win = 0, share = 0;
+    };
+
+    Outcome playMatch(const CompareArm& arm, ServeReceiveTables& tables, uint64_t seed, bool antithetic) {
+        applyRoster(arm.roster);
+        pinBalance(arm.params);
+        setServeReceiveTables(&tables);
+        simSetAntithetic(antithetic);
+        simSeed(seed);
+        MatchStats match;
+        int winner = simulateMatch(match);
+        Outcome o;
+        o.win = (winner == 0) ? 1.0 : 0.0;
+        long long points = match.pointsA + match.pointsB;
+        o.share = points ? static_cast<double>(match.pointsA) / points : 0.5;
+        return o;
+    }
+
+    // 样本方差（每单位）
+    double sampleVariance(double sum, double sumSq, long long n) {
+        if (n < 2) return 0.0;
+        double mean = sum / n;
+        return std::max(0.0, (sumSq - n * mean * mean) / (n - 1));
+    }
+
+    CompareEstimate runMode(ThreadPool& pool, CompareMode mode, const CompareArm* arms, const CompareSpec& spec) {
+        bool streams = (mode == COMPARE_SITE_STREAMS || mode == COMPARE_ANTITHETIC);
+        bool paired = (mode == COMPARE_ANTITHETIC);
+        int units = paired ? std::max(1, spec.matches / 2) : spec.matches;
+
+        std::vector<DiffTally> partial(pool.size());
+        // 每个槽位、每个方案各一份发球→接一联合分布表（表与阵容、参数绑定）
+        std::vector<ServeReceiveTables> tables(pool.size() * 2);
+
+        auto t0 = std::chrono::steady_clock::now();
+        int chunk = std::max(1, units / (pool.size() * 8));
+        pool.parallelForSlots(units, chunk, [&](int slot, int begin, int end) {
+            setUIEventsEnabled(false);
+            simSetSiteStreams(streams);
+            DiffTally& tally = partial[slot];
+            for (int i = begin; i < end; i++) {
+                uint64_t seeds[2] = {matchSeed(spec.seed, i), matchSeed(spec.seed, i)};
+                if (mode == COMPARE_INDEPENDENT) seeds[1] = matchSeed(spec.seed ^ kIndependentSeedOffset, i);
+
+                Outcome o[2];
+                for (int side = 0; side < 2; side++) {
+                    o[side] = playMatch(arms[side], tables[slot * 2 + side], seeds[side], false);
+                    if (paired) {
+                        Outcome mirror = playMatch(arms[side], tables[slot * 2 + side], seeds[side], true);
+                        o[side].win = (o[side].win + mirror.win) / 2;
+                        o[side].share = (o[side].share + mirror.share) / 2;
+                    }
+                }
+                double dw = o[1].win - o[0].win;
+                double ds = o[1].share - o[0].share;
+                tally.win[0] += o[0].win;
+                tally.win[1] += o[1].win;
+                tally.winDiff += dw;
+                tally.winDiffSq += dw * dw;
+                tally.shareDiff += ds;
+                tally.shareDiffSq += ds * ds;
+                tally.units++;
+            }
+            simSetAntithetic(false);
+            simSetSiteStreams(false);
+            setServeReceiveTables(nullptr);
+        });
+        auto t1 = std::chrono::steady_clock::now();
+
+        DiffTally total;
+        for (const auto& p : partial) total.add(p);
+        double n = static_cast<double>(total.units);
+        double matchesPerUnit = paired ? 2.0 : 1.0;
+
+        CompareEstimate e;
+        e.mode = mode;
+        e.matches = total.units * static_cast<long long>(matchesPerUnit);
+        e.winA[0] = total.win[0] / n;
+        e.winA[1] = total.win[1] / n;
+        e.winDiff = total.winDiff / n;
+        e.shareDiff = total.shareDiff / n;
+        // 折算到每场：一对用了两场，方差乘以 2 才能与单场的方差比较
+        e.winDiffVar = sampleVariance(total.winDiff, total.winDiffSq, total.units) * matchesPerUnit;
+        e.shareDiffVar = sampleVariance(total.shareDiff, total.shareDiffSq, total.units) * matchesPerUnit;
+        e.seconds = std::chrono::duration<double>(t1 - t0).count();
+        return e;
+    }
+
+    void printReduction(double baseline, double variance) {
+        std::cout << std::setprecision(1);
+        if (variance > 0) std::cout << std::setw(9) << baseline / variance << "x";
+        else std::cout << std::setw(10) << "-";
+        std::cout << std::setprecision(4);
+    }
+
+    // 按显示宽度补齐（汉字占3字节、显示2格）
+    std::string padded(const std::string& text, int width, bool left) {
+        int display = 0;
+        for (unsigned char c : text) {
+            if (c < 0x80) display += 1;
+            else if (c >= 0xE0) display += 2;
+        }
+        std::string fill(std::max(0, width - display), ' ');
+        return left ? text + fill : fill + text;
+    }
+}
+
+std::vector<CompareEstimate> compareArms(const CompareArm& first, const CompareArm& second, const CompareSpec& spec) {
+    ThreadPool pool(spec.threads);
+    CompareArm arms[2] = {first, second};
+    std::vector<CompareEstimate> estimates;
+    for (int m = 0; m < COMPARE_MODE_COUNT; m++) {
+        estimates.push_back(runMode(pool, static_cast<CompareMode>(m), arms, spec));
+    }
+    return estimates;
+}
+
+void printCompareReport(const CompareSpec& spec, const std::vector<CompareEstimate>& estimates) {
+    if (estimates.empty()) return;
+    const CompareEstimate& base = estimates[0];
+    std::cout << "方案对比：每种方式每个方案约 " << spec.matches << " 场，差值为 方案2 - 方案1，±为 95% 置信区间半宽\n";
+    std::cout << padded("方式", 14, true) << padded("场数", 7, false) << padded("胜率1", 9, false)
+              << padded("胜率2", 9, false) << padded("胜率差", 18, false) << padded("缩减", 10, false)
+              << padded("得分率差", 20, false) << padded("缩减", 10, false) << padded("用时s", 9, false) << "\n";
+    std::cout << std::fixed;
+    for (const auto& e : estimates) {
+        double winHalf = 1.96 * std::sqrt(e.winDiffVar / std::max<long long>(1, e.matches));
+        double shareHalf = 1.96 * std::sqrt(e.shareDiffVar / std::max<long long>(1, e.matches));
+        std::cout << padded(kModeNames[e.mode], 14, true) << std::setw(7) << e.matches << std::setprecision(4) << std::setw(9) << e.winA[0] << std::setw(9)
+                  << e.winA[1] << std::showpos << std::setw(10) << e.winDiff << std::noshowpos << " ±" << std::setw(6)
+                  << winHalf;
+        printReduction(base.winDiffVar, e.winDiffVar);
+        std::cout << std::showpos << std::setw(12) << e.shareDiff << std::noshowpos << " ±" << std::setw(6) << shareHalf;
+        printReduction(base.shareDiffVar, e.shareDiffVar);
+        std::cout << std::setprecision(2) << std::setw(9) << e.seconds << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "缩减倍数 = 独立方式的每场方差 / 该方式的每场方差，即达到同样置信区间所需场数之比" << std::endl;
+}
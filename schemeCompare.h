@@ -0,0 +1,55 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef SCHEMECOMPARE_H
+#define SCHEMECOMPARE_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ============ 两个方案的对比（方差缩减） ============
+// 比较两套参数或两种阵容时，关心的是两边胜率之差。差值的方差 = 两边方差之和 - 2×协方差，
+// 让两边的随机数尽量对齐（正相关）就能用少得多的场数得到同样的置信区间。依次用四种方式各模拟同样的场数：
+//   独立：两边种子不同（基准）
+//   同种子：第 i 场两边都用种子 (seed, i)，但一步抽数不同就整场错开
+//   决策点子序列：同种子，且每球按比分给六个决策点各派生子序列（见 simRandom.h）
+//   子序列+对偶：在上一种基础上，每个种子再打一场取对偶随机数的比赛，两场配成一对
+// 每种方式按每场（对偶为每对）的差值估计方差，报告相对独立方式的方差缩减倍数，即同样精度所需场数之比。
+
+enum CompareMode {
+    COMPARE_INDEPENDENT,
+    COMPARE_SAME_SEED,
+    COMPARE_SITE_STREAMS,
+    COMPARE_ANTITHETIC,
+    COMPARE_MODE_COUNT
+};
+
+// 一个方案：阵容与参数
+struct CompareArm {
+    Roster roster;
+    std::shared_ptr<const BalanceParams> params;
+};
+
+struct CompareSpec {
+    int matches = 2000;         // 每种方式、每个方案模拟的场数
+    uint64_t seed = 1;
+    int threads = 0;            // 0 为自动
+};
+
+// 一种方式的估计。指标为 A队胜率与 A队得分占比，差值为 方案2 - 方案1
+struct CompareEstimate {
+    CompareMode mode = COMPARE_INDEPENDENT;
+    long long matches = 0;                      // 每个方案实际模拟的场数
+    double winA[2] = {0, 0};
+    double winDiff = 0, winDiffVar = 0;         // 差值，以及折算到每场的方差（差值估计的方差 × 场数）
+    double shareDiff = 0, shareDiffVar = 0;
+    double seconds = 0;
+};
+
+std::vector<CompareEstimate> compareArms(const CompareArm& first, const CompareArm& second, const CompareSpec& spec);
+void printCompareReport(const CompareSpec& spec, const std::vector<CompareEstimate>& estimates);
+
+#endif //SCHEMECOMPARE_H
@@ -0,0 +1,111 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "sequentialRun.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    // 按当前胜率估计还需多少场才能满足停止条件；估计不出时返回 -1
+    double remainingEstimate(const StopRule& rule, long long wins, long long matches, double llr,
+                             double upper, double lower, double winStep, double lossStep) {
+        double p = static_cast<double>(wins) / matches;
+        if (rule.kind == STOP_RULE_PRECISION) {
+            // Wilson 半宽约为 z·sqrt(p(1-p)/n)；p 贴近 0 或 1 时由 z²/(2n) 项主导
+            double w = rule.halfWidth;
+            double needed = std::max(rule.z * rule.z * p * (1 - p) / (w * w), rule.z * rule.z / (2 * w));
+            return needed - matches;
+        }
+        double drift = p * winStep + (1 - p) * lossStep;    // 每场对数似然比的期望增量
+        if (std::fabs(drift) < 1e-12) return -1;
+        return drift > 0 ? (upper - llr) / drift : (llr - lower) / -drift;
+    }
+}
+
+SequentialResult runMatchesSequential(ThreadPool& pool, ResultCache* cache, const Roster& roster,
+                                      std::shared_ptr<const BalanceParams> params,
+                                      const StopRule& rule, uint64_t seed) {
+    SequentialResult result;
+    auto t0 = std::chrono::steady_clock::now();
+    bool cached = cache && cache->isOpen();
+
+    double p0 = 0.5 - rule.delta, p1 = 0.5 + rule.delta;
+    double winStep = std::log(p1 / p0);
+    double lossStep = std::log((1 - p1) / (1 - p0));
+    double upper = std::log((1 - rule.beta) / rule.alpha);
+    double lower = std::log(rule.beta / (1 - rule.alpha));
+
+    int maxMatches = std::max(1, rule.maxMatches);
+    int minRound = std::max(1, rule.roundMatches / 4);
+    int next = std::min(std::max(1, rule.roundMatches), maxMatches);
+    long long matches = 0;
+    while (true) {
+        result.rounds++;
+        if (cached) {
+            // 前一轮已按 matches 场存入缓存，这里只会模拟新增的场次
+            long long hit = 0;
+            result.stats = runMatchesCached(pool, cache, roster, params, static_cast<int>(matches + next), seed, &hit);
+            result.cachedMatches += std::max(0LL, hit - matches);
+        } else {
+            result.stats.add(runMatches(pool, roster, params, next, seed, static_cast<int>(matches)));
+        }
+        matches = result.stats.matches;
+
+        long long wins = result.stats.winsA;
+        wilsonInterval(wins, matches, rule.z, result.low, result.high);
+        result.llr = wins * winStep + (matches - wins) * lossStep;
+
+        if (rule.kind == STOP_RULE_PRECISION && (result.high - result.low) / 2 <= rule.halfWidth) {
+            result.outcome = STOP_PRECISION_REACHED;
+            break;
+        }
+        if (rule.kind == STOP_RULE_SPRT && result.llr >= upper) {
+            result.outcome = STOP_A_BETTER;
+            break;
+        }
+        if (rule.kind == STOP_RULE_SPRT && result.llr <= lower) {
+            result.outcome = STOP_B_BETTER;
+            break;
+        }
+        if (matches >= maxMatches) {
+            result.outcome = STOP_MAX_MATCHES;
+            break;
+        }
+
+        double remaining = remainingEstimate(rule, wins, matches, result.llr, upper, lower, winStep, lossStep);
+        long long size = remaining < 0 ? matches : static_cast<long long>(std::ceil(remaining));
+        size = std::clamp<long long>(size, minRound, matches);
+        next = static_cast<int>(std::min<long long>(size, maxMatches - matches));
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+void printSequentialSummary(const StopRule& rule, const SequentialResult& result) {
+    const MatchStats& s = result.stats;
+    double rate = s.matches ? static_cast<double>(s.winsA) / s.matches : 0.0;
+    std::cout << "自适应场数：共 " << result.rounds << " 轮、" << s.matches << " 场，用时 " << result.seconds << " 秒";
+    if (result.cachedMatches) std::cout << "（其中 " << result.cachedMatches << " 场取自缓存）";
+    std::cout << "\nA队胜率 " << rate << "，置信区间 [" << result.low << ", " << result.high << "]，半宽 "
+              << (result.high - result.low) / 2 << "\n";
+    switch (result.outcome) {
+        case STOP_PRECISION_REACHED:
+            std::cout << "已达到精度目标 ±" << rule.halfWidth;
+            break;
+        case STOP_A_BETTER:
+            std::cout << "SPRT 结论：A队更强（胜率 ≥ " << 0.5 + rule.delta << " 一侧），对数似然比 " << result.llr;
+            break;
+        case STOP_B_BETTER:
+            std::cout << "SPRT 结论：B队更强（胜率 ≤ " << 0.5 - rule.delta << " 一侧），对数似然比 " << result.llr;
+            break;
+        case STOP_MAX_MATCHES:
+            std::cout << "达到场数上限 " << rule.maxMatches << " 仍未满足停止条件"
+                      << (rule.kind == STOP_RULE_SPRT ? "（两队胜率差在无差异区间附近）" : "");
+            break;
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,61 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef SEQUENTIALRUN_H
+#define SEQUENTIALRUN_H
+
+#include "resultCache.h"
+
+// ============ 自适应场数（序贯停止） ============
+// 不必事先猜要模拟多少场：分轮在线程池上模拟，每轮结束检查停止条件，满足即停。
+//   精度：A队胜率的 Wilson 置信区间半宽不超过目标值（如 ±0.005）
+//   SPRT：序贯概率比检验 H0: p = 0.5 - delta（B队更强）对 H1: p = 0.5 + delta（A队更强），
+//         对数似然比越过 log((1-beta)/alpha) 或 log(beta/(1-alpha)) 时停止
+// 第一轮模拟 roundMatches 场；之后按当前估计推算还差多少场，下一轮不少于 roundMatches/4 场、
+// 不超过已模拟的场数（最多翻倍，防止早期估计偏差导致一次跑过头）。
+// 第 i 场仍用种子 (seed, i)，每轮的场数只取决于已有结果，因此停止位置与线程数无关。
+// 实力悬殊的对阵胜率接近 0 或 1，方差小、似然比增长快，几轮就能停下。
+// 打开结果缓存时每轮都按已模拟的总场数存一次，重复同样的查询时每轮都直接命中。
+
+enum StopRuleKind {
+    STOP_RULE_PRECISION,
+    STOP_RULE_SPRT
+};
+
+struct StopRule {
+    StopRuleKind kind = STOP_RULE_PRECISION;
+    double halfWidth = 0.005;   // 精度目标：胜率置信区间半宽
+    double z = 1.96;
+    double delta = 0.02;        // SPRT 的无差异区间半宽
+    double alpha = 0.05;        // 误判 A队更强的概率
+    double beta = 0.05;         // 误判 B队更强的概率
+    int roundMatches = 200;     // 第一轮场数
+    int maxMatches = 1000000;   // 场数上限，达到时无论结果如何都停止
+};
+
+enum StopOutcome {
+    STOP_PRECISION_REACHED,
+    STOP_A_BETTER,
+    STOP_B_BETTER,
+    STOP_MAX_MATCHES
+};
+
+struct SequentialResult {
+    MatchStats stats;
+    StopOutcome outcome = STOP_MAX_MATCHES;
+    int rounds = 0;
+    long long cachedMatches = 0;
+    double low = 0, high = 1;   // 停止时 A队胜率的 Wilson 区间
+    double llr = 0;             // 停止时的对数似然比（SPRT）
+    double seconds = 0;
+};
+
+// 用给定的阵容与参数按停止条件分轮模拟；cache 可为空（不用缓存）
+SequentialResult runMatchesSequential(ThreadPool& pool, ResultCache* cache, const Roster& roster,
+                                      std::shared_ptr<const BalanceParams> params,
+                                      const StopRule& rule, uint64_t seed);
+
+void printSequentialSummary(const StopRule& rule, const SequentialResult& result);
+
+#endif //SEQUENTIALRUN_H
@@ -1,16 +1,24 @@
 #include "serve.h"
 #include "config.h"
+#include "balanceConfig.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <cstdlib>
 #include <ctime>
-#include <iostream>
-
-// 添加调试信息标志
 
 Serve::Serve(const Player& server, const GameState& game)
     : server(server), game(game), adjustment(1.0) {
 }
 
-ServeType Serve::decideServeStrategy() {
+// 发球方视角的比分局势：0 接近（相差不超过2分），1 领先，2 落后
+int Serve::scoreSituation(const GameState& game) {
+    int scoreDiff = game.scoreA - game.scoreB;
+    if (game.serveSide == 1) scoreDiff = -scoreDiff; // 对B队来说要取反
+    if (abs(scoreDiff) <= 2) return 0;
+    return scoreDiff > 0 ? 1 : 2;
+}
+
+ServeType Serve::decideServeStrategy(int randomRoll) {
     // 基础策略：根据球员属性和比赛情况决定
     
     // 1. 发球属性高且自信心高的球员更倾向于冲发球
@@ -27,15 +35,19 @@ ServeType Serve::decideServeStrategy() {
     if (game.serveSide == 1) scoreDiff = -scoreDiff; // 对B队来说要取反
     
     double situationFactor;
-    if (abs(scoreDiff) <= 2) {
-        // 比分接近时，根据球员特点决定
-        situationFactor = 0.5;
-    } else if (scoreDiff > 0) {
-        // 领先时更倾向于稳定发球
-        situationFactor = 0.3;
-    } else {
-        // 落后时更倾向于冲发球搏杀
-        situationFactor = 0.7;
+    switch (scoreSituation(game)) {
+        case 0:
+            // 比分接近时，根据球员特点决定
+            situationFactor = 0.5;
+            break;
+        case 1:
+            // 领先时更倾向于稳定发球
+            situationFactor = 0.3;
+            break;
+        default:
+            // 落后时更倾向于冲发球搏杀
+            situationFactor = 0.7;
+            break;
     }
     
     // 5. 耐力影响：耐力低的球员后期更倾向于稳定发球
@@ -51,29 +63,29 @@ ServeType Serve::decideServeStrategy() {
         staminaFactor * fatigueEffect * 0.1; // 耐力权重10%
     
     // 添加随机因素
-    double randomFactor = (rand() % 20 - 10) / 100.0;
+    double randomFactor = (randomRoll - 10) / 100.0;
     aggressiveTendency += randomFactor;
     
-    ServeType result = (aggressiveTendency > AGGRESSIVE_SERVE_THRESHOLD) ? AGGRESSIVE_SERVE : STABLE_SERVE;
-    
-    #if DEBUG_SERVE
-    std::cout << "\n=== 发球策略决策调试信息 ===" << std::endl;
-    std::cout << "球员: " << server.name << " 发球属性: " << server.serve << " 自信: " << server.mental.confidence << std::endl;
-    std::cout << "1. 发球技能因子: " << serveSkillFactor << std::endl;
-    std::cout << "2. 心理素质因子: " << mentalFactor << std::endl;
-    std::cout << "3. 专注度因子: " << concentrationFactor << std::endl;
-    std::cout << "4. 比分差: " << scoreDiff << " 局势因子: " << situationFactor << std::endl;
-    std::cout << "5. 耐力因子: " << staminaFactor << " 疲劳影响: " << fatigueEffect << std::endl;
-    std::cout << "6. 随机因子: " << randomFactor << std::endl;
-    std::cout << "综合攻击倾向: " << aggressiveTendency << " (阈值: 0.5)" << std::endl;
-    std::cout << "最终决策: " << (result == AGGRESSIVE_SERVE ? "冲发球" : "稳定发球") << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
+    ServeType result = (aggressiveTendency > balance().aggressiveServeThreshold) ? AGGRESSIVE_SERVE : STABLE_SERVE;
+    
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "=== 发球策略决策调试信息 ===");
+        traceWrite(TRACE_SERVE, "球员: {} 发球属性: {} 自信: {}", server.name, server.serve, server.mental.confidence);
+        traceWrite(TRACE_SERVE, "1. 发球技能因子: {}", serveSkillFactor);
+        traceWrite(TRACE_SERVE, "2. 心理素质因子: {}", mentalFactor);
+        traceWrite(TRACE_SERVE, "3. 专注度因子: {}", concentrationFactor);
+        traceWrite(TRACE_SERVE, "4. 比分差: {} 局势因子: {}", scoreDiff, situationFactor);
+        traceWrite(TRACE_SERVE, "5. 耐力因子: {} 疲劳影响: {}", staminaFactor, fatigueEffect);
+        traceWrite(TRACE_SERVE, "6. 随机因子: {}", randomFactor);
+        traceWrite(TRACE_SERVE, "综合攻击倾向: {} (阈值: 0.5)", aggressiveTendency);
+        traceWrite(TRACE_SERVE, "最终决策: {}", (result == AGGRESSIVE_SERVE ? "冲发球" : "稳定发球"));
+        traceWrite(TRACE_SERVE, "===========================");
+    }
     
     return result;
 }
 
-double Serve::calculateServeAdjustment() {
+double Serve::calculateServeAdjustment(int randomRoll) {
     double adjustment = 1.0;
     
     // 耐力影响：比赛越久，耐力越低，失误率增加
@@ -89,19 +101,19 @@ double Serve::calculateServeAdjustment() {
     double concentrationEffect = server.mental.concentration / 100.0;
     adjustment *= (0.9 + 0.2 * concentrationEffect); // 专注度占20%权重
 
-    double randomEffect = (rand() % 20 - 10) / 100.0;
+    double randomEffect = (randomRoll - 10) / 100.0;
     adjustment *= (1.0 + randomEffect);
     
-    #if DEBUG_SERVE
-    std::cout << "\n=== 发球调整系数调试信息 ===" << std::endl;
-    std::cout << "1. 耐力影响: " << staminaEffect << " * 疲劳系数 " << setFatigue << " = " << staminaEffect * setFatigue << std::endl;
-    std::cout << "2. 心理素质影响: " << mentalEffect << " => " << (0.85 + 0.3 * mentalEffect) << std::endl;
-    std::cout << "3. 专注度影响: " << concentrationEffect << " => " << (0.9 + 0.2 * concentrationEffect) << std::endl;
-    std::cout << "3. 专注度影响: " << concentrationEffect << " => " << (0.9 + 0.2 * concentrationEffect) << std::endl;
-    std::cout << "4. 随机影响：" << randomEffect << " => " << (1.0 + randomEffect) << std::endl;
-    std::cout << "最终调整系数: " << adjustment << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "=== 发球调整系数调试信息 ===");
+        traceWrite(TRACE_SERVE, "1. 耐力影响: {} * 疲劳系数 {} = {}", staminaEffect, setFatigue, staminaEffect * setFatigue);
+        traceWrite(TRACE_SERVE, "2. 心理素质影响: {} => {}", mentalEffect, (0.85 + 0.3 * mentalEffect));
+        traceWrite(TRACE_SERVE, "3. 专注度影响: {} => {}", concentrationEffect, (0.9 + 0.2 * concentrationEffect));
+        traceWrite(TRACE_SERVE, "3. 专注度影响: {} => {}", concentrationEffect, (0.9 + 0.2 * concentrationEffect));
+        traceWrite(TRACE_SERVE, "4. 随机影响：{} => {}", randomEffect, (1.0 + randomEffect));
+        traceWrite(TRACE_SERVE, "最终调整系数: {}", adjustment);
+        traceWrite(TRACE_SERVE, "===========================");
+    }
     
     return std::max(0.3, adjustment); // 确保调整系数不低于0.3
 }
@@ -113,17 +125,13 @@ int Serve::calculateServePower() {
     switch(serveType) {
         case STABLE_SERVE:
             // 稳定发球：中等强度，受调整影响较小
-            finalPower = static_cast<int>(basePower * STABLE_SERVE_POWER_RATE * (0.8 + 0.2 * adjustment));
-            #if DEBUG_SERVE
-            std::cout << "\n稳定发球: 基础强度" << basePower << " * " << STABLE_SERVE_POWER_RATE << " * (" << 0.8 << " + 0.2*" << adjustment << ") = " << finalPower << std::endl;
-            #endif
+            finalPower = static_cast<int>(basePower * balance().stableServePowerRate * (0.8 + 0.2 * adjustment));
+            TRACE(TRACE_SERVE, "稳定发球: 基础强度{} * {} * ({} + 0.2*{}) = {}", basePower, balance().stableServePowerRate, 0.8, adjustment, finalPower);
             return finalPower;
         case AGGRESSIVE_SERVE:
             // 冲发球：高强度，受调整影响较大
-            finalPower = static_cast<int>(basePower * AGGRESSIVE_SERVE_POWER_RATE * adjustment);
-            #if DEBUG_SERVE
-            std::cout << "\n冲发球: 基础强度" << basePower << " * " << AGGRESSIVE_SERVE_POWER_RATE << " * " << adjustment << " = " << finalPower << std::endl;
-            #endif
+            finalPower = static_cast<int>(basePower * balance().aggressiveServePowerRate * adjustment);
+            TRACE(TRACE_SERVE, "冲发球: 基础强度{} * {} * {} = {}", basePower, balance().aggressiveServePowerRate, adjustment, finalPower);
             return finalPower;
         default:
             return basePower;
@@ -135,10 +143,10 @@ double Serve::calculateServeFaultRate() {
     
     switch(serveType) {
         case STABLE_SERVE:
-            baseFaultRate = STABLE_SERVE_BASIC_FAULT_RATE; // 15%基础失误率
+            baseFaultRate = balance().stableServeBasicFaultRate; // 15%基础失误率
             break;
         case AGGRESSIVE_SERVE:
-            baseFaultRate = AGGRESSIVE_SERVE_BASIC_FAULT_RATE; // 30%基础失误率
+            baseFaultRate = balance().aggressiveServeBasicFaultRate; // 30%基础失误率
             break;
         default:
             baseFaultRate = 0.2;
@@ -153,15 +161,15 @@ double Serve::calculateServeFaultRate() {
     
     double finalFaultRate = std::max(0.05, std::min(0.8, adjustedFaultRate)); // 失误率限制在5%-80%之间
     
-    #if DEBUG_SERVE
-    std::cout << "\n=== 发球失误率调试信息 ===" << std::endl;
-    std::cout << "基础失误率: " << baseFaultRate << " (" << (serveType == STABLE_SERVE ? "稳定" : "冲发") << ")" << std::endl;
-    std::cout << "发球技能效果: " << serveSkillEffect << " => 失误率减少: " << faultReduction << "%" << std::endl;
-    std::cout << "调整系数影响: (2.0 - " << adjustment << ") = " << (2.0 - adjustment) << std::endl;
-    std::cout << "计算后失误率: " << adjustedFaultRate << std::endl;
-    std::cout << "最终失误率(限定范围): " << finalFaultRate << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "=== 发球失误率调试信息 ===");
+        traceWrite(TRACE_SERVE, "基础失误率: {} ({})", baseFaultRate, (serveType == STABLE_SERVE ? "稳定" : "冲发"));
+        traceWrite(TRACE_SERVE, "发球技能效果: {} => 失误率减少: {}%", serveSkillEffect, faultReduction);
+        traceWrite(TRACE_SERVE, "调整系数影响: (2.0 - {}) = {}", adjustment, (2.0 - adjustment));
+        traceWrite(TRACE_SERVE, "计算后失误率: {}", adjustedFaultRate);
+        traceWrite(TRACE_SERVE, "最终失误率(限定范围): {}", finalFaultRate);
+        traceWrite(TRACE_SERVE, "===========================");
+    }
     
     return finalFaultRate;
 }
@@ -169,49 +177,82 @@ double Serve::calculateServeFaultRate() {
 ServeResult Serve::simulate() {
     ServeResult result;
 
-#if DEBUG_SERVE
-    std::cout << "\n\n=== 发球模拟开始 ===" << std::endl;
-    std::cout << "发球球员: " << server.name << " 发球属性: " << server.serve << std::endl;
-    std::cout << "当前局数: " << game.setNum << " 比分 A:" << game.scoreA << " B:" << game.scoreB << std::endl;
-#endif
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "=== 发球模拟开始 ===");
+        traceWrite(TRACE_SERVE, "发球球员: {} 发球属性: {}", server.name, server.serve);
+        traceWrite(TRACE_SERVE, "当前局数: {} 比分 A:{} B:{}", game.setNum, game.scoreA, game.scoreB);
+    }
 
     // 决定发球策略
-    serveType = decideServeStrategy();
+    serveType = decideServeStrategy(simRandBelow(20));
     result.type = serveType;
 
     // 计算调整系数
-    adjustment = calculateServeAdjustment();
+    adjustment = calculateServeAdjustment(simRandBelow(20));
 
     // 计算发球强度和失误率
     int servePower = calculateServePower();
     double faultRate = calculateServeFaultRate();
 
     // 判断发球是否成功
-    double randomValue = (rand() % 100) / 100.0;
-    result.success = (randomValue > faultRate);
+    int faultRoll = simRollPercent(SIM_TILT_SERVE_FAULT, game.serveSide, faultRate, true);
+    double randomValue = faultRoll / 100.0;
+    result.success = serveLands(faultRoll, faultRate);
 
-#if DEBUG_SERVE
-    std::cout << "\n=== 发球结果 ===" << std::endl;
-    std::cout << "随机值: " << randomValue << " 失误率阈值: " << faultRate << std::endl;
-    std::cout << "发球是否成功: " << (result.success ? "成功" : "失败") << std::endl;
-#endif
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "=== 发球结果 ===");
+        traceWrite(TRACE_SERVE, "随机值: {} 失误率阈值: {}", randomValue, faultRate);
+        traceWrite(TRACE_SERVE, "发球是否成功: {}", (result.success ? "成功" : "失败"));
+    }
 
     if (!result.success) {
         result.effectiveness = 0;
-#if DEBUG_SERVE
-        std::cout << "发球失误，效果值为0" << std::endl;
-        std::cout << "=== 发球模拟结束 ===\n" << std::endl;
-#endif
+        if (traceOn(TRACE_SERVE)) {
+            traceWrite(TRACE_SERVE, "发球失误，效果值为0");
+            traceWrite(TRACE_SERVE, "=== 发球模拟结束 ===");
+        }
         return result;
     }
 
     // 发球成功，计算发球效果
     result.effectiveness = servePower;
 
-#if DEBUG_SERVE
-    std::cout << "发球效果值: " << result.effectiveness << std::endl;
-    std::cout << "=== 发球模拟结束 ===\n" << std::endl;
-#endif
+    if (traceOn(TRACE_SERVE)) {
+        traceWrite(TRACE_SERVE, "发球效果值: {}", result.effectiveness);
+        traceWrite(TRACE_SERVE, "=== 发球模拟结束 ===");
+    }
 
     return result;
 }
+
+// 枚举三个随机档位（策略 20 × 调整 20 × 失误判定 100），合并相同结果
+std::vector<ServeOutcome> Serve::outcomeDistribution() {
+    std::vector<ServeOutcome> outcomes;
+    auto add = [&outcomes](ServeType type, bool success, int effectiveness, double probability) {
+        if (probability <= 0.0) return;
+        for (auto& outcome : outcomes) {
+            if (outcome.type == type && outcome.success == success && outcome.effectiveness == effectiveness) {
+                outcome.probability += probability;
+                return;
+            }
+        }
+        outcomes.push_back({type, success, effectiveness, probability});
+    };
+
+    for (int strategyRoll = 0; strategyRoll < 20; strategyRoll++) {
+        for (int adjustRoll = 0; adjustRoll < 20; adjustRoll++) {
+            serveType = decideServeStrategy(strategyRoll);
+            adjustment = calculateServeAdjustment(adjustRoll);
+            int servePower = calculateServePower();
+            double faultRate = calculateServeFaultRate();
+
+            int lands = 0;
+            for (int faultRoll = 0; faultRoll < 100; faultRoll++) {
+                if (serveLands(faultRoll, faultRate)) lands++;
+            }
+            add(serveType, true, servePower, lands / 40000.0);
+            add(serveType, false, 0, (100 - lands) / 40000.0);
+        }
+    }
+    return outcomes;
+}
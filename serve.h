@@ -4,6 +4,7 @@
 #include "player.h"
 #include "game.h"
 #include <cmath>
+#include <vector>
 
 // 发球选择枚举
 enum ServeType {
@@ -18,6 +19,14 @@ struct ServeResult {
     ServeType type;     // 发球类型
 };
 
+// 发球结果的一种可能及其概率（精确枚举用）
+struct ServeOutcome {
+    ServeType type;
+    bool success;
+    int effectiveness;  // 失误时为0
+    double probability;
+};
+
 class Serve {
 private:
     const Player& server;
@@ -25,8 +34,9 @@ private:
     ServeType serveType;
     double adjustment;
 
-    ServeType decideServeStrategy();
-    double calculateServeAdjustment();
+    // 随机档位由调用方给出（0-19），便于精确枚举
+    ServeType decideServeStrategy(int randomRoll);
+    double calculateServeAdjustment(int randomRoll);
     int calculateServePower();
     double calculateServeFaultRate();
 
@@ -35,6 +45,15 @@ public:
 
     ServeResult simulate();
 
+    // 枚举全部随机档位得到的发球结果分布（会改动本对象的发球类型与调整系数）
+    std::vector<ServeOutcome> outcomeDistribution();
+
+    // 发球方视角的比分局势：0 接近，1 领先，2 落后
+    static int scoreSituation(const GameState& game);
+
+    // 失误判定档位（0-99）下发球是否成功
+    static bool serveLands(int faultRoll, double faultRate) { return faultRoll / 100.0 > faultRate; }
+
     ServeType getServeType() const { return serveType; }
     double getAdjustment() const { return adjustment; }
 
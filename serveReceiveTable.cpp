@@ -0,0 +1,244 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    thread_local ServeReceiveTables* t_serveReceiveTables = nullptr;
+
+    const uint32_t kFullColumn = 1u << 31;
+
+    // 接发球方轮转按每人3位打包
+    uint32_t packRotation(const int rotate[6]) {
+        uint32_t key = 0;
+        for (int i = 0; i < 6; i++) key |= static_cast<uint32_t>(rotate[i] & 7) << (3 * i);
+        return key;
+    }
+
+    // 0-99 中满足 r / 100.0 < x 的档位个数（与逐个比较的结果一致）
+    int rollsBelow(double x) {
+        int k = std::max(0, std::min(100, static_cast<int>(std::ceil(x * 100.0))));
+        while (k > 0 && (k - 1) / 100.0 >= x) k--;
+        while (k < 100 && k / 100.0 < x) k++;
+        return k;
+    }
+
+    // 建表时调用的各环节函数带有调试追踪，建表期间临时关闭
+    struct TraceMute {
+        uint32_t saved = t_traceMask;
+        TraceMute() { traceSetMask(0); }
+        ~TraceMute() { traceSetMask(saved); }
+    };
+}
+
+void setServeReceiveTables(ServeReceiveTables* tables) {
+    t_serveReceiveTables = tables;
+}
+
+ServeReceiveTables* serveReceiveTables() {
+    return t_serveReceiveTables;
+}
+
+// Vose 方法：概率放大 count 倍后，把多出的部分填进不足一格的列
+void ServeReceiveTable::build(const std::vector<ServeReceiveOutcome>& outcomeValues, const std::vector<double>& weights,
+                              const std::vector<std::vector<EffectivenessWeight>>& effectiveness) {
+    outcomes = outcomeValues;
+    probabilities = weights;
+    int count = static_cast<int>(outcomes.size());
+    double total = 0.0;
+    for (double w : weights) total += w;
+
+    threshold.assign(count, kFullColumn);
+    alias.resize(count);
+    std::vector<double> scaled(count);
+    std::vector<int> small, large;
+    for (int i = 0; i < count; i++) {
+        probabilities[i] = weights[i] / total;
+        scaled[i] = probabilities[i] * count;
+        alias[i] = i;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+        large.pop_back();
+        threshold[s] = static_cast<uint32_t>(scaled[s] * kFullColumn);
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+    // 剩下的列（含浮点误差留下的）视为满格
+
+    effectivenessStart.assign(1, 0);
+    effectivenessValues.clear();
+    effectivenessCumulative.clear();
+    for (int i = 0; i < count; i++) {
+        double sum = 0.0;
+        for (const auto& e : effectiveness[i]) sum += e.weight;
+        double cumulative = 0.0;
+        for (const auto& e : effectiveness[i]) {
+            cumulative += e.weight;
+            effectivenessValues.push_back(e.effectiveness);
+            effectivenessCumulative.push_back(cumulative / sum);
+        }
+        effectivenessStart.push_back(static_cast<int>(effectivenessValues.size()));
+    }
+}
+
+// u ∈ (0,1) 落在第几段累积概率，就取哪个效果值
+int ServeReceiveTable::effectivenessAt(size_t index, double u) const {
+    int begin = effectivenessStart[index], end = effectivenessStart[index + 1];
+    if (begin == end) return 0;
+    for (int k = begin; k < end - 1; k++) {
+        if (u < effectivenessCumulative[k]) return effectivenessValues[k];
+    }
+    return effectivenessValues[end - 1];
+}
+
+// 选定结果后，硬币在该段内的位置仍是均匀的，折算成 (0,1) 用来取效果值
+const ServeReceiveOutcome& ServeReceiveTable::sample(int& effectiveness) const {
+    uint64_t x = static_cast<uint64_t>(simRand()) * outcomes.size();
+    size_t column = static_cast<size_t>(x >> 31);
+    uint32_t coin = static_cast<uint32_t>(x & (kFullColumn - 1));
+    size_t index;
+    double u;
+    if (coin < threshold[column]) {
+        index = column;
+        u = (coin + 0.5) / threshold[column];
+    } else {
+        index = static_cast<size_t>(alias[column]);
+        u = (coin - threshold[column] + 0.5) / (kFullColumn - threshold[column]);
+    }
+    effectiveness = effectivenessAt(index, u);
+    return outcomes[index];
+}
+
+const std::vector<ServeOutcome>& ServeReceiveTables::serveDistribution(const GameState& game, int server) {
+    int situation = Serve::scoreSituation(game);
+    uint32_t key = static_cast<uint32_t>(game.serveSide) | (server << 1) | ((game.setNum & 3) << 4) | (situation << 6);
+    auto it = serveOutcomes.find(key);
+    if (it != serveOutcomes.end()) return it->second;
+
+    const Player& player = (game.serveSide == 0) ? teamA[server] : teamB[server];
+    Serve serve(player, game);
+    return serveOutcomes.emplace(key, serve.outcomeDistribution()).first->second;
+}
+
+// 某名球员在某发球效果值下的接一质量分布（对调整、随机因素、质量判定三个档位求平均）
+const std::array<double, 4>& ServeReceiveTables::qualityDistribution(const GameState& game, int side, int player,
+                                                                      int effectiveness) {
+    uint32_t playerKey = static_cast<uint32_t>(side) | (player << 1) | ((game.setNum & 3) << 4);
+    uint64_t key = playerKey | (static_cast<uint64_t>(static_cast<uint32_t>(effectiveness)) << 6);
+    auto it = receiveQualities.find(key);
+    if (it != receiveQualities.end()) return it->second;
+
+    const Player& receiver = (side == 0) ? teamA[player] : teamB[player];
+    auto adjustmentIt = receiveAdjustments.find(playerKey);
+    if (adjustmentIt == receiveAdjustments.end()) {
+        ReceiveServe receiveServe(game, side, 0);
+        std::array<double, 20> adjustments{};
+        for (int roll = 0; roll < 20; roll++) adjustments[roll] = receiveServe.calculateReceiveAdjustment(receiver, roll);
+        adjustmentIt = receiveAdjustments.emplace(playerKey, adjustments).first;
+    }
+
+    std::array<double, 4> distribution{};
+    for (double adjustment : adjustmentIt->second) {
+        for (int factorRoll = 0; factorRoll < 5; factorRoll++) {
+            double successRate = ReceiveServe::receiveSuccessRate(receiver.defense, adjustment, effectiveness, factorRoll);
+            // 判定档位从小到大依次落在 到位→半到位→不到位→接飞 四段
+            int previous = 0;
+            for (int q = 0; q < 4; q++) {
+                ReceiveQuality quality = static_cast<ReceiveQuality>(q);
+                int end = std::max(previous, rollsBelow(ReceiveServe::qualityThreshold(quality, successRate)));
+                distribution[q] += (end - previous) / 10000.0;
+                previous = end;
+            }
+        }
+    }
+    return receiveQualities.emplace(key, distribution).first->second;
+}
+
+const ServeReceiveTable& ServeReceiveTables::lookup(const GameState& game) {
+    int receivingSide = 1 - game.serveSide;
+    const int* rotate = (receivingSide == 0) ? game.rotateA : game.rotateB;
+    int server = (game.serveSide == 0) ? game.rotateA[0] : game.rotateB[0];
+    uint32_t key = static_cast<uint32_t>(game.serveSide) | (server << 1) | ((game.setNum & 3) << 4) |
+                   (Serve::scoreSituation(game) << 6) | (packRotation(rotate) << 8);
+    auto it = tables.find(key);
+    if (it != tables.end()) return it->second;
+
+    TraceMute mute;
+    ReceiveServe receiveServe(game, receivingSide, 0);
+    const AliasTable& receivers = receiveServe.receiverDistribution(receiveServe.getReceiveFormation());
+
+    // [发球类型][接一位置，6 为发球失误][接一质量]，以及各格内按发球效果值分开的权重
+    double joint[2][7][4] = {};
+    std::vector<EffectivenessWeight> byEffectiveness[2][6][4];
+    for (const ServeOutcome& serve : serveDistribution(game, server)) {
+        int type = (serve.type == AGGRESSIVE_SERVE) ? 1 : 0;
+        if (!serve.success) {
+            joint[type][6][0] += serve.probability;
+            continue;
+        }
+        for (int position = 0; position < 6; position++) {
+            double receiverProbability = receivers.probability(position);
+            if (receiverProbability <= 0.0) continue;
+            const auto& quality = qualityDistribution(game, receivingSide, rotate[position], serve.effectiveness);
+            for (int q = 0; q < 4; q++) {
+                double p = serve.probability * receiverProbability * quality[q];
+                joint[type][position][q] += p;
+                if (p > 0.0) byEffectiveness[type][position][q].push_back({serve.effectiveness, p});
+            }
+        }
+    }
+
+    std::vector<ServeReceiveOutcome> outcomes;
+    std::vector<double> probabilities;
+    std::vector<std::vector<EffectivenessWeight>> effectiveness;
+    for (int type = 0; type < 2; type++) {
+        ServeType serveType = type ? AGGRESSIVE_SERVE : STABLE_SERVE;
+        if (joint[type][6][0] > 0.0) {
+            outcomes.push_back({serveType, true, 0, RECEIVE_FAULT});
+            probabilities.push_back(joint[type][6][0]);
+            effectiveness.emplace_back();
+        }
+        for (int position = 0; position < 6; position++) {
+            for (int q = 0; q < 4; q++) {
+                if (joint[type][position][q] <= 0.0) continue;
+                outcomes.push_back({serveType, false, position, static_cast<ReceiveQuality>(q)});
+                probabilities.push_back(joint[type][position][q]);
+                effectiveness.push_back(std::move(byEffectiveness[type][position][q]));
+            }
+        }
+    }
+
+    ServeReceiveTable& table = tables[key];
+    table.build(outcomes, probabilities, effectiveness);
+    return table;
+}
+
+void ServeReceiveTables::sample(const GameState& game, ServeResult& serve, ReceiveResult& receive) {
+    const ServeReceiveOutcome& outcome = lookup(game).sample(serve.effectiveness);
+    serve.type = outcome.type;
+    serve.success = !outcome.serveFault;
+    TRACE(TRACE_SERVE, "查表: {}{}，效果值 {}", (outcome.type == AGGRESSIVE_SERVE ? "冲发球" : "稳定发球"),
+          (outcome.serveFault ? "，发球失误" : ""), serve.effectiveness);
+    if (outcome.serveFault) return;
+
+    int receivingSide = 1 - game.serveSide;
+    const int* rotate = (receivingSide == 0) ? game.rotateA : game.rotateB;
+    const Player* team = (receivingSide == 0) ? teamA : teamB;
+    receive.receiverIndex = rotate[outcome.position];
+    receive.receiver = team[receive.receiverIndex];
+    receive.position = outcome.position;
+    receive.quality = outcome.quality;
+    receive.qualityValue = ReceiveServe::drawQualityValue(outcome.quality);
+    receive.description = ReceiveServe::qualityDescription(outcome.quality);
+    TRACE(TRACE_RECEIVE, "查表: {}({}号位)接一，质量值 {}", receive.receiver.name, outcome.position + 1, receive.qualityValue);
+}
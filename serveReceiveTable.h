@@ -0,0 +1,86 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef SERVERECEIVETABLE_H
+#define SERVERECEIVETABLE_H
+
+#include "game.h"
+#include "serve.h"
+#include "receiveServe.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ============ 发球→接一联合分布表 ============
+// 发球与接一两个环节只取决于：发球队员、接发球方轮转（含自由人）、局数、发球方的比分局势（接近/领先/落后）。
+// 对每种组合精确枚举两个环节的全部随机档位，得到（发球类型，是否失误，接一位置，接一质量）的联合分布，
+// 建成别名表后，批量模拟每球只需一次抽样（质量值仍按原流程在质量段内另抽）。
+// 每个结果另存发球效果值的条件分布，用别名表抽样剩下的余量取值，不多取随机数。
+// 表与当前线程的阵容和平衡参数绑定：批量模拟的每个工作槽各一份，首次遇到某个组合时建表，
+// 各槽并行建表、互不加锁。界面回放不挂表，走逐步计算的精确路径（可追踪每一步的数值）。
+
+// 一次发球到接一的结果
+struct ServeReceiveOutcome {
+    ServeType type;
+    bool serveFault;            // 发球失误（此时没有接一）
+    int position;               // 接一球员的场上位置（0-5）
+    ReceiveQuality quality;
+};
+
+// 发球效果值及其权重
+struct EffectivenessWeight {
+    int effectiveness;
+    double weight;
+};
+
+// 一种组合下的联合分布（别名表，一次 simRand() 抽样）
+class ServeReceiveTable {
+public:
+    // effectiveness[i] 为第 i 个结果下发球效果值的分布（权重不必归一）
+    void build(const std::vector<ServeReceiveOutcome>& outcomes, const std::vector<double>& probabilities,
+               const std::vector<std::vector<EffectivenessWeight>>& effectiveness);
+    // 抽样一个结果，effectiveness 按该结果下的条件分布给出发球效果值
+    const ServeReceiveOutcome& sample(int& effectiveness) const;
+
+    const std::vector<ServeReceiveOutcome>& outcomeList() const { return outcomes; }
+    const std::vector<double>& probabilityList() const { return probabilities; }
+
+private:
+    std::vector<ServeReceiveOutcome> outcomes;
+    std::vector<double> probabilities;
+    std::vector<uint32_t> threshold;    // 以 2^31 为满格
+    std::vector<int> alias;
+    std::vector<int> effectivenessStart;        // 第 i 个结果的效果值在下面两个数组中的起点，末尾多一项
+    std::vector<int> effectivenessValues;
+    std::vector<double> effectivenessCumulative;  // 各结果内的累积概率
+
+    int effectivenessAt(size_t index, double u) const;
+};
+
+class ServeReceiveTables {
+public:
+    // 当前局面对应的表，没有则现建（建表不消耗随机数）
+    const ServeReceiveTable& lookup(const GameState& game);
+
+    // 抽样一球的发球与接一结果，发球失误时 serve.effectiveness 为0、receive 不填写
+    void sample(const GameState& game, ServeResult& serve, ReceiveResult& receive);
+
+    size_t tableCount() const { return tables.size(); }
+
+private:
+    std::unordered_map<uint32_t, ServeReceiveTable> tables;
+    std::unordered_map<uint32_t, std::vector<ServeOutcome>> serveOutcomes;         // 发球方、发球队员、局数、局势
+    std::unordered_map<uint32_t, std::array<double, 20>> receiveAdjustments;      // 接发球方、球员、局数
+    std::unordered_map<uint64_t, std::array<double, 4>> receiveQualities;         // 同上加发球效果值
+
+    const std::vector<ServeOutcome>& serveDistribution(const GameState& game, int server);
+    const std::array<double, 4>& qualityDistribution(const GameState& game, int side, int player, int effectiveness);
+};
+
+// 当前线程使用的表，为空时逐步计算（默认）
+void setServeReceiveTables(ServeReceiveTables* tables);
+ServeReceiveTables* serveReceiveTables();
+
+#endif //SERVERECEIVETABLE_H
@@ -1,9 +1,36 @@
 #include "setBall.h"
 #include "config.h"
+#include "balanceConfig.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <algorithm>
 #include <vector>
 #include <cmath>
-#include <iostream>
+
+// 调试追踪中显示的枚举名称
+namespace {
+    const char* passTargetName(PassTarget value) {
+        switch (value) {
+            case FRONT_SPIKER: return "前排主攻";
+            case FRONT_BLOCKER: return "前排副攻";
+            case BACK_SPIKER: return "后排主攻";
+            case OPPOSITE: return "接应";
+            case SETTER_DUMP: return "二传二次进攻";
+            case ADJUST_ATTACK: return "调整攻";
+        }
+        return "";
+    }
+}
+
+const char* passQualityName(PassQuality value) {
+    switch (value) {
+        case PERFECT_PASS: return "完美传球";
+        case GOOD_PASS: return "好球";
+        case DECENT_PASS: return "一般传球";
+        case POOR_PASS: return "差球";
+    }
+    return "";
+}
 
 
 // 构造函数
@@ -65,22 +92,22 @@ double Setter::calculatePassAdjustment(const ReceiveResult& receiveResult) {
 
     double finalAdjustment = std::max(0.3, adjustment);
 
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 传球调整系数调试信息 ===" << std::endl;
-    std::cout << "二传球员: " << setter.name << " 传球属性: " << setter.pass << " 调整属性: " << setter.adjust << std::endl;
-    std::cout << "1. 耐力影响: " << staminaEffect << " * 疲劳系数 " << setFatigue << " = " << staminaEffect * setFatigue << std::endl;
-    std::cout << "2. 心理素质影响: " << pressureEffect << " => " << (0.85 + 0.3 * pressureEffect) << std::endl;
-    std::cout << "3. 专注度影响: " << concentrationEffect << " => " << (0.85 + 0.3 * concentrationEffect) << std::endl;
-    std::cout << "4. 沟通配合影响: " << communicationEffect << " => " << (0.9 + 0.2 * communicationEffect) << std::endl;
-    std::cout << "5. 调整属性影响:" << std::endl;
-    std::cout << "   一传质量值: " << receiveResult.qualityValue << " => 一传质量因子: " << receiveQualityFactor << std::endl;
-    std::cout << "   调整属性值: " << setter.adjust << " => 调整效果: " << adjustEffect << std::endl;
-    std::cout << "   调整权重: 基础0.3 + " << receiveQualityFactor << "*0.4 = " << adjustWeight << std::endl;
-    std::cout << "   调整部分: 1 + "  << adjustWeight << "*" << adjustEffect << " = " << (1.0 + adjustWeight * adjustEffect) << std::endl;
-    std::cout << "计算后调整系数: " << adjustment << std::endl;
-    std::cout << "最终调整系数(限定范围): " << finalAdjustment << std::endl;
-    std::cout << "============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 传球调整系数调试信息 ===");
+        traceWrite(TRACE_SETBALL, "二传球员: {} 传球属性: {} 调整属性: {}", setter.name, setter.pass, setter.adjust);
+        traceWrite(TRACE_SETBALL, "1. 耐力影响: {} * 疲劳系数 {} = {}", staminaEffect, setFatigue, staminaEffect * setFatigue);
+        traceWrite(TRACE_SETBALL, "2. 心理素质影响: {} => {}", pressureEffect, (0.85 + 0.3 * pressureEffect));
+        traceWrite(TRACE_SETBALL, "3. 专注度影响: {} => {}", concentrationEffect, (0.85 + 0.3 * concentrationEffect));
+        traceWrite(TRACE_SETBALL, "4. 沟通配合影响: {} => {}", communicationEffect, (0.9 + 0.2 * communicationEffect));
+        traceWrite(TRACE_SETBALL, "5. 调整属性影响:");
+        traceWrite(TRACE_SETBALL, "   一传质量值: {} => 一传质量因子: {}", receiveResult.qualityValue, receiveQualityFactor);
+        traceWrite(TRACE_SETBALL, "   调整属性值: {} => 调整效果: {}", setter.adjust, adjustEffect);
+        traceWrite(TRACE_SETBALL, "   调整权重: 基础0.3 + {}*0.4 = {}", receiveQualityFactor, adjustWeight);
+        traceWrite(TRACE_SETBALL, "   调整部分: 1 + {}*{} = {}", adjustWeight, adjustEffect, (1.0 + adjustWeight * adjustEffect));
+        traceWrite(TRACE_SETBALL, "计算后调整系数: {}", adjustment);
+        traceWrite(TRACE_SETBALL, "最终调整系数(限定范围): {}", finalAdjustment);
+        traceWrite(TRACE_SETBALL, "============================");
+    }
 
     return finalAdjustment;
 }
@@ -115,20 +142,20 @@ double Setter::calculateDumpAdjustment(const ReceiveResult& receiveResult) {
 
     double finalAdjustment = std::max(0.2, adjustment);
     
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 二次进攻调整系数调试信息 ===" << std::endl;
-    std::cout << "二传球员: " << setter.name << " 扣球属性: " << setter.spike << std::endl;
-    std::cout << "1. 耐力影响: " << staminaEffect << " * 疲劳系数 " << setFatigue << " = " << staminaEffect * setFatigue << std::endl;
-    std::cout << "2. 心理素质影响: " << pressureEffect << " => " << (0.6 + 0.4 * pressureEffect) << std::endl;
-    std::cout << "3. 专注度影响: " << concentrationEffect << " => " << (0.7 + 0.3 * concentrationEffect) << std::endl;
-    std::cout << "4. 沟通配合影响: " << communicationEffect << " => " << (0.8 + 0.2 * communicationEffect) << std::endl;
-    std::cout << "5. 调整属性影响:" << std::endl;
-    std::cout << "   一传质量因子: " << receiveQualityFactor << std::endl;
-    std::cout << "   调整权重: 基础0.4 + " << receiveQualityFactor << "*0.3 = " << adjustWeight << std::endl;
-    std::cout << "   调整部分: (1 - " << adjustWeight << ") + " << adjustWeight << "*" << adjustEffect << " = " << (1.0 - adjustWeight + adjustWeight * adjustEffect) << std::endl;
-    std::cout << "最终调整系数(限定范围): " << finalAdjustment << std::endl;
-    std::cout << "==================================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 二次进攻调整系数调试信息 ===");
+        traceWrite(TRACE_SETBALL, "二传球员: {} 扣球属性: {}", setter.name, setter.spike);
+        traceWrite(TRACE_SETBALL, "1. 耐力影响: {} * 疲劳系数 {} = {}", staminaEffect, setFatigue, staminaEffect * setFatigue);
+        traceWrite(TRACE_SETBALL, "2. 心理素质影响: {} => {}", pressureEffect, (0.6 + 0.4 * pressureEffect));
+        traceWrite(TRACE_SETBALL, "3. 专注度影响: {} => {}", concentrationEffect, (0.7 + 0.3 * concentrationEffect));
+        traceWrite(TRACE_SETBALL, "4. 沟通配合影响: {} => {}", communicationEffect, (0.8 + 0.2 * communicationEffect));
+        traceWrite(TRACE_SETBALL, "5. 调整属性影响:");
+        traceWrite(TRACE_SETBALL, "   一传质量因子: {}", receiveQualityFactor);
+        traceWrite(TRACE_SETBALL, "   调整权重: 基础0.4 + {}*0.3 = {}", receiveQualityFactor, adjustWeight);
+        traceWrite(TRACE_SETBALL, "   调整部分: (1 - {}) + {}*{} = {}", adjustWeight, adjustWeight, adjustEffect, (1.0 - adjustWeight + adjustWeight * adjustEffect));
+        traceWrite(TRACE_SETBALL, "最终调整系数(限定范围): {}", finalAdjustment);
+        traceWrite(TRACE_SETBALL, "==================================");
+    }
     
     return finalAdjustment;
 }
@@ -275,20 +302,42 @@ double Setter::calculateAttackerEffectiveness(const Player& attacker, int positi
     // 计算总有效性分数
     double totalEffectiveness = matchupAdvantage + positionBonus + staminaBonus;
 
-#if DEBUG_SETBALL
-    std::cout << "攻手有效性评估: " << attacker.name << " (" << position+1 << "号位)" << std::endl;
-    std::cout << "  对位优势: " << matchupAdvantage << " (55%)" << std::endl;
-    std::cout << "  位置优势: " << positionBonus << " (35%)" << std::endl;
-    std::cout << "  体能因素: " << staminaBonus << " (10%)" << std::endl;
-    std::cout << "  总有效性: " << totalEffectiveness << std::endl;
-#endif
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "攻手有效性评估: {} ({}号位)", attacker.name, position+1);
+        traceWrite(TRACE_SETBALL, "  对位优势: {} (55%)", matchupAdvantage);
+        traceWrite(TRACE_SETBALL, "  位置优势: {} (35%)", positionBonus);
+        traceWrite(TRACE_SETBALL, "  体能因素: {} (10%)", staminaBonus);
+        traceWrite(TRACE_SETBALL, "  总有效性: {}", totalEffectiveness);
+    }
 
     return totalEffectiveness;
 }
 
+// 传球目标分布（百分比），按二传是否在前排分两种情况
+// 二传在前排时（合法阵容中接应与二传对角，因此在后排）传给接应的概率降低，并且可以二次进攻；
+// 二传在后排时不能二次进攻，这部分概率并入前排主攻（半到位）或调整攻（不到位）
+namespace {
+    constexpr AliasTable kGoodFrontSetterTargets = makeAliasTable({
+        {OPPOSITE, 10}, {FRONT_SPIKER, 70}, {BACK_SPIKER, 10}, {SETTER_DUMP, 10}});
+    constexpr AliasTable kGoodBackSetterTargets = makeAliasTable({
+        {OPPOSITE, 35}, {FRONT_SPIKER, 55}, {BACK_SPIKER, 10}});
+    constexpr AliasTable kBadFrontSetterTargets = makeAliasTable({
+        {OPPOSITE, 10}, {ADJUST_ATTACK, 60}, {BACK_SPIKER, 10}, {SETTER_DUMP, 20}});
+    constexpr AliasTable kBadBackSetterTargets = makeAliasTable({
+        {OPPOSITE, 30}, {ADJUST_ATTACK, 60}, {BACK_SPIKER, 10}});
+    constexpr AliasTable kDefaultTargets = makeAliasTable({{ADJUST_ATTACK, 1}});
+}
+
+const AliasTable& Setter::targetTable(ReceiveQuality quality, bool setterInFrontRow) {
+    switch (quality) {
+        case RECEIVE_GOOD: return setterInFrontRow ? kGoodFrontSetterTargets : kGoodBackSetterTargets;
+        case RECEIVE_BAD: return setterInFrontRow ? kBadFrontSetterTargets : kBadBackSetterTargets;
+        default: return kDefaultTargets;
+    }
+}
+
 PassTarget Setter::decidePassTarget(const ReceiveResult& receiveResult) {
     // 根据一传质量决定传球策略
-    double randomValue = (rand() % 100) / 100.0;
     PassTarget target;
 
     // 将变量初始化移到switch语句之前
@@ -296,22 +345,15 @@ PassTarget Setter::decidePassTarget(const ReceiveResult& receiveResult) {
     const Player* team = getTeamPlayers();
     const int* rotation = getRotation();
 
-    // 检查接应是否在后排（即二传在前排）
-    bool oppositeInBackRow = isSetterInFrontRow();
-
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 传球目标决策调试信息 ===" << std::endl;
-    std::cout << "一传质量: ";
-    switch(receiveResult.quality) {
-        case RECEIVE_PERFECT: std::cout << "到位"; break;
-        case RECEIVE_GOOD: std::cout << "半到位"; break;
-        case RECEIVE_BAD: std::cout << "不到位"; break;
-        case RECEIVE_FAULT: std::cout << "接飞"; break;
+    // 二传是否在前排。接应的前后排也由此推断（假定阵容合法、二传与接应对角站位），
+    // 手动输入的阵容不满足时按二传的位置处理，与逐步计算的原有判断一致
+    bool setterInFrontRow = isSetterInFrontRow();
+
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 传球目标决策调试信息 ===");
+        traceWrite(TRACE_SETBALL, "一传质量: {} (质量值: {})", receiveQualityName(receiveResult.quality), receiveResult.qualityValue);
+        traceWrite(TRACE_SETBALL, "二传在前排（接应在后排）: {}", (setterInFrontRow ? "是" : "否"));
     }
-    std::cout << " (质量值: " << receiveResult.qualityValue << ")" << std::endl;
-    std::cout << "随机值: " << randomValue << std::endl;
-    std::cout << "接应在后排: " << (oppositeInBackRow ? "是" : "否") << std::endl;
-    #endif
 
     switch (receiveResult.quality)
     {
@@ -375,64 +417,27 @@ PassTarget Setter::decidePassTarget(const ReceiveResult& receiveResult) {
         }
 
         case RECEIVE_GOOD:  // 半到位
-            if (randomValue < 0.8) {
-                // 80%概率在前排和接应中选择
-                // 如果接应在后排，降低传给接应的概率
-                double oppositeProbability = oppositeInBackRow ? 0.10 : 0.35; // 从35%降至10%
-                if (randomValue < oppositeProbability) {
-                    target = OPPOSITE;
-                } else { // 剩余概率给前排主攻
-                    target = FRONT_SPIKER;
-                }
-            } else if (randomValue < 0.9) { // 10%概率给后排主攻
-                target = BACK_SPIKER;
-            } else { // 10%概率二次进攻
-                target = isSetterInFrontRow() ? SETTER_DUMP : FRONT_SPIKER;
-            }
-            break;
-
-        case RECEIVE_BAD:  // 不到位
-            if (randomValue < 0.7) {
-                // 70%概率给调整攻或接应
-                // 如果接应在后排，降低传给接应的概率
-                double oppositeProbability = oppositeInBackRow ? 0.1 : 0.3; // 从30%降至10%
-                if (randomValue < oppositeProbability) {
-                    target = OPPOSITE;
-                } else { // 剩余概率给调整攻
-                    target = ADJUST_ATTACK;
-                }
-            } else if (randomValue < 0.8) { // 10%概率给后排主攻
-                target = BACK_SPIKER;
-            } else { // 20%概率二次进攻
-                target = isSetterInFrontRow() ? SETTER_DUMP : ADJUST_ATTACK;
-            }
+        case RECEIVE_BAD:   // 不到位
+            // 按（一传质量，二传是否在前排）查表抽样
+            target = static_cast<PassTarget>(targetTable(receiveResult.quality, setterInFrontRow).sample());
             break;
 
         default:  // 接飞不会到这里，但安全处理
             target = ADJUST_ATTACK;
     }
 
-    #if DEBUG_SETBALL
-    std::cout << "最终传球目标: ";
-    switch(target) {
-        case FRONT_SPIKER: std::cout << "前排主攻"; break;
-        case FRONT_BLOCKER: std::cout << "前排副攻"; break;
-        case BACK_SPIKER: std::cout << "后排主攻"; break;
-        case OPPOSITE: std::cout << "接应"; break;
-        case SETTER_DUMP: std::cout << "二传二次进攻"; break;
-        case ADJUST_ATTACK: std::cout << "调整攻"; break;
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "最终传球目标: {}", passTargetName(target));
+        traceWrite(TRACE_SETBALL, "================================");
     }
-    std::cout << std::endl << "================================" << std::endl;
-    #endif
     
     return target;
 }
 
-// 获取目标球员
-Player Setter::getTargetPlayer(PassTarget target) {
+// 获取目标球员在本队的下标，二次进攻（二传自己）时返回 -1
+int Setter::getTargetIndex(PassTarget target) {
     const Player* team = getTeamPlayers();
     const int* rotation = getRotation();
-    Player result;
 
     // 根据目标类型找到对应球员
     switch (target) {
@@ -440,117 +445,78 @@ Player Setter::getTargetPlayer(PassTarget target) {
             // 寻找前排主攻（位置索引1,2,3中的主攻）
             for (int i = 1; i <= 3; i++) {
                 if (team[rotation[i]].position == "OH" || team[rotation[i]].position == "主攻") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到前排主攻: " << result.name << " (" << i << "号位)" << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到前排主攻: {} ({}号位)", team[rotation[i]].name, i);
+                    return rotation[i];
                 }
             }
             // 如果没找到，返回第一个前排球员
-            result = team[rotation[1]];
-            #if DEBUG_SETBALL
-            std::cout << "未找到前排主攻，使用默认: " << result.name << " (1号位)" << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "未找到前排主攻，使用默认: {} (1号位)", team[rotation[1]].name);
+            return rotation[1];
 
         case FRONT_BLOCKER:  // 前排副攻
             // 寻找前排副攻
             for (int i = 1; i <= 3; i++) {
                 if (team[rotation[i]].position == "MB" || team[rotation[i]].position == "副攻") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到前排副攻: " << result.name  << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到前排副攻: {}", team[rotation[i]].name);
+                    return rotation[i];
                 }
             }
             // 如果没找到，返回第一个前排球员
-            result = team[rotation[2]];
-            #if DEBUG_SETBALL
-            std::cout << "未找到前排副攻，使用默认: " << result.name << " (2号位)" << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "未找到前排副攻，使用默认: {} (2号位)", team[rotation[2]].name);
+            return rotation[2];
 
         case BACK_SPIKER:  // 后排主攻
             // 寻找后排主攻（位置索引0,4,5中的主攻）
             for (int i : {0, 4, 5}) {
                 if (team[rotation[i]].position == "OH" || team[rotation[i]].position == "主攻") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到后排主攻: " << result.name << " (" << i << "号位)" << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到后排主攻: {} ({}号位)", team[rotation[i]].name, i);
+                    return rotation[i];
                 }
             }
             // 如果没找到，返回第一个后排球员
-            result = team[rotation[0]];
-            #if DEBUG_SETBALL
-            std::cout << "未找到后排主攻，使用默认: " << result.name << " (0号位)" << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "未找到后排主攻，使用默认: {} (0号位)", team[rotation[0]].name);
+            return rotation[0];
 
         case OPPOSITE:  // 接应
             // 寻找接应（无论前后排）
             for (int i = 0; i < 6; i++) {
                 if (team[rotation[i]].position == "OP" || team[rotation[i]].position == "接应") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到接应: " << result.name << " (" << i << "号位)" << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到接应: {} ({}号位)", team[rotation[i]].name, i);
+                    return rotation[i];
                 }
             }
             // 如果没找到，返回第一个前排球员
-            result = team[rotation[1]];
-            #if DEBUG_SETBALL
-            std::cout << "未找到接应，使用默认: " << result.name << " (1号位)" << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "未找到接应，使用默认: {} (1号位)", team[rotation[1]].name);
+            return rotation[1];
 
         case SETTER_DUMP:  // 二传自己
-            result = setter;
-            #if DEBUG_SETBALL
-            std::cout << "目标为二传自己: " << result.name << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "目标为二传自己: {}", setter.name);
+            return -1;
 
         case ADJUST_ATTACK:  // 调整攻，默认给主攻
         default:
             // 优先找前排主攻
             for (int i = 1; i <= 3; i++) {
                if (team[rotation[i]].position == "OH" || team[rotation[i]].position == "主攻") {
-                   result = team[rotation[i]];
-                   #if DEBUG_SETBALL
-                   std::cout << "找到前排主攻(调整攻): " << result.name << " (" << i << "号位)" << std::endl;
-                   #endif
-                   return result;
+                   TRACE(TRACE_SETBALL, "找到前排主攻(调整攻): {} ({}号位)", team[rotation[i]].name, i);
+                   return rotation[i];
                }
             }
 
             for (int i = 0; i < 6; i++) {
                 if (team[rotation[i]].position == "OH" || team[rotation[i]].position == "主攻") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到主攻(调整攻): " << result.name << " (" << i << "号位)" << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到主攻(调整攻): {} ({}号位)", team[rotation[i]].name, i);
+                    return rotation[i];
                 }
             }
             for (int i = 0; i < 6; i++) {
                 if (team[rotation[i]].position == "OP" || team[rotation[i]].position == "接应") {
-                    result = team[rotation[i]];
-                    #if DEBUG_SETBALL
-                    std::cout << "找到接应(调整攻): " << result.name << " (" << i << "号位)" << std::endl;
-                    #endif
-                    return result;
+                    TRACE(TRACE_SETBALL, "找到接应(调整攻): {} ({}号位)", team[rotation[i]].name, i);
+                    return rotation[i];
                 }
             }
-            result = team[rotation[0]]; // 默认返回第一个球员
-            #if DEBUG_SETBALL
-            std::cout << "未找到合适球员，使用默认: " << result.name << " (0号位)" << std::endl;
-            #endif
-            return result;
+            TRACE(TRACE_SETBALL, "未找到合适球员，使用默认: {} (0号位)", team[rotation[0]].name);
+            return rotation[0]; // 默认返回第一个球员
     }
 }
 
@@ -569,23 +535,23 @@ PassQuality Setter::calculatePassQuality(const ReceiveResult& receiveResult, Pas
     std::string difficultyStr = "标准";
     switch (target) {
         case FRONT_BLOCKER:  // 快攻最难
-            difficultyFactor = SET_QUICK_ATTACK_DIFF_RATE;
+            difficultyFactor = balance().setQuickAttackDiffRate;
             difficultyStr = "高(快攻)";
             break;
         case BACK_SPIKER:    // 后排攻较难
-            difficultyFactor = SET_BACK_ATTACK_DIFF_RATE;
+            difficultyFactor = balance().setBackAttackDiffRate;
             difficultyStr = "较高(后排攻)";
             break;
         case OPPOSITE:       // 接应一般
-            difficultyFactor = SET_OPPOSITE_DIFF_RATE;
+            difficultyFactor = balance().setOppositeDiffRate;
             difficultyStr = "中等(接应)";
             break;
         case FRONT_SPIKER:   // 前排主攻较容易
-            difficultyFactor = SET_FRONT_SPIKER_DIFF_RATE;
+            difficultyFactor = balance().setFrontSpikerDiffRate;
             difficultyStr = "较低(前排主攻)";
             break;
         case ADJUST_ATTACK:  // 调整攻最容易（只要高就行）
-            difficultyFactor = SET_ADJUST_ATTACK_DIFF_RATE;
+            difficultyFactor = balance().setAdjustAttackDiffRate;
             difficultyStr = "低(调整攻)";
             break;
         default:
@@ -597,7 +563,7 @@ PassQuality Setter::calculatePassQuality(const ReceiveResult& receiveResult, Pas
     double passValue = basePassAbility * adjustment * receiveInfluence / difficultyFactor;
 
     // 添加随机因素
-    double randomFactor = (rand() % 20 - 10);
+    double randomFactor = (simRandBelow(20) - 10);
     passValue += randomFactor;
     passValue = std::max(0.0, passValue);
 
@@ -615,24 +581,18 @@ PassQuality Setter::calculatePassQuality(const ReceiveResult& receiveResult, Pas
         quality = POOR_PASS;
     }
     
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 传球质量计算调试信息 ===" << std::endl;
-    std::cout << "基础传球能力: " << basePassAbility << std::endl;
-    std::cout << "调整系数: " << adjustment << std::endl;
-    std::cout << "一传影响: sqrt(" << receiveResult.qualityValue << "/100) = " << receiveInfluence << std::endl;
-    std::cout << "传球难度系数: " << difficultyFactor << " (" << difficultyStr << ")" << std::endl;
-    std::cout << "计算: " << basePassAbility << " * " << adjustment << " * " << receiveInfluence << " / " << difficultyFactor << " = " << basePassAbility * adjustment * receiveInfluence / difficultyFactor << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "传球质量值: " << passValue << " (取整: " << qualityValue << ")" << std::endl;
-    std::cout << "传球质量等级: ";
-    switch(quality) {
-        case PERFECT_PASS: std::cout << "完美传球"; break;
-        case GOOD_PASS: std::cout << "好球"; break;
-        case DECENT_PASS: std::cout << "一般传球"; break;
-        case POOR_PASS: std::cout << "差球"; break;
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 传球质量计算调试信息 ===");
+        traceWrite(TRACE_SETBALL, "基础传球能力: {}", basePassAbility);
+        traceWrite(TRACE_SETBALL, "调整系数: {}", adjustment);
+        traceWrite(TRACE_SETBALL, "一传影响: sqrt({}/100) = {}", receiveResult.qualityValue, receiveInfluence);
+        traceWrite(TRACE_SETBALL, "传球难度系数: {} ({})", difficultyFactor, difficultyStr);
+        traceWrite(TRACE_SETBALL, "计算: {} * {} * {} / {} = {}", basePassAbility, adjustment, receiveInfluence, difficultyFactor, basePassAbility * adjustment * receiveInfluence / difficultyFactor);
+        traceWrite(TRACE_SETBALL, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_SETBALL, "传球质量值: {} (取整: {})", passValue, qualityValue);
+        traceWrite(TRACE_SETBALL, "传球质量等级: {}", passQualityName(quality));
+        traceWrite(TRACE_SETBALL, "=================================");
     }
-    std::cout << std::endl << "=================================" << std::endl;
-    #endif
 
     return quality;
 }
@@ -647,7 +607,7 @@ int Setter::calculateDumpQuality(const ReceiveResult& receiveResult, DumpType& d
     spikeScore *= 0.7;
 
     // 根据分数决定二次进攻类型
-    double randomValue = (rand() % 100) / 100.0;
+    double randomValue = simRandBelow(100) / 100.0;
     double totalScore = spikeScore + tipScore;
     double spikeProbability = spikeScore / totalScore;
 
@@ -684,27 +644,27 @@ int Setter::calculateDumpQuality(const ReceiveResult& receiveResult, DumpType& d
     double dumpValue = baseAbility * adjustment * receiveInfluence;
 
     // 添加随机因素
-    double randomFactor = (rand() % 30 - 15);
+    double randomFactor = (simRandBelow(30) - 15);
     dumpValue += randomFactor;
     dumpValue = std::max(0.0, std::min(100.0, dumpValue));
 
     int result = static_cast<int>(dumpValue);
 
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 二次进攻质量计算调试信息 ===" << std::endl;
-    std::cout << "二传球员: " << setter.name << " 扣球属性: " << setter.spike << " 传球属性: " << setter.pass << std::endl;
-    std::cout << "球商: " << setter.wisdom << std::endl;
-    std::cout << "进攻类型: " << attackType << std::endl;
-    std::cout << "扣球倾向分数: " << spikeScore << " 吊球倾向分数: " << tipScore << std::endl;
-    std::cout << "扣球概率: " << spikeProbability * 100 << "%" << std::endl;
-    std::cout << "基础能力值: " << baseAbility << std::endl;
-    std::cout << "调整系数: " << adjustment << std::endl;
-    std::cout << "一传影响: " << receiveResult.qualityValue << "/100 = " << receiveInfluence << std::endl;
-    std::cout << "计算: " << baseAbility << " * " << adjustment << " * " << receiveInfluence << " = " << baseAbility * adjustment * receiveInfluence << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "二次进攻效果值: " << dumpValue << " (四舍五入: " << result << ")" << std::endl;
-    std::cout << "==================================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 二次进攻质量计算调试信息 ===");
+        traceWrite(TRACE_SETBALL, "二传球员: {} 扣球属性: {} 传球属性: {}", setter.name, setter.spike, setter.pass);
+        traceWrite(TRACE_SETBALL, "球商: {}", setter.wisdom);
+        traceWrite(TRACE_SETBALL, "进攻类型: {}", attackType);
+        traceWrite(TRACE_SETBALL, "扣球倾向分数: {} 吊球倾向分数: {}", spikeScore, tipScore);
+        traceWrite(TRACE_SETBALL, "扣球概率: {}%", spikeProbability * 100);
+        traceWrite(TRACE_SETBALL, "基础能力值: {}", baseAbility);
+        traceWrite(TRACE_SETBALL, "调整系数: {}", adjustment);
+        traceWrite(TRACE_SETBALL, "一传影响: {}/100 = {}", receiveResult.qualityValue, receiveInfluence);
+        traceWrite(TRACE_SETBALL, "计算: {} * {} * {} = {}", baseAbility, adjustment, receiveInfluence, baseAbility * adjustment * receiveInfluence);
+        traceWrite(TRACE_SETBALL, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_SETBALL, "二次进攻效果值: {} (四舍五入: {})", dumpValue, result);
+        traceWrite(TRACE_SETBALL, "==================================");
+    }
     
     return result;
 }
@@ -713,24 +673,18 @@ int Setter::calculateDumpQuality(const ReceiveResult& receiveResult, DumpType& d
 PassResult Setter::simulateSet(const ReceiveResult& receiveResult) {
     PassResult result;
 
-    #if DEBUG_SETBALL
-    std::cout << "\n\n=== 传球模拟开始 ===" << std::endl;
-    std::cout << "二传球员: " << setter.name << " 传球属性: " << setter.pass << std::endl;
-    std::cout << "一传质量值: " << receiveResult.qualityValue << " (";
-    switch(receiveResult.quality) {
-        case RECEIVE_PERFECT: std::cout << "到位"; break;
-        case RECEIVE_GOOD: std::cout << "半到位"; break;
-        case RECEIVE_BAD: std::cout << "不到位"; break;
-        case RECEIVE_FAULT: std::cout << "接飞"; break;
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 传球模拟开始 ===");
+        traceWrite(TRACE_SETBALL, "二传球员: {} 传球属性: {}", setter.name, setter.pass);
+        traceWrite(TRACE_SETBALL, "一传质量值: {} ({})", receiveResult.qualityValue, receiveQualityName(receiveResult.quality));
     }
-    std::cout << ")" << std::endl;
-    #endif
 
     // 决定传球目标
     result.target = decidePassTarget(receiveResult);
 
     // 获取目标球员
-    result.targetPlayer = getTargetPlayer(result.target);
+    result.targetIndex = getTargetIndex(result.target);
+    result.targetPlayer = (result.targetIndex >= 0) ? getTeamPlayers()[result.targetIndex] : setter;
 
     // 判断是否为二次进攻
     result.isSetterDump = (result.target == SETTER_DUMP);
@@ -779,33 +733,17 @@ PassResult Setter::simulateSet(const ReceiveResult& receiveResult) {
         }
     }
 
-    #if DEBUG_SETBALL
-    std::cout << "\n=== 传球最终结果 ===" << std::endl;
-    std::cout << "传球目标: ";
-    switch(result.target) {
-        case FRONT_SPIKER: std::cout << "前排主攻"; break;
-        case FRONT_BLOCKER: std::cout << "前排副攻"; break;
-        case BACK_SPIKER: std::cout << "后排主攻"; break;
-        case OPPOSITE: std::cout << "接应"; break;
-        case SETTER_DUMP: std::cout << "二传二次进攻"; break;
-        case ADJUST_ATTACK: std::cout << "调整攻"; break;
-    }
-    std::cout << " (" << result.targetPlayer.name << ")" << std::endl;
-    std::cout << "是否为二次进攻: " << (result.isSetterDump ? "是" : "否") << std::endl;
-    std::cout << "传球质量等级: ";
-    switch(result.quality) {
-        case PERFECT_PASS: std::cout << "完美传球"; break;
-        case GOOD_PASS: std::cout << "好球"; break;
-        case DECENT_PASS: std::cout << "一般传球"; break;
-        case POOR_PASS: std::cout << "差球"; break;
-    }
-    std::cout << " (质量值: " << result.qualityValue << ")" << std::endl;
-    if (result.isSetterDump) {
-        std::cout << "二次进攻效果值: " << result.dumpEffectiveness << std::endl;
+    if (traceOn(TRACE_SETBALL)) {
+        traceWrite(TRACE_SETBALL, "=== 传球最终结果 ===");
+        traceWrite(TRACE_SETBALL, "传球目标: {} ({})", passTargetName(result.target), result.targetPlayer.name);
+        traceWrite(TRACE_SETBALL, "是否为二次进攻: {}", (result.isSetterDump ? "是" : "否"));
+        traceWrite(TRACE_SETBALL, "传球质量等级: {} (质量值: {})", passQualityName(result.quality), result.qualityValue);
+        if (result.isSetterDump) {
+            traceWrite(TRACE_SETBALL, "二次进攻效果值: {}", result.dumpEffectiveness);
+        }
+        traceWrite(TRACE_SETBALL, "描述: {}", result.description);
+        traceWrite(TRACE_SETBALL, "=== 传球模拟结束 ===");
     }
-    std::cout << "描述: " << result.description << std::endl;
-    std::cout << "=== 传球模拟结束 ===\n" << std::endl;
-    #endif
 
     return result;
 }
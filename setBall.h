@@ -8,6 +8,7 @@
 #include "player.h"
 #include "game.h"
 #include "receiveServe.h"
+#include "aliasTable.h"
 
 // 传球目标类型枚举
 enum PassTarget {
@@ -27,12 +28,15 @@ enum PassQuality {
     POOR_PASS          // 差球（难处理）
 };
 
+const char* passQualityName(PassQuality value);  // 调试追踪中显示的名称
+
 // 传球结果结构体
 struct PassResult {
     PassTarget target;          // 传球目标
     PassQuality quality;        // 传球质量
     int qualityValue;           // 传球质量数值（0-100）
     Player targetPlayer;        // 目标球员
+    int targetIndex;            // 目标球员在本队的下标（二次进攻时为 -1，即二传本人）
     std::string description;    // 传球结果描述
     bool isSetterDump;          // 是否为二次进攻
     int dumpEffectiveness;      // 二次进攻效果值（如果是二次进攻）
@@ -53,8 +57,11 @@ public:
     // 决定传球目标
     PassTarget decidePassTarget(const ReceiveResult& receiveResult);
 
-    // 获取目标球员
-    Player getTargetPlayer(PassTarget target);
+    // 传球目标的分布表（半到位/不到位；到位时按攻手有效性选择，其余情况固定调整攻）
+    static const AliasTable& targetTable(ReceiveQuality quality, bool setterInFrontRow);
+
+    // 获取目标球员在本队的下标（二次进攻时为 -1）
+    int getTargetIndex(PassTarget target);
 
     // 计算传球质量
     PassQuality calculatePassQuality(const ReceiveResult& receiveResult, PassTarget target, int& qualityValue);
@@ -0,0 +1,91 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "simRandom.h"
+#include <algorithm>
+#include <cmath>
+
+constinit thread_local uint64_t g_simRandState = 0x853c49e6748fea9bULL;
+constinit thread_local uint32_t g_simRandFlip = 0;
+constinit thread_local SimRandStreams g_simStreams;
+constinit thread_local SimTilt g_simTilt;
+
+namespace {
+    // splitmix64：相邻的输入（如批量模拟中的 seed+i）得到互不相关的输出
+    uint64_t mixSeed(uint64_t seed) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebULL;
+        return seed ^ (seed >> 31);
+    }
+
+    // PCG 标准初始化流程：state = 0，前进一步，加上种子，再前进一步
+    uint64_t pcgInitialState(uint64_t mixed) {
+        const uint64_t mul = 6364136223846793005ULL, inc = 1442695040888963407ULL;
+        uint64_t state = inc;
+        state += mixed;
+        return state * mul + inc;
+    }
+}
+
+void simSeed(uint64_t seed) {
+    g_simStreams.matchSeed = seed;
+    g_simRandState = pcgInitialState(mixSeed(seed));
+}
+
+void simSetSiteStreams(bool enabled) {
+    g_simStreams.enabled = enabled;
+}
+
+void simSetAntithetic(bool antithetic) {
+    g_simRandFlip = antithetic ? SIM_RAND_MAX : 0;
+}
+
+void simBeginRallyStreams(int setNum, int scoreA, int scoreB) {
+    if (!g_simStreams.enabled) return;
+    uint64_t rallyKey = mixSeed(g_simStreams.matchSeed) ^
+                        (static_cast<uint64_t>(setNum) << 48 | static_cast<uint64_t>(scoreA) << 24 | static_cast<uint64_t>(scoreB));
+    for (int site = 0; site < SIM_SITE_COUNT; site++) {
+        g_simStreams.state[site] = pcgInitialState(mixSeed(rallyKey + static_cast<uint64_t>(site) * 0x632be59bd9b4e019ULL));
+    }
+}
+
+void simSetTilt(const SimTiltSpec& spec) {
+    g_simTilt = SimTilt();
+    g_simTilt.spec = spec;
+    for (int site = 0; site < SIM_TILT_COUNT; site++) {
+        for (int side = 0; side < 2; side++) {
+            if (spec.odds[site][side] != 1.0) g_simTilt.enabled = true;
+        }
+    }
+}
+
+void simClearTilt() {
+    g_simTilt = SimTilt();
+}
+
+int simTiltedPercent(SimTiltSite site, int side, double threshold, bool inclusive) {
+    // 事件档位为 [0, m)：按与调用处相同的比较方式逐档确定边界
+    auto inEvent = [&](int roll) {
+        double value = roll / 100.0;
+        return inclusive ? value <= threshold : value < threshold;
+    };
+    int m = std::clamp(static_cast<int>(threshold * 100), 0, 100);
+    while (m > 0 && !inEvent(m - 1)) m--;
+    while (m < 100 && inEvent(m)) m++;
+
+    if (g_simTilt.spec.byServe) side = (side == g_simTilt.serveSide) ? 0 : 1;
+    double lambda = g_simTilt.spec.odds[site][side];
+    if (m == 0 || m == 100 || lambda == 1.0) return simRandBelow(100);
+
+    double p = m / 100.0;
+    double q = lambda * p / (lambda * p + 1 - p);
+    double u = simRand() / (SIM_RAND_MAX + 1.0);
+    if (u < q) {
+        g_simTilt.logWeight += std::log(p / q);
+        return simRandBelow(m);
+    }
+    g_simTilt.logWeight += std::log((1 - p) / (1 - q));
+    return m + simRandBelow(100 - m);
+}
@@ -0,0 +1,142 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef SIMRANDOM_H
+#define SIMRANDOM_H
+
+#include <cstdint>
+
+// ============ 模拟用随机数 ============
+// 替代 rand()/srand()：每个线程各自一份状态（PCG32），
+// 多线程批量模拟时互不干扰，给定种子后结果可复现。
+// simRand() 的取值范围与 rand() 相同：[0, SIM_RAND_MAX]；取 [0, n) 的整数用 simRandBelow(n)
+
+#define SIM_RAND_MAX 0x7fffffff
+
+extern constinit thread_local uint64_t g_simRandState;
+extern constinit thread_local uint32_t g_simRandFlip;  // 0，或对偶模式下的 SIM_RAND_MAX（输出取 SIM_RAND_MAX - x）
+
+inline int simRand() {
+    uint64_t old = g_simRandState;
+    g_simRandState = old * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = static_cast<uint32_t>(old >> 59u);
+    uint32_t r = (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    return static_cast<int>((r >> 1) ^ g_simRandFlip);
+}
+
+// [0, n) 上的整数，即 simRand() % n。对偶模式下在档位上镜像为 n-1-k：
+// 直接对 SIM_RAND_MAX - x 取模并不单调（2^31-1 不是 n 的倍数时余数整体错位），配对就失去了负相关
+inline int simRandBelow(int n) {
+    int k = static_cast<int>(simRand() ^ g_simRandFlip) % n;
+    return g_simRandFlip ? n - 1 - k : k;
+}
+
+// 设置当前线程的随机数种子
+void simSeed(uint64_t seed);
+
+// ============ 决策点子序列（比较两个方案时的公共随机数） ============
+// 两个方案（两套参数或两种阵容）用同一个种子比较时，只要某一步多抽或少抽一次随机数，
+// 之后的整场比赛就完全错开了，两边的噪声几乎独立。开启子序列后，每一球开始时
+// 按（比赛种子，局数，比分）给发球、接一、二传、扣球、拦网、防守六个决策点各派生一条独立的子序列，
+// 每个环节只从自己的子序列取数：两个方案打到同一比分时，同一决策点拿到的随机数相同，差异只来自方案本身。
+// 对偶：同一种子再打一场，所有随机数取镜像（simRand() 取 SIM_RAND_MAX - x，simRandBelow(n) 取 n-1-k），
+// 与原场配成一对。比赛结果对各次取数并不单调，两场的负相关很弱（4000 对实测一场胜负的相关系数约为 0）。
+// 默认关闭，关闭时与原来的单一序列逐位相同；界面与其他批量命令不受影响。
+
+enum SimRandSite {
+    SIM_SITE_SERVE,
+    SIM_SITE_RECEIVE,
+    SIM_SITE_SET,
+    SIM_SITE_SPIKE,
+    SIM_SITE_BLOCK,
+    SIM_SITE_DEFENSE,
+    SIM_SITE_COUNT
+};
+
+struct SimRandStreams {
+    bool enabled = false;
+    uint64_t matchSeed = 0;                 // 最近一次 simSeed 的种子
+    uint64_t state[SIM_SITE_COUNT] = {};
+};
+
+extern constinit thread_local SimRandStreams g_simStreams;
+
+// 当前线程是否使用决策点子序列、是否取对偶数
+void simSetSiteStreams(bool enabled);
+void simSetAntithetic(bool antithetic);
+
+// 一球开始时派生各决策点的子序列（未开启时不做任何事）
+void simBeginRallyStreams(int setNum, int scoreA, int scoreB);
+
+// 在作用域内从某个决策点的子序列取数
+class SimRandSiteScope {
+public:
+    explicit SimRandSiteScope(SimRandSite site) : site(g_simStreams.enabled ? site : SIM_SITE_COUNT) {
+        if (this->site != SIM_SITE_COUNT) {
+            saved = g_simRandState;
+            g_simRandState = g_simStreams.state[site];
+        }
+    }
+    ~SimRandSiteScope() {
+        if (site != SIM_SITE_COUNT) {
+            g_simStreams.state[site] = g_simRandState;
+            g_simRandState = saved;
+        }
+    }
+    SimRandSiteScope(const SimRandSiteScope&) = delete;
+    SimRandSiteScope& operator=(const SimRandSiteScope&) = delete;
+
+private:
+    SimRandSite site;
+    uint64_t saved = 0;
+};
+
+// ============ 重要性抽样（稀有事件） ============
+// 发球失误、扣球失误、防守起球这几个"是否发生"的判定，都是从 [0,100) 均匀抽一个档位与阈值比较，
+// 事件对应前 m 个档位。开启倾斜后，按（判定点，队伍）的优势比倍数 λ 把事件概率 p = m/100 改为
+// q = λp / (λp + 1 - p)：先按 q 决定是否落在事件档位，再在选中的区间内均匀抽档位（区间内的分布与原来相同），
+// 同时把似然比 p/q 或 (1-p)/(1-q) 累乘进权重（取对数累加）。按权重加权的事件频率是原模型下概率的无偏估计。
+// byServe 时倍数按本球的发球方/接发球方给出，而不是A队/B队。
+// 默认关闭，关闭时即 simRandBelow(100)，与原来逐位相同。
+
+enum SimTiltSite {
+    SIM_TILT_SERVE_FAULT,   // 发球失误
+    SIM_TILT_SPIKE_ERROR,   // 扣球（含二次进攻）失误
+    SIM_TILT_DEFENSE,       // 防守起球（不失误）
+    SIM_TILT_COUNT
+};
+
+struct SimTiltSpec {
+    double odds[SIM_TILT_COUNT][2] = {{1, 1}, {1, 1}, {1, 1}};   // [判定点][A队,B队 或 发球方,接发球方] 优势比倍数
+    bool byServe = false;
+};
+
+struct SimTilt {
+    SimTiltSpec spec;
+    bool enabled = false;                                       // 倍数不全为 1
+    int serveSide = 0;                                          // 本球的发球方
+    double logWeight = 0;                                       // 似然比的对数
+};
+
+extern constinit thread_local SimTilt g_simTilt;
+
+// 设置当前线程的倾斜，并清零权重
+void simSetTilt(const SimTiltSpec& spec);
+void simClearTilt();
+
+// 一球开始时记下发球方（byServe 用）
+inline void simTiltServeSide(int serveSide) {
+    g_simTilt.serveSide = serveSide;
+}
+
+int simTiltedPercent(SimTiltSite site, int side, double threshold, bool inclusive);
+
+// 判定档位 [0,100)：档位/100 < threshold（inclusive 时为 <=）即事件发生；side 为做动作的队伍
+inline int simRollPercent(SimTiltSite site, int side, double threshold, bool inclusive = false) {
+    if (!g_simTilt.enabled) return simRandBelow(100);
+    return simTiltedPercent(site, side, threshold, inclusive);
+}
+
+#endif //SIMRANDOM_H
@@ -0,0 +1,580 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "simService.h"
+#include "balanceConfig.h"
+#include "resultCache.h"
+#include "serveReceiveTable.h"
+#include "simRandom.h"
+#include "player.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsBetween(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    std::string jsonEscape(const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else if (c < 0x20) {
+                const char* hex = "0123456789abcdef";
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+        return out;
+    }
+
+    // 一队阵容：7个 players.txt 序号（从1开始）或球员姓名，逗号分隔。key 追加球员池下标，用于合并请求
+    bool parseTeam(const std::string& value, Player team[7], std::string& key, std::string& error) {
+        std::vector<std::string> items;
+        std::stringstream ss(value);
+        std::string item;
+        while (std::getline(ss, item, ',')) items.push_back(item);
+        if (items.size() != 7) {
+            error = "阵容需要7名球员: " + value;
+            return false;
+        }
+        for (int i = 0; i < 7; i++) {
+            int index = -1;
+            bool numeric = !items[i].empty() && std::all_of(items[i].begin(), items[i].end(),
+                                                            [](unsigned char c) { return std::isdigit(c); });
+            if (numeric) {
+                index = std::stoi(items[i]) - 1;
+                if (index < 0 || index >= static_cast<int>(allPlayers.size())) index = -1;
+            } else {
+                for (int p = 0; p < static_cast<int>(allPlayers.size()); p++) {
+                    if (allPlayers[p].name == items[i]) {
+                        index = p;
+                        break;
+                    }
+                }
+            }
+            if (index < 0) {
+                error = "找不到球员: " + items[i];
+                return false;
+            }
+            team[i] = allPlayers[index];
+            key += std::to_string(index) + ",";
+        }
+        return true;
+    }
+
+    // 排队中的请求
+    struct Job {
+        ServiceRequest request;
+        Clock::time_point received;
+        Clock::time_point deadline;
+        bool hasDeadline = false;
+        std::promise<ServiceResponse> done;
+        ResultCacheKey cacheKey;
+        int first = 0;              // 缓存中已有前 first 场，从第 first 场起模拟
+        MatchStats prefix;          // 前 first 场的汇总
+    };
+
+    // 由场数、胜场与局数反推 2:0、2:1、1:2、0:2 的场数
+    void setScoreCounts(const MatchStats& s, long long counts[4]) {
+        long long threeSets = s.sets - 2 * s.matches;
+        long long lostDecider = s.setsA - 2 * s.winsA;      // A队 1:2 输掉的场数
+        counts[1] = threeSets - lostDecider;
+        counts[0] = s.winsA - counts[1];
+        counts[2] = lostDecider;
+        counts[3] = s.matches - s.winsA - lostDecider;
+    }
+
+    void fillResponse(ServiceResponse& response, const MatchStats& total) {
+        response.completed = total.matches;
+        response.winsA = total.winsA;
+        setScoreCounts(total, response.setScores);
+    }
+
+    // 调度：同一 batchKey 的请求合并成一批，在共用线程池上分发
+    class SimulationService {
+    public:
+        explicit SimulationService(const ServiceSpec& spec)
+            : pool(spec.threads), maxQueuedMatches(std::min<long long>(spec.maxQueuedMatches, INT_MAX)) {
+            if (!spec.cacheDir.empty()) {
+                std::string error;
+                if (cache.open(spec.cacheDir, spec.cacheCapacity, error)) std::cout << "结果缓存: " << spec.cacheDir << std::endl;
+                else std::cerr << error << "，不使用缓存" << std::endl;
+            }
+            scheduler = std::thread(&SimulationService::schedulerLoop, this);
+        }
+
+        ~SimulationService() {
+            stop();
+        }
+
+        // 查结果缓存：全部命中时填好 response 返回 true，不必排队；部分命中时记下已有的前缀
+        bool lookupCached(Job& job, ServiceResponse& response) {
+            if (!cache.isOpen()) return false;
+            Clock::time_point start = Clock::now();
+            job.cacheKey = resultCacheKey(job.request.roster, *job.request.params, job.request.seed);
+            job.first = static_cast<int>(cache.lookup(job.cacheKey, job.request.matches, job.prefix));
+            if (job.first < job.request.matches) return false;
+
+            response.ok = true;
+            fillResponse(response, job.prefix);
+            response.cached = job.first;
+            response.runMs = millisecondsBetween(start, Clock::now());
+            return true;
+        }
+
+        // 排队场数已达上限时返回 false（调用方回复 busy）
+        bool submit(const std::shared_ptr<Job>& job) {
+            std::lock_guard<std::mutex> lock(mtx);
+            int remaining = job->request.matches - job->first;
+            if (stopping || queuedMatches + remaining > maxQueuedMatches) return false;
+            queuedMatches += remaining;
+            pending.push_back(job);
+            cv.notify_one();
+            return true;
+        }
+
+        // 做完正在模拟的一批，其余排队的请求回复 shutting down
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (stopping) return;
+                stopping = true;
+            }
+            cv.notify_all();
+            scheduler.join();
+        }
+
+    private:
+        ThreadPool pool;
+        ResultCache cache;
+        long long maxQueuedMatches;
+        long long queuedMatches = 0;
+        std::deque<std::shared_ptr<Job>> pending;
+        bool stopping = false;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::thread scheduler;
+
+        void schedulerLoop() {
+            while (true) {
+                std::vector<std::shared_ptr<Job>> batch;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [this] { return stopping || !pending.empty(); });
+                    if (stopping) break;
+
+                    // 取出与队首相同阵容、参数的全部请求，保持先后顺序
+                    const std::string key = pending.front()->request.batchKey;
+                    for (auto it = pending.begin(); it != pending.end();) {
+                        if ((*it)->request.batchKey == key) {
+                            queuedMatches -= (*it)->request.matches - (*it)->first;
+                            batch.push_back(std::move(*it));
+                            it = pending.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                }
+                runBatch(batch);
+            }
+
+            std::lock_guard<std::mutex> lock(mtx);
+            for (auto& job : pending) {
+                ServiceResponse response;
+                response.error = "shutting down";
+                job->done.set_value(response);
+            }
+            pending.clear();
+            queuedMatches = 0;
+        }
+
+        void runBatch(std::vector<std::shared_ptr<Job>>& jobs) {
+            Clock::time_point start = Clock::now();
+
+            // 排队期间已超时的请求不再模拟
+            std::vector<std::shared_ptr<Job>> batch;
+            for (auto& job : jobs) {
+                if (job->hasDeadline && start >= job->deadline) {
+                    ServiceResponse response;
+                    response.error = "deadline exceeded";
+                    response.deadlineExceeded = true;
+                    response.queueMs = millisecondsBetween(job->received, start);
+                    job->done.set_value(response);
+                } else {
+                    batch.push_back(job);
+                }
+            }
+            if (batch.empty()) return;
+
+            // 种子、场数、缓存前缀与截止时间都相同（或都不限时）的请求结果相同，只模拟一次再分给每个请求；
+            // 截止时间不同的不合并，每个请求仍按自己的截止时间停止
+            std::vector<int> runOf(batch.size());
+            std::vector<const Job*> runs;
+            std::map<std::tuple<uint64_t, int, int, bool, Clock::time_point>, int> runIndex;
+            for (size_t k = 0; k < batch.size(); k++) {
+                const Job& job = *batch[k];
+                Clock::time_point deadline = job.hasDeadline ? job.deadline : Clock::time_point();
+                auto [it, inserted] = runIndex.emplace(
+                    std::make_tuple(job.request.seed, job.first, job.request.matches, job.hasDeadline, deadline),
+                    static_cast<int>(runs.size()));
+                if (inserted) runs.push_back(&job);
+                runOf[k] = it->second;
+            }
+
+            // 各组尚未缓存的场次首尾相接排成一个区间，一次分发
+            int count = static_cast<int>(runs.size());
+            std::vector<int> offsets(count + 1, 0);
+            for (int j = 0; j < count; j++) offsets[j + 1] = offsets[j] + runs[j]->request.matches - runs[j]->first;
+            int total = offsets[count];
+
+            const Roster& roster = runs[0]->request.roster;
+            const std::shared_ptr<const BalanceParams>& params = runs[0]->request.params;
+            std::vector<std::vector<MatchStats>> partial(pool.size(), std::vector<MatchStats>(count));
+            std::vector<ServeReceiveTables> tables(pool.size());   // 本批阵容和参数不变，每个槽位一份
+
+            int chunk = std::max(1, total / (pool.size() * 8));
+            pool.parallelForSlots(total, chunk, [&](int slot, int begin, int end) {
+                applyRoster(roster);
+                pinBalance(params);
+                setUIEventsEnabled(false);
+                setServeReceiveTables(&tables[slot]);
+
+                int j = static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()) - 1;
+                for (int i = begin; i < end; i++) {
+                    while (i >= offsets[j + 1]) j++;
+                    const Job& job = *runs[j];
+                    if (job.hasDeadline && Clock::now() >= job.deadline) continue;
+
+                    simSeed(matchSeed(job.request.seed, job.first + i - offsets[j]));
+                    simulateMatch(partial[slot][j]);
+                }
+                setServeReceiveTables(nullptr);
+            });
+
+            Clock::time_point finish = Clock::now();
+            std::vector<MatchStats> totals(count);
+            for (int j = 0; j < count; j++) {
+                const Job& job = *runs[j];
+                totals[j] = job.prefix;
+                for (const auto& slotStats : partial) totals[j].add(slotStats[j]);
+                // 中途超时跳过的场次不连续，只存完整的结果
+                if (totals[j].matches == job.request.matches && job.first < job.request.matches) {
+                    cache.store(job.cacheKey, job.request.matches, totals[j]);
+                }
+            }
+            for (size_t k = 0; k < batch.size(); k++) {
+                const Job& job = *batch[k];
+                ServiceResponse response;
+                fillResponse(response, totals[runOf[k]]);
+                response.cached = job.first;
+                response.deadlineExceeded = response.completed < job.request.matches;
+                response.ok = response.completed > 0;
+                if (!response.ok) response.error = "deadline exceeded";
+                response.batched = static_cast<int>(batch.size());
+                response.queueMs = millisecondsBetween(job.received, start);
+                response.runMs = millisecondsBetween(start, finish);
+                batch[k]->done.set_value(response);
+            }
+        }
+    };
+
+#ifndef _WIN32
+    volatile std::sig_atomic_t g_serviceStop = 0;
+
+    void onStopSignal(int) {
+        g_serviceStop = 1;
+    }
+
+    // 当前连接与计数，退出时用来关闭仍在等待的连接
+    struct ClientRegistry {
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::set<int> fds;
+    };
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    const size_t kMaxRequestLine = 64 * 1024;
+
+    void serveClient(int fd, SimulationService& service, const ServiceSpec& spec, const Roster& defaults,
+                     ClientRegistry& registry) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            // 已读到的完整各行一起提交，同一连接上的请求也可以合并成一批
+            std::vector<ServiceRequest> requests;
+            std::vector<ServiceResponse> immediate;
+            std::vector<std::future<ServiceResponse>> futures;
+            size_t lineEnd;
+            while ((lineEnd = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, lineEnd);
+                buffer.erase(0, lineEnd + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.find_first_not_of(" \t") == std::string::npos) continue;
+
+                Clock::time_point received = Clock::now();
+                auto job = std::make_shared<Job>();
+                ServiceResponse response;
+                std::string error;
+                if (!parseServiceRequest(line, defaults, currentBalance(), job->request, error)) {
+                    response.error = error;
+                } else if (job->request.matches > spec.maxMatchesPerRequest) {
+                    response.error = "matches exceeds " + std::to_string(spec.maxMatchesPerRequest);
+                } else {
+                    job->received = received;
+                    job->hasDeadline = job->request.deadlineMs > 0;
+                    job->deadline = received + std::chrono::milliseconds(job->request.deadlineMs);
+                    std::future<ServiceResponse> future = job->done.get_future();
+                    if (service.lookupCached(*job, response)) {
+                        requests.push_back(job->request);
+                        immediate.push_back(response);
+                        futures.emplace_back();
+                        continue;
+                    }
+                    if (service.submit(job)) {
+                        requests.push_back(job->request);
+                        immediate.emplace_back();
+                        futures.push_back(std::move(future));
+                        continue;
+                    }
+                    response.error = "busy";
+                }
+                requests.push_back(job->request);
+                immediate.push_back(response);
+                futures.emplace_back();
+            }
+
+            std::string out;
+            for (size_t i = 0; i < requests.size(); i++) {
+                ServiceResponse response = futures[i].valid() ? futures[i].get() : immediate[i];
+                out += formatServiceResponse(requests[i], response);
+            }
+            if (!out.empty() && !sendAll(fd, out)) break;
+
+            if (buffer.size() > kMaxRequestLine) {
+                ServiceResponse response;
+                response.error = "request line too long";
+                sendAll(fd, formatServiceResponse(ServiceRequest(), response));
+                break;
+            }
+        }
+
+        ::close(fd);
+        std::lock_guard<std::mutex> lock(registry.mtx);
+        registry.fds.erase(fd);
+        registry.cv.notify_all();
+    }
+#endif
+}
+
+bool parseServiceRequest(const std::string& line, const Roster& defaults, std::shared_ptr<const BalanceParams> base,
+                         ServiceRequest& request, std::string& error) {
+    request = ServiceRequest();
+    request.roster = defaults;
+    std::string teamKey[2] = {"default", "default"};
+    std::map<std::string, double> overrides;     // 按键排序，写法顺序不同的相同覆盖可以合并
+
+    std::istringstream iss(line);
+    std::string token;
+    while (iss >> token) {
+        size_t eq = token.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            error = "格式应为 key=value: " + token;
+            return false;
+        }
+        std::string key = token.substr(0, eq);
+        std::string value = token.substr(eq + 1);
+        try {
+            if (key == "id") {
+                request.id = value;
+            } else if (key == "matches") {
+                request.matches = std::stoi(value);
+            } else if (key == "seed") {
+                request.seed = std::stoull(value);
+            } else if (key == "deadline_ms") {
+                request.deadlineMs = std::stoi(value);
+            } else if (key == "a" || key == "b") {
+                int side = (key == "a") ? 0 : 1;
+                teamKey[side].clear();
+                if (!parseTeam(value, side == 0 ? request.roster.teamA : request.roster.teamB, teamKey[side], error)) {
+                    return false;
+                }
+            } else {
+                BalanceParams probe = *base;
+                double number = std::stod(value);
+                if (!setBalanceValue(probe, key, number)) {
+                    error = "未知参数: " + key;
+                    return false;
+                }
+                overrides[key] = number;
+            }
+        } catch (const std::exception&) {
+            error = "数值格式错误: " + token;
+            return false;
+        }
+    }
+    if (request.matches <= 0) {
+        error = "matches 必须为正数";
+        return false;
+    }
+
+    request.params = base;
+    std::ostringstream key;
+    key << "a=" << teamKey[0] << ";b=" << teamKey[1] << ";p=" << base.get() << ";";
+    if (!overrides.empty()) {
+        auto params = std::make_shared<BalanceParams>(*base);
+        for (const auto& [name, value] : overrides) {
+            setBalanceValue(*params, name, value);
+            key << name << "=" << std::setprecision(17) << value << ";";
+        }
+        request.params = params;
+    }
+    request.batchKey = key.str();
+    return true;
+}
+
+std::string formatServiceResponse(const ServiceRequest& request, const ServiceResponse& response) {
+    std::ostringstream out;
+    out << "{\"id\":\"" << jsonEscape(request.id) << "\",\"ok\":" << (response.ok ? "true" : "false");
+    if (!response.ok) {
+        out << ",\"error\":\"" << jsonEscape(response.error) << "\"";
+        if (response.deadlineExceeded) out << ",\"queue_ms\":" << response.queueMs;
+        out << "}\n";
+        return out.str();
+    }
+
+    double low, high;
+    wilsonInterval(response.winsA, response.completed, 1.96, low, high);
+    double n = static_cast<double>(response.completed);
+    out << std::setprecision(6);
+    out << ",\"matches\":" << request.matches << ",\"completed\":" << response.completed
+        << ",\"deadline_exceeded\":" << (response.deadlineExceeded ? "true" : "false")
+        << ",\"win_a\":" << response.winsA / n << ",\"win_a_low\":" << low << ",\"win_a_high\":" << high
+        << ",\"sets\":{\"2:0\":" << response.setScores[0] / n << ",\"2:1\":" << response.setScores[1] / n
+        << ",\"1:2\":" << response.setScores[2] / n << ",\"0:2\":" << response.setScores[3] / n << "}"
+        << ",\"cached\":" << response.cached << ",\"batched\":" << response.batched << ",\"queue_ms\":" << response.queueMs
+        << ",\"run_ms\":" << response.runMs << "}\n";
+    return out.str();
+}
+
+#ifdef _WIN32
+
+int runService(const ServiceSpec&) {
+    std::cerr << "本平台不支持 --serve（需要 Unix 域套接字）" << std::endl;
+    return 1;
+}
+
+#else
+
+int runService(const ServiceSpec& spec) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (spec.socketPath.empty() || spec.socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "套接字路径过长: " << spec.socketPath << std::endl;
+        return 1;
+    }
+    std::copy(spec.socketPath.begin(), spec.socketPath.end(), address.sun_path);
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "无法创建套接字" << std::endl;
+        return 1;
+    }
+    ::unlink(spec.socketPath.c_str());      // 上次异常退出留下的套接字文件
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listenFd, 64) < 0) {
+        std::cerr << "无法监听 " << spec.socketPath << std::endl;
+        ::close(listenFd);
+        return 1;
+    }
+
+    g_serviceStop = 0;
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    std::signal(SIGPIPE, SIG_IGN);          // 客户端提前断开时 send 返回错误，而不是结束进程
+
+    // 长时间运行：监视 balance.cfg，修改后的参数从之后收到的请求开始生效（参数不同的请求不会合并进同一批）
+    startBalanceWatcher("balance.cfg");
+    Roster defaults = captureRoster();
+    SimulationService service(spec);
+    ClientRegistry registry;
+    std::cout << "模拟服务已启动: " << spec.socketPath << "（Ctrl+C 退出）" << std::endl;
+
+    while (!g_serviceStop) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        if (::poll(&pfd, 1, 200) <= 0) continue;     // 超时或被信号打断，回去检查退出标志
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        std::lock_guard<std::mutex> lock(registry.mtx);
+        if (static_cast<int>(registry.fds.size()) >= spec.maxClients) {
+            ServiceResponse response;
+            response.error = "busy";
+            sendAll(fd, formatServiceResponse(ServiceRequest(), response));
+            ::close(fd);
+            continue;
+        }
+        registry.fds.insert(fd);
+        std::thread(serveClient, fd, std::ref(service), std::cref(spec), std::cref(defaults), std::ref(registry)).detach();
+    }
+
+    // 不再接受连接；排队的请求回复 shutting down，然后断开仍在读取的连接并等它们退出
+    ::close(listenFd);
+    ::unlink(spec.socketPath.c_str());
+    service.stop();
+    {
+        std::unique_lock<std::mutex> lock(registry.mtx);
+        for (int fd : registry.fds) ::shutdown(fd, SHUT_RDWR);
+        registry.cv.wait(lock, [&registry] { return registry.fds.empty(); });
+    }
+    stopBalanceWatcher();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::cout << "模拟服务已退出" << std::endl;
+    return 0;
+}
+
+#endif
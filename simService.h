@@ -0,0 +1,71 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef SIMSERVICE_H
+#define SIMSERVICE_H
+
+#include "batchSim.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ============ 本地模拟服务 ============
+// 守护进程模式：监听一个 Unix 域套接字，按行接收请求、按行返回 JSON 结果，供后端按需查询对阵预测。
+// 请求为一行空格分隔的 key=value：
+//   id=任意字符串  matches=2000  seed=1  deadline_ms=500
+//   a=1,2,3,4,5,6,7  b=8,9,10,11,12,13,14   两队阵容（1-6号位+自由人），可写 players.txt 中的序号（从1开始）或球员姓名；
+//                                          不写时用 players.txt 的预设两队
+//   AGGRESSIVE_SERVE_THRESHOLD=0.6 ...      其余键按平衡参数覆盖（与 config.h 中的宏同名），只对本请求生效
+// 返回一行 JSON：A队胜率及 95% 置信区间、局分分布（2:0、2:1、1:2、0:2）、缓存命中的场数、排队与模拟用时。
+//
+// 阵容与参数都相同的请求合并成一批，在共用的线程池上一次分发；第 i 场使用种子 (seed, i)，结果与 --boxscore 等批量命令一致。
+// 同一批中种子、场数与截止时间也相同（或都不限时）的请求只模拟一次，结果分给每个请求。
+// 同一连接可以连续发送多行，已读到的各行一起提交，结果按请求顺序返回；多个客户端可以同时连接。
+// 背压：排队的总场数或连接数超过上限时直接返回 busy，不在服务端无限排队。
+// 截止时间：排队期间已超时的请求不再模拟；模拟中途超时则停止，返回已完成的部分（completed < matches）。
+// 运行期间监视 balance.cfg，修改后的参数对之后收到的请求生效，无需重启服务。
+// 指定缓存目录时先查结果缓存：全部命中的请求不进队列直接返回，部分命中的只模拟缓存之后的场次。
+
+struct ServiceSpec {
+    std::string socketPath = "volleyball.sock";
+    int threads = 0;                        // 0 为自动
+    int maxClients = 64;                    // 同时连接数上限
+    long long maxQueuedMatches = 2000000;   // 排队等待模拟的总场数上限
+    int maxMatchesPerRequest = 1000000;
+    std::string cacheDir;                   // 结果缓存目录，空为不用缓存
+    int cacheCapacity = 4096;
+};
+
+// 一个请求
+struct ServiceRequest {
+    std::string id;
+    int matches = 1000;
+    uint64_t seed = 1;
+    int deadlineMs = 0;                     // 0 为不限
+    Roster roster;
+    std::shared_ptr<const BalanceParams> params;
+    std::string batchKey;                   // 阵容与参数相同的请求 batchKey 相同，可以合并
+};
+
+// 一个请求的结果
+struct ServiceResponse {
+    bool ok = false;
+    std::string error;
+    long long completed = 0, winsA = 0;
+    long long setScores[4] = {0, 0, 0, 0};  // 2:0、2:1、1:2、0:2 的场数
+    bool deadlineExceeded = false;
+    long long cached = 0;                   // 从结果缓存取出的场数
+    int batched = 1;                        // 本批合并的请求数
+    double queueMs = 0.0, runMs = 0.0;
+};
+
+// 解析一行请求；阵容缺省为 defaults，参数以 base 为基础
+bool parseServiceRequest(const std::string& line, const Roster& defaults, std::shared_ptr<const BalanceParams> base,
+                         ServiceRequest& request, std::string& error);
+std::string formatServiceResponse(const ServiceRequest& request, const ServiceResponse& response);
+
+// 运行服务直到收到 SIGINT/SIGTERM；阵容缺省取当前线程的两队，参数取当前发布的参数
+int runService(const ServiceSpec& spec);
+
+#endif //SIMSERVICE_H
@@ -5,9 +5,24 @@
 
 #include "spike.h"
 #include "config.h"
+#include "balanceConfig.h"
+#include "simRandom.h"
+#include "trace.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+
+const char* spikeStrategyName(SpikeStrategy value) {
+    switch (value) {
+        case STRONG_ATTACK: return "强攻";
+        case AVOID_BLOCK: return "避手";
+        case DROP_SHOT: return "吊球";
+        case QUICK_ATTACK: return "快球";
+        case ADJUST_SPIKE: return "调整攻";
+        case TRANSITION_ATTACK: return "过渡";
+        case SETTER_SPIKE: return "二次进攻";
+    }
+    return "";
+}
 
 
 // 构造函数
@@ -49,18 +64,42 @@ double Spiker::getFatigueFactor() {
     double staminaEffect = sqrt(sqrt(attacker.stamina / 100.0));
     double result = baseFatigue * staminaEffect;
 
-    #if DEBUG_SPIKE
-    std::cout << "\n疲劳因子: 基础" << baseFatigue << " * 耐力" << staminaEffect << " = " << result << std::endl;
-    #endif
+    TRACE(TRACE_SPIKE, "疲劳因子: 基础{} * 耐力{} = {}", baseFatigue, staminaEffect, result);
 
     return result;
 }
 
+// 扣球策略分布（百分比）
+namespace {
+    constexpr AliasTable kPerfectFrontStrategies = makeAliasTable({
+        {QUICK_ATTACK, 40}, {STRONG_ATTACK, 30}, {AVOID_BLOCK, 15}, {DROP_SHOT, 15}});
+    constexpr AliasTable kPerfectBackStrategies = makeAliasTable({
+        {STRONG_ATTACK, 70}, {AVOID_BLOCK, 20}, {TRANSITION_ATTACK, 10}});
+    constexpr AliasTable kGoodFrontStrategies = makeAliasTable({
+        {STRONG_ATTACK, 50}, {AVOID_BLOCK, 25}, {DROP_SHOT, 15}, {ADJUST_SPIKE, 10}});
+    constexpr AliasTable kGoodBackStrategies = makeAliasTable({
+        {STRONG_ATTACK, 50}, {AVOID_BLOCK, 20}, {TRANSITION_ATTACK, 15}, {ADJUST_SPIKE, 15}});
+    // 一般传球：15%强攻为搏杀
+    constexpr AliasTable kDecentStrategies = makeAliasTable({
+        {ADJUST_SPIKE, 40}, {TRANSITION_ATTACK, 30}, {DROP_SHOT, 15}, {STRONG_ATTACK, 15}});
+    constexpr AliasTable kPoorStrategies = makeAliasTable({
+        {TRANSITION_ATTACK, 50}, {ADJUST_SPIKE, 30}, {DROP_SHOT, 20}});
+    constexpr AliasTable kDefaultStrategies = makeAliasTable({{ADJUST_SPIKE, 1}});
+}
+
+const AliasTable& Spiker::strategyTable(PassQuality quality, bool frontRow) {
+    switch (quality) {
+        case PERFECT_PASS: return frontRow ? kPerfectFrontStrategies : kPerfectBackStrategies;
+        case GOOD_PASS: return frontRow ? kGoodFrontStrategies : kGoodBackStrategies;
+        case DECENT_PASS: return kDecentStrategies;
+        case POOR_PASS: return kPoorStrategies;
+    }
+    return kDefaultStrategies;
+}
+
 // 选择扣球策略
 SpikeStrategy Spiker::chooseSpikeStrategy(const PassResult& passResult) {
     // 根据传球质量和球员特点选择策略
-    double randomValue = (rand() % 100) / 100.0;
-
     // 判断进攻位置
     bool isFrontRow = isFrontRowAttack(attacker);
     bool isBackRow = isBackRowAttack(attacker);
@@ -74,181 +113,20 @@ SpikeStrategy Spiker::chooseSpikeStrategy(const PassResult& passResult) {
     double mentalToughness = attacker.mental.pressureResist / 100.0;
     double confidence = attacker.mental.confidence / 100.0;
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 扣球策略选择调试信息 ===" << std::endl;
-    std::cout << "扣球球员: " << attacker.name << " 扣球属性: " << attacker.spike << std::endl;
-    std::cout << "进攻位置: " << (isFrontRow ? "前排" : (isBackRow ? "后排" : "未知")) << std::endl;
-    std::cout << "传球质量: ";
-    switch(passQuality) {
-        case PERFECT_PASS: std::cout << "完美传球"; break;
-        case GOOD_PASS: std::cout << "好球"; break;
-        case DECENT_PASS: std::cout << "一般传球"; break;
-        case POOR_PASS: std::cout << "差球"; break;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球策略选择调试信息 ===");
+        traceWrite(TRACE_SPIKE, "扣球球员: {} 扣球属性: {}", attacker.name, attacker.spike);
+        traceWrite(TRACE_SPIKE, "进攻位置: {}", (isFrontRow ? "前排" : (isBackRow ? "后排" : "未知")));
+        traceWrite(TRACE_SPIKE, "传球质量: {} (质量值: {})", passQualityName(passQuality), passQualityValue);
     }
-    std::cout << " (质量值: " << passQualityValue << ")" << std::endl;
-    std::cout << "随机值: " << randomValue << std::endl;
-    #endif
-
-    SpikeStrategy strategy;
-
-    // 根据不同传球质量选择策略
-    switch (passQuality) {
-        case PERFECT_PASS:  // 完美传球
-            if (isFrontRow) {
-                // 前排可以打快球
-                if (randomValue < 0.4) { // 40%概率快球
-                    strategy = QUICK_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0, 0.4) => 策略: 快球" << std::endl;
-                    #endif
-                } else if (randomValue < 0.7) { // 30%概率强攻
-                    strategy = STRONG_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.4, 0.7) => 策略: 强攻" << std::endl;
-                    #endif
-                } else if (randomValue < 0.85) { // 15%概率避手
-                    strategy = AVOID_BLOCK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.7, 0.85) => 策略: 避手" << std::endl;
-                    #endif
-                } else { // 15%概率吊球
-                    strategy = DROP_SHOT;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.85, 1.0) => 策略: 吊球" << std::endl;
-                    #endif
-                }
-            } else {
-                // 后排进攻
-                if (randomValue < 0.7) { // 70%概率强攻
-                    strategy = STRONG_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0, 0.7) => 策略: 强攻" << std::endl;
-                    #endif
-                } else if (randomValue < 0.9) { // 20%概率避手
-                    strategy = AVOID_BLOCK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.7, 0.9) => 策略: 避手" << std::endl;
-                    #endif
-                } else { // 10%概率过渡
-                    strategy = TRANSITION_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.9, 1.0) => 策略: 过渡" << std::endl;
-                    #endif
-                }
-            }
-            break;
-
-        case GOOD_PASS:  // 好球
-            if (isFrontRow) {
-                if (randomValue < 0.5) { // 50%概率强攻
-                    strategy = STRONG_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0, 0.5) => 策略: 强攻" << std::endl;
-                    #endif
-                } else if (randomValue < 0.75) { // 25%概率避手
-                    strategy = AVOID_BLOCK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.5, 0.75) => 策略: 避手" << std::endl;
-                    #endif
-                } else if (randomValue < 0.9) { // 15%概率吊球
-                    strategy = DROP_SHOT;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.75, 0.9) => 策略: 吊球" << std::endl;
-                    #endif
-                } else { // 10%概率调整攻
-                    strategy = ADJUST_SPIKE;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.9, 1.0) => 策略: 调整攻" << std::endl;
-                    #endif
-                }
-            } else {
-                if (randomValue < 0.5) { // 50%概率强攻
-                    strategy = STRONG_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0, 0.5) => 策略: 强攻" << std::endl;
-                    #endif
-                } else if (randomValue < 0.7) { // 20%概率避手
-                    strategy = AVOID_BLOCK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.5, 0.7) => 策略: 避手" << std::endl;
-                    #endif
-                } else if (randomValue < 0.85) { // 15%概率过渡
-                    strategy = TRANSITION_ATTACK;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.7, 0.85) => 策略: 过渡" << std::endl;
-                    #endif
-                } else { // 15%概率调整攻
-                    strategy = ADJUST_SPIKE;
-                    #if DEBUG_SPIKE
-                    std::cout << "概率区间: [0.85, 1.0) => 策略: 调整攻" << std::endl;
-                    #endif
-                }
-            }
-            break;
-
-        case DECENT_PASS:  // 一般传球
-            if (randomValue < 0.4) { // 40%概率调整攻
-                strategy = ADJUST_SPIKE;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0, 0.4) => 策略: 调整攻" << std::endl;
-                #endif
-            } else if (randomValue < 0.7) { // 30%概率过渡
-                strategy = TRANSITION_ATTACK;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0.4, 0.7) => 策略: 过渡" << std::endl;
-                #endif
-            } else if (randomValue < 0.85) { // 15%概率吊球
-                strategy = DROP_SHOT;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0.7, 0.85) => 策略: 吊球" << std::endl;
-                #endif
-            } else { // 15%概率强攻（搏杀）
-                strategy = STRONG_ATTACK;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0.85, 1.0) => 策略: 强攻(搏杀)" << std::endl;
-                #endif
-            }
-            break;
-
-        case POOR_PASS:  // 差球
-            if (randomValue < 0.5) { // 50%概率过渡
-                strategy = TRANSITION_ATTACK;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0, 0.5) => 策略: 过渡" << std::endl;
-                #endif
-            } else if (randomValue < 0.8) { // 30%概率调整攻
-                strategy = ADJUST_SPIKE;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0.5, 0.8) => 策略: 调整攻" << std::endl;
-                #endif
-            } else { // 20%概率吊球
-                strategy = DROP_SHOT;
-                #if DEBUG_SPIKE
-                std::cout << "概率区间: [0.8, 1.0) => 策略: 吊球" << std::endl;
-                #endif
-            }
-            break;
 
-        default:
-            strategy = ADJUST_SPIKE;
-            #if DEBUG_SPIKE
-            std::cout << "默认策略: 调整攻" << std::endl;
-            #endif
-    }
+    // 按（传球质量，前后排）查表抽样
+    SpikeStrategy strategy = static_cast<SpikeStrategy>(strategyTable(passQuality, isFrontRow).sample());
 
-    #if DEBUG_SPIKE
-    std::cout << "最终扣球策略: ";
-    switch(strategy) {
-        case STRONG_ATTACK: std::cout << "强攻"; break;
-        case AVOID_BLOCK: std::cout << "避手"; break;
-        case DROP_SHOT: std::cout << "吊球"; break;
-        case QUICK_ATTACK: std::cout << "快球"; break;
-        case ADJUST_SPIKE: std::cout << "调整攻"; break;
-        case TRANSITION_ATTACK: std::cout << "过渡"; break;
-        case SETTER_SPIKE: std::cout << "二次进攻"; break;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "最终扣球策略: {}", spikeStrategyName(strategy));
+        traceWrite(TRACE_SPIKE, "===============================");
     }
-    std::cout << std::endl << "===============================" << std::endl;
-    #endif
 
     return strategy;
 }
@@ -259,90 +137,80 @@ StrategyAttributes Spiker::getStrategyAttributes(SpikeStrategy strategy) {
 
     switch (strategy) {
         case STRONG_ATTACK:      // 强攻
-            attr.powerFactor = STRONG_ATTACK_POWER;
-            attr.blockFactor = STRONG_ATTACK_BLOCK;  // 标准拦网难度
-            attr.errorRate = STRONG_ATTACK_FAULT;   // 20%基础失误率
-            attr.passQualityEffect = STRONG_ATTACK_PASS;  // 受二传质量影响大
-            attr.adjustmentEffect = STRONG_ATTACK_ADJUST;   // 调整属性影响一般
+            attr.powerFactor = balance().strongAttackPower;
+            attr.blockFactor = balance().strongAttackBlock;  // 标准拦网难度
+            attr.errorRate = balance().strongAttackFault;   // 20%基础失误率
+            attr.passQualityEffect = balance().strongAttackPass;  // 受二传质量影响大
+            attr.adjustmentEffect = balance().strongAttackAdjust;   // 调整属性影响一般
             attr.description = "强力扣杀";
             break;
 
         case AVOID_BLOCK:        // 避手
-            attr.powerFactor = AVOID_BLOCK_POWER;
-            attr.blockFactor = AVOID_BLOCK_BLOCK;  // 更难拦网
-            attr.errorRate = AVOID_BLOCK_FAULT;   // 25%基础失误率（更高）
-            attr.passQualityEffect = AVOID_BLOCK_PASS;  // 受二传质量影响中等
-            attr.adjustmentEffect = AVOID_BLOCK_ADJUST;   // 调整属性影响较大
+            attr.powerFactor = balance().avoidBlockPower;
+            attr.blockFactor = balance().avoidBlockBlock;  // 更难拦网
+            attr.errorRate = balance().avoidBlockFault;   // 25%基础失误率（更高）
+            attr.passQualityEffect = balance().avoidBlockPass;  // 受二传质量影响中等
+            attr.adjustmentEffect = balance().avoidBlockAdjust;   // 调整属性影响较大
             attr.description = "避手线";
             break;
 
         case DROP_SHOT:          // 吊球
-            attr.powerFactor = DROP_SHOT_POWER;
-            attr.blockFactor = DROP_SHOT_BLOCK;  // 很难拦网
-            attr.errorRate = DROP_SHOT_FAULT;   // 15%基础失误率
-            attr.passQualityEffect = DROP_SHOT_PASS;  // 受二传质量影响小
-            attr.adjustmentEffect = DROP_SHOT_ADJUST;   // 调整属性影响大
+            attr.powerFactor = balance().dropShotPower;
+            attr.blockFactor = balance().dropShotBlock;  // 很难拦网
+            attr.errorRate = balance().dropShotFault;   // 15%基础失误率
+            attr.passQualityEffect = balance().dropShotPass;  // 受二传质量影响小
+            attr.adjustmentEffect = balance().dropShotAdjust;   // 调整属性影响大
             attr.description = "轻吊";
             break;
 
         case QUICK_ATTACK:       // 快球
-            attr.powerFactor = QUICK_ATTACK_POWER;
-            attr.blockFactor = QUICK_ATTACK_BLOCK;  // 较难拦网
-            attr.errorRate = QUICK_ATTACK_FAULT;   // 20%基础失误率
-            attr.passQualityEffect = QUICK_ATTACK_PASS;  // 受二传质量影响很大
-            attr.adjustmentEffect = QUICK_ATTACK_ADJUST;   // 调整属性影响较大
+            attr.powerFactor = balance().quickAttackPower;
+            attr.blockFactor = balance().quickAttackBlock;  // 较难拦网
+            attr.errorRate = balance().quickAttackFault;   // 20%基础失误率
+            attr.passQualityEffect = balance().quickAttackPass;  // 受二传质量影响很大
+            attr.adjustmentEffect = balance().quickAttackAdjust;   // 调整属性影响较大
             attr.description = "快攻";
             break;
 
         case ADJUST_SPIKE:      // 调整攻
-            attr.powerFactor = ADJUST_SPIKE_POWER;
-            attr.blockFactor = ADJUST_SPIKE_BLOCK;  // 标准
-            attr.errorRate = ADJUST_SPIKE_FAULT;   // 15%基础失误率
-            attr.passQualityEffect = ADJUST_SPIKE_PASS;  // 受二传质量影响中等
-            attr.adjustmentEffect = ADJUST_SPIKE_ADJUST;   // 调整属性影响很大
+            attr.powerFactor = balance().adjustSpikePower;
+            attr.blockFactor = balance().adjustSpikeBlock;  // 标准
+            attr.errorRate = balance().adjustSpikeFault;   // 15%基础失误率
+            attr.passQualityEffect = balance().adjustSpikePass;  // 受二传质量影响中等
+            attr.adjustmentEffect = balance().adjustSpikeAdjust;   // 调整属性影响很大
             attr.description = "调整攻";
             break;
 
         case TRANSITION_ATTACK:  // 过渡
-            attr.powerFactor = TRANSITION_ATTACK_POWER;
-            attr.blockFactor = TRANSITION_ATTACK_BLOCK;  // 不易拦网
-            attr.errorRate = TRANSITION_ATTACK_FAULT;   // 10%基础失误率
-            attr.passQualityEffect = TRANSITION_ATTACK_PASS;  // 受二传质量影响小
-            attr.adjustmentEffect = TRANSITION_ATTACK_ADJUST;   // 调整属性影响大
+            attr.powerFactor = balance().transitionAttackPower;
+            attr.blockFactor = balance().transitionAttackBlock;  // 不易拦网
+            attr.errorRate = balance().transitionAttackFault;   // 10%基础失误率
+            attr.passQualityEffect = balance().transitionAttackPass;  // 受二传质量影响小
+            attr.adjustmentEffect = balance().transitionAttackAdjust;   // 调整属性影响大
             attr.description = "过渡球";
             break;
 
         case SETTER_SPIKE:       // 二次进攻
-            attr.powerFactor = SETTER_SPIKE_POWER;
-            attr.blockFactor = SETTER_SPIKE_BLOCK;  // 较难拦网
-            attr.errorRate = SETTER_SPIKE_FAULT;   // 25%基础失误率
-            attr.passQualityEffect = SETTER_SPIKE_PASS;  // 受二传质量影响中等
-            attr.adjustmentEffect = SETTER_SPIKE_ADJUST;   // 调整属性影响中等
+            attr.powerFactor = balance().setterSpikePower;
+            attr.blockFactor = balance().setterSpikeBlock;  // 较难拦网
+            attr.errorRate = balance().setterSpikeFault;   // 25%基础失误率
+            attr.passQualityEffect = balance().setterSpikePass;  // 受二传质量影响中等
+            attr.adjustmentEffect = balance().setterSpikeAdjust;   // 调整属性影响中等
             attr.description = "二次进攻";
             break;
     }
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 策略属性调试信息 ===" << std::endl;
-    std::cout << "策略: ";
-    switch(strategy) {
-        case STRONG_ATTACK: std::cout << "强攻"; break;
-        case AVOID_BLOCK: std::cout << "避手"; break;
-        case DROP_SHOT: std::cout << "吊球"; break;
-        case QUICK_ATTACK: std::cout << "快球"; break;
-        case ADJUST_SPIKE: std::cout << "调整攻"; break;
-        case TRANSITION_ATTACK: std::cout << "过渡"; break;
-        case SETTER_SPIKE: std::cout << "二次进攻"; break;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 策略属性调试信息 ===");
+        traceWrite(TRACE_SPIKE, "策略: {}", spikeStrategyName(strategy));
+        traceWrite(TRACE_SPIKE, "强度系数: {}", attr.powerFactor);
+        traceWrite(TRACE_SPIKE, "拦网系数(基础): {}", attr.blockFactor);
+        traceWrite(TRACE_SPIKE, "基础失误率: {}", attr.errorRate);
+        traceWrite(TRACE_SPIKE, "二传质量影响系数: {}", attr.passQualityEffect);
+        traceWrite(TRACE_SPIKE, "调整属性影响系数: {}", attr.adjustmentEffect);
+        traceWrite(TRACE_SPIKE, "描述: {}", attr.description);
+        traceWrite(TRACE_SPIKE, "=========================");
     }
-    std::cout << std::endl;
-    std::cout << "强度系数: " << attr.powerFactor << std::endl;
-    std::cout << "拦网系数(基础): " << attr.blockFactor << std::endl;
-    std::cout << "基础失误率: " << attr.errorRate << std::endl;
-    std::cout << "二传质量影响系数: " << attr.passQualityEffect << std::endl;
-    std::cout << "调整属性影响系数: " << attr.adjustmentEffect << std::endl;
-    std::cout << "描述: " << attr.description << std::endl;
-    std::cout << "=========================" << std::endl;
-    #endif
 
     return attr;
 }
@@ -385,24 +253,24 @@ double Spiker::calculateSpikeAdjustment(const PassResult& passResult, SpikeStrat
 
     double finalAdjustment = std::max(0.3, adjustment);
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 扣球调整系数调试信息 ===" << std::endl;
-    std::cout << "1. 疲劳影响: " << getFatigueFactor() << std::endl;
-    std::cout << "2. 心理素质影响: " << pressureEffect << " => " << (0.85 + 0.3 * pressureEffect) << std::endl;
-    std::cout << "3. 自信心影响: " << confidenceEffect << " => " << (0.9 + 0.2 * confidenceEffect) << std::endl;
-    std::cout << "4. 专注度影响: " << concentrationEffect << " => " << (0.9 + 0.2 * concentrationEffect) << std::endl;
-    std::cout << "5. 团队压力影响: " << teamPressureEffect << " => " << (1.0 - 0.05 * teamPressureEffect) << std::endl;
-    std::cout << "6. 调整属性影响:" << std::endl;
-    std::cout << "   传球质量值: " << passResult.qualityValue << " => 传球质量因子: " << passQualityFactor << std::endl;
-    std::cout << "   调整属性值: " << attacker.adjust << " => 调整效果: " << adjustEffect << std::endl;
-    std::cout << "   调整权重: 基础0.3 + " << passQualityFactor << "*0.5 = " << 0.3 + passQualityFactor * 0.5 << std::endl;
-    std::cout << "   策略调整属性系数: " << attr.adjustmentEffect << std::endl;
-    std::cout << "   最终调整权重: " << (0.3 + passQualityFactor * 0.5) << " * " << attr.adjustmentEffect << " = " << adjustWeight << std::endl;
-    std::cout << "   调整部分: (1 - " << adjustWeight << ") + " << adjustWeight << "*" << adjustEffect << " = " << (1.0 - adjustWeight + adjustWeight * adjustEffect) << std::endl;
-    std::cout << "计算后调整系数: " << adjustment << std::endl;
-    std::cout << "最终调整系数(限定范围): " << finalAdjustment << std::endl;
-    std::cout << "=============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球调整系数调试信息 ===");
+        traceWrite(TRACE_SPIKE, "1. 疲劳影响: {}", getFatigueFactor());
+        traceWrite(TRACE_SPIKE, "2. 心理素质影响: {} => {}", pressureEffect, (0.85 + 0.3 * pressureEffect));
+        traceWrite(TRACE_SPIKE, "3. 自信心影响: {} => {}", confidenceEffect, (0.9 + 0.2 * confidenceEffect));
+        traceWrite(TRACE_SPIKE, "4. 专注度影响: {} => {}", concentrationEffect, (0.9 + 0.2 * concentrationEffect));
+        traceWrite(TRACE_SPIKE, "5. 团队压力影响: {} => {}", teamPressureEffect, (1.0 - 0.05 * teamPressureEffect));
+        traceWrite(TRACE_SPIKE, "6. 调整属性影响:");
+        traceWrite(TRACE_SPIKE, "   传球质量值: {} => 传球质量因子: {}", passResult.qualityValue, passQualityFactor);
+        traceWrite(TRACE_SPIKE, "   调整属性值: {} => 调整效果: {}", attacker.adjust, adjustEffect);
+        traceWrite(TRACE_SPIKE, "   调整权重: 基础0.3 + {}*0.5 = {}", passQualityFactor, 0.3 + passQualityFactor * 0.5);
+        traceWrite(TRACE_SPIKE, "   策略调整属性系数: {}", attr.adjustmentEffect);
+        traceWrite(TRACE_SPIKE, "   最终调整权重: {} * {} = {}", (0.3 + passQualityFactor * 0.5), attr.adjustmentEffect, adjustWeight);
+        traceWrite(TRACE_SPIKE, "   调整部分: (1 - {}) + {}*{} = {}", adjustWeight, adjustWeight, adjustEffect, (1.0 - adjustWeight + adjustWeight * adjustEffect));
+        traceWrite(TRACE_SPIKE, "计算后调整系数: {}", adjustment);
+        traceWrite(TRACE_SPIKE, "最终调整系数(限定范围): {}", finalAdjustment);
+        traceWrite(TRACE_SPIKE, "=============================");
+    }
 
     return finalAdjustment;
 }
@@ -428,11 +296,11 @@ int Spiker::calculateSpikePower(const PassResult& passResult, SpikeStrategy stra
     // 添加后排进攻补正：后排进攻扣球强度削弱15%
     bool isBackRow = isBackRowAttack(attacker);
     if (isBackRow) {
-        spikePower *= BACK_ATTACK_POWER_ADJUST; // 后排进攻强度削弱15%
+        spikePower *= balance().backAttackPowerAdjust; // 后排进攻强度削弱15%
     }
 
     // 添加随机因素
-    double randomFactor = (rand() % 30 - 15);
+    double randomFactor = (simRandBelow(30) - 15);
     spikePower += randomFactor;
 
     // 限制在合理范围
@@ -440,23 +308,23 @@ int Spiker::calculateSpikePower(const PassResult& passResult, SpikeStrategy stra
 
     int result = static_cast<int>(spikePower);
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 扣球强度计算调试信息 ===" << std::endl;
-    std::cout << "基础扣球能力: " << baseSpikeAbility << std::endl;
-    std::cout << "调整系数: " << adjustment << std::endl;
-    std::cout << "策略强度系数: " << powerFactor << std::endl;
-    std::cout << "传球质量影响: " << passQualityEffect << std::endl;
-    std::cout << "传球影响系数: 0.5 + 0.5*" << passQualityEffect << " = " << passInfluence << std::endl;
-    std::cout << "基础计算: " << baseSpikeAbility << " * " << adjustment << " * " << powerFactor << " * " << passInfluence << " = " << baseSpikeAbility * adjustment * powerFactor * passInfluence << std::endl;
-    std::cout << "计算后强度: " << spikePower - randomFactor << std::endl;
-    std::cout << "后排进攻补正: " << (isBackRow ? "是(削弱15%)" : "否") << std::endl;
-    if (isBackRow) {
-        std::cout << "后排削弱后强度: " << (spikePower - randomFactor) * 0.85 << std::endl;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球强度计算调试信息 ===");
+        traceWrite(TRACE_SPIKE, "基础扣球能力: {}", baseSpikeAbility);
+        traceWrite(TRACE_SPIKE, "调整系数: {}", adjustment);
+        traceWrite(TRACE_SPIKE, "策略强度系数: {}", powerFactor);
+        traceWrite(TRACE_SPIKE, "传球质量影响: {}", passQualityEffect);
+        traceWrite(TRACE_SPIKE, "传球影响系数: 0.5 + 0.5*{} = {}", passQualityEffect, passInfluence);
+        traceWrite(TRACE_SPIKE, "基础计算: {} * {} * {} * {} = {}", baseSpikeAbility, adjustment, powerFactor, passInfluence, baseSpikeAbility * adjustment * powerFactor * passInfluence);
+        traceWrite(TRACE_SPIKE, "计算后强度: {}", spikePower - randomFactor);
+        traceWrite(TRACE_SPIKE, "后排进攻补正: {}", (isBackRow ? "是(削弱15%)" : "否"));
+        if (isBackRow) {
+            traceWrite(TRACE_SPIKE, "后排削弱后强度: {}", (spikePower - randomFactor) * 0.85);
+        }
+        traceWrite(TRACE_SPIKE, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_SPIKE, "最终强度值: {} (四舍五入: {})", spikePower, result);
+        traceWrite(TRACE_SPIKE, "============================");
     }
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终强度值: " << spikePower << " (四舍五入: " << result << ")" << std::endl;
-    std::cout << "============================" << std::endl;
-    #endif
 
     return result;
 }
@@ -488,31 +356,31 @@ double Spiker::calculateBlockCoefficient(const PassResult& passResult, SpikeStra
     // 添加后排进攻补正：后排进攻更不容易被拦网（降低30%拦网系数）
     bool isBackRow = isBackRowAttack(attacker);
     if (isBackRow) {
-        blockDifficulty *= BACK_ATTACK_BLOCK_ADJUST; // 后排进攻降低30%拦网系数
+        blockDifficulty *= balance().backAttackBlockAdjust; // 后排进攻降低30%拦网系数
     }
 
     // 添加随机因素
-    double randomFactor = ((rand() % 20) - 10) / 100.0;
+    double randomFactor = (simRandBelow(20) - 10) / 100.0;
     blockDifficulty += randomFactor;
 
     // 限制范围：0.3-1.5
     blockDifficulty = std::max(0.3, std::min(1.5, blockDifficulty));
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 拦网系数计算调试信息 ===" << std::endl;
-    std::cout << "基础拦网系数: " << baseBlockCoefficient << std::endl;
-    std::cout << "扣球能力影响: " << spikeAbilityEffect << " => 降低: " << spikeAbilityEffect * 0.3 << std::endl;
-    std::cout << "扣球影响后系数: " << baseBlockCoefficient << " * (1 - " << spikeAbilityEffect << "*0.3) = " << baseBlockCoefficient * (1.0 - spikeAbilityEffect * 0.3) << std::endl;
-    std::cout << "传球质量影响: " << passQualityEffect << " => 降低: " << passQualityEffect * 0.2 << std::endl;
-    std::cout << "传球影响后系数: " << blockDifficulty / (1.0 - adjustment * 0.2 + 0.2) << " * (1 - " << passQualityEffect << "*0.2) = " << blockDifficulty / (1.0 - adjustment * 0.2 + 0.2) * (1.0 - passQualityEffect * 0.2) << std::endl;
-    std::cout << "调整系数影响: " << adjustment << " => 公式: (1 - " << adjustment << "*0.2 + 0.2) = " << (1.0 - adjustment * 0.2 + 0.2) << std::endl;
-    std::cout << "策略特异性: " << (strategy == QUICK_ATTACK ? "快球(降低20%)" : "无") << std::endl;
-    std::cout << "后排进攻补正: " << (isBackRow ? "是(降低30%)" : "否") << std::endl;
-    std::cout << "计算后系数: " << blockDifficulty - randomFactor << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终拦网系数: " << blockDifficulty << " (范围: 0.3-1.5)" << std::endl;
-    std::cout << "============================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 拦网系数计算调试信息 ===");
+        traceWrite(TRACE_SPIKE, "基础拦网系数: {}", baseBlockCoefficient);
+        traceWrite(TRACE_SPIKE, "扣球能力影响: {} => 降低: {}", spikeAbilityEffect, spikeAbilityEffect * 0.3);
+        traceWrite(TRACE_SPIKE, "扣球影响后系数: {} * (1 - {}*0.3) = {}", baseBlockCoefficient, spikeAbilityEffect, baseBlockCoefficient * (1.0 - spikeAbilityEffect * 0.3));
+        traceWrite(TRACE_SPIKE, "传球质量影响: {} => 降低: {}", passQualityEffect, passQualityEffect * 0.2);
+        traceWrite(TRACE_SPIKE, "传球影响后系数: {} * (1 - {}*0.2) = {}", blockDifficulty / (1.0 - adjustment * 0.2 + 0.2), passQualityEffect, blockDifficulty / (1.0 - adjustment * 0.2 + 0.2) * (1.0 - passQualityEffect * 0.2));
+        traceWrite(TRACE_SPIKE, "调整系数影响: {} => 公式: (1 - {}*0.2 + 0.2) = {}", adjustment, adjustment, (1.0 - adjustment * 0.2 + 0.2));
+        traceWrite(TRACE_SPIKE, "策略特异性: {}", (strategy == QUICK_ATTACK ? "快球(降低20%)" : "无"));
+        traceWrite(TRACE_SPIKE, "后排进攻补正: {}", (isBackRow ? "是(降低30%)" : "否"));
+        traceWrite(TRACE_SPIKE, "计算后系数: {}", blockDifficulty - randomFactor);
+        traceWrite(TRACE_SPIKE, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_SPIKE, "最终拦网系数: {} (范围: 0.3-1.5)", blockDifficulty);
+        traceWrite(TRACE_SPIKE, "============================");
+    }
 
     return blockDifficulty;
 }
@@ -552,32 +420,26 @@ double Spiker::calculateErrorRate(const PassResult& passResult, SpikeStrategy st
     }
 
     // 添加随机因素
-    double randomFactor = ((rand() % 10) - 5) / 100.0;
+    double randomFactor = (simRandBelow(10) - 5) / 100.0;
     errorRate += randomFactor;
 
     // 限制范围：5%-50%
     errorRate = std::max(0.05, std::min(0.5, errorRate));
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 失误率计算调试信息 ===" << std::endl;
-    std::cout << "基础失误率: " << baseErrorRate << std::endl;
-    std::cout << "扣球技能降低失误率: 降低了" << (1-errorReductionRate) * 100 << "% "  << std::endl;
-    std::cout << "传球质量影响: 传球质量 " << passResult.qualityValue << " => 质量因子 " << passQualityEffect << " => 增加失误率 " << passPenalty << std::endl;
-    std::cout << "调整系数影响: 调整系数 " << adjustment << " => 惩罚 " << (1.0 - adjustment) << " * 0.4 = " << adjustmentPenalty << std::endl;
-    std::cout << "初步计算失误率: " << baseErrorRate << " * " << errorReductionRate << " + " << passPenalty << " + " << adjustmentPenalty << " = " << baseErrorRate * errorReductionRate + passPenalty + adjustmentPenalty << std::endl;
-    std::cout << "策略特异性: ";
-    if (strategy == AVOID_BLOCK) {
-        std::cout << "避手(+5%)" << std::endl;
-    } else if (strategy == DROP_SHOT) {
-        std::cout << "吊球(-3%)" << std::endl;
-    } else {
-        std::cout << "无" << std::endl;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 失误率计算调试信息 ===");
+        traceWrite(TRACE_SPIKE, "基础失误率: {}", baseErrorRate);
+        traceWrite(TRACE_SPIKE, "扣球技能降低失误率: 降低了{}% ", (1-errorReductionRate) * 100);
+        traceWrite(TRACE_SPIKE, "传球质量影响: 传球质量 {} => 质量因子 {} => 增加失误率 {}", passResult.qualityValue, passQualityEffect, passPenalty);
+        traceWrite(TRACE_SPIKE, "调整系数影响: 调整系数 {} => 惩罚 {} * 0.4 = {}", adjustment, (1.0 - adjustment), adjustmentPenalty);
+        traceWrite(TRACE_SPIKE, "初步计算失误率: {} * {} + {} + {} = {}", baseErrorRate, errorReductionRate, passPenalty, adjustmentPenalty, baseErrorRate * errorReductionRate + passPenalty + adjustmentPenalty);
+        traceWrite(TRACE_SPIKE, "策略特异性: {}",
+                   strategy == AVOID_BLOCK ? "避手(+5%)" : strategy == DROP_SHOT ? "吊球(-3%)" : "无");
+        traceWrite(TRACE_SPIKE, "后排进攻补正: {}", (isBackRow ? "是(+5%)" : "否"));
+        traceWrite(TRACE_SPIKE, "随机因素: {}", randomFactor);
+        traceWrite(TRACE_SPIKE, "最终失误率: {} (范围: 5%-50%)", errorRate);
+        traceWrite(TRACE_SPIKE, "===========================");
     }
-    std::cout << "后排进攻补正: " << (isBackRow ? "是(+5%)" : "否") << std::endl;
-    std::cout << "随机因素: " << randomFactor << std::endl;
-    std::cout << "最终失误率: " << errorRate << " (范围: 5%-50%)" << std::endl;
-    std::cout << "===========================" << std::endl;
-    #endif
 
     return errorRate;
 }
@@ -587,18 +449,11 @@ SpikeResult Spiker::simulateSpike(const PassResult& passResult) {
     SpikeResult result;
     result.attacker = attacker;
 
-    #if DEBUG_SPIKE
-    std::cout << "\n\n=== 扣球模拟开始 ===" << std::endl;
-    std::cout << "扣球球员: " << attacker.name << " 扣球属性: " << attacker.spike << " 调整属性: " << attacker.adjust << std::endl;
-    std::cout << "传球质量值: " << passResult.qualityValue << " (";
-    switch(passResult.quality) {
-        case PERFECT_PASS: std::cout << "完美传球"; break;
-        case GOOD_PASS: std::cout << "好球"; break;
-        case DECENT_PASS: std::cout << "一般传球"; break;
-        case POOR_PASS: std::cout << "差球"; break;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球模拟开始 ===");
+        traceWrite(TRACE_SPIKE, "扣球球员: {} 扣球属性: {} 调整属性: {}", attacker.name, attacker.spike, attacker.adjust);
+        traceWrite(TRACE_SPIKE, "传球质量值: {} ({})", passResult.qualityValue, passQualityName(passResult.quality));
     }
-    std::cout << ")" << std::endl;
-    #endif
 
     // 选择扣球策略
     result.strategy = chooseSpikeStrategy(passResult);
@@ -620,18 +475,18 @@ SpikeResult Spiker::simulateSpike(const PassResult& passResult) {
     double errorRate = calculateErrorRate(passResult, result.strategy, adjustment);
 
     // 判断是否失误
-    double randomValue = (rand() % 100) / 100.0;
+    double randomValue = simRollPercent(SIM_TILT_SPIKE_ERROR, teamID, errorRate) / 100.0;
     result.isError = (randomValue < errorRate);
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 扣球结果判定 ===" << std::endl;
-    std::cout << "失误率: " << errorRate << " 随机值: " << randomValue << std::endl;
-    std::cout << "是否失误: " << (result.isError ? "是" : "否") << std::endl;
-    #endif
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球结果判定 ===");
+        traceWrite(TRACE_SPIKE, "失误率: {} 随机值: {}", errorRate, randomValue);
+        traceWrite(TRACE_SPIKE, "是否失误: {}", (result.isError ? "是" : "否"));
+    }
 
     if (result.isError) {
         // 判断是出界还是下网
-        double errorType = (rand() % 100) / 100.0;
+        double errorType = simRandBelow(100) / 100.0;
         result.isOut = (errorType > 0.5); // 50%概率出界，50%概率下网
 
         if (result.isOut) {
@@ -644,10 +499,10 @@ SpikeResult Spiker::simulateSpike(const PassResult& passResult) {
         result.spikePower = 0;
         result.blockCoefficient = 0;
 
-        #if DEBUG_SPIKE
-        std::cout << "失误类型: " << (result.isOut ? "出界" : "下网") << std::endl;
-        std::cout << "描述: " << result.description << std::endl;
-        #endif
+        if (traceOn(TRACE_SPIKE)) {
+            traceWrite(TRACE_SPIKE, "失误类型: {}", (result.isOut ? "出界" : "下网"));
+            traceWrite(TRACE_SPIKE, "描述: {}", result.description);
+        }
     } else {
         // 成功扣球
         result.isOut = false;
@@ -676,50 +531,40 @@ SpikeResult Spiker::simulateSpike(const PassResult& passResult) {
             result.description += "（轻处理）";
         }
 
-        #if DEBUG_SPIKE
-        std::cout << "扣球强度: " << result.spikePower << " => 描述: " << result.description << std::endl;
-        std::cout << "拦网系数: " << result.blockCoefficient << std::endl;
-        #endif
+        if (traceOn(TRACE_SPIKE)) {
+            traceWrite(TRACE_SPIKE, "扣球强度: {} => 描述: {}", result.spikePower, result.description);
+            traceWrite(TRACE_SPIKE, "拦网系数: {}", result.blockCoefficient);
+        }
     }
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 扣球最终结果 ===" << std::endl;
-    std::cout << "扣球策略: ";
-    switch(result.strategy) {
-        case STRONG_ATTACK: std::cout << "强攻"; break;
-        case AVOID_BLOCK: std::cout << "避手"; break;
-        case DROP_SHOT: std::cout << "吊球"; break;
-        case QUICK_ATTACK: std::cout << "快球"; break;
-        case ADJUST_SPIKE: std::cout << "调整攻"; break;
-        case TRANSITION_ATTACK: std::cout << "过渡"; break;
-        case SETTER_SPIKE: std::cout << "二次进攻"; break;
-    }
-    std::cout << std::endl;
-    std::cout << "扣球强度: " << result.spikePower << std::endl;
-    std::cout << "拦网系数: " << result.blockCoefficient << std::endl;
-    std::cout << "是否失误: " << (result.isError ? "是" : "否") << std::endl;
-    if (result.isError) {
-        std::cout << "失误类型: " << (result.isOut ? "出界" : "下网") << std::endl;
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 扣球最终结果 ===");
+        traceWrite(TRACE_SPIKE, "扣球策略: {}", spikeStrategyName(result.strategy));
+        traceWrite(TRACE_SPIKE, "扣球强度: {}", result.spikePower);
+        traceWrite(TRACE_SPIKE, "拦网系数: {}", result.blockCoefficient);
+        traceWrite(TRACE_SPIKE, "是否失误: {}", (result.isError ? "是" : "否"));
+        if (result.isError) {
+            traceWrite(TRACE_SPIKE, "失误类型: {}", (result.isOut ? "出界" : "下网"));
+        }
+        traceWrite(TRACE_SPIKE, "描述: {}", result.description);
+        traceWrite(TRACE_SPIKE, "=== 扣球模拟结束 ===");
     }
-    std::cout << "描述: " << result.description << std::endl;
-    std::cout << "=== 扣球模拟结束 ===\n" << std::endl;
-    #endif
 
     return result;
 }
 
 // 创建二次进攻扣球结果
-SpikeResult Spiker::createSetterDumpResult(const Player& setter, int dumpEffectiveness) {
+SpikeResult Spiker::createSetterDumpResult(const Player& setter, int dumpEffectiveness, int teamID) {
     SpikeResult result;
     result.attacker = setter;
     result.strategy = SETTER_SPIKE;
     result.spikePower = dumpEffectiveness;
-    result.blockCoefficient = SETTER_SPIKE_BLOCK; // 二次进攻拦网系数较低
+    result.blockCoefficient = balance().setterSpikeBlock; // 二次进攻拦网系数较低
     result.isSetterDump = true;
 
     // 二次进攻的失误率计算
     // 基础失误率：二次进攻相对稳定，基础失误率较低
-    double baseErrorRate = 0.15; // 15%基础失误率
+    double baseErrorRate = balance().dumpErrorRate; // 15%基础失误率
 
     // 二传手的调整属性影响失误率
     double adjustmentEffect = setter.adjust / 100.0;
@@ -733,28 +578,28 @@ SpikeResult Spiker::createSetterDumpResult(const Player& setter, int dumpEffecti
     double errorRate = baseErrorRate * errorReductionRate * effectivenessReduction;
 
     // 添加随机因素
-    double randomFactor = ((rand() % 10) - 5) / 100.0;
+    double randomFactor = (simRandBelow(10) - 5) / 100.0;
     errorRate += randomFactor;
 
     // 限制范围：5%-30%（二次进攻相对稳定）
     errorRate = std::max(0.05, std::min(0.3, errorRate));
 
     // 判断是否失误
-    double randomValue = (rand() % 100) / 100.0;
+    double randomValue = simRollPercent(SIM_TILT_SPIKE_ERROR, teamID, errorRate) / 100.0;
     result.isError = (randomValue < errorRate);
 
-    #if DEBUG_SPIKE
-    std::cout << "\n=== 二次进攻扣球结果 ===" << std::endl;
-    std::cout << "扣球球员: " << setter.name << std::endl;
-    std::cout << "扣球强度: " << dumpEffectiveness << std::endl;
-    std::cout << "拦网系数: 0.6" << std::endl;
-    std::cout << "失误率: " << errorRate << " 随机值: " << randomValue << std::endl;
-    std::cout << "是否失误: " << (result.isError ? "是" : "否") << std::endl;
-    #endif
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "=== 二次进攻扣球结果 ===");
+        traceWrite(TRACE_SPIKE, "扣球球员: {}", setter.name);
+        traceWrite(TRACE_SPIKE, "扣球强度: {}", dumpEffectiveness);
+        traceWrite(TRACE_SPIKE, "拦网系数: 0.6");
+        traceWrite(TRACE_SPIKE, "失误率: {} 随机值: {}", errorRate, randomValue);
+        traceWrite(TRACE_SPIKE, "是否失误: {}", (result.isError ? "是" : "否"));
+    }
 
     if (result.isError) {
         // 判断是出界还是下网
-        double errorType = (rand() % 100) / 100.0;
+        double errorType = simRandBelow(100) / 100.0;
         result.isOut = (errorType > 0.5); // 50%概率出界，50%概率下网
 
         if (result.isOut) {
@@ -783,10 +628,10 @@ SpikeResult Spiker::createSetterDumpResult(const Player& setter, int dumpEffecti
         }
     }
 
-    #if DEBUG_SPIKE
-    std::cout << "描述: " << result.description << std::endl;
-    std::cout << "========================" << std::endl;
-    #endif
+    if (traceOn(TRACE_SPIKE)) {
+        traceWrite(TRACE_SPIKE, "描述: {}", result.description);
+        traceWrite(TRACE_SPIKE, "========================");
+    }
 
     return result;
 }
\ No newline at end of file
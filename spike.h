@@ -8,6 +8,7 @@
 #include "player.h"
 #include "game.h"
 #include "setBall.h"
+#include "aliasTable.h"
 
 // 扣球策略枚举
 enum SpikeStrategy {
@@ -20,6 +21,8 @@ enum SpikeStrategy {
     SETTER_SPIKE         // 二传二次进攻（新增）
 };
 
+const char* spikeStrategyName(SpikeStrategy value);  // 调试追踪中显示的名称
+
 // 扣球结果结构体
 struct SpikeResult {
     SpikeStrategy strategy;          // 扣球策略
@@ -51,6 +54,9 @@ public:
     // 选择扣球策略
     SpikeStrategy chooseSpikeStrategy(const PassResult& passResult);
 
+    // 扣球策略的分布表（按传球质量与前后排）
+    static const AliasTable& strategyTable(PassQuality quality, bool frontRow);
+
     // 获取策略属性
     StrategyAttributes getStrategyAttributes(SpikeStrategy strategy);
 
@@ -70,7 +76,7 @@ public:
     SpikeResult simulateSpike(const PassResult& passResult);
 
     // 创建二次进攻扣球结果（新增）
-    static SpikeResult createSetterDumpResult(const Player& setter, int dumpEffectiveness);
+    static SpikeResult createSetterDumpResult(const Player& setter, int dumpEffectiveness, int teamID);
 
 private:
     Player attacker;            // 扣球球员
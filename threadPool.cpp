@@ -0,0 +1,86 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "threadPool.h"
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(int threadCount) : running(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = true;
+    }
+    taskCv.notify_all();
+    for (auto& t : workers) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            taskCv.wait(lk, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;  // stopping 且无剩余任务
+            task = std::move(tasks.front());
+            tasks.pop();
+            running++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            running--;
+            if (running == 0 && tasks.empty()) doneCv.notify_all();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        tasks.push(std::move(task));
+    }
+    taskCv.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lk(mtx);
+    doneCv.wait(lk, [this]() { return running == 0 && tasks.empty(); });
+}
+
+void ThreadPool::parallelFor(int count, int chunk, const std::function<void(int, int)>& fn) {
+    parallelForSlots(count, chunk, [&fn](int, int begin, int end) { fn(begin, end); });
+}
+
+void ThreadPool::parallelForSlots(int count, int chunk, const std::function<void(int, int, int)>& fn) {
+    if (count <= 0) return;
+    if (chunk <= 0) chunk = 1;
+
+    // 各线程从共享计数器领取下一块，快的线程多做，避免尾部等待
+    std::atomic<int> next{0};
+    int jobs = std::min(size(), (count + chunk - 1) / chunk);
+    for (int j = 0; j < jobs; j++) {
+        submit([&next, count, chunk, &fn, j]() {
+            while (true) {
+                int begin = next.fetch_add(chunk);
+                if (begin >= count) break;
+                fn(j, begin, std::min(count, begin + chunk));
+            }
+        });
+    }
+    wait();
+}
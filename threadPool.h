@@ -0,0 +1,47 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池，批量模拟共用
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable taskCv;
+    std::condition_variable doneCv;
+    int running;        // 已取出但未完成的任务数
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(int threadCount = 0);   // 0 表示使用硬件线程数
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    void submit(std::function<void()> task);
+    void wait();        // 等待所有已提交的任务完成
+
+    // 把 [0, count) 按 chunk 大小动态分发给各线程，fn(begin, end) 处理一块；阻塞直到全部完成
+    void parallelFor(int count, int chunk, const std::function<void(int, int)>& fn);
+
+    // 同上，fn(slot, begin, end) 另给出槽位号 [0, size())；同一槽位不会并发执行，可用来索引每线程的累加器
+    void parallelForSlots(int count, int chunk, const std::function<void(int, int, int)>& fn);
+};
+
+#endif //THREADPOOL_H
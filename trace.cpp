@@ -0,0 +1,129 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#include "trace.h"
+#include <algorithm>
+#include <vector>
+
+thread_local uint32_t t_traceMask = 0;
+
+namespace {
+    const size_t kRingCapacity = 4096;
+
+    const char* kModuleNames[TRACE_MODULE_COUNT] = {
+        "serve", "receive", "setball", "spike", "block", "defense", "game", "mental"
+    };
+
+    // 当前线程的环形缓冲区，第一次写入时才分配
+    struct TraceRing {
+        std::vector<TraceRecord> records;
+        size_t start = 0, count = 0;
+        std::ostream* sink = nullptr;
+    };
+
+    thread_local TraceRing t_ring;
+
+    void writeArg(std::ostream& out, const TraceArg& a) {
+        switch (a.kind) {
+            case TraceArg::INT: out << a.i; break;
+            case TraceArg::REAL: out << a.d; break;
+            case TraceArg::LITERAL: out << a.s; break;
+            case TraceArg::TEXT: out << a.text; break;
+            default: break;
+        }
+    }
+
+    void writeRecord(std::ostream& out, const TraceRecord& r) {
+        out << "[" << kModuleNames[r.module] << "] ";
+        int next = 0;
+        for (const char* p = r.format; *p; p++) {
+            if (p[0] == '{' && p[1] == '}' && next < r.argc) {
+                writeArg(out, r.args[next++]);
+                p++;
+            } else {
+                out << *p;
+            }
+        }
+        out << "\n";
+    }
+}
+
+void traceSetMask(uint32_t mask) {
+    t_traceMask = mask & TRACE_ALL;
+}
+
+const char* traceModuleName(TraceModule module) {
+    return kModuleNames[module];
+}
+
+uint32_t parseTraceModules(const std::string& list) {
+    uint32_t mask = 0;
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos) end = list.size();
+        std::string name = list.substr(begin, end - begin);
+        if (name == "all") {
+            mask |= TRACE_ALL;
+        } else if (!name.empty()) {
+            int found = -1;
+            for (int m = 0; m < TRACE_MODULE_COUNT; m++) {
+                if (name == kModuleNames[m]) found = m;
+            }
+            if (found < 0) return 0;
+            mask |= 1u << found;
+        }
+        begin = end + 1;
+    }
+    return mask;
+}
+
+void traceSetSink(std::ostream* out) {
+    t_ring.sink = out;
+}
+
+void traceFlush(std::ostream* out) {
+    TraceRing& ring = t_ring;
+    if (ring.count == 0) return;
+    if (!out) out = ring.sink;
+    if (out) {
+        for (size_t k = 0; k < ring.count; k++) {
+            writeRecord(*out, ring.records[(ring.start + k) % ring.records.size()]);
+        }
+        out->flush();
+    }
+    ring.start = 0;
+    ring.count = 0;
+}
+
+TraceRecord& traceAppend(TraceModule module, const char* format) {
+    TraceRing& ring = t_ring;
+    if (ring.records.empty()) ring.records.resize(kRingCapacity);
+    if (ring.count == ring.records.size()) {
+        if (ring.sink) {
+            traceFlush(ring.sink);
+        } else {
+            // 覆盖最旧的一条
+            ring.start = (ring.start + 1) % ring.records.size();
+            ring.count--;
+        }
+    }
+    TraceRecord& r = ring.records[(ring.start + ring.count) % ring.records.size()];
+    ring.count++;
+    r.module = static_cast<uint8_t>(module);
+    r.format = format;
+    r.argc = 0;
+    return r;
+}
+
+namespace traceDetail {
+    void store(TraceArg& a, const std::string& s) {
+        a.kind = TraceArg::TEXT;
+        size_t n = std::min(s.size(), sizeof(a.text) - 1);
+        // 不在 UTF-8 多字节字符中间截断
+        while (n < s.size() && n > 0 && (static_cast<unsigned char>(s[n]) & 0xC0) == 0x80) n--;
+        std::memcpy(a.text, s.data(), n);
+        a.text[n] = '\0';
+    }
+}
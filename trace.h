@@ -0,0 +1,102 @@
+//
+// Created by yaorz2 on 25-12-1.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// ============ 运行时调试追踪 ============
+// 取代原来 config.h 中 DEBUG_* 宏控制的 std::cout 调试输出，无需重新编译即可开关。
+// 每个线程有自己的开关掩码（按模块）和环形缓冲区：
+//   关闭时 TRACE 只是一次对线程局部掩码的判断；
+//   开启时只把格式串指针和参数原样写入缓冲区，不做格式化，由 traceFlush 统一输出为文本。
+// 格式串中的 {} 依次替换为参数；字符串参数须为字面量（只保存指针），std::string 会截断复制。
+
+enum TraceModule {
+    TRACE_SERVE,
+    TRACE_RECEIVE,
+    TRACE_SETBALL,
+    TRACE_SPIKE,
+    TRACE_BLOCK,
+    TRACE_DEFENSE,
+    TRACE_GAME,
+    TRACE_MENTAL,
+    TRACE_MODULE_COUNT
+};
+
+const uint32_t TRACE_ALL = (1u << TRACE_MODULE_COUNT) - 1;
+
+struct TraceArg {
+    enum Kind : uint8_t { NONE, INT, REAL, LITERAL, TEXT } kind = NONE;
+    union {
+        long long i;
+        double d;
+        const char* s;
+        char text[48];      // 复制的字符串（球员姓名、结果描述等），按 UTF-8 字符边界截断
+    };
+    TraceArg() : i(0) {}
+};
+
+const int kTraceMaxArgs = 8;
+
+struct TraceRecord {
+    uint8_t module;
+    uint8_t argc;
+    const char* format;
+    TraceArg args[kTraceMaxArgs];
+};
+
+extern thread_local uint32_t t_traceMask;
+
+inline bool traceOn(TraceModule module) {
+    return (t_traceMask >> module) & 1u;
+}
+
+void traceSetMask(uint32_t mask);                   // 设置当前线程的开关掩码
+uint32_t parseTraceModules(const std::string& list); // "serve,block" / "all"，无法识别的名字返回0
+const char* traceModuleName(TraceModule module);
+
+// 设置当前线程的输出流：缓冲区写满时先输出再清空；为空时写满后覆盖最旧的记录
+void traceSetSink(std::ostream* out);
+// 把当前线程缓冲区中的记录按顺序输出并清空（out 为空时使用 traceSetSink 的流）
+void traceFlush(std::ostream* out = nullptr);
+
+TraceRecord& traceAppend(TraceModule module, const char* format);
+
+namespace traceDetail {
+    inline void store(TraceArg& a, const char* s) { a.kind = TraceArg::LITERAL; a.s = s; }
+    inline void store(TraceArg& a, char c) { a.kind = TraceArg::TEXT; a.text[0] = c; a.text[1] = '\0'; }
+    void store(TraceArg& a, const std::string& s);
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> store(TraceArg& a, T v) {
+        if constexpr (std::is_floating_point_v<T>) {
+            a.kind = TraceArg::REAL;
+            a.d = v;
+        } else {
+            a.kind = TraceArg::INT;
+            a.i = static_cast<long long>(v);
+        }
+    }
+}
+
+// 不检查开关，调用方已判断 traceOn
+template <typename... Args>
+void traceWrite(TraceModule module, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= kTraceMaxArgs, "too many trace arguments");
+    TraceRecord& r = traceAppend(module, format);
+    r.argc = static_cast<uint8_t>(sizeof...(Args));
+    int n = 0;
+    (traceDetail::store(r.args[n++], args), ...);
+}
+
+#define TRACE(module, ...) \
+    do { if (traceOn(module)) traceWrite(module, __VA_ARGS__); } while (0)
+
+#endif //TRACE_H